@@ -452,6 +452,18 @@ namespace yato
             return *this;
         }
 
+        /**
+         * Evaluate lazy expression into the viewed elements. See expression_nd.h
+         * Unlike other assignments, the view is not rebound. Shapes must match.
+         */
+        template <typename Expression_, typename =
+            std::enable_if_t<yato::is_expression_nd<Expression_>::value>>
+        array_view_nd& operator=(const Expression_ & expression)
+        {
+            expression.evaluate_to(*this);
+            return *this;
+        }
+
         /**
          * Create a new array view on the same data but with another shape
          * Total size should be unchanged
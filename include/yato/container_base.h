@@ -33,6 +33,22 @@ namespace yato
     struct container_continuous_tag : public container_strided_tag {};
 
 
+    /**
+     * Base of lazy expressions, which can be assigned to containers. See expression_nd.h
+     */
+    struct expression_nd_tag {};
+
+    template <typename Ty_>
+    using is_expression_nd = std::is_base_of<expression_nd_tag, Ty_>;
+
+    /**
+     * Selects container constructors, which allocate storage without constructing elements.
+     */
+    struct uninitialized_t {};
+
+    YATO_INLINE_VARIABLE constexpr uninitialized_t uninitialized{};
+
+
 
 
     /**
@@ -1013,6 +1013,42 @@ namespace yato
             return fetch_value_impl_<ValueType_, Dim_ + 1>(container_ops::get_category(c), s, container_ops::subscript(c, effective_idx), i1, indexes_tail...);
         }
 
+        template <typename ValueType_, size_t Dim_, typename SamplerRef_, typename ContainerRef_, typename... Indexes_>
+        static YATO_CONSTEXPR_FUNC_CXX14
+        decltype(auto) fetch_value_impl_(yato::container_strided_tag, SamplerRef_&& s, ContainerRef_&& c, const Indexes_&... indexes)
+        {
+            size_t effective_offset{ 0 };
+            return fetch_value_strided_impl_<ValueType_, Dim_, 0>(effective_offset, s, c, indexes...);
+        }
+
+        /**
+         * Accumulates byte offset of the row, then reads the element with a single pointer arithmetic.
+         * Dim_ is the sampler dimension, ContainerDim_ is the dimension in the container being sampled.
+         */
+        template <typename ValueType_, size_t Dim_, size_t ContainerDim_, typename SamplerRef_, typename ContainerRef_>
+        static YATO_CONSTEXPR_FUNC_CXX14
+        decltype(auto) fetch_value_strided_impl_(size_t& effective_offset, SamplerRef_&& s, ContainerRef_&& c, index_type index_curr)
+        {
+            using container_ops = container_ops<yato::remove_cvref_t<ContainerRef_>>;
+
+            const size_t effective_idx = invoke_transform_index_<Dim_>(has_transform_index_{}, s, index_curr, container_ops::size(c, ContainerDim_));
+            auto row_ptr = container_ops::data(c);
+            details::advance_bytes(row_ptr, effective_offset);
+            return row_ptr[effective_idx];
+        }
+
+        template <typename ValueType_, size_t Dim_, size_t ContainerDim_, typename SamplerRef_, typename ContainerRef_, typename... Indexes_>
+        static YATO_CONSTEXPR_FUNC_CXX14
+        decltype(auto) fetch_value_strided_impl_(size_t& effective_offset, SamplerRef_&& s, ContainerRef_&& c, index_type index_curr, index_type index_next, const Indexes_&... indexes_tail)
+        {
+            using container_ops = container_ops<yato::remove_cvref_t<ContainerRef_>>;
+
+            const size_t effective_idx = invoke_transform_index_<Dim_>(has_transform_index_{}, s, index_curr, container_ops::size(c, ContainerDim_));
+            effective_offset += effective_idx * container_ops::stride(c, ContainerDim_);
+
+            return fetch_value_strided_impl_<ValueType_, Dim_ + 1, ContainerDim_ + 1>(effective_offset, s, c, index_next, indexes_tail...);
+        }
+
         template <typename ValueType_, size_t Dim_, typename SamplerRef_, typename ContainerRef_, typename... Indexes_>
         static YATO_CONSTEXPR_FUNC_CXX14
         decltype(auto) fetch_value_impl_(yato::container_continuous_tag, SamplerRef_&& s, ContainerRef_&& c, const Indexes_&... indexes)
@@ -0,0 +1,546 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_EXPRESSION_ND_H_
+#define _YATO_EXPRESSION_ND_H_
+
+#include <array>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "assertion.h"
+#include "array_view.h"
+#include "container_nd.h"
+#include "vector_nd.h"
+
+namespace yato
+{
+
+    namespace details
+    {
+
+        /**
+         * Types which are turned into expressions by arithmetic operators.
+         */
+        template <typename Ty_>
+        struct is_expression_operand_
+            : yato::is_expression_nd<Ty_>
+        { };
+
+        template <typename Ty_, size_t Dims_, typename Allocator_, typename CapacityPolicy_, typename LayoutPolicy_>
+        struct is_expression_operand_<vector_nd_impl<Ty_, Dims_, Allocator_, CapacityPolicy_, LayoutPolicy_>>
+            : std::true_type
+        { };
+
+        template <typename Ty_, size_t Dims_>
+        struct is_expression_operand_<yato::array_view_nd<Ty_, Dims_>>
+            : std::true_type
+        { };
+
+        template <typename Ty_, typename Descriptor_, size_t Dims_, proxy_access_policy Access_>
+        struct is_expression_operand_<yato::proxy_nd<Ty_, Descriptor_, Dims_, Access_>>
+            : std::true_type
+        { };
+
+        template <typename Left_, typename Right_>
+        using enable_if_expression_operands_ = std::enable_if_t<
+            (is_expression_operand_<yato::remove_cvref_t<Left_>>::value || is_expression_operand_<yato::remove_cvref_t<Right_>>::value) &&
+            (is_expression_operand_<yato::remove_cvref_t<Left_>>::value || std::is_arithmetic<yato::remove_cvref_t<Left_>>::value) &&
+            (is_expression_operand_<yato::remove_cvref_t<Right_>>::value || std::is_arithmetic<yato::remove_cvref_t<Right_>>::value)
+        >;
+
+        //-------------------------------------------------------
+        // Plain evaluators. Called with a linear index when all leaves are continuous.
+
+        template <typename Ty_>
+        struct plain_pointer_evaluator
+        {
+            const Ty_* ptr;
+
+            Ty_ operator()(size_t idx) const
+            {
+                return ptr[idx];
+            }
+        };
+
+        template <typename Ty_>
+        struct plain_scalar_evaluator
+        {
+            Ty_ value;
+
+            Ty_ operator()(size_t /*idx*/) const
+            {
+                return value;
+            }
+        };
+
+        template <typename Op_, typename Arg_>
+        struct plain_unary_evaluator
+        {
+            Op_ op;
+            Arg_ arg;
+
+            decltype(auto) operator()(size_t idx) const
+            {
+                return op(arg(idx));
+            }
+        };
+
+        template <typename Op_, typename Left_, typename Right_>
+        struct plain_binary_evaluator
+        {
+            Op_ op;
+            Left_ left;
+            Right_ right;
+
+            decltype(auto) operator()(size_t idx) const
+            {
+                return op(left(idx), right(idx));
+            }
+        };
+
+        //-------------------------------------------------------
+
+        template <typename Derived_, size_t Dims_>
+        class expression_nd_base;
+
+        template <size_t Dims_, typename Expression_, typename Container_>
+        void evaluate_expression_(const Expression_ & expression, Container_ && dst, std::integral_constant<size_t, 1>);
+
+        template <size_t Dims_, typename Expression_, typename Container_, size_t SubDims_>
+        void evaluate_expression_(const Expression_ & expression, Container_ && dst, std::integral_constant<size_t, SubDims_>);
+
+    } // namespace details
+
+
+    /**
+     * Lazy element-wise expression over multidimensional containers.
+     * Operators build an expression tree, which is evaluated in one pass on assignment to vector_nd or array_view_nd.
+     * Expression keeps references to lvalue containers, so it should not outlive them.
+     */
+    template <typename Derived_, size_t Dims_>
+    class expression_nd
+        : public expression_nd_tag
+    {
+    public:
+        static YATO_CONSTEXPR_VAR size_t dimensions_number = Dims_;
+
+        const Derived_ & derived() const
+        {
+            return static_cast<const Derived_&>(*this);
+        }
+
+        /**
+         * Common shape of all containers in the expression.
+         * Throws yato::argument_error if shapes mismatch.
+         */
+        dimensionality<Dims_, size_t> dimensions() const
+        {
+            std::array<size_t, Dims_> shape = {};
+            bool initialized = false;
+            bool valid = true;
+            derived().collect_shape(shape, initialized, valid);
+            if (!valid) {
+                throw yato::argument_error("yato::expression_nd: containers have different shapes.");
+            }
+            return dimensionality<Dims_, size_t>(yato::make_range(shape.cbegin(), shape.cend()));
+        }
+
+        size_t total_size() const
+        {
+            return dimensions().total_size();
+        }
+
+        /**
+         * Writes the result to a container of the same shape.
+         */
+        template <typename Container_>
+        void evaluate_to(Container_ && dst) const
+        {
+            using container_ops = yato::container_ops<yato::remove_cvref_t<Container_>>;
+            static_assert(container_ops::dimensions_number == Dims_, "yato::expression_nd: destination has different dimensions number.");
+            const auto extents = dimensions();
+            for (size_t d = 0; d < Dims_; ++d) {
+                if (container_ops::size(dst, d) != extents[d]) {
+                    throw yato::argument_error("yato::expression_nd: destination has different shape.");
+                }
+            }
+            details::evaluate_expression_<Dims_>(derived(), dst, std::integral_constant<size_t, Dims_>{});
+        }
+    };
+
+
+    namespace details
+    {
+
+        /**
+         * Leaf referencing a container. Holder_ is either const reference or value type.
+         */
+        template <typename Holder_>
+        class container_expression
+            : public expression_nd<container_expression<Holder_>, container_ops<yato::remove_cvref_t<Holder_>>::dimensions_number>
+        {
+        private:
+            using container_type = yato::remove_cvref_t<Holder_>;
+            using container_ops = yato::container_ops<container_type>;
+
+            Holder_ m_container;
+
+        public:
+            using value_type = std::remove_cv_t<typename container_ops::value_type>;
+            static YATO_CONSTEXPR_VAR size_t dimensions_number = container_ops::dimensions_number;
+
+            template <typename Container_>
+            explicit
+            container_expression(Container_ && c)
+                : m_container(std::forward<Container_>(c))
+            { }
+
+            size_t size(size_t dim) const
+            {
+                return container_ops::size(m_container, dim);
+            }
+
+            bool continuous() const
+            {
+                return container_ops::continuous(m_container);
+            }
+
+            template <size_t Dims_>
+            void collect_shape(std::array<size_t, Dims_> & shape, bool & initialized, bool & valid) const
+            {
+                for (size_t d = 0; d < Dims_; ++d) {
+                    const size_t extent = size(d);
+                    if (initialized) {
+                        valid = valid && (shape[d] == extent);
+                    }
+                    else {
+                        shape[d] = extent;
+                    }
+                }
+                initialized = true;
+            }
+
+            auto sub(size_t idx) const
+            {
+                using sub_type = yato::remove_cvref_t<decltype(container_ops::csubscript(m_container, idx))>;
+                return container_expression<sub_type>(container_ops::csubscript(m_container, idx));
+            }
+
+            auto plain() const
+            {
+                return plain_pointer_evaluator<value_type>{ container_ops::cdata(m_container) };
+            }
+        };
+
+        /**
+         * Leaf broadcasting a single value
+         */
+        template <typename Ty_>
+        class scalar_expression
+        {
+        private:
+            Ty_ m_value;
+
+        public:
+            using value_type = Ty_;
+            static YATO_CONSTEXPR_VAR size_t dimensions_number = 0;
+
+            explicit
+            scalar_expression(const Ty_ & value)
+                : m_value(value)
+            { }
+
+            bool continuous() const
+            {
+                return true;
+            }
+
+            template <size_t Dims_>
+            void collect_shape(std::array<size_t, Dims_> & /*shape*/, bool & /*initialized*/, bool & /*valid*/) const
+            { }
+
+            const scalar_expression & sub(size_t /*idx*/) const
+            {
+                return *this;
+            }
+
+            auto plain() const
+            {
+                return plain_scalar_evaluator<Ty_>{ m_value };
+            }
+        };
+
+        template <typename Op_, typename Arg_>
+        class unary_expression
+            : public expression_nd<unary_expression<Op_, Arg_>, Arg_::dimensions_number>
+        {
+        private:
+            Op_ m_op;
+            Arg_ m_arg;
+
+        public:
+            using value_type = std::decay_t<decltype(std::declval<const Op_&>()(std::declval<typename Arg_::value_type>()))>;
+            static YATO_CONSTEXPR_VAR size_t dimensions_number = Arg_::dimensions_number;
+
+            unary_expression(const Op_ & op, Arg_ arg)
+                : m_op(op), m_arg(std::move(arg))
+            { }
+
+            size_t size(size_t dim) const
+            {
+                return m_arg.size(dim);
+            }
+
+            bool continuous() const
+            {
+                return m_arg.continuous();
+            }
+
+            template <size_t Dims_>
+            void collect_shape(std::array<size_t, Dims_> & shape, bool & initialized, bool & valid) const
+            {
+                m_arg.collect_shape(shape, initialized, valid);
+            }
+
+            auto sub(size_t idx) const
+            {
+                using sub_arg = yato::remove_cvref_t<decltype(m_arg.sub(idx))>;
+                return unary_expression<Op_, sub_arg>(m_op, m_arg.sub(idx));
+            }
+
+            auto plain() const
+            {
+                using arg_evaluator = decltype(m_arg.plain());
+                return plain_unary_evaluator<Op_, arg_evaluator>{ m_op, m_arg.plain() };
+            }
+        };
+
+        template <typename Op_, typename Left_, typename Right_>
+        class binary_expression
+            : public expression_nd<binary_expression<Op_, Left_, Right_>, std::max(Left_::dimensions_number, Right_::dimensions_number)>
+        {
+            static_assert((Left_::dimensions_number == Right_::dimensions_number) || (Left_::dimensions_number == 0) || (Right_::dimensions_number == 0),
+                "yato::expression_nd: operands have different dimensions number.");
+
+        private:
+            Op_ m_op;
+            Left_ m_left;
+            Right_ m_right;
+
+            size_t size_(size_t dim, std::true_type /*left is container*/) const
+            {
+                return m_left.size(dim);
+            }
+
+            size_t size_(size_t dim, std::false_type /*left is container*/) const
+            {
+                return m_right.size(dim);
+            }
+
+        public:
+            using value_type = std::decay_t<decltype(std::declval<const Op_&>()(std::declval<typename Left_::value_type>(), std::declval<typename Right_::value_type>()))>;
+            static YATO_CONSTEXPR_VAR size_t dimensions_number = std::max(Left_::dimensions_number, Right_::dimensions_number);
+
+            binary_expression(const Op_ & op, Left_ left, Right_ right)
+                : m_op(op), m_left(std::move(left)), m_right(std::move(right))
+            { }
+
+            size_t size(size_t dim) const
+            {
+                return size_(dim, std::integral_constant<bool, (Left_::dimensions_number > 0)>{});
+            }
+
+            bool continuous() const
+            {
+                return m_left.continuous() && m_right.continuous();
+            }
+
+            template <size_t Dims_>
+            void collect_shape(std::array<size_t, Dims_> & shape, bool & initialized, bool & valid) const
+            {
+                m_left.collect_shape(shape, initialized, valid);
+                m_right.collect_shape(shape, initialized, valid);
+            }
+
+            auto sub(size_t idx) const
+            {
+                using sub_left  = yato::remove_cvref_t<decltype(m_left.sub(idx))>;
+                using sub_right = yato::remove_cvref_t<decltype(m_right.sub(idx))>;
+                return binary_expression<Op_, sub_left, sub_right>(m_op, m_left.sub(idx), m_right.sub(idx));
+            }
+
+            auto plain() const
+            {
+                using left_evaluator  = decltype(m_left.plain());
+                using right_evaluator = decltype(m_right.plain());
+                return plain_binary_evaluator<Op_, left_evaluator, right_evaluator>{ m_op, m_left.plain(), m_right.plain() };
+            }
+        };
+
+        //-------------------------------------------------------
+
+        template <typename Ty_>
+        auto make_expression_operand_(Ty_ && operand, std::true_type /*is expression*/, std::false_type /*is arithmetic*/)
+        {
+            return yato::remove_cvref_t<Ty_>(std::forward<Ty_>(operand));
+        }
+
+        template <typename Ty_>
+        auto make_expression_operand_(Ty_ && operand, std::false_type /*is expression*/, std::false_type /*is arithmetic*/)
+        {
+            // Lvalues are referenced, rvalues are moved into the expression
+            using holder_type = std::conditional_t<std::is_lvalue_reference<Ty_>::value, const yato::remove_cvref_t<Ty_>&, yato::remove_cvref_t<Ty_>>;
+            return container_expression<holder_type>(std::forward<Ty_>(operand));
+        }
+
+        template <typename Ty_>
+        auto make_expression_operand_(Ty_ && operand, std::false_type /*is expression*/, std::true_type /*is arithmetic*/)
+        {
+            return scalar_expression<yato::remove_cvref_t<Ty_>>(operand);
+        }
+
+        template <typename Ty_>
+        auto make_expression_operand_(Ty_ && operand)
+        {
+            return make_expression_operand_(std::forward<Ty_>(operand),
+                yato::is_expression_nd<yato::remove_cvref_t<Ty_>>{}, std::is_arithmetic<yato::remove_cvref_t<Ty_>>{});
+        }
+
+        template <typename Op_, typename Left_, typename Right_>
+        auto make_binary_expression_(const Op_ & op, Left_ && left, Right_ && right)
+        {
+            auto left_operand  = make_expression_operand_(std::forward<Left_>(left));
+            auto right_operand = make_expression_operand_(std::forward<Right_>(right));
+            return binary_expression<Op_, decltype(left_operand), decltype(right_operand)>(op, std::move(left_operand), std::move(right_operand));
+        }
+
+        template <typename Op_, typename Arg_>
+        auto make_unary_expression_(const Op_ & op, Arg_ && arg)
+        {
+            auto operand = make_expression_operand_(std::forward<Arg_>(arg));
+            return unary_expression<Op_, decltype(operand)>(op, std::move(operand));
+        }
+
+        //-------------------------------------------------------
+
+        template <size_t Dims_, typename Expression_, typename Container_>
+        void evaluate_plain_(const Expression_ & expression, Container_ & dst, size_t size)
+        {
+            using container_ops = yato::container_ops<yato::remove_cvref_t<Container_>>;
+            if (size > 0) {
+                const auto eval = expression.plain();
+                auto* out = container_ops::data(dst);
+                for (size_t i = 0; i < size; ++i) {
+                    out[i] = eval(i);
+                }
+            }
+        }
+
+        template <size_t Dims_, typename Expression_, typename Container_>
+        void evaluate_expression_(const Expression_ & expression, Container_ && dst, std::integral_constant<size_t, 1>)
+        {
+            using container_ops = yato::container_ops<yato::remove_cvref_t<Container_>>;
+            evaluate_plain_<Dims_>(expression, dst, container_ops::size(dst, 0));
+        }
+
+        template <size_t Dims_, typename Expression_, typename Container_, size_t SubDims_>
+        void evaluate_expression_(const Expression_ & expression, Container_ && dst, std::integral_constant<size_t, SubDims_>)
+        {
+            using container_ops = yato::container_ops<yato::remove_cvref_t<Container_>>;
+            if (container_ops::continuous(dst) && expression.continuous()) {
+                evaluate_plain_<Dims_>(expression, dst, container_ops::total_size(dst));
+            }
+            else {
+                const size_t size = container_ops::size(dst, 0);
+                for (size_t i = 0; i < size; ++i) {
+                    evaluate_expression_<Dims_>(expression.sub(i), container_ops::subscript(dst, i), std::integral_constant<size_t, SubDims_ - 1>{});
+                }
+            }
+        }
+
+        //-------------------------------------------------------
+        // Operators are found by ADL for containers and expressions
+
+        template <typename Left_, typename Right_, typename = enable_if_expression_operands_<Left_, Right_>>
+        auto operator + (Left_ && left, Right_ && right)
+        {
+            return make_binary_expression_(std::plus<>{}, std::forward<Left_>(left), std::forward<Right_>(right));
+        }
+
+        template <typename Left_, typename Right_, typename = enable_if_expression_operands_<Left_, Right_>>
+        auto operator - (Left_ && left, Right_ && right)
+        {
+            return make_binary_expression_(std::minus<>{}, std::forward<Left_>(left), std::forward<Right_>(right));
+        }
+
+        template <typename Left_, typename Right_, typename = enable_if_expression_operands_<Left_, Right_>>
+        auto operator * (Left_ && left, Right_ && right)
+        {
+            return make_binary_expression_(std::multiplies<>{}, std::forward<Left_>(left), std::forward<Right_>(right));
+        }
+
+        template <typename Left_, typename Right_, typename = enable_if_expression_operands_<Left_, Right_>>
+        auto operator / (Left_ && left, Right_ && right)
+        {
+            return make_binary_expression_(std::divides<>{}, std::forward<Left_>(left), std::forward<Right_>(right));
+        }
+
+        template <typename Arg_, typename = std::enable_if_t<is_expression_operand_<yato::remove_cvref_t<Arg_>>::value>>
+        auto operator - (Arg_ && arg)
+        {
+            return make_unary_expression_(std::negate<>{}, std::forward<Arg_>(arg));
+        }
+
+    } // namespace details
+
+    using details::operator+;
+    using details::operator-;
+    using details::operator*;
+    using details::operator/;
+
+
+    /**
+     * Wraps any container supported by yato::container_ops into an expression, e.g. std::vector.
+     */
+    template <typename Container_>
+    auto make_expression(Container_ && c)
+    {
+        return details::make_expression_operand_(std::forward<Container_>(c));
+    }
+
+    /**
+     * Lazily applies func to every element of the expression.
+     */
+    template <typename Func_, typename Arg_, typename = std::enable_if_t<details::is_expression_operand_<yato::remove_cvref_t<Arg_>>::value>>
+    auto map_expression(Func_ && func, Arg_ && arg)
+    {
+        return details::make_unary_expression_(std::forward<Func_>(func), std::forward<Arg_>(arg));
+    }
+
+    /**
+     * Lazily applies func to the pair of elements.
+     */
+    template <typename Func_, typename Left_, typename Right_, typename = details::enable_if_expression_operands_<Left_, Right_>>
+    auto map_expression(Func_ && func, Left_ && left, Right_ && right)
+    {
+        return details::make_binary_expression_(std::forward<Func_>(func), std::forward<Left_>(left), std::forward<Right_>(right));
+    }
+
+    /**
+     * Evaluates expression into a new vector.
+     */
+    template <typename Derived_, size_t Dims_>
+    auto evaluate(const expression_nd<Derived_, Dims_> & expression)
+    {
+        return yato::vector_nd<typename Derived_::value_type, Dims_>(expression.derived());
+    }
+
+} // namespace yato
+
+#endif // _YATO_EXPRESSION_ND_H_
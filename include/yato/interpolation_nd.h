@@ -0,0 +1,414 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_INTERPOLATION_ND_H_
+#define _YATO_INTERPOLATION_ND_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "assertion.h"
+#include "container_base.h"
+#include "container_nd.h"
+
+namespace yato
+{
+
+    /**
+     * Multilinear interpolation with floating point weights: linear for 1D, bilinear for 2D, trilinear for 3D.
+     * The footprint of 2^N neighbours is checked against the container bounds once.
+     * If the footprint crosses the bounds, then all neighbours are loaded through BorderSampler_.
+     */
+    template <typename BorderSampler_ = sampler_clamp>
+    struct sampler_linear
+    {
+        using border_sampler = BorderSampler_;
+        using weight_type = float;
+
+        template <typename ValueType_>
+        using blend_type = std::common_type_t<std::remove_cv_t<ValueType_>, float>;
+
+        template <typename ValueType_>
+        using return_type = blend_type<ValueType_>;
+
+        template <typename CoordTy_>
+        static YATO_CONSTEXPR_FUNC
+        weight_type weight(CoordTy_ fraction)
+        {
+            return static_cast<weight_type>(fraction);
+        }
+
+        template <typename BlendTy_>
+        static YATO_CONSTEXPR_FUNC
+        BlendTy_ lerp(BlendTy_ a, BlendTy_ b, weight_type w)
+        {
+            return a + (b - a) * w;
+        }
+
+        template <typename ValueType_, typename BlendTy_>
+        static YATO_CONSTEXPR_FUNC
+        return_type<ValueType_> result(BlendTy_ value)
+        {
+            return value;
+        }
+    };
+
+    /**
+     * Multilinear interpolation with fixed-point weights having FractionBits_ fraction bits.
+     * Intended for integral images, the result is rounded to the nearest value of the element type.
+     */
+    template <typename BorderSampler_ = sampler_clamp, size_t FractionBits_ = 8>
+    struct sampler_linear_fixed
+    {
+        static_assert(FractionBits_ > 0 && FractionBits_ < 16, "Fraction bits should be in range [1, 15]");
+
+        using border_sampler = BorderSampler_;
+        using weight_type = int32_t;
+
+        static YATO_CONSTEXPR_VAR size_t fraction_bits = FractionBits_;
+        static YATO_CONSTEXPR_VAR int32_t weight_one = static_cast<int32_t>(1) << FractionBits_;
+
+        template <typename ValueType_>
+        using blend_type = std::conditional_t<(sizeof(ValueType_) < sizeof(int32_t)), int32_t, int64_t>;
+
+        template <typename ValueType_>
+        using return_type = std::remove_cv_t<ValueType_>;
+
+        template <typename CoordTy_>
+        static YATO_CONSTEXPR_FUNC
+        weight_type weight(CoordTy_ fraction)
+        {
+            return static_cast<weight_type>(fraction * weight_one + static_cast<CoordTy_>(0.5));
+        }
+
+        /**
+         * Rounds to nearest after every blend step, so the result stays in the range of the inputs.
+         */
+        template <typename BlendTy_>
+        static YATO_CONSTEXPR_FUNC
+        BlendTy_ lerp(BlendTy_ a, BlendTy_ b, weight_type w)
+        {
+            return (a * (weight_one - w) + b * w + (weight_one >> 1)) >> FractionBits_;
+        }
+
+        template <typename ValueType_, typename BlendTy_>
+        static YATO_CONSTEXPR_FUNC
+        return_type<ValueType_> result(BlendTy_ value)
+        {
+            return static_cast<return_type<ValueType_>>(value);
+        }
+    };
+
+
+
+    namespace details
+    {
+
+        template <typename Container_>
+        using interpolation_has_pointer_ = std::is_base_of<yato::container_strided_tag, typename container_traits<Container_>::container_category>;
+
+        /**
+         * Limits coordinates to [-2^30, 2^30], so the floor and the upper neighbour fit into int32.
+         * NaN is mapped to the lower limit. Both go to the border path, since the footprint is out of the container.
+         * Written with selects instead of std::min/max, so it is vectorized in row loops.
+         */
+        template <typename CoordTy_>
+        YATO_FORCED_INLINE
+        CoordTy_ interpolation_clamp_(CoordTy_ coord)
+        {
+            const CoordTy_ limit = static_cast<CoordTy_>(1 << 30);
+            return (coord >= -limit) ? ((coord <= limit) ? coord : limit) : -limit;
+        }
+
+        /**
+         * Floor for coordinates in the range of int32.
+         */
+        template <typename CoordTy_>
+        YATO_FORCED_INLINE
+        int32_t interpolation_floor_(CoordTy_ coord)
+        {
+            const int32_t i = static_cast<int32_t>(coord);
+            return i - static_cast<int32_t>(static_cast<CoordTy_>(i) > coord);
+        }
+
+        template <typename Ty_>
+        YATO_FORCED_INLINE
+        std::remove_cv_t<Ty_> interpolation_read_(Ty_* base, std::ptrdiff_t offset)
+        {
+            details::advance_bytes(base, offset);
+            return *base;
+        }
+
+        template <typename Container_>
+        std::ptrdiff_t interpolation_stride_(const Container_ & c, size_t dim, std::true_type /*has outer dimensions*/)
+        {
+            return static_cast<std::ptrdiff_t>(yato::container_ops<Container_>::stride(c, dim));
+        }
+
+        template <typename Container_>
+        std::ptrdiff_t interpolation_stride_(const Container_ & /*c*/, size_t /*dim*/, std::false_type /*has outer dimensions*/)
+        {
+            return 0;
+        }
+
+        /**
+         * Bounds and byte strides of a container, stride of the last dimension is the element size.
+         */
+        template <size_t Dims_>
+        struct interpolation_layout_
+        {
+            std::array<int32_t, Dims_> sizes{};
+            std::array<std::ptrdiff_t, Dims_> strides{};
+
+            template <typename Container_>
+            explicit
+            interpolation_layout_(const Container_ & c)
+            {
+                using container_ops = yato::container_ops<Container_>;
+                for (size_t d = 0; d < Dims_; ++d) {
+                    sizes[d] = yato::narrow_cast<int32_t>(container_ops::size(c, d));
+                    strides[d] = (d + 1 < Dims_)
+                        ? interpolation_stride_(c, d, std::integral_constant<bool, (Dims_ > 1)>{})
+                        : static_cast<std::ptrdiff_t>(sizeof(typename container_traits<Container_>::value_type));
+                }
+            }
+        };
+
+        template <typename BorderSampler_, typename Container_, typename Index_, size_t... Indexes_>
+        decltype(auto) interpolation_load_(const Container_ & c, const Index_ & index, std::index_sequence<Indexes_...>)
+        {
+            return yato::load<BorderSampler_>(c, index[Indexes_]...);
+        }
+
+        /**
+         * Blends the footprint recursively, lerping along Dim_ between two sub-footprints of the inner dimensions.
+         * Upper neighbour along a dimension is skipped if its weight is zero.
+         */
+        template <typename Sampler_, typename BlendTy_, size_t Dim_, size_t Dims_>
+        struct interpolation_footprint_
+        {
+            using next = interpolation_footprint_<Sampler_, BlendTy_, Dim_ + 1, Dims_>;
+            using weights_array = std::array<typename Sampler_::weight_type, Dims_>;
+
+            /**
+             * Fast path: footprint is inside, neighbours are read relative to the lower corner.
+             */
+            template <typename Ty_>
+            static YATO_FORCED_INLINE
+            BlendTy_ read(Ty_* base, std::ptrdiff_t offset, const std::array<std::ptrdiff_t, Dims_> & steps, const weights_array & weights)
+            {
+                const BlendTy_ low  = next::read(base, offset, steps, weights);
+                const BlendTy_ high = next::read(base, offset + steps[Dim_], steps, weights);
+                return Sampler_::lerp(low, high, weights[Dim_]);
+            }
+
+            /**
+             * Slow path: every neighbour is loaded through the border sampler.
+             */
+            template <typename BorderSampler_, typename Container_, typename Index_>
+            static
+            BlendTy_ load(const Container_ & c, Index_ index, const weights_array & weights)
+            {
+                const BlendTy_ low = next::template load<BorderSampler_>(c, index, weights);
+                if (weights[Dim_] != 0) {
+                    index[Dim_] += 1;
+                }
+                const BlendTy_ high = next::template load<BorderSampler_>(c, index, weights);
+                return Sampler_::lerp(low, high, weights[Dim_]);
+            }
+        };
+
+        template <typename Sampler_, typename BlendTy_, size_t Dims_>
+        struct interpolation_footprint_<Sampler_, BlendTy_, Dims_, Dims_>
+        {
+            using weights_array = std::array<typename Sampler_::weight_type, Dims_>;
+
+            template <typename Ty_>
+            static YATO_FORCED_INLINE
+            BlendTy_ read(Ty_* base, std::ptrdiff_t offset, const std::array<std::ptrdiff_t, Dims_> & /*steps*/, const weights_array & /*weights*/)
+            {
+                return static_cast<BlendTy_>(details::interpolation_read_(base, offset));
+            }
+
+            template <typename BorderSampler_, typename Container_, typename Index_>
+            static YATO_FORCED_INLINE
+            BlendTy_ load(const Container_ & c, const Index_ & index, const weights_array & /*weights*/)
+            {
+                return static_cast<BlendTy_>(details::interpolation_load_<BorderSampler_>(c, index, std::make_index_sequence<Dims_>{}));
+            }
+        };
+
+        template <typename Sampler_, typename BlendTy_, size_t Dims_, typename Ty_>
+        YATO_FORCED_INLINE
+        BlendTy_ interpolation_inside_(Ty_* base, std::ptrdiff_t offset, const std::array<std::ptrdiff_t, Dims_> & steps, const std::array<typename Sampler_::weight_type, Dims_> & weights)
+        {
+            return interpolation_footprint_<Sampler_, BlendTy_, 0, Dims_>::read(base, offset, steps, weights);
+        }
+
+        template <typename Sampler_, typename BlendTy_, size_t Dims_, typename Container_>
+        BlendTy_ interpolation_border_(const Container_ & c, const std::array<int32_t, Dims_> & lower, const std::array<typename Sampler_::weight_type, Dims_> & weights)
+        {
+            using border_sampler = typename Sampler_::border_sampler;
+            using index_type = typename border_sampler::index_type;
+            std::array<index_type, Dims_> index;
+            for (size_t d = 0; d < Dims_; ++d) {
+                index[d] = static_cast<index_type>(lower[d]);
+            }
+            return interpolation_footprint_<Sampler_, BlendTy_, 0, Dims_>::template load<border_sampler>(c, index, weights);
+        }
+
+        template <typename Sampler_, typename Container_, typename CoordArray_>
+        YATO_FORCED_INLINE
+        auto interpolate_impl_(const Container_ & c, const CoordArray_ & coords, std::true_type /*has pointer*/)
+        {
+            using value_type = typename container_traits<Container_>::value_type;
+            using blend_type = typename Sampler_::template blend_type<value_type>;
+            using weight_type = typename Sampler_::weight_type;
+            YATO_CONSTEXPR_VAR size_t dims = container_traits<Container_>::dimensions_number;
+            using container_ops = yato::container_ops<Container_>;
+
+            const interpolation_layout_<dims> layout(c);
+            std::array<int32_t, dims> lower;
+            std::array<weight_type, dims> weights;
+            std::array<std::ptrdiff_t, dims> steps;
+            std::ptrdiff_t offset = 0;
+            bool inside = true;
+            for (size_t d = 0; d < dims; ++d) {
+                const auto coord = details::interpolation_clamp_(coords[d]);
+                lower[d] = details::interpolation_floor_(coord);
+                weights[d] = Sampler_::weight(coord - static_cast<typename CoordArray_::value_type>(lower[d]));
+                const int32_t upper = lower[d] + ((weights[d] != 0) ? 1 : 0);
+                inside = inside && (lower[d] >= 0) && (upper < layout.sizes[d]);
+                offset += static_cast<std::ptrdiff_t>(lower[d]) * layout.strides[d];
+                steps[d] = (weights[d] != 0) ? layout.strides[d] : 0;
+            }
+            if (inside) {
+                return Sampler_::template result<value_type>(interpolation_inside_<Sampler_, blend_type>(container_ops::cdata(c), offset, steps, weights));
+            }
+            return Sampler_::template result<value_type>(interpolation_border_<Sampler_, blend_type>(c, lower, weights));
+        }
+
+        template <typename Sampler_, typename Container_, typename CoordArray_>
+        auto interpolate_impl_(const Container_ & c, const CoordArray_ & coords, std::false_type /*has pointer*/)
+        {
+            using value_type = typename container_traits<Container_>::value_type;
+            using blend_type = typename Sampler_::template blend_type<value_type>;
+            using weight_type = typename Sampler_::weight_type;
+            YATO_CONSTEXPR_VAR size_t dims = container_traits<Container_>::dimensions_number;
+
+            std::array<int32_t, dims> lower;
+            std::array<weight_type, dims> weights;
+            for (size_t d = 0; d < dims; ++d) {
+                const auto coord = details::interpolation_clamp_(coords[d]);
+                lower[d] = details::interpolation_floor_(coord);
+                weights[d] = Sampler_::weight(coord - static_cast<typename CoordArray_::value_type>(lower[d]));
+            }
+            return Sampler_::template result<value_type>(interpolation_border_<Sampler_, blend_type>(c, lower, weights));
+        }
+
+    } // namespace details
+
+
+    /**
+     * Interpolates a container at fractional coordinates, one coordinate per dimension.
+     * Integer coordinates hit elements exactly. NaN and coordinates beyond 2^30 are sampled through the border sampler as out of bounds.
+     */
+    template <typename Sampler_ = sampler_linear<>, typename Container_, typename... Coords_>
+    auto interpolate(const Container_ & c, const Coords_ &... coords)
+        -> typename Sampler_::template return_type<typename container_traits<Container_>::value_type>
+    {
+        static_assert(sizeof...(Coords_) == container_traits<Container_>::dimensions_number, "yato::interpolate: number of coordinates should match dimensions number");
+        using coord_type = std::common_type_t<Coords_...>;
+        static_assert(std::is_floating_point<coord_type>::value, "yato::interpolate: coordinates should be floating point");
+        const std::array<coord_type, sizeof...(Coords_)> coords_array = { static_cast<coord_type>(coords)... };
+        return details::interpolate_impl_<Sampler_>(c, coords_array, details::interpolation_has_pointer_<Container_>{});
+    }
+
+
+    /**
+     * Batched interpolation: dst[k] = interpolate(c, coords[k]...) for k in [0, count).
+     * Coordinates are given as one array per dimension.
+     * Floors, weights and bounds checks are computed for a chunk of points in branch-free loops, which are vectorized by the compiler.
+     * Then points with the footprint inside are blended without checks, and points crossing the bounds go through the border sampler.
+     */
+    template <typename Sampler_ = sampler_linear<>, typename Container_, typename OutTy_, typename... CoordTys_>
+    void interpolate_row(const Container_ & c, OutTy_* dst, size_t count, const CoordTys_* ... coords)
+    {
+        YATO_CONSTEXPR_VAR size_t dims = container_traits<Container_>::dimensions_number;
+        static_assert(sizeof...(CoordTys_) == dims, "yato::interpolate_row: number of coordinate arrays should match dimensions number");
+        using coord_type = std::common_type_t<CoordTys_...>;
+        static_assert(std::is_floating_point<coord_type>::value, "yato::interpolate_row: coordinates should be floating point");
+        static_assert(details::interpolation_has_pointer_<Container_>::value, "yato::interpolate_row: container should provide data and strides");
+        using value_type = typename container_traits<Container_>::value_type;
+        using blend_type = typename Sampler_::template blend_type<value_type>;
+        using weight_type = typename Sampler_::weight_type;
+        using container_ops = yato::container_ops<Container_>;
+
+        YATO_CONSTEXPR_VAR size_t chunk = 256;
+        const std::array<const coord_type*, dims> coords_ptrs = { coords... };
+        const details::interpolation_layout_<dims> layout(c);
+        const bool not_empty = std::all_of(layout.sizes.cbegin(), layout.sizes.cend(), [](int32_t s) { return s > 0; });
+        const auto base = container_ops::cdata(c);
+
+        int32_t lower[dims][chunk];
+        weight_type weights[dims][chunk];
+        int32_t inside[chunk];
+
+        for (size_t first = 0; first < count; first += chunk) {
+            const size_t n = std::min(chunk, count - first);
+            for (size_t k = 0; k < n; ++k) {
+                inside[k] = not_empty ? 1 : 0;
+            }
+            for (size_t d = 0; d < dims; ++d) {
+                const coord_type* const coord = coords_ptrs[d] + first;
+                const int32_t size = layout.sizes[d];
+                int32_t* const point_lower = lower[d];
+                weight_type* const point_weight = weights[d];
+                for (size_t k = 0; k < n; ++k) {
+                    const coord_type x = details::interpolation_clamp_(coord[k]);
+                    const int32_t i = details::interpolation_floor_(x);
+                    const weight_type w = Sampler_::weight(x - static_cast<coord_type>(i));
+                    const int32_t upper = i + static_cast<int32_t>(w != 0);
+                    point_lower[k] = i;
+                    point_weight[k] = w;
+                    inside[k] &= static_cast<int32_t>(i >= 0) & static_cast<int32_t>(upper < size);
+                }
+            }
+            for (size_t k = 0; k < n; ++k) {
+                if (inside[k]) {
+                    std::ptrdiff_t offset = 0;
+                    std::array<std::ptrdiff_t, dims> point_steps;
+                    std::array<weight_type, dims> point_weights;
+                    for (size_t d = 0; d < dims; ++d) {
+                        offset += static_cast<std::ptrdiff_t>(lower[d][k]) * layout.strides[d];
+                        point_steps[d] = (weights[d][k] != 0) ? layout.strides[d] : 0;
+                        point_weights[d] = weights[d][k];
+                    }
+                    dst[first + k] = static_cast<OutTy_>(Sampler_::template result<value_type>(
+                        details::interpolation_inside_<Sampler_, blend_type>(base, offset, point_steps, point_weights)));
+                }
+                else {
+                    std::array<int32_t, dims> point_lower;
+                    std::array<weight_type, dims> point_weights;
+                    for (size_t d = 0; d < dims; ++d) {
+                        point_lower[d] = lower[d][k];
+                        point_weights[d] = weights[d][k];
+                    }
+                    dst[first + k] = static_cast<OutTy_>(Sampler_::template result<value_type>(
+                        details::interpolation_border_<Sampler_, blend_type>(c, point_lower, point_weights)));
+                }
+            }
+        }
+    }
+
+} // namespace yato
+
+#endif // _YATO_INTERPOLATION_ND_H_
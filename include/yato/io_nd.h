@@ -0,0 +1,470 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_IO_ND_H_
+#define _YATO_IO_ND_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assertion.h"
+#include "array_view.h"
+#include "container_base.h"
+#include "type_traits.h"
+#include "vector_nd.h"
+
+namespace yato
+{
+
+namespace io
+{
+
+    /**
+     * Strided containers are gathered into chunks of this size before writing.
+     */
+    YATO_INLINE_VARIABLE constexpr size_t stream_chunk_size = 1024 * 1024;
+
+    namespace details
+    {
+        YATO_INLINE_VARIABLE constexpr char npy_magic[6] = { '\x93', 'N', 'U', 'M', 'P', 'Y' };
+        YATO_INLINE_VARIABLE constexpr size_t npy_alignment = 64;
+
+        inline
+        bool npy_little_endian_()
+        {
+            const uint16_t probe = 1;
+            unsigned char first = 0;
+            std::memcpy(&first, &probe, 1);
+            return first == 1;
+        }
+
+        /**
+         * NPY type description without byte order, e.g. "f4"
+         */
+        template <typename Ty_>
+        std::string npy_type_code_()
+        {
+            char kind = 'V';
+            if (std::is_same<Ty_, bool>::value) {
+                kind = 'b';
+            }
+            else if (std::is_floating_point<Ty_>::value) {
+                kind = 'f';
+            }
+            else if (std::is_integral<Ty_>::value) {
+                kind = std::is_signed<Ty_>::value ? 'i' : 'u';
+            }
+            return kind + std::to_string(sizeof(Ty_));
+        }
+
+        template <typename Ty_>
+        char npy_byte_order_(bool native)
+        {
+            if (sizeof(Ty_) == 1 || !std::is_arithmetic<Ty_>::value) {
+                return '|';
+            }
+            return (npy_little_endian_() == native) ? '<' : '>';
+        }
+
+        template <typename Ty_, size_t Dims_>
+        std::string npy_make_header_(const std::array<size_t, Dims_> & extents)
+        {
+            std::string dict = "{'descr': '";
+            dict += npy_byte_order_<Ty_>(true);
+            dict += npy_type_code_<Ty_>();
+            dict += "', 'fortran_order': False, 'shape': (";
+            for (size_t d = 0; d < Dims_; ++d) {
+                dict += std::to_string(extents[d]);
+                dict += (Dims_ == 1) ? "," : (d + 1 < Dims_ ? ", " : "");
+            }
+            dict += "), }";
+
+            // magic + version + length, padded with spaces and terminated by newline
+            const size_t prefix = sizeof(npy_magic) + 2 + 2;
+            const size_t total = (prefix + dict.size() + 1 + npy_alignment - 1) / npy_alignment * npy_alignment;
+            dict.append(total - prefix - dict.size() - 1, ' ');
+            dict += '\n';
+            if (dict.size() > 0xFFFF) {
+                throw yato::argument_error("yato::io: NPY header is too long");
+            }
+
+            std::string header(npy_magic, sizeof(npy_magic));
+            header += '\x01';
+            header += '\x00';
+            header += static_cast<char>(dict.size() & 0xFF);
+            header += static_cast<char>((dict.size() >> 8) & 0xFF);
+            header += dict;
+            return header;
+        }
+
+        struct npy_header
+        {
+            std::string descr;
+            bool fortran_order = false;
+            std::vector<size_t> shape;
+        };
+
+        inline
+        void npy_read_(std::istream & is, char* dst, size_t size)
+        {
+            is.read(dst, static_cast<std::streamsize>(size));
+            if (static_cast<size_t>(is.gcount()) != size) {
+                throw yato::runtime_error("yato::io: Unexpected end of stream");
+            }
+        }
+
+        inline
+        void npy_write_(std::ostream & os, const char* src, size_t size)
+        {
+            os.write(src, static_cast<std::streamsize>(size));
+            if (!os) {
+                throw yato::runtime_error("yato::io: Failed to write stream");
+            }
+        }
+
+        /**
+         * Returns position after the value of the key in the header dictionary.
+         */
+        inline
+        size_t npy_find_value_(const std::string & dict, const char* key)
+        {
+            const size_t pos = dict.find(std::string("'") + key + "'");
+            if (pos == std::string::npos) {
+                throw yato::runtime_error(std::string("yato::io: NPY header has no key ") + key);
+            }
+            const size_t colon = dict.find(':', pos);
+            if (colon == std::string::npos) {
+                throw yato::runtime_error("yato::io: Invalid NPY header");
+            }
+            return dict.find_first_not_of(' ', colon + 1);
+        }
+
+        inline
+        npy_header npy_read_header_(std::istream & is)
+        {
+            char prefix[sizeof(npy_magic) + 2];
+            npy_read_(is, prefix, sizeof(prefix));
+            if (std::memcmp(prefix, npy_magic, sizeof(npy_magic)) != 0) {
+                throw yato::runtime_error("yato::io: Not an NPY stream");
+            }
+            const unsigned char major = static_cast<unsigned char>(prefix[sizeof(npy_magic)]);
+            size_t dict_size = 0;
+            if (major == 1) {
+                unsigned char length[2];
+                npy_read_(is, reinterpret_cast<char*>(length), sizeof(length));
+                dict_size = length[0] | (static_cast<size_t>(length[1]) << 8);
+            }
+            else if (major == 2 || major == 3) {
+                unsigned char length[4];
+                npy_read_(is, reinterpret_cast<char*>(length), sizeof(length));
+                dict_size = length[0] | (static_cast<size_t>(length[1]) << 8) | (static_cast<size_t>(length[2]) << 16) | (static_cast<size_t>(length[3]) << 24);
+            }
+            else {
+                throw yato::runtime_error("yato::io: Unsupported NPY version");
+            }
+            std::string dict(dict_size, '\0');
+            npy_read_(is, &dict[0], dict_size);
+
+            npy_header header;
+            size_t pos = npy_find_value_(dict, "descr");
+            if (pos == std::string::npos || (dict[pos] != '\'' && dict[pos] != '"')) {
+                throw yato::runtime_error("yato::io: Unsupported NPY descr");
+            }
+            const size_t descr_end = dict.find(dict[pos], pos + 1);
+            if (descr_end == std::string::npos) {
+                throw yato::runtime_error("yato::io: Invalid NPY header");
+            }
+            header.descr = dict.substr(pos + 1, descr_end - pos - 1);
+
+            pos = npy_find_value_(dict, "fortran_order");
+            header.fortran_order = (pos != std::string::npos) && (dict.compare(pos, 4, "True") == 0);
+
+            pos = npy_find_value_(dict, "shape");
+            if (pos == std::string::npos || dict[pos] != '(') {
+                throw yato::runtime_error("yato::io: Invalid NPY shape");
+            }
+            const size_t shape_end = dict.find(')', pos);
+            if (shape_end == std::string::npos) {
+                throw yato::runtime_error("yato::io: Invalid NPY shape");
+            }
+            for (size_t i = pos + 1; i < shape_end; ) {
+                if (dict[i] >= '0' && dict[i] <= '9') {
+                    size_t value = 0;
+                    while (i < shape_end && dict[i] >= '0' && dict[i] <= '9') {
+                        const size_t digit = static_cast<size_t>(dict[i] - '0');
+                        if (value > (std::numeric_limits<size_t>::max() - digit) / 10) {
+                            throw yato::runtime_error("yato::io: Invalid NPY shape");
+                        }
+                        value = value * 10 + digit;
+                        ++i;
+                    }
+                    header.shape.push_back(value);
+                }
+                else {
+                    ++i;
+                }
+            }
+            return header;
+        }
+
+        /**
+         * Checks the header against the element type and the dimensions number.
+         * @return true if elements are stored with the opposite byte order.
+         */
+        template <typename Ty_, size_t Dims_>
+        bool npy_check_header_(const npy_header & header)
+        {
+            if (header.fortran_order) {
+                throw yato::runtime_error("yato::io: Fortran order is not supported");
+            }
+            if (header.shape.size() != Dims_) {
+                throw yato::argument_error("yato::io: Dimensions number mismatch");
+            }
+            const std::string code = npy_type_code_<Ty_>();
+            if (header.descr.size() == code.size() + 1 && header.descr.compare(1, std::string::npos, code) == 0) {
+                const char order = header.descr[0];
+                if (order == '|' || order == '=' || order == npy_byte_order_<Ty_>(true)) {
+                    return false;
+                }
+                if (order == npy_byte_order_<Ty_>(false)) {
+                    return true;
+                }
+            }
+            throw yato::argument_error("yato::io: Element type mismatch, stored '" + header.descr + "'");
+        }
+
+        /**
+         * Returns size of the data in bytes. Fails if the size overflows or the stream is shorter, so nothing is allocated for a corrupted header.
+         * Streams without seeking are checked only for overflow.
+         */
+        template <typename Ty_>
+        size_t npy_data_size_(std::istream & is, const npy_header & header)
+        {
+            size_t bytes = sizeof(Ty_);
+            for (const size_t extent : header.shape) {
+                if (extent != 0 && bytes > std::numeric_limits<size_t>::max() / extent) {
+                    throw yato::runtime_error("yato::io: NPY shape is too large");
+                }
+                bytes *= extent;
+            }
+            const std::istream::pos_type current = is.tellg();
+            if (current != std::istream::pos_type(-1)) {
+                is.seekg(0, std::ios::end);
+                const std::istream::pos_type end = is.tellg();
+                is.seekg(current);
+                if (end != std::istream::pos_type(-1) && static_cast<unsigned long long>(end - current) < bytes) {
+                    throw yato::runtime_error("yato::io: Unexpected end of stream");
+                }
+            }
+            return bytes;
+        }
+
+        template <typename Ty_>
+        void npy_swap_bytes_(Ty_* data, size_t size)
+        {
+            unsigned char* bytes = reinterpret_cast<unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i, bytes += sizeof(Ty_)) {
+                std::reverse(bytes, bytes + sizeof(Ty_));
+            }
+        }
+
+        /**
+         * Calls func(size, block) for every continuous block of the container.
+         */
+        template <typename Func_, typename View_>
+        void io_rows_(Func_ & func, std::integral_constant<size_t, 1>, View_ && view)
+        {
+            const size_t size = view.size(0);
+            if (size > 0) {
+                func(size, view);
+            }
+        }
+
+        template <typename Func_, size_t Dims_, typename View_>
+        void io_rows_(Func_ & func, std::integral_constant<size_t, Dims_>, View_ && view)
+        {
+            if (view.continuous()) {
+                const size_t size = view.total_size();
+                if (size > 0) {
+                    func(size, view);
+                }
+            }
+            else {
+                const size_t size = view.size(0);
+                for (size_t i = 0; i < size; ++i) {
+                    io_rows_(func, std::integral_constant<size_t, Dims_ - 1>{}, view[i]);
+                }
+            }
+        }
+
+        template <typename Func_, typename View_>
+        void io_for_each_row_(Func_ && func, View_ && view)
+        {
+            io_rows_(func, std::integral_constant<size_t, yato::remove_cvref_t<View_>::dimensions_number>{}, view);
+        }
+
+        template <typename Ty_, size_t Dims_>
+        void npy_read_data_(std::istream & is, const yato::array_view_nd<Ty_, Dims_> & dst, bool swap_bytes)
+        {
+            if (dst.continuous()) {
+                // Directly into the destination storage
+                npy_read_(is, reinterpret_cast<char*>(dst.data()), dst.total_size() * sizeof(Ty_));
+                if (swap_bytes) {
+                    npy_swap_bytes_(dst.data(), dst.total_size());
+                }
+                return;
+            }
+            std::vector<char> chunk;
+            size_t chunk_begin = 0;
+            size_t chunk_end = 0;
+            const size_t total_bytes = dst.total_size() * sizeof(Ty_);
+            size_t consumed = 0;
+            io_for_each_row_([&](size_t size, auto && block) {
+                Ty_* const row = std::addressof(*block.plain_begin());
+                char* out = reinterpret_cast<char*>(row);
+                size_t bytes = size * sizeof(Ty_);
+                while (bytes > 0) {
+                    if (chunk_begin == chunk_end) {
+                        const size_t next = std::min(stream_chunk_size, total_bytes - consumed);
+                        chunk.resize(next);
+                        npy_read_(is, chunk.data(), next);
+                        consumed += next;
+                        chunk_begin = 0;
+                        chunk_end = next;
+                    }
+                    const size_t step = std::min(bytes, chunk_end - chunk_begin);
+                    std::memcpy(out, chunk.data() + chunk_begin, step);
+                    chunk_begin += step;
+                    out += step;
+                    bytes -= step;
+                }
+                if (swap_bytes) {
+                    npy_swap_bytes_(row, size);
+                }
+            }, dst);
+        }
+
+    } // namespace details
+
+
+    /**
+     * Writes container in NPY format.
+     * Continuous storage is written with one call, strided rows are gathered into chunks.
+     */
+    template <typename Container_>
+    void write_nd(std::ostream & os, const Container_ & src)
+    {
+        using value_type = std::remove_cv_t<typename Container_::value_type>;
+        static YATO_CONSTEXPR_VAR size_t dims = Container_::dimensions_number;
+        static_assert(std::is_trivially_copyable<value_type>::value, "yato::io: value type must be trivially copyable");
+
+        std::array<size_t, dims> extents;
+        for (size_t d = 0; d < dims; ++d) {
+            extents[d] = src.size(d);
+        }
+        const std::string header = details::npy_make_header_<value_type>(extents);
+        details::npy_write_(os, header.data(), header.size());
+
+        std::vector<char> chunk;
+        details::io_for_each_row_([&](size_t size, auto && block) {
+            const value_type* const row = std::addressof(*block.plain_cbegin());
+            const size_t bytes = size * sizeof(value_type);
+            if (chunk.size() + bytes > stream_chunk_size) {
+                if (!chunk.empty()) {
+                    details::npy_write_(os, chunk.data(), chunk.size());
+                    chunk.clear();
+                }
+                if (bytes >= stream_chunk_size) {
+                    details::npy_write_(os, reinterpret_cast<const char*>(row), bytes);
+                    return;
+                }
+            }
+            chunk.insert(chunk.end(), reinterpret_cast<const char*>(row), reinterpret_cast<const char*>(row) + bytes);
+        }, src);
+        if (!chunk.empty()) {
+            details::npy_write_(os, chunk.data(), chunk.size());
+        }
+    }
+
+    /**
+     * Writes container into NPY file.
+     */
+    template <typename Container_>
+    void write_nd(const std::string & path, const Container_ & src)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw yato::runtime_error("yato::io: Failed to open file " + path);
+        }
+        write_nd(file, src);
+        file.flush();
+        if (!file) {
+            throw yato::runtime_error("yato::io: Failed to write file " + path);
+        }
+    }
+
+    /**
+     * Reads NPY data into the view. Shape must match exactly.
+     */
+    template <typename Ty_, size_t DimensionsNum_>
+    void read_nd(std::istream & is, const yato::array_view_nd<Ty_, DimensionsNum_> & dst)
+    {
+        static_assert(std::is_trivially_copyable<Ty_>::value && !std::is_const<Ty_>::value, "yato::io: value type must be trivially copyable and mutable");
+        const auto header = details::npy_read_header_(is);
+        const bool swap_bytes = details::npy_check_header_<Ty_, DimensionsNum_>(header);
+        for (size_t d = 0; d < DimensionsNum_; ++d) {
+            if (header.shape[d] != dst.size(d)) {
+                throw yato::argument_error("yato::io: Shape mismatch");
+            }
+        }
+        details::npy_read_data_(is, dst, swap_bytes);
+    }
+
+    /**
+     * Reads NPY data into a new vector. Elements are read directly into the uninitialized storage.
+     */
+    template <typename Ty_, size_t DimensionsNum_, typename Allocator_ = std::allocator<Ty_>>
+    yato::vector_nd<Ty_, DimensionsNum_, Allocator_> read_nd(std::istream & is, const Allocator_ & alloc = Allocator_())
+    {
+        static_assert(std::is_trivially_copyable<Ty_>::value, "yato::io: value type must be trivially copyable");
+        const auto header = details::npy_read_header_(is);
+        const bool swap_bytes = details::npy_check_header_<Ty_, DimensionsNum_>(header);
+        details::npy_data_size_<Ty_>(is, header);
+        yato::vector_nd<Ty_, DimensionsNum_, Allocator_> res(
+            yato::dimensionality<DimensionsNum_, size_t>(yato::make_range(header.shape.cbegin(), header.shape.cend())), yato::uninitialized, alloc);
+        details::npy_read_data_(is, yato::array_view_nd<Ty_, DimensionsNum_>(res.data(), res.dimensions()), swap_bytes);
+        return res;
+    }
+
+    /**
+     * Reads NPY file into a new vector.
+     */
+    template <typename Ty_, size_t DimensionsNum_, typename Allocator_ = std::allocator<Ty_>>
+    yato::vector_nd<Ty_, DimensionsNum_, Allocator_> read_nd(const std::string & path, const Allocator_ & alloc = Allocator_())
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw yato::runtime_error("yato::io: Failed to open file " + path);
+        }
+        return read_nd<Ty_, DimensionsNum_, Allocator_>(file, alloc);
+    }
+
+} // namespace io
+
+} // namespace yato
+
+#endif // _YATO_IO_ND_H_
@@ -0,0 +1,691 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_MAPPED_ARRAY_ND_H_
+#define _YATO_MAPPED_ARRAY_ND_H_
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include "assertion.h"
+#include "array_view.h"
+#include "container_base.h"
+#include "range.h"
+
+namespace yato
+{
+
+    /**
+     * Element type code stored in the file header.
+     */
+    enum class mapped_dtype : uint32_t
+    {
+        raw = 0,
+        int8,
+        uint8,
+        int16,
+        uint16,
+        int32,
+        uint32,
+        int64,
+        uint64,
+        float32,
+        float64
+    };
+
+    /**
+     * Access mode of a mapping.
+     */
+    enum class mapped_access
+    {
+        read_only,
+        read_write
+    };
+
+    /**
+     * Expected access pattern. Passed to the OS as a hint and never changes the contents.
+     */
+    enum class mapped_access_hint
+    {
+        normal,
+        sequential,
+        random,
+        will_need,
+        dont_need
+    };
+
+    /**
+     * Layout options for a newly created file.
+     */
+    struct mapped_array_options
+    {
+        /**
+         * Align the data to 2 MiB and ask the OS for transparent huge pages.
+         */
+        bool huge_pages = false;
+
+        /**
+         * Pad rows of the innermost dimension to a multiple of this number of bytes. Zero means packed rows.
+         */
+        size_t row_alignment = 0;
+    };
+
+    /**
+     * File header. Data starts at data_offset, strides are in bytes.
+     */
+    struct mapped_array_header
+    {
+        static YATO_CONSTEXPR_VAR size_t max_dimensions = 8;
+        static YATO_CONSTEXPR_VAR uint32_t current_version = 1;
+        static YATO_CONSTEXPR_VAR uint32_t flag_huge_pages = 1;
+
+        char magic[8];
+        uint32_t version;
+        uint32_t dtype;
+        uint32_t element_size;
+        uint32_t dimensions;
+        uint32_t flags;
+        uint32_t reserved;
+        uint64_t data_offset;
+        uint64_t extents[max_dimensions];
+        uint64_t strides[max_dimensions];
+    };
+
+    namespace details
+    {
+        YATO_INLINE_VARIABLE constexpr char mapped_array_magic[8] = { 'Y', 'A', 'T', 'O', 'N', 'D', 'A', 0 };
+        YATO_INLINE_VARIABLE constexpr size_t mapped_huge_page_size = 2 * 1024 * 1024;
+
+        template <typename Ty_, typename = void>
+        struct mapped_dtype_of
+            : std::integral_constant<mapped_dtype, mapped_dtype::raw>
+        { };
+
+        template <typename Ty_>
+        struct mapped_dtype_of<Ty_, std::enable_if_t<std::is_integral<Ty_>::value && !std::is_same<Ty_, bool>::value>>
+            : std::integral_constant<mapped_dtype,
+                sizeof(Ty_) == 1 ? (std::is_signed<Ty_>::value ? mapped_dtype::int8  : mapped_dtype::uint8)  :
+                sizeof(Ty_) == 2 ? (std::is_signed<Ty_>::value ? mapped_dtype::int16 : mapped_dtype::uint16) :
+                sizeof(Ty_) == 4 ? (std::is_signed<Ty_>::value ? mapped_dtype::int32 : mapped_dtype::uint32) :
+                sizeof(Ty_) == 8 ? (std::is_signed<Ty_>::value ? mapped_dtype::int64 : mapped_dtype::uint64) :
+                mapped_dtype::raw>
+        { };
+
+        template <typename Ty_>
+        struct mapped_dtype_of<Ty_, std::enable_if_t<std::is_floating_point<Ty_>::value>>
+            : std::integral_constant<mapped_dtype,
+                sizeof(Ty_) == 4 ? mapped_dtype::float32 :
+                sizeof(Ty_) == 8 ? mapped_dtype::float64 :
+                mapped_dtype::raw>
+        { };
+
+        inline
+        size_t mapped_page_size()
+        {
+#ifdef _WIN32
+            SYSTEM_INFO info;
+            ::GetSystemInfo(&info);
+            return static_cast<size_t>(info.dwAllocationGranularity);
+#else
+            return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+        }
+
+        inline
+        uint64_t mapped_align_up(uint64_t value, uint64_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+#ifndef _WIN32
+        /**
+         * Allocates disk blocks of the file, so writes through the mapping can't fail with SIGBUS on a full disk.
+         * Falls back to ftruncate, which gives a sparse file, if the file system doesn't support allocation.
+         * @return 0 or error code
+         */
+        inline
+        int mapped_allocate_file(int fd, size_t size)
+        {
+#ifndef __APPLE__
+            const int err = ::posix_fallocate(fd, 0, static_cast<off_t>(size));
+            if ((err != EINVAL) && (err != EOPNOTSUPP)) {
+                return err;
+            }
+#endif
+            return (::ftruncate(fd, static_cast<off_t>(size)) == 0) ? 0 : errno;
+        }
+#endif
+
+
+        /**
+         * Shared file mapping of the whole file.
+         */
+        class mapped_region
+        {
+        private:
+            char* m_data = nullptr;
+            size_t m_size = 0;
+#ifdef _WIN32
+            HANDLE m_file = INVALID_HANDLE_VALUE;
+            HANDLE m_mapping = nullptr;
+#else
+            int m_fd = -1;
+            char* m_reserved = nullptr;
+            size_t m_reserved_size = 0;
+#endif
+            //-------------------------------------------------------
+
+            void swap_(mapped_region & other) noexcept
+            {
+                std::swap(m_data, other.m_data);
+                std::swap(m_size, other.m_size);
+#ifdef _WIN32
+                std::swap(m_file, other.m_file);
+                std::swap(m_mapping, other.m_mapping);
+#else
+                std::swap(m_fd, other.m_fd);
+                std::swap(m_reserved, other.m_reserved);
+                std::swap(m_reserved_size, other.m_reserved_size);
+#endif
+            }
+
+        public:
+            mapped_region() = default;
+
+            /**
+             * Maps the file. Writable files are truncated or extended to the size.
+             * @param size Size of the mapping. Zero means the current file size.
+             * @param alignment Required alignment of the mapping address. Zero means page alignment.
+             */
+            mapped_region(const std::string & path, size_t size, bool writable, bool create, size_t alignment)
+            {
+#ifdef _WIN32
+                (void)alignment;
+                m_file = ::CreateFileA(path.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                    nullptr, create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (m_file == INVALID_HANDLE_VALUE) {
+                    throw yato::runtime_error("yato::mapped_array_nd: Failed to open file " + path);
+                }
+                if (size == 0) {
+                    LARGE_INTEGER file_size;
+                    ::GetFileSizeEx(m_file, &file_size);
+                    size = static_cast<size_t>(file_size.QuadPart);
+                }
+                if (size == 0) {
+                    close();
+                    throw yato::runtime_error("yato::mapped_array_nd: File is empty " + path);
+                }
+                const auto size_high = static_cast<DWORD>(static_cast<uint64_t>(size) >> 32);
+                const auto size_low  = static_cast<DWORD>(static_cast<uint64_t>(size) & 0xFFFFFFFFu);
+                m_mapping = ::CreateFileMappingA(m_file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, size_high, size_low, nullptr);
+                if (m_mapping == nullptr) {
+                    close();
+                    throw yato::runtime_error("yato::mapped_array_nd: Failed to map file " + path);
+                }
+                m_data = static_cast<char*>(::MapViewOfFile(m_mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size));
+                if (m_data == nullptr) {
+                    close();
+                    throw yato::runtime_error("yato::mapped_array_nd: Failed to map file " + path);
+                }
+#else
+                int flags = writable ? O_RDWR : O_RDONLY;
+                if (create) {
+                    flags |= O_CREAT | O_TRUNC;
+                }
+                m_fd = ::open(path.c_str(), flags, 0644);
+                if (m_fd < 0) {
+                    throw yato::runtime_error("yato::mapped_array_nd: Failed to open file " + path);
+                }
+                if (size == 0) {
+                    struct stat st{};
+                    ::fstat(m_fd, &st);
+                    size = static_cast<size_t>(st.st_size);
+                }
+                else if (create) {
+                    const int err = mapped_allocate_file(m_fd, size);
+                    if (err != 0) {
+                        close();
+                        throw yato::runtime_error("yato::mapped_array_nd: Failed to allocate file " + path + ". " + std::strerror(err));
+                    }
+                }
+                if (size == 0) {
+                    close();
+                    throw yato::runtime_error("yato::mapped_array_nd: File is empty " + path);
+                }
+                const int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+                void* hint = nullptr;
+                int map_flags = MAP_SHARED;
+                if (alignment > mapped_page_size()) {
+                    // Reserve a larger range and place the file mapping at an aligned address inside it
+                    m_reserved_size = size + alignment;
+                    void* reserved = ::mmap(nullptr, m_reserved_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    if (reserved == MAP_FAILED) {
+                        m_reserved_size = 0;
+                        close();
+                        throw yato::runtime_error("yato::mapped_array_nd: Failed to reserve address space for " + path);
+                    }
+                    m_reserved = static_cast<char*>(reserved);
+                    hint = reinterpret_cast<void*>(mapped_align_up(reinterpret_cast<uintptr_t>(reserved), alignment));
+                    map_flags |= MAP_FIXED;
+                }
+                void* ptr = ::mmap(hint, size, prot, map_flags, m_fd, 0);
+                if (ptr == MAP_FAILED) {
+                    close();
+                    throw yato::runtime_error("yato::mapped_array_nd: Failed to map file " + path);
+                }
+                m_data = static_cast<char*>(ptr);
+#endif
+                m_size = size;
+            }
+
+            ~mapped_region()
+            {
+                close();
+            }
+
+            mapped_region(const mapped_region&) = delete;
+
+            mapped_region(mapped_region && other) noexcept
+            {
+                swap_(other);
+            }
+
+            mapped_region& operator=(const mapped_region&) = delete;
+
+            mapped_region& operator=(mapped_region && other) noexcept
+            {
+                if (this != &other) {
+                    close();
+                    swap_(other);
+                }
+                return *this;
+            }
+
+            char* data() const
+            {
+                return m_data;
+            }
+
+            size_t size() const
+            {
+                return m_size;
+            }
+
+            bool is_open() const
+            {
+                return m_data != nullptr;
+            }
+
+            void advise(mapped_access_hint hint, bool huge_pages)
+            {
+#ifdef _WIN32
+                (void)hint;
+                (void)huge_pages;
+#else
+                if (m_data == nullptr) {
+                    return;
+                }
+                int advice = MADV_NORMAL;
+                switch (hint) {
+                case mapped_access_hint::sequential:
+                    advice = MADV_SEQUENTIAL;
+                    break;
+                case mapped_access_hint::random:
+                    advice = MADV_RANDOM;
+                    break;
+                case mapped_access_hint::will_need:
+                    advice = MADV_WILLNEED;
+                    break;
+                case mapped_access_hint::dont_need:
+                    advice = MADV_DONTNEED;
+                    break;
+                default:
+                    break;
+                }
+                // Hints are best effort
+                static_cast<void>(::madvise(m_data, m_size, advice));
+# ifdef MADV_HUGEPAGE
+                if (huge_pages) {
+                    static_cast<void>(::madvise(m_data, m_size, MADV_HUGEPAGE));
+                }
+# else
+                (void)huge_pages;
+# endif
+#endif
+            }
+
+            void flush()
+            {
+                if (m_data == nullptr) {
+                    return;
+                }
+#ifdef _WIN32
+                if (!::FlushViewOfFile(m_data, 0) || !::FlushFileBuffers(m_file)) {
+                    throw yato::runtime_error("yato::mapped_array_nd: Failed to flush mapping");
+                }
+#else
+                if (::msync(m_data, m_size, MS_SYNC) != 0) {
+                    throw yato::runtime_error("yato::mapped_array_nd: Failed to flush mapping");
+                }
+#endif
+            }
+
+            void close() noexcept
+            {
+#ifdef _WIN32
+                if (m_data != nullptr) {
+                    ::UnmapViewOfFile(m_data);
+                }
+                if (m_mapping != nullptr) {
+                    ::CloseHandle(m_mapping);
+                    m_mapping = nullptr;
+                }
+                if (m_file != INVALID_HANDLE_VALUE) {
+                    ::CloseHandle(m_file);
+                    m_file = INVALID_HANDLE_VALUE;
+                }
+#else
+                if (m_reserved != nullptr) {
+                    // Covers the file mapping as well
+                    ::munmap(m_reserved, m_reserved_size);
+                    m_reserved = nullptr;
+                    m_reserved_size = 0;
+                }
+                else if (m_data != nullptr) {
+                    ::munmap(m_data, m_size);
+                }
+                if (m_fd >= 0) {
+                    ::close(m_fd);
+                    m_fd = -1;
+                }
+#endif
+                m_data = nullptr;
+                m_size = 0;
+            }
+        };
+
+    } // namespace details
+
+
+    /**
+     * N-dimensional array stored in a memory-mapped file.
+     * The file starts with mapped_array_header followed by the data, so opening is O(1) and pages are loaded on demand.
+     */
+    template <typename Ty_, size_t DimensionsNum_>
+    class mapped_array_nd
+    {
+        static_assert(DimensionsNum_ > 0, "yato::mapped_array_nd: dimensions number must be positive");
+        static_assert(DimensionsNum_ <= mapped_array_header::max_dimensions, "yato::mapped_array_nd: too many dimensions");
+        static_assert(std::is_trivially_copyable<Ty_>::value, "yato::mapped_array_nd: value type must be trivially copyable");
+        static_assert(!std::is_const<Ty_>::value, "yato::mapped_array_nd: value type must be non-const");
+
+    public:
+        using value_type = Ty_;
+        using size_type  = size_t;
+        using dimensions_type = dimensionality<DimensionsNum_, size_t>;
+        using strides_type    = strides_array<DimensionsNum_ - 1, size_t>;
+        using view_type       = array_view_nd<value_type, DimensionsNum_>;
+        using const_view_type = array_view_nd<const value_type, DimensionsNum_>;
+
+        static YATO_CONSTEXPR_VAR size_t dimensions_number = DimensionsNum_;
+        static YATO_CONSTEXPR_VAR mapped_dtype dtype = details::mapped_dtype_of<value_type>::value;
+
+    private:
+        details::mapped_region m_region;
+        mapped_access m_access = mapped_access::read_only;
+        bool m_huge_pages = false;
+        dimensions_type m_extents{};
+        std::array<size_t, DimensionsNum_> m_byte_strides{};
+        value_type* m_data = nullptr;
+        //-------------------------------------------------------
+
+        static
+        mapped_array_header read_header_(const std::string & path)
+        {
+            mapped_array_header header{};
+            std::FILE* file = std::fopen(path.c_str(), "rb");
+            if (file == nullptr) {
+                throw yato::runtime_error("yato::mapped_array_nd: Failed to open file " + path);
+            }
+            const size_t read = std::fread(&header, sizeof(header), 1, file);
+            std::fclose(file);
+            if (read != 1 || std::memcmp(header.magic, details::mapped_array_magic, sizeof(header.magic)) != 0) {
+                throw yato::runtime_error("yato::mapped_array_nd: Not an array file " + path);
+            }
+            if (header.version != mapped_array_header::current_version) {
+                throw yato::runtime_error("yato::mapped_array_nd: Unsupported file version " + path);
+            }
+            return header;
+        }
+
+        void validate_(const mapped_array_header & header, const std::string & path) const
+        {
+            if (header.dimensions != dimensions_number) {
+                throw yato::argument_error("yato::mapped_array_nd: Dimensions number mismatch in " + path);
+            }
+            if (header.dtype != static_cast<uint32_t>(dtype) || header.element_size != sizeof(value_type)) {
+                throw yato::argument_error("yato::mapped_array_nd: Element type mismatch in " + path);
+            }
+            if (header.strides[dimensions_number - 1] != sizeof(value_type) || header.data_offset % alignof(value_type) != 0) {
+                throw yato::runtime_error("yato::mapped_array_nd: Invalid layout in " + path);
+            }
+            // Header values come from the file, so the products are checked for overflow before comparing with the mapping size
+            uint64_t required = sizeof(value_type);
+            for (size_t i = dimensions_number; i > 0; --i) {
+                const uint64_t stride = header.strides[i - 1];
+                const uint64_t extent = header.extents[i - 1];
+                if (stride < required || stride % alignof(value_type) != 0) {
+                    throw yato::runtime_error("yato::mapped_array_nd: Invalid layout in " + path);
+                }
+                if (extent != 0 && stride > std::numeric_limits<uint64_t>::max() / extent) {
+                    throw yato::runtime_error("yato::mapped_array_nd: Invalid layout in " + path);
+                }
+                required = stride * extent;
+            }
+            const uint64_t region_size = m_region.size();
+            if (header.data_offset < sizeof(mapped_array_header) || header.data_offset > region_size || required > region_size - header.data_offset) {
+                throw yato::runtime_error("yato::mapped_array_nd: File is truncated " + path);
+            }
+        }
+
+        void bind_(const mapped_array_header & header)
+        {
+            for (size_t i = 0; i < dimensions_number; ++i) {
+                m_extents[i] = static_cast<size_t>(header.extents[i]);
+                m_byte_strides[i] = static_cast<size_t>(header.strides[i]);
+            }
+            m_huge_pages = (header.flags & mapped_array_header::flag_huge_pages) != 0;
+            m_data = reinterpret_cast<value_type*>(m_region.data() + header.data_offset);
+        }
+
+        mapped_array_nd(details::mapped_region && region, mapped_access access)
+            : m_region(std::move(region)), m_access(access)
+        { }
+
+    public:
+        mapped_array_nd() = default;
+
+        mapped_array_nd(const mapped_array_nd&) = delete;
+        mapped_array_nd(mapped_array_nd&&) noexcept = default;
+
+        mapped_array_nd& operator=(const mapped_array_nd&) = delete;
+        mapped_array_nd& operator=(mapped_array_nd&&) noexcept = default;
+
+        ~mapped_array_nd() = default;
+
+        /**
+         * Creates a new file, or overwrites an existing one, and maps it for reading and writing.
+         * Data is zero initialized.
+         */
+        static
+        mapped_array_nd create(const std::string & path, const dimensions_type & extents, const mapped_array_options & options = mapped_array_options{})
+        {
+            mapped_array_header header{};
+            std::memcpy(header.magic, details::mapped_array_magic, sizeof(header.magic));
+            header.version      = mapped_array_header::current_version;
+            header.dtype        = static_cast<uint32_t>(dtype);
+            header.element_size = static_cast<uint32_t>(sizeof(value_type));
+            header.dimensions   = static_cast<uint32_t>(dimensions_number);
+            header.flags        = options.huge_pages ? mapped_array_header::flag_huge_pages : 0;
+
+            uint64_t stride = sizeof(value_type);
+            for (size_t i = dimensions_number; i > 0; --i) {
+                header.extents[i - 1] = extents[i - 1];
+                header.strides[i - 1] = stride;
+                stride *= extents[i - 1];
+                if (i == dimensions_number && dimensions_number > 1 && options.row_alignment > 0) {
+                    if (options.row_alignment % alignof(value_type) != 0) {
+                        throw yato::argument_error("yato::mapped_array_nd: Row alignment must be a multiple of the element alignment");
+                    }
+                    stride = details::mapped_align_up(stride, options.row_alignment);
+                }
+            }
+
+            const size_t alignment = options.huge_pages ? details::mapped_huge_page_size : details::mapped_page_size();
+            header.data_offset = details::mapped_align_up(sizeof(mapped_array_header), alignment);
+            const uint64_t file_size = header.data_offset + stride;
+
+            mapped_array_nd res(details::mapped_region(path, static_cast<size_t>(file_size), true, true, options.huge_pages ? alignment : 0), mapped_access::read_write);
+            std::memcpy(res.m_region.data(), &header, sizeof(header));
+            res.bind_(header);
+            if (options.huge_pages) {
+                res.m_region.advise(mapped_access_hint::normal, true);
+            }
+            return res;
+        }
+
+        /**
+         * Maps an existing file.
+         * Throws argument_error if the file stores different element type or dimensions number.
+         */
+        static
+        mapped_array_nd open(const std::string & path, mapped_access access = mapped_access::read_only)
+        {
+            const mapped_array_header header = read_header_(path);
+            const bool huge_pages = (header.flags & mapped_array_header::flag_huge_pages) != 0;
+            mapped_array_nd res(details::mapped_region(path, 0, access == mapped_access::read_write, false, huge_pages ? details::mapped_huge_page_size : 0), access);
+            res.validate_(header, path);
+            res.bind_(header);
+            if (huge_pages) {
+                res.m_region.advise(mapped_access_hint::normal, true);
+            }
+            return res;
+        }
+
+        bool is_open() const
+        {
+            return m_region.is_open();
+        }
+
+        mapped_access access() const
+        {
+            return m_access;
+        }
+
+        const dimensions_type & dimensions() const
+        {
+            return m_extents;
+        }
+
+        size_type size(size_t idx) const
+        {
+            YATO_REQUIRES(idx < dimensions_number);
+            return m_extents[idx];
+        }
+
+        size_type total_size() const
+        {
+            return m_extents.total_size();
+        }
+
+        /**
+         * Byte strides of all dimensions except the last one.
+         */
+        strides_type strides() const
+        {
+            return strides_type(yato::make_range(m_byte_strides.cbegin(), std::next(m_byte_strides.cbegin(), dimensions_number - 1)));
+        }
+
+        /**
+         * Mutable view of the data. Throws bad_state_error for read-only mappings.
+         */
+        view_type view() const
+        {
+            if (m_access != mapped_access::read_write) {
+                throw yato::bad_state_error("yato::mapped_array_nd: Mapping is read-only");
+            }
+            return view_type(m_data, m_extents, strides());
+        }
+
+        const_view_type cview() const
+        {
+            return const_view_type(m_data, m_extents, strides());
+        }
+
+        /**
+         * Passes expected access pattern to the OS.
+         */
+        void advise(mapped_access_hint hint)
+        {
+            m_region.advise(hint, m_huge_pages);
+        }
+
+        /**
+         * Writes modified pages to the file synchronously.
+         */
+        void flush()
+        {
+            if (m_access == mapped_access::read_write) {
+                m_region.flush();
+            }
+        }
+
+        /**
+         * Unmaps the file. Modified pages are written back by the OS.
+         */
+        void close() noexcept
+        {
+            m_region.close();
+            m_extents = dimensions_type{};
+            m_data = nullptr;
+        }
+    };
+
+
+    template <typename Ty_>
+    using mapped_array_1d = mapped_array_nd<Ty_, 1>;
+
+    template <typename Ty_>
+    using mapped_array_2d = mapped_array_nd<Ty_, 2>;
+
+    template <typename Ty_>
+    using mapped_array_3d = mapped_array_nd<Ty_, 3>;
+
+} // namespace yato
+
+#endif // _YATO_MAPPED_ARRAY_ND_H_
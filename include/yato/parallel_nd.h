@@ -0,0 +1,678 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_PARALLEL_ND_H_
+#define _YATO_PARALLEL_ND_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assertion.h"
+#include "type_traits.h"
+
+namespace yato
+{
+
+    /**
+     * Parameters of parallel traversal.
+     */
+    struct parallel_policy
+    {
+        /**
+         * Maximal number of threads including the calling one. Zero means all hardware threads.
+         */
+        size_t threads = 0;
+
+        /**
+         * Minimal number of elements processed by one task.
+         */
+        size_t grain = 16 * 1024;
+    };
+
+
+    namespace details
+    {
+
+        /**
+         * Fork-join pool shared by all parallel algorithms.
+         * The calling thread takes part in execution. If the pool is busy or is called from its own task, then the job runs serially.
+         */
+        class parallel_nd_pool
+        {
+        private:
+            using invoke_function = void(*)(void*, size_t);
+
+            std::vector<std::thread> m_threads;
+
+            std::mutex m_job_mutex;
+            std::mutex m_mutex;
+            std::condition_variable m_start_cv;
+            std::condition_variable m_done_cv;
+
+            invoke_function m_invoke = nullptr;
+            void* m_job = nullptr;
+            size_t m_tasks = 0;
+            std::atomic<size_t> m_next_task{ 0 };
+            size_t m_free_slots = 0;
+            size_t m_active = 0;
+            uint64_t m_generation = 0;
+            bool m_stop = false;
+            std::exception_ptr m_error;
+            //-------------------------------------------------------
+
+            static
+            bool& inside_task_()
+            {
+                thread_local bool flag = false;
+                return flag;
+            }
+
+            void execute_()
+            {
+                inside_task_() = true;
+                for (;;) {
+                    const size_t task = m_next_task.fetch_add(1, std::memory_order_relaxed);
+                    if (task >= m_tasks) {
+                        break;
+                    }
+                    try {
+                        m_invoke(m_job, task);
+                    }
+                    catch (...) {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        if (!m_error) {
+                            m_error = std::current_exception();
+                        }
+                    }
+                }
+                inside_task_() = false;
+            }
+
+            void worker_function_()
+            {
+                uint64_t seen_generation = 0;
+                std::unique_lock<std::mutex> lock(m_mutex);
+                for (;;) {
+                    m_start_cv.wait(lock, [&] { return m_stop || ((m_generation != seen_generation) && (m_free_slots > 0)); });
+                    if (m_stop) {
+                        break;
+                    }
+                    seen_generation = m_generation;
+                    --m_free_slots;
+                    ++m_active;
+                    lock.unlock();
+                    execute_();
+                    lock.lock();
+                    if (--m_active == 0) {
+                        m_done_cv.notify_all();
+                    }
+                }
+            }
+
+            explicit
+            parallel_nd_pool(size_t helpers)
+            {
+                m_threads.reserve(helpers);
+                for (size_t i = 0; i < helpers; ++i) {
+                    m_threads.emplace_back([this] { worker_function_(); });
+                }
+            }
+
+        public:
+            ~parallel_nd_pool()
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_stop = true;
+                }
+                m_start_cv.notify_all();
+                for (auto & t : m_threads) {
+                    t.join();
+                }
+            }
+
+            parallel_nd_pool(const parallel_nd_pool&) = delete;
+            parallel_nd_pool& operator=(const parallel_nd_pool&) = delete;
+
+            static
+            parallel_nd_pool & instance()
+            {
+                static parallel_nd_pool pool(std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1);
+                return pool;
+            }
+
+            /**
+             * Number of threads including the calling one.
+             */
+            size_t concurrency() const
+            {
+                return m_threads.size() + 1;
+            }
+
+            /**
+             * Calls fn(task) for every task in [0, tasks) using up to `threads` threads. Returns after all tasks are finished.
+             * The first exception thrown by a task is rethrown.
+             */
+            template <typename Fn_>
+            void run(size_t tasks, size_t threads, Fn_ && fn)
+            {
+                std::unique_lock<std::mutex> job_lock(m_job_mutex, std::defer_lock);
+                if ((tasks <= 1) || (threads <= 1) || m_threads.empty() || inside_task_() || !job_lock.try_lock()) {
+                    for (size_t task = 0; task < tasks; ++task) {
+                        fn(task);
+                    }
+                    return;
+                }
+                using fn_type = std::remove_reference_t<Fn_>;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_invoke = [](void* job, size_t task) { (*static_cast<fn_type*>(job))(task); };
+                    m_job    = static_cast<void*>(std::addressof(fn));
+                    m_tasks  = tasks;
+                    m_next_task.store(0, std::memory_order_relaxed);
+                    m_free_slots = std::min(std::min(threads - 1, tasks - 1), m_threads.size());
+                    m_error = nullptr;
+                    ++m_generation;
+                }
+                m_start_cv.notify_all();
+                execute_();
+
+                std::exception_ptr error;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    // Late workers are not needed anymore
+                    m_free_slots = 0;
+                    m_done_cv.wait(lock, [this] { return m_active == 0; });
+                    m_job = nullptr;
+                    error = m_error;
+                    m_error = nullptr;
+                }
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        };
+
+        //-------------------------------------------------------
+        // Serial kernels
+
+        template <typename View_>
+        using view_dims_ = std::integral_constant<size_t, yato::remove_cvref_t<View_>::dimensions_number>;
+
+        template <typename View_, typename... Views_>
+        struct first_view_dims_
+            : public view_dims_<View_>
+        { };
+
+        template <typename Container_>
+        auto plain_begin_(Container_ & c)
+        {
+            return c.plain_begin();
+        }
+
+        template <typename Container_>
+        auto plain_begin_(const Container_ & c)
+        {
+            return c.plain_cbegin();
+        }
+
+        template <typename View_, typename Func_>
+        void serial_for_each_(View_ && view, Func_ & func, std::integral_constant<size_t, 1>)
+        {
+            const size_t size = view.size(0);
+            if (view.continuous()) {
+                auto it = plain_begin_(view);
+                for (size_t i = 0; i < size; ++i, ++it) {
+                    func(*it);
+                }
+            }
+            else {
+                for (size_t i = 0; i < size; ++i) {
+                    func(view[i]);
+                }
+            }
+        }
+
+        template <typename View_, typename Func_, size_t Dims_>
+        void serial_for_each_(View_ && view, Func_ & func, std::integral_constant<size_t, Dims_>)
+        {
+            if (view.continuous()) {
+                auto it = plain_begin_(view);
+                const size_t size = view.total_size();
+                for (size_t i = 0; i < size; ++i, ++it) {
+                    func(*it);
+                }
+            }
+            else {
+                const size_t size = view.size(0);
+                for (size_t i = 0; i < size; ++i) {
+                    serial_for_each_(view[i], func, std::integral_constant<size_t, Dims_ - 1>{});
+                }
+            }
+        }
+
+        template <typename SrcView_, typename DstView_, typename Func_>
+        void serial_transform_(SrcView_ && src, DstView_ && dst, Func_ & func, std::integral_constant<size_t, 1>)
+        {
+            const size_t size = src.size(0);
+            if (src.continuous() && dst.continuous()) {
+                auto it_src = plain_begin_(src);
+                auto it_dst = plain_begin_(dst);
+                for (size_t i = 0; i < size; ++i, ++it_src, ++it_dst) {
+                    *it_dst = func(*it_src);
+                }
+            }
+            else {
+                for (size_t i = 0; i < size; ++i) {
+                    dst[i] = func(src[i]);
+                }
+            }
+        }
+
+        template <typename SrcView_, typename DstView_, typename Func_, size_t Dims_>
+        void serial_transform_(SrcView_ && src, DstView_ && dst, Func_ & func, std::integral_constant<size_t, Dims_>)
+        {
+            if (src.continuous() && dst.continuous()) {
+                auto it_src = plain_begin_(src);
+                auto it_dst = plain_begin_(dst);
+                const size_t size = src.total_size();
+                for (size_t i = 0; i < size; ++i, ++it_src, ++it_dst) {
+                    *it_dst = func(*it_src);
+                }
+            }
+            else {
+                const size_t size = src.size(0);
+                for (size_t i = 0; i < size; ++i) {
+                    serial_transform_(src[i], dst[i], func, std::integral_constant<size_t, Dims_ - 1>{});
+                }
+            }
+        }
+
+        template <typename Iterator_, typename Ty_, typename BinaryOp_>
+        void serial_reduce_range_(Iterator_ it, size_t size, Ty_ & acc, bool & has_value, BinaryOp_ & op)
+        {
+            size_t i = 0;
+            if (!has_value && (size > 0)) {
+                acc = *it;
+                ++it;
+                ++i;
+                has_value = true;
+            }
+            for (; i < size; ++i, ++it) {
+                acc = op(acc, *it);
+            }
+        }
+
+        template <typename View_, typename Ty_, typename BinaryOp_>
+        void serial_reduce_(View_ && view, Ty_ & acc, bool & has_value, BinaryOp_ & op, std::integral_constant<size_t, 1>)
+        {
+            const size_t size = view.size(0);
+            if (view.continuous()) {
+                serial_reduce_range_(plain_begin_(view), size, acc, has_value, op);
+            }
+            else {
+                for (size_t i = 0; i < size; ++i) {
+                    if (has_value) {
+                        acc = op(acc, view[i]);
+                    }
+                    else {
+                        acc = view[i];
+                        has_value = true;
+                    }
+                }
+            }
+        }
+
+        template <typename View_, typename Ty_, typename BinaryOp_, size_t Dims_>
+        void serial_reduce_(View_ && view, Ty_ & acc, bool & has_value, BinaryOp_ & op, std::integral_constant<size_t, Dims_>)
+        {
+            if (view.continuous()) {
+                serial_reduce_range_(plain_begin_(view), view.total_size(), acc, has_value, op);
+            }
+            else {
+                const size_t size = view.size(0);
+                for (size_t i = 0; i < size; ++i) {
+                    serial_reduce_(view[i], acc, has_value, op, std::integral_constant<size_t, Dims_ - 1>{});
+                }
+            }
+        }
+
+        template <size_t Dims_, typename Index_, typename View_, typename Func_>
+        void serial_for_each_index_(View_ && view, Index_ & index, Func_ & func, std::integral_constant<size_t, 1>)
+        {
+            const size_t size = view.size(0);
+            if (view.continuous()) {
+                auto it = plain_begin_(view);
+                for (size_t i = 0; i < size; ++i, ++it) {
+                    index[Dims_ - 1] = i;
+                    func(static_cast<const Index_&>(index), *it);
+                }
+            }
+            else {
+                for (size_t i = 0; i < size; ++i) {
+                    index[Dims_ - 1] = i;
+                    func(static_cast<const Index_&>(index), view[i]);
+                }
+            }
+        }
+
+        template <size_t Dims_, typename Index_, typename View_, typename Func_, size_t ViewDims_>
+        void serial_for_each_index_(View_ && view, Index_ & index, Func_ & func, std::integral_constant<size_t, ViewDims_>)
+        {
+            const size_t size = view.size(0);
+            for (size_t i = 0; i < size; ++i) {
+                index[Dims_ - ViewDims_] = i;
+                serial_for_each_index_<Dims_>(view[i], index, func, std::integral_constant<size_t, ViewDims_ - 1>{});
+            }
+        }
+
+        //-------------------------------------------------------
+        // Partitioning
+
+        /**
+         * Splits outer dimensions of a container into row or plane tiles.
+         * Outer dimensions are merged until there are enough tiles for all threads.
+         */
+        template <size_t Dims_>
+        struct nd_partition
+        {
+            std::array<size_t, Dims_> extents{};
+            size_t outer_dims = 1;
+            size_t outer_size = 0;
+            size_t tile_size = 1;
+            size_t tasks = 0;
+            size_t threads = 1;
+
+            template <typename Container_>
+            nd_partition(const Container_ & c, const parallel_policy & policy)
+            {
+                auto & pool = parallel_nd_pool::instance();
+                threads = (policy.threads != 0) ? std::min(policy.threads, pool.concurrency()) : pool.concurrency();
+
+                size_t total = 1;
+                for (size_t d = 0; d < Dims_; ++d) {
+                    extents[d] = c.size(d);
+                    total *= extents[d];
+                }
+                const size_t max_tasks = std::max<size_t>(1, total / std::max<size_t>(policy.grain, 1));
+                const size_t wanted = std::min(max_tasks, 4 * threads);
+
+                outer_size = extents[0];
+                for (; (outer_dims < Dims_ - 1) && (outer_size < wanted); ++outer_dims) {
+                    outer_size *= extents[outer_dims];
+                }
+                if (Dims_ == 1) {
+                    outer_size = 1;
+                    outer_dims = 0;
+                    tasks = std::min(wanted, std::max<size_t>(total, 1));
+                    tile_size = (total + tasks - 1) / std::max<size_t>(tasks, 1);
+                }
+                else {
+                    tasks = std::min(wanted, outer_size);
+                    tile_size = (outer_size + tasks - 1) / std::max<size_t>(tasks, 1);
+                }
+                if (total == 0) {
+                    tasks = 0;
+                }
+            }
+
+            /**
+             * Range of outer indexes (or elements for 1D) of the task
+             */
+            std::pair<size_t, size_t> range(size_t task, size_t length) const
+            {
+                const size_t first = std::min(task * tile_size, length);
+                return std::make_pair(first, std::min(first + tile_size, length));
+            }
+
+            /**
+             * Number of elements in one outer tile
+             */
+            size_t inner_size() const
+            {
+                size_t res = 1;
+                for (size_t d = outer_dims; d < Dims_; ++d) {
+                    res *= extents[d];
+                }
+                return res;
+            }
+
+            std::array<size_t, Dims_> unflatten(size_t outer) const
+            {
+                std::array<size_t, Dims_> index{};
+                for (size_t d = outer_dims; d-- > 0;) {
+                    index[d] = outer % extents[d];
+                    outer /= extents[d];
+                }
+                return index;
+            }
+        };
+
+        template <size_t Depth_>
+        struct nd_subscript
+        {
+            template <typename Index_, typename Callback_, typename... Views_>
+            static
+            void apply(const Index_ & index, size_t outer_dims, size_t dim, const Callback_ & callback, Views_ && ... views)
+            {
+                if (dim == outer_dims) {
+                    callback(std::integral_constant<size_t, first_view_dims_<Views_...>::value>{}, std::forward<Views_>(views)...);
+                }
+                else {
+                    nd_subscript<Depth_ - 1>::apply(index, outer_dims, dim + 1, callback, views[index[dim]]...);
+                }
+            }
+        };
+
+        template <>
+        struct nd_subscript<0>
+        {
+            template <typename Index_, typename Callback_, typename... Views_>
+            static
+            void apply(const Index_ & /*index*/, size_t /*outer_dims*/, size_t /*dim*/, const Callback_ & callback, Views_ && ... views)
+            {
+                callback(std::integral_constant<size_t, first_view_dims_<Views_...>::value>{}, std::forward<Views_>(views)...);
+            }
+        };
+
+        /**
+         * Calls callback(dims, sub_views...) for sub-views of all containers at the outer index.
+         * Only the first dimensions_number - 1 dimensions may be outer, so sub-views are always containers.
+         */
+        template <typename Partition_, typename Callback_, typename Container_, typename... Containers_>
+        void with_outer_views_(const Partition_ & partition, size_t outer, const Callback_ & callback, Container_ && c, Containers_ && ... cs)
+        {
+            const auto index = partition.unflatten(outer);
+            nd_subscript<view_dims_<Container_>::value - 1>::apply(index, partition.outer_dims, 0, callback, std::forward<Container_>(c), std::forward<Containers_>(cs)...);
+        }
+
+    } // namespace details
+
+
+    /**
+     * Calls func(element) for all elements of a multidimensional container.
+     * Rows or planes are distributed between threads. Continuous tiles are traversed as plain ranges.
+     * The order of calls is unspecified.
+     */
+    template <typename Container_, typename Func_>
+    void for_each_nd(const parallel_policy & policy, Container_ && c, Func_ && func)
+    {
+        constexpr size_t dims = details::view_dims_<Container_>::value;
+        const details::nd_partition<dims> partition(c, policy);
+        const bool continuous = c.continuous();
+        auto task_function = [&](size_t task) {
+            if (dims == 1 || continuous) {
+                const size_t inner = (dims == 1) ? 1 : partition.inner_size();
+                const auto range = partition.range(task, (dims == 1) ? c.size(0) : partition.outer_size);
+                auto it = details::plain_begin_(c) + range.first * inner;
+                const auto last = details::plain_begin_(c) + range.second * inner;
+                for (; it != last; ++it) {
+                    func(*it);
+                }
+            }
+            else {
+                const auto range = partition.range(task, partition.outer_size);
+                for (size_t outer = range.first; outer < range.second; ++outer) {
+                    details::with_outer_views_(partition, outer, [&func](auto view_dims, auto && view) {
+                        details::serial_for_each_(view, func, view_dims);
+                    }, c);
+                }
+            }
+        };
+        details::parallel_nd_pool::instance().run(partition.tasks, partition.threads, task_function);
+    }
+
+    template <typename Container_, typename Func_>
+    void for_each_nd(Container_ && c, Func_ && func)
+    {
+        for_each_nd(parallel_policy{}, std::forward<Container_>(c), std::forward<Func_>(func));
+    }
+
+
+    /**
+     * Writes func(src element) to the corresponding element of dst. Dimensions of containers must be equal.
+     */
+    template <typename SrcContainer_, typename DstContainer_, typename Func_>
+    void transform_nd(const parallel_policy & policy, const SrcContainer_ & src, DstContainer_ && dst, Func_ && func)
+    {
+        constexpr size_t dims = details::view_dims_<SrcContainer_>::value;
+        static_assert(dims == details::view_dims_<DstContainer_>::value, "yato::transform_nd: containers must have equal dimensions number");
+        for (size_t d = 0; d < dims; ++d) {
+            if (src.size(d) != dst.size(d)) {
+                throw yato::argument_error("yato::transform_nd: containers have different sizes");
+            }
+        }
+        const details::nd_partition<dims> partition(src, policy);
+        const bool continuous = src.continuous() && dst.continuous();
+        auto task_function = [&](size_t task) {
+            if (dims == 1 || continuous) {
+                const size_t inner = (dims == 1) ? 1 : partition.inner_size();
+                const auto range = partition.range(task, (dims == 1) ? src.size(0) : partition.outer_size);
+                auto it_src = details::plain_begin_(src) + range.first * inner;
+                auto it_dst = details::plain_begin_(dst) + range.first * inner;
+                const auto last = details::plain_begin_(src) + range.second * inner;
+                for (; it_src != last; ++it_src, ++it_dst) {
+                    *it_dst = func(*it_src);
+                }
+            }
+            else {
+                const auto range = partition.range(task, partition.outer_size);
+                for (size_t outer = range.first; outer < range.second; ++outer) {
+                    details::with_outer_views_(partition, outer, [&func](auto view_dims, auto && src_view, auto && dst_view) {
+                        details::serial_transform_(src_view, dst_view, func, view_dims);
+                    }, src, dst);
+                }
+            }
+        };
+        details::parallel_nd_pool::instance().run(partition.tasks, partition.threads, task_function);
+    }
+
+    template <typename SrcContainer_, typename DstContainer_, typename Func_>
+    void transform_nd(const SrcContainer_ & src, DstContainer_ && dst, Func_ && func)
+    {
+        transform_nd(parallel_policy{}, src, std::forward<DstContainer_>(dst), std::forward<Func_>(func));
+    }
+
+
+    /**
+     * Reduces all elements with an associative operation.
+     * Every tile is reduced separately, then partial results are combined with init in the order of tiles.
+     */
+    template <typename Container_, typename Ty_, typename BinaryOp_>
+    Ty_ reduce_nd(const parallel_policy & policy, const Container_ & c, Ty_ init, BinaryOp_ && op)
+    {
+        constexpr size_t dims = details::view_dims_<Container_>::value;
+        const details::nd_partition<dims> partition(c, policy);
+        const bool continuous = c.continuous();
+
+        std::vector<Ty_> partials(partition.tasks, init);
+        std::vector<char> has_partial(partition.tasks, 0);
+        auto task_function = [&](size_t task) {
+            Ty_ acc = init;
+            bool has_value = false;
+            if (dims == 1 || continuous) {
+                const size_t inner = (dims == 1) ? 1 : partition.inner_size();
+                const auto range = partition.range(task, (dims == 1) ? c.size(0) : partition.outer_size);
+                details::serial_reduce_range_(details::plain_begin_(c) + range.first * inner, (range.second - range.first) * inner, acc, has_value, op);
+            }
+            else {
+                const auto range = partition.range(task, partition.outer_size);
+                for (size_t outer = range.first; outer < range.second; ++outer) {
+                    details::with_outer_views_(partition, outer, [&](auto view_dims, auto && view) {
+                        details::serial_reduce_(view, acc, has_value, op, view_dims);
+                    }, c);
+                }
+            }
+            partials[task] = std::move(acc);
+            has_partial[task] = has_value ? 1 : 0;
+        };
+        details::parallel_nd_pool::instance().run(partition.tasks, partition.threads, task_function);
+
+        for (size_t task = 0; task < partition.tasks; ++task) {
+            if (has_partial[task]) {
+                init = op(init, partials[task]);
+            }
+        }
+        return init;
+    }
+
+    template <typename Container_, typename Ty_, typename BinaryOp_>
+    Ty_ reduce_nd(const Container_ & c, Ty_ init, BinaryOp_ && op)
+    {
+        return reduce_nd(parallel_policy{}, c, std::move(init), std::forward<BinaryOp_>(op));
+    }
+
+
+    /**
+     * Calls func(index, element) for all elements, where index is std::array<size_t, dimensions_number>.
+     */
+    template <typename Container_, typename Func_>
+    void for_each_index_nd(const parallel_policy & policy, Container_ && c, Func_ && func)
+    {
+        constexpr size_t dims = details::view_dims_<Container_>::value;
+        using index_type = std::array<size_t, dims>;
+        const details::nd_partition<dims> partition(c, policy);
+        auto task_function = [&](size_t task) {
+            if (dims == 1) {
+                const auto range = partition.range(task, c.size(0));
+                index_type index{};
+                auto it = details::plain_begin_(c) + range.first;
+                for (size_t i = range.first; i < range.second; ++i, ++it) {
+                    index[0] = i;
+                    func(static_cast<const index_type&>(index), *it);
+                }
+            }
+            else {
+                const auto range = partition.range(task, partition.outer_size);
+                for (size_t outer = range.first; outer < range.second; ++outer) {
+                    index_type index = partition.unflatten(outer);
+                    details::with_outer_views_(partition, outer, [&](auto view_dims, auto && view) {
+                        details::serial_for_each_index_<dims>(view, index, func, view_dims);
+                    }, c);
+                }
+            }
+        };
+        details::parallel_nd_pool::instance().run(partition.tasks, partition.threads, task_function);
+    }
+
+    template <typename Container_, typename Func_>
+    void for_each_index_nd(Container_ && c, Func_ && func)
+    {
+        for_each_index_nd(parallel_policy{}, std::forward<Container_>(c), std::forward<Func_>(func));
+    }
+
+} // namespace yato
+
+#endif // _YATO_PARALLEL_ND_H_
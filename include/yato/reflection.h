@@ -241,6 +241,38 @@ namespace yato
         }
         template<typename _T>
         using reflection_manager = singleton_holder<details::reflection_manager_impl<_T>, create_using_new>;
+
+        namespace details
+        {
+            /**
+             *  Access to the static reflection info, independent of members visibility
+             */
+            struct member_access
+            {
+                template <typename _MemberInfo>
+                static YATO_CONSTEXPR_FUNC
+                typename _MemberInfo::my_type _MemberInfo::my_class::* pointer()
+                {
+                    return _MemberInfo::my_class::_yato_data_member_pointer(meta::number<_MemberInfo::my_idx>{});
+                }
+            };
+        }
+
+        /**
+         *  List of data_member_info for all reflected data members of a class in declaration order
+         */
+        template <typename _T>
+        using data_members_list = typename details::reflection_manager_impl<_T>::data_members_list;
+
+        /**
+         *  Get pointer to the data member described by data_member_info. Works for private members too.
+         */
+        template <typename _MemberInfo>
+        YATO_CONSTEXPR_FUNC
+        typename _MemberInfo::my_type _MemberInfo::my_class::* data_member_pointer()
+        {
+            return details::member_access::pointer<_MemberInfo>();
+        }
       
 
         template<typename _T>
@@ -318,6 +350,7 @@ namespace yato
     \
     /* declare manager as friend to have access to registration functions */ \
     friend class yato::reflection::details::reflection_manager_impl<_yato_reflection_my_type>;\
+    friend struct yato::reflection::details::member_access;\
     \
     /* friend function for the reflected trait; reachable by ADL */ \
     friend std::true_type _yato_test_reflection_flag(_yato_reflection_my_type); \
@@ -335,6 +368,12 @@ namespace yato
     static auto _yato_data_members_list_getter(yato::meta::number<_yato_reflected_idx_##Var>) \
         -> typename yato::meta::list_push_back<decltype(_yato_data_members_list_getter(yato::meta::number<_yato_reflected_idx_##Var - 1>{})), _yato_reflected_##Var>::type; \
     \
+    static YATO_CONSTEXPR_FUNC auto _yato_data_member_pointer(yato::meta::number<_yato_reflected_idx_##Var>) \
+        -> typename _yato_reflected_##Var::my_type _yato_reflection_my_type::* \
+    { \
+        return &_yato_reflection_my_type::Var; \
+    } \
+    \
     /* dynamic reflection info */ \
     static void _yato_runtime_register(yato::meta::number<_yato_reflected_idx_##Var>)\
     {\
@@ -0,0 +1,1097 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_SIMD_ND_H_
+#define _YATO_SIMD_ND_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "assertion.h"
+#include "prerequisites.h"
+#include "type_traits.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+# define YATO_SIMD_X86
+#endif
+
+#ifdef YATO_SIMD_X86
+# include <immintrin.h>
+# if defined(YATO_MSVC) && !defined(YATO_CLANG)
+#  include <intrin.h>
+#  define YATO_SIMD_TARGET(Features_)
+# else
+#  define YATO_SIMD_TARGET(Features_) __attribute__((target(Features_)))
+# endif
+# define YATO_SIMD_SSE2   YATO_SIMD_TARGET("sse2")
+# define YATO_SIMD_AVX2   YATO_SIMD_TARGET("avx2,fma")
+# define YATO_SIMD_AVX512 YATO_SIMD_TARGET("avx512f,avx2,fma")
+#endif
+
+namespace yato
+{
+
+    /**
+     * Vectorized element-wise kernels for multidimensional containers.
+     * Rows with continuous memory are processed with the best instruction set available at runtime, other element types use scalar loops.
+     */
+    namespace simd
+    {
+
+        enum class isa
+        {
+            scalar,
+            sse2,
+            avx2,
+            avx512
+        };
+
+        /**
+         * Total size in bytes, starting from which fill() and copy() bypass cache.
+         */
+        YATO_INLINE_VARIABLE constexpr size_t non_temporal_threshold = 4 * 1024 * 1024;
+
+    } // namespace simd
+
+
+    namespace details
+    {
+
+        //-------------------------------------------------------
+        // Scalar kernels
+
+        /**
+         * Same semantics as SIMD min/max instructions: the second argument is returned if any is NaN.
+         */
+        template <typename Ty_>
+        Ty_ simd_min_(Ty_ a, Ty_ b)
+        {
+            return (a < b) ? a : b;
+        }
+
+        template <typename Ty_>
+        Ty_ simd_max_(Ty_ a, Ty_ b)
+        {
+            return (a > b) ? a : b;
+        }
+
+        template <typename Ty_>
+        Ty_ simd_clamp_(Ty_ x, Ty_ lo, Ty_ hi)
+        {
+            return simd_min_(simd_max_(x, lo), hi);
+        }
+
+        /**
+         * Rounds to nearest and saturates. NaN is converted to the lowest value.
+         */
+        template <typename DstTy_, typename SrcTy_>
+        DstTy_ saturate_cast_(SrcTy_ x, std::true_type /*float to integral*/)
+        {
+            const SrcTy_ lo = static_cast<SrcTy_>(std::numeric_limits<DstTy_>::lowest());
+            const SrcTy_ hi = static_cast<SrcTy_>(std::numeric_limits<DstTy_>::max());
+            const SrcTy_ v = std::nearbyint(x);
+            if (!(v > lo)) {
+                return std::numeric_limits<DstTy_>::lowest();
+            }
+            if (!(v < hi)) {
+                return std::numeric_limits<DstTy_>::max();
+            }
+            return static_cast<DstTy_>(v);
+        }
+
+        template <typename DstTy_, typename SrcTy_>
+        DstTy_ saturate_cast_(SrcTy_ x, std::false_type /*float to integral*/)
+        {
+            using common = std::common_type_t<SrcTy_, DstTy_>;
+            if (std::is_integral<DstTy_>::value && std::is_integral<SrcTy_>::value) {
+                const auto lo = std::numeric_limits<DstTy_>::lowest();
+                const auto hi = std::numeric_limits<DstTy_>::max();
+                if (std::is_signed<SrcTy_>::value && (x < 0)) {
+                    // Negative source is compared in signed domain only
+                    if (std::is_unsigned<DstTy_>::value) {
+                        return 0;
+                    }
+                    return (static_cast<intmax_t>(x) < static_cast<intmax_t>(lo)) ? lo : static_cast<DstTy_>(x);
+                }
+                return (static_cast<uintmax_t>(x) > static_cast<uintmax_t>(hi)) ? hi : static_cast<DstTy_>(x);
+            }
+            return static_cast<DstTy_>(static_cast<common>(x));
+        }
+
+        template <typename DstTy_, typename SrcTy_>
+        DstTy_ saturate_cast_(SrcTy_ x)
+        {
+            return saturate_cast_<DstTy_>(x, std::integral_constant<bool, std::is_floating_point<SrcTy_>::value && std::is_integral<DstTy_>::value>{});
+        }
+
+        struct simd_add_
+        {
+            template <typename Ty_>
+            Ty_ operator()(Ty_ a, Ty_ b) const { return a + b; }
+        };
+
+        struct simd_mul_
+        {
+            template <typename Ty_>
+            Ty_ operator()(Ty_ a, Ty_ b) const { return a * b; }
+        };
+
+        struct simd_minimum_
+        {
+            template <typename Ty_>
+            Ty_ operator()(Ty_ a, Ty_ b) const { return simd_min_(a, b); }
+        };
+
+        struct simd_maximum_
+        {
+            template <typename Ty_>
+            Ty_ operator()(Ty_ a, Ty_ b) const { return simd_max_(a, b); }
+        };
+
+        template <typename Op_, typename Ty_>
+        void scalar_binary_(const Ty_* a, const Ty_* b, Ty_* dst, size_t size)
+        {
+            const Op_ op{};
+            for (size_t i = 0; i < size; ++i) {
+                dst[i] = op(a[i], b[i]);
+            }
+        }
+
+        template <typename Ty_>
+        void scalar_fma_(const Ty_* a, const Ty_* b, const Ty_* c, Ty_* dst, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i) {
+                dst[i] = a[i] * b[i] + c[i];
+            }
+        }
+
+        template <typename Ty_>
+        void scalar_clamp_(const Ty_* src, Ty_ lo, Ty_ hi, Ty_* dst, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i) {
+                dst[i] = simd_clamp_(src[i], lo, hi);
+            }
+        }
+
+        template <typename SrcTy_, typename DstTy_>
+        void scalar_convert_(const SrcTy_* src, DstTy_* dst, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i) {
+                dst[i] = saturate_cast_<DstTy_>(src[i]);
+            }
+        }
+
+        inline
+        void scalar_stream_copy_(void* dst, const void* src, size_t bytes)
+        {
+            std::memcpy(dst, src, bytes);
+        }
+
+        /**
+         * Pattern is 128 bytes of repeated value, starting at dst phase.
+         * SIMD kernels write an unaligned head first, so they continue from pattern + head, which has the phase of the next byte.
+         */
+        inline
+        void scalar_stream_fill_(void* dst, const uint8_t* pattern, size_t bytes)
+        {
+            auto* ptr = static_cast<uint8_t*>(dst);
+            for (; bytes >= 64; bytes -= 64, ptr += 64) {
+                std::memcpy(ptr, pattern, 64);
+            }
+            std::memcpy(ptr, pattern, bytes);
+        }
+
+        /**
+         * Kernels for one instruction set. All pointers are unaligned.
+         */
+        struct simd_kernels
+        {
+            void (*add)(const float*, const float*, float*, size_t);
+            void (*mul)(const float*, const float*, float*, size_t);
+            void (*min)(const float*, const float*, float*, size_t);
+            void (*max)(const float*, const float*, float*, size_t);
+            void (*fma)(const float*, const float*, const float*, float*, size_t);
+            void (*clamp)(const float*, float, float, float*, size_t);
+            void (*f32_to_u8)(const float*, uint8_t*, size_t);
+            void (*f32_to_i16)(const float*, int16_t*, size_t);
+            void (*u8_to_f32)(const uint8_t*, float*, size_t);
+            void (*stream_copy)(void*, const void*, size_t);
+            void (*stream_fill)(void*, const uint8_t*, size_t);
+        };
+
+#ifdef YATO_SIMD_X86
+
+        //-------------------------------------------------------
+        // SSE2
+
+        struct sse2_ops
+        {
+            using reg = __m128;
+            static YATO_CONSTEXPR_VAR size_t width = 4;
+
+            static YATO_SIMD_SSE2 reg load(const float* p) { return _mm_loadu_ps(p); }
+            static YATO_SIMD_SSE2 void store(float* p, reg v) { _mm_storeu_ps(p, v); }
+            static YATO_SIMD_SSE2 reg set1(float x) { return _mm_set1_ps(x); }
+            static YATO_SIMD_SSE2 reg apply(simd_add_, reg a, reg b) { return _mm_add_ps(a, b); }
+            static YATO_SIMD_SSE2 reg apply(simd_mul_, reg a, reg b) { return _mm_mul_ps(a, b); }
+            static YATO_SIMD_SSE2 reg apply(simd_minimum_, reg a, reg b) { return _mm_min_ps(a, b); }
+            static YATO_SIMD_SSE2 reg apply(simd_maximum_, reg a, reg b) { return _mm_max_ps(a, b); }
+            static YATO_SIMD_SSE2 reg fma(reg a, reg b, reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        };
+
+        template <typename Op_>
+        YATO_SIMD_SSE2
+        void sse2_binary_(const float* a, const float* b, float* dst, size_t size)
+        {
+            using ops = sse2_ops;
+            size_t i = 0;
+            for (; i + ops::width <= size; i += ops::width) {
+                ops::store(dst + i, ops::apply(Op_{}, ops::load(a + i), ops::load(b + i)));
+            }
+            scalar_binary_<Op_>(a + i, b + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_SSE2 inline
+        void sse2_fma_(const float* a, const float* b, const float* c, float* dst, size_t size)
+        {
+            using ops = sse2_ops;
+            size_t i = 0;
+            for (; i + ops::width <= size; i += ops::width) {
+                ops::store(dst + i, ops::fma(ops::load(a + i), ops::load(b + i), ops::load(c + i)));
+            }
+            scalar_fma_(a + i, b + i, c + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_SSE2 inline
+        void sse2_clamp_(const float* src, float lo, float hi, float* dst, size_t size)
+        {
+            using ops = sse2_ops;
+            const __m128 vlo = ops::set1(lo);
+            const __m128 vhi = ops::set1(hi);
+            size_t i = 0;
+            for (; i + ops::width <= size; i += ops::width) {
+                ops::store(dst + i, _mm_min_ps(_mm_max_ps(ops::load(src + i), vlo), vhi));
+            }
+            scalar_clamp_(src + i, lo, hi, dst + i, size - i);
+        }
+
+        YATO_SIMD_SSE2 inline
+        __m128i sse2_round_clamped_(const float* src, __m128 lo, __m128 hi)
+        {
+            return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src), lo), hi));
+        }
+
+        YATO_SIMD_SSE2 inline
+        void sse2_f32_to_u8_(const float* src, uint8_t* dst, size_t size)
+        {
+            const __m128 lo = _mm_set1_ps(0.0f);
+            const __m128 hi = _mm_set1_ps(255.0f);
+            size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                const __m128i v01 = _mm_packs_epi32(sse2_round_clamped_(src + i, lo, hi), sse2_round_clamped_(src + i + 4, lo, hi));
+                const __m128i v23 = _mm_packs_epi32(sse2_round_clamped_(src + i + 8, lo, hi), sse2_round_clamped_(src + i + 12, lo, hi));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(v01, v23));
+            }
+            scalar_convert_(src + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_SSE2 inline
+        void sse2_f32_to_i16_(const float* src, int16_t* dst, size_t size)
+        {
+            const __m128 lo = _mm_set1_ps(-32768.0f);
+            const __m128 hi = _mm_set1_ps(32767.0f);
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                const __m128i v = _mm_packs_epi32(sse2_round_clamped_(src + i, lo, hi), sse2_round_clamped_(src + i + 4, lo, hi));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+            }
+            scalar_convert_(src + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_SSE2 inline
+        void sse2_u8_to_f32_(const uint8_t* src, float* dst, size_t size)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                const __m128i lo = _mm_unpacklo_epi8(v, zero);
+                const __m128i hi = _mm_unpackhi_epi8(v, zero);
+                _mm_storeu_ps(dst + i,      _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)));
+                _mm_storeu_ps(dst + i + 4,  _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)));
+                _mm_storeu_ps(dst + i + 8,  _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)));
+                _mm_storeu_ps(dst + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)));
+            }
+            scalar_convert_(src + i, dst + i, size - i);
+        }
+
+        /**
+         * Number of bytes before the next address aligned to Align_
+         */
+        template <size_t Align_>
+        size_t simd_misalignment_(const void* ptr, size_t bytes)
+        {
+            const size_t head = (Align_ - reinterpret_cast<uintptr_t>(ptr) % Align_) % Align_;
+            return std::min(head, bytes);
+        }
+
+        YATO_SIMD_SSE2 inline
+        void sse2_stream_copy_(void* dst, const void* src, size_t bytes)
+        {
+            auto* d = static_cast<uint8_t*>(dst);
+            auto* s = static_cast<const uint8_t*>(src);
+            const size_t head = simd_misalignment_<16>(d, bytes);
+            std::memcpy(d, s, head);
+            d += head; s += head; bytes -= head;
+            for (; bytes >= 16; bytes -= 16, d += 16, s += 16) {
+                _mm_stream_si128(reinterpret_cast<__m128i*>(d), _mm_loadu_si128(reinterpret_cast<const __m128i*>(s)));
+            }
+            std::memcpy(d, s, bytes);
+            _mm_sfence();
+        }
+
+        YATO_SIMD_SSE2 inline
+        void sse2_stream_fill_(void* dst, const uint8_t* pattern, size_t bytes)
+        {
+            auto* d = static_cast<uint8_t*>(dst);
+            const size_t head = simd_misalignment_<16>(d, bytes);
+            std::memcpy(d, pattern, head);
+            d += head; bytes -= head;
+            // Element size divides the vector width, so every vector and the tail start at the phase after the head
+            const uint8_t* phase = pattern + head;
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(phase));
+            for (; bytes >= 16; bytes -= 16, d += 16) {
+                _mm_stream_si128(reinterpret_cast<__m128i*>(d), v);
+            }
+            std::memcpy(d, phase, bytes);
+            _mm_sfence();
+        }
+
+        //-------------------------------------------------------
+        // AVX2
+
+        struct avx2_ops
+        {
+            using reg = __m256;
+            static YATO_CONSTEXPR_VAR size_t width = 8;
+
+            static YATO_SIMD_AVX2 reg load(const float* p) { return _mm256_loadu_ps(p); }
+            static YATO_SIMD_AVX2 void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+            static YATO_SIMD_AVX2 reg set1(float x) { return _mm256_set1_ps(x); }
+            static YATO_SIMD_AVX2 reg apply(simd_add_, reg a, reg b) { return _mm256_add_ps(a, b); }
+            static YATO_SIMD_AVX2 reg apply(simd_mul_, reg a, reg b) { return _mm256_mul_ps(a, b); }
+            static YATO_SIMD_AVX2 reg apply(simd_minimum_, reg a, reg b) { return _mm256_min_ps(a, b); }
+            static YATO_SIMD_AVX2 reg apply(simd_maximum_, reg a, reg b) { return _mm256_max_ps(a, b); }
+            static YATO_SIMD_AVX2 reg fma(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+        };
+
+        template <typename Op_>
+        YATO_SIMD_AVX2
+        void avx2_binary_(const float* a, const float* b, float* dst, size_t size)
+        {
+            using ops = avx2_ops;
+            size_t i = 0;
+            for (; i + ops::width <= size; i += ops::width) {
+                ops::store(dst + i, ops::apply(Op_{}, ops::load(a + i), ops::load(b + i)));
+            }
+            scalar_binary_<Op_>(a + i, b + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_AVX2 inline
+        void avx2_fma_(const float* a, const float* b, const float* c, float* dst, size_t size)
+        {
+            using ops = avx2_ops;
+            size_t i = 0;
+            for (; i + ops::width <= size; i += ops::width) {
+                ops::store(dst + i, ops::fma(ops::load(a + i), ops::load(b + i), ops::load(c + i)));
+            }
+            scalar_fma_(a + i, b + i, c + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_AVX2 inline
+        void avx2_clamp_(const float* src, float lo, float hi, float* dst, size_t size)
+        {
+            using ops = avx2_ops;
+            const __m256 vlo = ops::set1(lo);
+            const __m256 vhi = ops::set1(hi);
+            size_t i = 0;
+            for (; i + ops::width <= size; i += ops::width) {
+                ops::store(dst + i, _mm256_min_ps(_mm256_max_ps(ops::load(src + i), vlo), vhi));
+            }
+            scalar_clamp_(src + i, lo, hi, dst + i, size - i);
+        }
+
+        YATO_SIMD_AVX2 inline
+        __m256i avx2_round_clamped_(const float* src, __m256 lo, __m256 hi)
+        {
+            return _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src), lo), hi));
+        }
+
+        YATO_SIMD_AVX2 inline
+        void avx2_f32_to_u8_(const float* src, uint8_t* dst, size_t size)
+        {
+            const __m256 lo = _mm256_set1_ps(0.0f);
+            const __m256 hi = _mm256_set1_ps(255.0f);
+            // Packing works within 128 bit lanes
+            const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+            size_t i = 0;
+            for (; i + 32 <= size; i += 32) {
+                const __m256i v01 = _mm256_packs_epi32(avx2_round_clamped_(src + i, lo, hi), avx2_round_clamped_(src + i + 8, lo, hi));
+                const __m256i v23 = _mm256_packs_epi32(avx2_round_clamped_(src + i + 16, lo, hi), avx2_round_clamped_(src + i + 24, lo, hi));
+                const __m256i v = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(v01, v23), order);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+            }
+            sse2_f32_to_u8_(src + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_AVX2 inline
+        void avx2_f32_to_i16_(const float* src, int16_t* dst, size_t size)
+        {
+            const __m256 lo = _mm256_set1_ps(-32768.0f);
+            const __m256 hi = _mm256_set1_ps(32767.0f);
+            size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                const __m256i v = _mm256_packs_epi32(avx2_round_clamped_(src + i, lo, hi), avx2_round_clamped_(src + i + 8, lo, hi));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0)));
+            }
+            sse2_f32_to_i16_(src + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_AVX2 inline
+        void avx2_u8_to_f32_(const uint8_t* src, float* dst, size_t size)
+        {
+            size_t i = 0;
+            for (; i + 8 <= size; i += 8) {
+                const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+                _mm256_storeu_ps(dst + i, _mm256_cvtepi32_ps(v));
+            }
+            scalar_convert_(src + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_AVX2 inline
+        void avx2_stream_copy_(void* dst, const void* src, size_t bytes)
+        {
+            auto* d = static_cast<uint8_t*>(dst);
+            auto* s = static_cast<const uint8_t*>(src);
+            const size_t head = simd_misalignment_<32>(d, bytes);
+            std::memcpy(d, s, head);
+            d += head; s += head; bytes -= head;
+            for (; bytes >= 32; bytes -= 32, d += 32, s += 32) {
+                _mm256_stream_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)));
+            }
+            std::memcpy(d, s, bytes);
+            _mm_sfence();
+        }
+
+        YATO_SIMD_AVX2 inline
+        void avx2_stream_fill_(void* dst, const uint8_t* pattern, size_t bytes)
+        {
+            auto* d = static_cast<uint8_t*>(dst);
+            const size_t head = simd_misalignment_<32>(d, bytes);
+            std::memcpy(d, pattern, head);
+            d += head; bytes -= head;
+            const uint8_t* phase = pattern + head;
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(phase));
+            for (; bytes >= 32; bytes -= 32, d += 32) {
+                _mm256_stream_si256(reinterpret_cast<__m256i*>(d), v);
+            }
+            std::memcpy(d, phase, bytes);
+            _mm_sfence();
+        }
+
+        //-------------------------------------------------------
+        // AVX-512
+
+        YATO_PRAGMA_WARNING_PUSH
+        // False positive in GCC intrinsics headers
+        YATO_GCC_WARNING_IGNORE("-Wmaybe-uninitialized")
+
+        struct avx512_ops
+        {
+            using reg = __m512;
+            static YATO_CONSTEXPR_VAR size_t width = 16;
+
+            static YATO_SIMD_AVX512 reg load(const float* p) { return _mm512_loadu_ps(p); }
+            static YATO_SIMD_AVX512 void store(float* p, reg v) { _mm512_storeu_ps(p, v); }
+            static YATO_SIMD_AVX512 reg set1(float x) { return _mm512_set1_ps(x); }
+            static YATO_SIMD_AVX512 reg apply(simd_add_, reg a, reg b) { return _mm512_add_ps(a, b); }
+            static YATO_SIMD_AVX512 reg apply(simd_mul_, reg a, reg b) { return _mm512_mul_ps(a, b); }
+            static YATO_SIMD_AVX512 reg apply(simd_minimum_, reg a, reg b) { return _mm512_min_ps(a, b); }
+            static YATO_SIMD_AVX512 reg apply(simd_maximum_, reg a, reg b) { return _mm512_max_ps(a, b); }
+            static YATO_SIMD_AVX512 reg fma(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+        };
+
+        template <typename Op_>
+        YATO_SIMD_AVX512
+        void avx512_binary_(const float* a, const float* b, float* dst, size_t size)
+        {
+            using ops = avx512_ops;
+            size_t i = 0;
+            for (; i + ops::width <= size; i += ops::width) {
+                ops::store(dst + i, ops::apply(Op_{}, ops::load(a + i), ops::load(b + i)));
+            }
+            avx2_binary_<Op_>(a + i, b + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_AVX512 inline
+        void avx512_fma_(const float* a, const float* b, const float* c, float* dst, size_t size)
+        {
+            using ops = avx512_ops;
+            size_t i = 0;
+            for (; i + ops::width <= size; i += ops::width) {
+                ops::store(dst + i, ops::fma(ops::load(a + i), ops::load(b + i), ops::load(c + i)));
+            }
+            avx2_fma_(a + i, b + i, c + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_AVX512 inline
+        void avx512_clamp_(const float* src, float lo, float hi, float* dst, size_t size)
+        {
+            using ops = avx512_ops;
+            const __m512 vlo = ops::set1(lo);
+            const __m512 vhi = ops::set1(hi);
+            size_t i = 0;
+            for (; i + ops::width <= size; i += ops::width) {
+                ops::store(dst + i, _mm512_min_ps(_mm512_max_ps(ops::load(src + i), vlo), vhi));
+            }
+            avx2_clamp_(src + i, lo, hi, dst + i, size - i);
+        }
+
+        YATO_SIMD_AVX512 inline
+        __m512i avx512_round_clamped_(const float* src, __m512 lo, __m512 hi)
+        {
+            return _mm512_cvtps_epi32(_mm512_min_ps(_mm512_max_ps(_mm512_loadu_ps(src), lo), hi));
+        }
+
+        YATO_SIMD_AVX512 inline
+        void avx512_f32_to_u8_(const float* src, uint8_t* dst, size_t size)
+        {
+            const __m512 lo = _mm512_set1_ps(0.0f);
+            const __m512 hi = _mm512_set1_ps(255.0f);
+            size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm512_cvtusepi32_epi8(avx512_round_clamped_(src + i, lo, hi)));
+            }
+            sse2_f32_to_u8_(src + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_AVX512 inline
+        void avx512_f32_to_i16_(const float* src, int16_t* dst, size_t size)
+        {
+            const __m512 lo = _mm512_set1_ps(-32768.0f);
+            const __m512 hi = _mm512_set1_ps(32767.0f);
+            size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm512_cvtsepi32_epi16(avx512_round_clamped_(src + i, lo, hi)));
+            }
+            sse2_f32_to_i16_(src + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_AVX512 inline
+        void avx512_u8_to_f32_(const uint8_t* src, float* dst, size_t size)
+        {
+            size_t i = 0;
+            for (; i + 16 <= size; i += 16) {
+                const __m512i v = _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+                _mm512_storeu_ps(dst + i, _mm512_cvtepi32_ps(v));
+            }
+            avx2_u8_to_f32_(src + i, dst + i, size - i);
+        }
+
+        YATO_SIMD_AVX512 inline
+        void avx512_stream_copy_(void* dst, const void* src, size_t bytes)
+        {
+            auto* d = static_cast<uint8_t*>(dst);
+            auto* s = static_cast<const uint8_t*>(src);
+            const size_t head = simd_misalignment_<64>(d, bytes);
+            std::memcpy(d, s, head);
+            d += head; s += head; bytes -= head;
+            for (; bytes >= 64; bytes -= 64, d += 64, s += 64) {
+                _mm512_stream_si512(reinterpret_cast<__m512i*>(d), _mm512_loadu_si512(reinterpret_cast<const void*>(s)));
+            }
+            std::memcpy(d, s, bytes);
+            _mm_sfence();
+        }
+
+        YATO_SIMD_AVX512 inline
+        void avx512_stream_fill_(void* dst, const uint8_t* pattern, size_t bytes)
+        {
+            auto* d = static_cast<uint8_t*>(dst);
+            const size_t head = simd_misalignment_<64>(d, bytes);
+            std::memcpy(d, pattern, head);
+            d += head; bytes -= head;
+            const uint8_t* phase = pattern + head;
+            const __m512i v = _mm512_loadu_si512(reinterpret_cast<const void*>(phase));
+            for (; bytes >= 64; bytes -= 64, d += 64) {
+                _mm512_stream_si512(reinterpret_cast<__m512i*>(d), v);
+            }
+            std::memcpy(d, phase, bytes);
+            _mm_sfence();
+        }
+
+        YATO_PRAGMA_WARNING_POP
+
+#endif // YATO_SIMD_X86
+
+        //-------------------------------------------------------
+        // Dispatch
+
+        inline
+        simd::isa simd_detect_isa_()
+        {
+#ifdef YATO_SIMD_X86
+# if defined(YATO_MSVC) && !defined(YATO_CLANG)
+            int regs[4] = {};
+            __cpuid(regs, 0);
+            const int max_leaf = regs[0];
+            __cpuid(regs, 1);
+            const bool sse2    = (regs[3] & (1 << 26)) != 0;
+            const bool fma     = (regs[2] & (1 << 12)) != 0;
+            const bool osxsave = (regs[2] & (1 << 27)) != 0;
+            const uint64_t xcr0 = osxsave ? _xgetbv(0) : 0;
+            bool avx2 = false;
+            bool avx512 = false;
+            if (max_leaf >= 7) {
+                __cpuidex(regs, 7, 0);
+                avx2   = fma && ((regs[1] & (1 << 5)) != 0) && ((xcr0 & 0x06) == 0x06);
+                avx512 = avx2 && ((regs[1] & (1 << 16)) != 0) && ((xcr0 & 0xE6) == 0xE6);
+            }
+# else
+            __builtin_cpu_init();
+            const bool sse2   = __builtin_cpu_supports("sse2");
+            const bool avx2   = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+            const bool avx512 = avx2 && __builtin_cpu_supports("avx512f");
+# endif
+            if (avx512) {
+                return simd::isa::avx512;
+            }
+            if (avx2) {
+                return simd::isa::avx2;
+            }
+            if (sse2) {
+                return simd::isa::sse2;
+            }
+#endif
+            return simd::isa::scalar;
+        }
+
+        inline
+        const simd_kernels & simd_kernels_for_(simd::isa set)
+        {
+            static const simd_kernels scalar = {
+                &scalar_binary_<simd_add_, float>, &scalar_binary_<simd_mul_, float>, &scalar_binary_<simd_minimum_, float>, &scalar_binary_<simd_maximum_, float>,
+                &scalar_fma_<float>, &scalar_clamp_<float>,
+                &scalar_convert_<float, uint8_t>, &scalar_convert_<float, int16_t>, &scalar_convert_<uint8_t, float>,
+                &scalar_stream_copy_, &scalar_stream_fill_
+            };
+#ifdef YATO_SIMD_X86
+            static const simd_kernels sse2 = {
+                &sse2_binary_<simd_add_>, &sse2_binary_<simd_mul_>, &sse2_binary_<simd_minimum_>, &sse2_binary_<simd_maximum_>,
+                &sse2_fma_, &sse2_clamp_,
+                &sse2_f32_to_u8_, &sse2_f32_to_i16_, &sse2_u8_to_f32_,
+                &sse2_stream_copy_, &sse2_stream_fill_
+            };
+            static const simd_kernels avx2 = {
+                &avx2_binary_<simd_add_>, &avx2_binary_<simd_mul_>, &avx2_binary_<simd_minimum_>, &avx2_binary_<simd_maximum_>,
+                &avx2_fma_, &avx2_clamp_,
+                &avx2_f32_to_u8_, &avx2_f32_to_i16_, &avx2_u8_to_f32_,
+                &avx2_stream_copy_, &avx2_stream_fill_
+            };
+            static const simd_kernels avx512 = {
+                &avx512_binary_<simd_add_>, &avx512_binary_<simd_mul_>, &avx512_binary_<simd_minimum_>, &avx512_binary_<simd_maximum_>,
+                &avx512_fma_, &avx512_clamp_,
+                &avx512_f32_to_u8_, &avx512_f32_to_i16_, &avx512_u8_to_f32_,
+                &avx512_stream_copy_, &avx512_stream_fill_
+            };
+            switch (set) {
+            case simd::isa::sse2:
+                return sse2;
+            case simd::isa::avx2:
+                return avx2;
+            case simd::isa::avx512:
+                return avx512;
+            default:
+                break;
+            }
+#else
+            YATO_MAYBE_UNUSED(set);
+#endif
+            return scalar;
+        }
+
+        inline
+        std::atomic<simd::isa> & simd_active_isa_()
+        {
+            static std::atomic<simd::isa> active{ simd_detect_isa_() };
+            return active;
+        }
+
+        inline
+        const simd_kernels & simd_active_kernels_()
+        {
+            return simd_kernels_for_(simd_active_isa_().load(std::memory_order_relaxed));
+        }
+
+        //-------------------------------------------------------
+        // Traversal
+
+        template <typename Container_>
+        auto simd_data_(Container_ & c)
+        {
+            return std::addressof(*c.plain_begin());
+        }
+
+        template <typename Container_>
+        auto simd_data_(const Container_ & c)
+        {
+            return std::addressof(*c.plain_cbegin());
+        }
+
+        template <typename View_, typename... Views_>
+        bool simd_continuous_(const View_ & view, const Views_ & ... views)
+        {
+            bool res = view.continuous();
+            (void)std::initializer_list<int>{ (res = res && views.continuous(), 0)... };
+            return res;
+        }
+
+        template <size_t Dims_, typename View_>
+        int simd_check_dims_(const View_ & /*view*/)
+        {
+            static_assert(Dims_ == View_::dimensions_number, "yato::simd: containers must have equal dimensions number");
+            return 0;
+        }
+
+        template <typename View_, typename... Views_>
+        void simd_check_sizes_(const View_ & view, const Views_ & ... views)
+        {
+            constexpr size_t dims = View_::dimensions_number;
+            (void)std::initializer_list<int>{ simd_check_dims_<dims>(views)... };
+            for (size_t d = 0; d < dims; ++d) {
+                bool equal = true;
+                (void)std::initializer_list<int>{ (equal = equal && (views.size(d) == view.size(d)), 0)... };
+                if (!equal) {
+                    throw yato::argument_error("yato::simd: containers have different sizes");
+                }
+            }
+        }
+
+        /**
+         * Calls func(size, pointers...) for every continuous row of the containers.
+         */
+        template <typename Func_, typename View_, typename... Views_>
+        void simd_rows_(Func_ & func, std::integral_constant<size_t, 1>, View_ && view, Views_ && ... views)
+        {
+            const size_t size = view.size(0);
+            if (size > 0) {
+                func(size, simd_data_(view), simd_data_(views)...);
+            }
+        }
+
+        template <typename Func_, size_t Dims_, typename View_, typename... Views_>
+        void simd_rows_(Func_ & func, std::integral_constant<size_t, Dims_>, View_ && view, Views_ && ... views)
+        {
+            if (simd_continuous_(view, views...)) {
+                const size_t size = view.total_size();
+                if (size > 0) {
+                    func(size, simd_data_(view), simd_data_(views)...);
+                }
+            }
+            else {
+                const size_t size = view.size(0);
+                for (size_t i = 0; i < size; ++i) {
+                    simd_rows_(func, std::integral_constant<size_t, Dims_ - 1>{}, view[i], views[i]...);
+                }
+            }
+        }
+
+        template <typename Func_, typename View_, typename... Views_>
+        void simd_for_each_row_(Func_ && func, View_ && view, Views_ && ... views)
+        {
+            simd_check_sizes_(view, views...);
+            simd_rows_(func, std::integral_constant<size_t, yato::remove_cvref_t<View_>::dimensions_number>{}, view, views...);
+        }
+
+        template <typename Container_>
+        using simd_value_t_ = std::remove_cv_t<typename yato::remove_cvref_t<Container_>::value_type>;
+
+        //-------------------------------------------------------
+        // Row operations with fast paths
+
+        template <typename Op_>
+        struct simd_binary_row_
+        {
+            static
+            void apply(const simd_kernels & kernels, size_t size, const float* a, const float* b, float* dst)
+            {
+                binary_kernel_(kernels, Op_{})(a, b, dst, size);
+            }
+
+            template <typename Ty_>
+            static
+            void apply(const simd_kernels & /*kernels*/, size_t size, const Ty_* a, const Ty_* b, Ty_* dst)
+            {
+                scalar_binary_<Op_>(a, b, dst, size);
+            }
+
+        private:
+            using kernel_type = void(*)(const float*, const float*, float*, size_t);
+
+            static kernel_type binary_kernel_(const simd_kernels & k, simd_add_) { return k.add; }
+            static kernel_type binary_kernel_(const simd_kernels & k, simd_mul_) { return k.mul; }
+            static kernel_type binary_kernel_(const simd_kernels & k, simd_minimum_) { return k.min; }
+            static kernel_type binary_kernel_(const simd_kernels & k, simd_maximum_) { return k.max; }
+        };
+
+        inline
+        void simd_fma_row_(const simd_kernels & kernels, size_t size, const float* a, const float* b, const float* c, float* dst)
+        {
+            kernels.fma(a, b, c, dst, size);
+        }
+
+        template <typename Ty_>
+        void simd_fma_row_(const simd_kernels & /*kernels*/, size_t size, const Ty_* a, const Ty_* b, const Ty_* c, Ty_* dst)
+        {
+            scalar_fma_(a, b, c, dst, size);
+        }
+
+        inline
+        void simd_clamp_row_(const simd_kernels & kernels, size_t size, const float* src, float lo, float hi, float* dst)
+        {
+            kernels.clamp(src, lo, hi, dst, size);
+        }
+
+        template <typename Ty_>
+        void simd_clamp_row_(const simd_kernels & /*kernels*/, size_t size, const Ty_* src, Ty_ lo, Ty_ hi, Ty_* dst)
+        {
+            scalar_clamp_(src, lo, hi, dst, size);
+        }
+
+        inline
+        void simd_convert_row_(const simd_kernels & kernels, size_t size, const float* src, uint8_t* dst)
+        {
+            kernels.f32_to_u8(src, dst, size);
+        }
+
+        inline
+        void simd_convert_row_(const simd_kernels & kernels, size_t size, const float* src, int16_t* dst)
+        {
+            kernels.f32_to_i16(src, dst, size);
+        }
+
+        inline
+        void simd_convert_row_(const simd_kernels & kernels, size_t size, const uint8_t* src, float* dst)
+        {
+            kernels.u8_to_f32(src, dst, size);
+        }
+
+        template <typename SrcTy_, typename DstTy_>
+        void simd_convert_row_(const simd_kernels & /*kernels*/, size_t size, const SrcTy_* src, DstTy_* dst)
+        {
+            scalar_convert_(src, dst, size);
+        }
+
+    } // namespace details
+
+
+    namespace simd
+    {
+
+        /**
+         * The best instruction set supported by CPU and OS.
+         */
+        inline
+        isa detected_isa()
+        {
+            static const isa detected = details::simd_detect_isa_();
+            return detected;
+        }
+
+        /**
+         * Instruction set used by kernels. Detected one by default.
+         */
+        inline
+        isa active_isa()
+        {
+            return details::simd_active_isa_().load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Limits instruction set used by kernels, e.g. for testing or benchmarking. Returns the previous one.
+         * Sets not supported by CPU are replaced with the detected one.
+         */
+        inline
+        isa set_active_isa(isa set)
+        {
+            return details::simd_active_isa_().exchange(std::min(set, detected_isa()), std::memory_order_relaxed);
+        }
+
+        inline
+        const char* isa_name(isa set)
+        {
+            switch (set) {
+            case isa::sse2:
+                return "sse2";
+            case isa::avx2:
+                return "avx2";
+            case isa::avx512:
+                return "avx512";
+            default:
+                return "scalar";
+            }
+        }
+
+        //-------------------------------------------------------
+
+        /**
+         * dst = a + b
+         */
+        template <typename ContainerA_, typename ContainerB_, typename DstContainer_>
+        void add(const ContainerA_ & a, const ContainerB_ & b, DstContainer_ && dst)
+        {
+            const auto & kernels = details::simd_active_kernels_();
+            details::simd_for_each_row_([&kernels](size_t size, auto pa, auto pb, auto pdst) {
+                details::simd_binary_row_<details::simd_add_>::apply(kernels, size, pa, pb, pdst);
+            }, a, b, dst);
+        }
+
+        /**
+         * dst = a * b
+         */
+        template <typename ContainerA_, typename ContainerB_, typename DstContainer_>
+        void mul(const ContainerA_ & a, const ContainerB_ & b, DstContainer_ && dst)
+        {
+            const auto & kernels = details::simd_active_kernels_();
+            details::simd_for_each_row_([&kernels](size_t size, auto pa, auto pb, auto pdst) {
+                details::simd_binary_row_<details::simd_mul_>::apply(kernels, size, pa, pb, pdst);
+            }, a, b, dst);
+        }
+
+        /**
+         * dst = a * b + c
+         * The result is computed with a single rounding if the instruction set has FMA, so it may differ in the last bit.
+         */
+        template <typename ContainerA_, typename ContainerB_, typename ContainerC_, typename DstContainer_>
+        void fma(const ContainerA_ & a, const ContainerB_ & b, const ContainerC_ & c, DstContainer_ && dst)
+        {
+            const auto & kernels = details::simd_active_kernels_();
+            details::simd_for_each_row_([&kernels](size_t size, auto pa, auto pb, auto pc, auto pdst) {
+                details::simd_fma_row_(kernels, size, pa, pb, pc, pdst);
+            }, a, b, c, dst);
+        }
+
+        /**
+         * dst = (a < b) ? a : b
+         */
+        template <typename ContainerA_, typename ContainerB_, typename DstContainer_>
+        void min(const ContainerA_ & a, const ContainerB_ & b, DstContainer_ && dst)
+        {
+            const auto & kernels = details::simd_active_kernels_();
+            details::simd_for_each_row_([&kernels](size_t size, auto pa, auto pb, auto pdst) {
+                details::simd_binary_row_<details::simd_minimum_>::apply(kernels, size, pa, pb, pdst);
+            }, a, b, dst);
+        }
+
+        /**
+         * dst = (a > b) ? a : b
+         */
+        template <typename ContainerA_, typename ContainerB_, typename DstContainer_>
+        void max(const ContainerA_ & a, const ContainerB_ & b, DstContainer_ && dst)
+        {
+            const auto & kernels = details::simd_active_kernels_();
+            details::simd_for_each_row_([&kernels](size_t size, auto pa, auto pb, auto pdst) {
+                details::simd_binary_row_<details::simd_maximum_>::apply(kernels, size, pa, pb, pdst);
+            }, a, b, dst);
+        }
+
+        /**
+         * Clamps src to [lo, hi]. NaN is replaced with lo.
+         */
+        template <typename SrcContainer_, typename DstContainer_, typename Ty_>
+        void clamp(const SrcContainer_ & src, const Ty_ & lo, const Ty_ & hi, DstContainer_ && dst)
+        {
+            using value_type = details::simd_value_t_<SrcContainer_>;
+            const auto & kernels = details::simd_active_kernels_();
+            details::simd_for_each_row_([&](size_t size, auto psrc, auto pdst) {
+                details::simd_clamp_row_(kernels, size, psrc, static_cast<value_type>(lo), static_cast<value_type>(hi), pdst);
+            }, src, dst);
+        }
+
+        /**
+         * Converts elements to the destination type.
+         * Conversion to integral types rounds to nearest and saturates, NaN becomes the lowest value.
+         */
+        template <typename SrcContainer_, typename DstContainer_>
+        void convert(const SrcContainer_ & src, DstContainer_ && dst)
+        {
+            const auto & kernels = details::simd_active_kernels_();
+            details::simd_for_each_row_([&kernels](size_t size, auto psrc, auto pdst) {
+                details::simd_convert_row_(kernels, size, psrc, pdst);
+            }, src, dst);
+        }
+
+        /**
+         * Copies elements. Large trivially copyable arrays are written with non-temporal stores.
+         */
+        template <typename SrcContainer_, typename DstContainer_>
+        void copy(const SrcContainer_ & src, DstContainer_ && dst)
+        {
+            using value_type = details::simd_value_t_<DstContainer_>;
+            static_assert(std::is_same<details::simd_value_t_<SrcContainer_>, value_type>::value, "yato::simd::copy: element types must be equal");
+            const bool streaming = std::is_trivially_copyable<value_type>::value && (src.total_size() * sizeof(value_type) >= non_temporal_threshold);
+            const auto & kernels = details::simd_active_kernels_();
+            details::simd_for_each_row_([&](size_t size, auto psrc, auto pdst) {
+                if (streaming) {
+                    kernels.stream_copy(pdst, psrc, size * sizeof(value_type));
+                }
+                else {
+                    std::copy(psrc, psrc + size, pdst);
+                }
+            }, src, dst);
+        }
+
+        /**
+         * Assigns value to all elements. Large arrays of 1, 2, 4 or 8 byte elements are written with non-temporal stores.
+         */
+        template <typename DstContainer_, typename Ty_>
+        void fill(DstContainer_ && dst, const Ty_ & value)
+        {
+            using value_type = details::simd_value_t_<DstContainer_>;
+            const value_type v = static_cast<value_type>(value);
+            const bool streaming = std::is_trivially_copyable<value_type>::value && (64 % sizeof(value_type) == 0) && (sizeof(value_type) <= 8)
+                && (dst.total_size() * sizeof(value_type) >= non_temporal_threshold);
+            if (streaming) {
+                // Two periods of 64 bytes, so the kernels can continue from any phase
+                alignas(64) uint8_t pattern[128];
+                for (size_t offset = 0; offset < sizeof(pattern); offset += sizeof(value_type)) {
+                    std::memcpy(pattern + offset, std::addressof(v), sizeof(value_type));
+                }
+                const auto & kernels = details::simd_active_kernels_();
+                details::simd_for_each_row_([&](size_t size, auto pdst) {
+                    kernels.stream_fill(pdst, pattern, size * sizeof(value_type));
+                }, dst);
+            }
+            else {
+                details::simd_for_each_row_([&v](size_t size, auto pdst) {
+                    std::fill(pdst, pdst + size, v);
+                }, dst);
+            }
+        }
+
+    } // namespace simd
+
+} // namespace yato
+
+#endif // _YATO_SIMD_ND_H_
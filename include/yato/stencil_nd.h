@@ -0,0 +1,313 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_STENCIL_ND_H_
+#define _YATO_STENCIL_ND_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "array_view.h"
+#include "assertion.h"
+#include "container_nd.h"
+#include "parallel_nd.h"
+#include "vector_nd.h"
+
+namespace yato
+{
+
+    namespace details
+    {
+
+        template <typename KernelTy_, typename SrcTy_>
+        using stencil_accumulator_t = yato::remove_cvref_t<decltype(std::declval<KernelTy_>() * std::declval<SrcTy_>())>;
+
+        template <typename Ty_, size_t Dims_, typename Container_>
+        yato::array_view_nd<Ty_, Dims_> stencil_view_(Container_ && c)
+        {
+            using container_ops = yato::container_ops<yato::remove_cvref_t<Container_>>;
+            return yato::array_view_nd<Ty_, Dims_>(container_ops::data(c), container_ops::dimensions(c), container_ops::strides(c));
+        }
+
+        /**
+         * Pointer to the row given by outer indexes.
+         */
+        template <typename Ty_, size_t Dims_, typename Index_>
+        Ty_* stencil_row_(const yato::array_view_nd<Ty_, Dims_> & view, const Index_ & outer)
+        {
+            Ty_* ptr = view.data();
+            for (size_t d = 0; d + 1 < Dims_; ++d) {
+                details::advance_bytes(ptr, static_cast<std::ptrdiff_t>(outer[d]) * static_cast<std::ptrdiff_t>(view.stride(d)));
+            }
+            return ptr;
+        }
+
+        template <size_t Dims_, typename Index_>
+        void stencil_unflatten_(size_t flat, const std::array<size_t, Dims_> & extents, Index_ & index)
+        {
+            for (size_t d = Dims_ - 1; d-- > 0;) {
+                index[d] = flat % extents[d];
+                flat /= extents[d];
+            }
+        }
+
+        template <typename Sampler_, typename View_, typename Index_, size_t... Indexes_>
+        decltype(auto) stencil_load_(const Sampler_ & sampler, const View_ & view, const Index_ & index, std::index_sequence<Indexes_...>)
+        {
+            return yato::loads(sampler, view, index[Indexes_]...);
+        }
+
+        /**
+         * Applies the kernel to one element through the sampler. Used for border elements only.
+         */
+        template <typename Acc_, typename Sampler_, typename SrcTy_, typename KernelTy_, size_t Dims_>
+        Acc_ stencil_border_value_(const Sampler_ & sampler, const yato::array_view_nd<const SrcTy_, Dims_> & src,
+            const std::vector<KernelTy_> & weights, const std::array<size_t, Dims_> & kernel_extents, const std::array<size_t, Dims_> & anchor,
+            const std::array<std::ptrdiff_t, Dims_> & position)
+        {
+            using index_type = typename Sampler_::index_type;
+            std::array<index_type, Dims_> index{};
+            std::array<size_t, Dims_> tap{};
+            Acc_ acc = static_cast<Acc_>(0);
+            for (size_t t = 0; t < weights.size(); ++t) {
+                for (size_t d = 0; d < Dims_; ++d) {
+                    index[d] = static_cast<index_type>(position[d] + static_cast<std::ptrdiff_t>(tap[d]) - static_cast<std::ptrdiff_t>(anchor[d]));
+                }
+                acc += weights[t] * stencil_load_(sampler, src, index, std::make_index_sequence<Dims_>{});
+                for (size_t d = Dims_; d-- > 0;) {
+                    if (++tap[d] < kernel_extents[d]) {
+                        break;
+                    }
+                    tap[d] = 0;
+                }
+            }
+            return acc;
+        }
+
+        /**
+         * Stencil over views. The kernel is packed densely in row-major order.
+         * Rows, which have all taps inside the source along outer dimensions, are split into the interior span and two border spans.
+         * The interior span is accumulated tap by tap with unchecked loops over row pointers, border spans go through the sampler.
+         */
+        template <typename Sampler_, typename SrcTy_, typename DstTy_, typename KernelTy_, size_t Dims_>
+        void stencil_apply_(const parallel_policy & policy, const Sampler_ & sampler,
+            const yato::array_view_nd<const SrcTy_, Dims_> & src, const yato::array_view_nd<DstTy_, Dims_> & dst,
+            const std::vector<KernelTy_> & weights, const std::array<size_t, Dims_> & kernel_extents)
+        {
+            using acc_type = details::stencil_accumulator_t<KernelTy_, SrcTy_>;
+            static_assert(Dims_ > 1, "yato::stencil_nd: only multidimensional containers are supported");
+
+            std::array<size_t, Dims_> extents{};
+            std::array<size_t, Dims_> anchor{};
+            size_t rows = 1;
+            size_t outer_taps = 1;
+            for (size_t d = 0; d < Dims_; ++d) {
+                extents[d] = src.size(d);
+                anchor[d]  = kernel_extents[d] / 2;
+                if (d + 1 < Dims_) {
+                    rows *= extents[d];
+                    outer_taps *= kernel_extents[d];
+                }
+            }
+            const size_t width = extents[Dims_ - 1];
+            const size_t kernel_width = kernel_extents[Dims_ - 1];
+            if (rows == 0 || width == 0) {
+                return;
+            }
+            // Interior span of a row
+            const size_t tail = kernel_width - 1 - anchor[Dims_ - 1];
+            const size_t x_begin = std::min(anchor[Dims_ - 1], width);
+            const size_t x_end = std::max(x_begin, (width > tail) ? width - tail : 0);
+
+            auto & pool = details::parallel_nd_pool::instance();
+            const size_t threads = (policy.threads != 0) ? std::min(policy.threads, pool.concurrency()) : pool.concurrency();
+            const size_t max_tasks = std::max<size_t>(1, rows * width * weights.size() / std::max<size_t>(policy.grain, 1));
+            const size_t tasks = std::min(std::min(max_tasks, 4 * threads), rows);
+            const size_t rows_per_task = (rows + tasks - 1) / tasks;
+
+            auto task_function = [&](size_t task) {
+                std::vector<acc_type> acc(width);
+                std::array<size_t, Dims_> outer{};
+                std::array<size_t, Dims_> tap{};
+                std::array<size_t, Dims_> src_outer{};
+                std::array<std::ptrdiff_t, Dims_> position{};
+
+                const size_t first = std::min(task * rows_per_task, rows);
+                const size_t last = std::min(first + rows_per_task, rows);
+                for (size_t row = first; row < last; ++row) {
+                    details::stencil_unflatten_<Dims_>(row, extents, outer);
+                    DstTy_* const dst_row = details::stencil_row_(dst, outer);
+
+                    bool interior = true;
+                    for (size_t d = 0; d + 1 < Dims_; ++d) {
+                        position[d] = static_cast<std::ptrdiff_t>(outer[d]);
+                        interior = interior && (outer[d] >= anchor[d]) && (outer[d] + kernel_extents[d] - 1 - anchor[d] < extents[d]);
+                    }
+                    const size_t span_begin = interior ? x_begin : width;
+                    const size_t span_end = interior ? x_end : width;
+
+                    if (span_begin < span_end) {
+                        std::fill(acc.begin() + span_begin, acc.begin() + span_end, static_cast<acc_type>(0));
+                        for (size_t t = 0; t < outer_taps; ++t) {
+                            details::stencil_unflatten_<Dims_>(t, kernel_extents, tap);
+                            for (size_t d = 0; d + 1 < Dims_; ++d) {
+                                src_outer[d] = outer[d] + tap[d] - anchor[d];
+                            }
+                            const SrcTy_* const src_row = details::stencil_row_(src, src_outer);
+                            const KernelTy_* const weights_row = weights.data() + t * kernel_width;
+                            acc_type* const acc_ptr = acc.data() + span_begin;
+                            for (size_t dx = 0; dx < kernel_width; ++dx) {
+                                const KernelTy_ w = weights_row[dx];
+                                const SrcTy_* const src_ptr = src_row + (span_begin + dx - anchor[Dims_ - 1]);
+                                for (size_t i = 0; i < span_end - span_begin; ++i) {
+                                    acc_ptr[i] += w * src_ptr[i];
+                                }
+                            }
+                        }
+                        for (size_t x = span_begin; x < span_end; ++x) {
+                            dst_row[x] = static_cast<DstTy_>(acc[x]);
+                        }
+                    }
+
+                    for (size_t x = 0; x < width; ++x) {
+                        if (x == span_begin) {
+                            x = span_end;
+                            if (x >= width) {
+                                break;
+                            }
+                        }
+                        position[Dims_ - 1] = static_cast<std::ptrdiff_t>(x);
+                        dst_row[x] = static_cast<DstTy_>(details::stencil_border_value_<acc_type>(sampler, src, weights, kernel_extents, anchor, position));
+                    }
+                }
+            };
+            pool.run(tasks, threads, task_function);
+        }
+
+        template <typename Container_>
+        void stencil_check_sizes_(const Container_ & src_dims, const Container_ & dst_dims)
+        {
+            if (src_dims != dst_dims) {
+                throw yato::argument_error("yato::stencil_nd: source and destination have different sizes");
+            }
+        }
+
+    } // namespace details
+
+
+    /**
+     * Applies a dense kernel to every element of src and writes results to dst.
+     * The kernel is centered at size / 2 along every dimension and is applied without flipping, i.e. as correlation.
+     * Taps outside of the source are resolved by the sampler, e.g. yato::sampler_clamp or yato::sampler_zero.
+     * Results are accumulated in the type of kernel * source product and are converted to the destination type with static_cast.
+     * Source and destination must not overlap. Rows are distributed between threads.
+     */
+    template <typename Sampler_, typename SrcContainer_, typename DstContainer_, typename KernelContainer_>
+    void stencil_nd(const parallel_policy & policy, const Sampler_ & sampler, const SrcContainer_ & src, DstContainer_ && dst, const KernelContainer_ & kernel)
+    {
+        constexpr size_t dims = container_traits<SrcContainer_>::dimensions_number;
+        static_assert(dims == container_traits<yato::remove_cvref_t<DstContainer_>>::dimensions_number, "yato::stencil_nd: containers must have equal dimensions number");
+        static_assert(dims == container_traits<KernelContainer_>::dimensions_number, "yato::stencil_nd: kernel must have the same dimensions number as containers");
+        using src_value = typename container_traits<SrcContainer_>::value_type;
+        using dst_value = typename container_traits<yato::remove_cvref_t<DstContainer_>>::value_type;
+        using kernel_value = typename container_traits<KernelContainer_>::value_type;
+
+        const auto src_view = details::stencil_view_<const src_value, dims>(src);
+        const auto dst_view = details::stencil_view_<dst_value, dims>(dst);
+        const auto kernel_view = details::stencil_view_<const kernel_value, dims>(kernel);
+        details::stencil_check_sizes_(src_view.dimensions(), dst_view.dimensions());
+
+        std::array<size_t, dims> kernel_extents{};
+        for (size_t d = 0; d < dims; ++d) {
+            kernel_extents[d] = kernel_view.size(d);
+            if (kernel_extents[d] == 0) {
+                throw yato::argument_error("yato::stencil_nd: kernel is empty");
+            }
+        }
+        // Pack the kernel densely
+        std::vector<std::remove_cv_t<kernel_value>> weights;
+        weights.reserve(kernel_view.total_size());
+        const size_t kernel_rows = kernel_view.total_size() / kernel_extents[dims - 1];
+        std::array<size_t, dims> row_index{};
+        for (size_t r = 0; r < kernel_rows; ++r) {
+            details::stencil_unflatten_<dims>(r, kernel_extents, row_index);
+            const kernel_value* row = details::stencil_row_(kernel_view, row_index);
+            weights.insert(weights.end(), row, row + kernel_extents[dims - 1]);
+        }
+        details::stencil_apply_(policy, sampler, src_view, dst_view, weights, kernel_extents);
+    }
+
+    template <typename Sampler_, typename SrcContainer_, typename DstContainer_, typename KernelContainer_>
+    void stencil_nd(const Sampler_ & sampler, const SrcContainer_ & src, DstContainer_ && dst, const KernelContainer_ & kernel)
+    {
+        stencil_nd(parallel_policy{}, sampler, src, std::forward<DstContainer_>(dst), kernel);
+    }
+
+
+    /**
+     * Applies a separable kernel, given by 1D weights for every dimension, as a sequence of 1D passes.
+     * The result equals to stencil_nd() with the outer product of weights for samplers, which resolve every dimension independently,
+     * such as yato::sampler_clamp or yato::sampler_zero.
+     * Intermediate passes are stored in the accumulator type.
+     */
+    template <typename Sampler_, typename SrcContainer_, typename DstContainer_, typename KernelTy_, typename KernelAllocator_, size_t Dims_>
+    void stencil_separable_nd(const parallel_policy & policy, const Sampler_ & sampler, const SrcContainer_ & src, DstContainer_ && dst,
+        const std::array<std::vector<KernelTy_, KernelAllocator_>, Dims_> & kernels)
+    {
+        constexpr size_t dims = container_traits<SrcContainer_>::dimensions_number;
+        static_assert(dims == Dims_, "yato::stencil_separable_nd: kernel must have weights for every dimension");
+        static_assert(dims == container_traits<yato::remove_cvref_t<DstContainer_>>::dimensions_number, "yato::stencil_separable_nd: containers must have equal dimensions number");
+        using src_value = typename container_traits<SrcContainer_>::value_type;
+        using dst_value = typename container_traits<yato::remove_cvref_t<DstContainer_>>::value_type;
+        using acc_type = details::stencil_accumulator_t<KernelTy_, src_value>;
+
+        const auto src_view = details::stencil_view_<const src_value, dims>(src);
+        const auto dst_view = details::stencil_view_<dst_value, dims>(dst);
+        details::stencil_check_sizes_(src_view.dimensions(), dst_view.dimensions());
+        for (const auto & k : kernels) {
+            if (k.empty()) {
+                throw yato::argument_error("yato::stencil_separable_nd: kernel is empty");
+            }
+        }
+
+        const auto pass_extents = [&kernels](size_t dim) {
+            std::array<size_t, dims> res{};
+            res.fill(1);
+            res[dim] = kernels[dim].size();
+            return res;
+        };
+        const auto pass_weights = [&kernels](size_t dim) {
+            return std::vector<KernelTy_>(kernels[dim].cbegin(), kernels[dim].cend());
+        };
+
+        // Innermost dimension first, the last pass writes to the destination
+        yato::vector_nd<acc_type, dims> buffer(src_view.dimensions(), yato::uninitialized);
+        details::stencil_apply_(policy, sampler, src_view, buffer.view(), pass_weights(dims - 1), pass_extents(dims - 1));
+        yato::vector_nd<acc_type, dims> buffer_next;
+        if (dims > 2) {
+            buffer_next = yato::vector_nd<acc_type, dims>(src_view.dimensions(), yato::uninitialized);
+        }
+        for (size_t d = dims - 1; d-- > 1;) {
+            details::stencil_apply_(policy, sampler, yato::array_view_nd<const acc_type, dims>(buffer.cview()), buffer_next.view(), pass_weights(d), pass_extents(d));
+            buffer.swap(buffer_next);
+        }
+        details::stencil_apply_(policy, sampler, yato::array_view_nd<const acc_type, dims>(buffer.cview()), dst_view, pass_weights(0), pass_extents(0));
+    }
+
+    template <typename Sampler_, typename SrcContainer_, typename DstContainer_, typename KernelTy_, typename KernelAllocator_, size_t Dims_>
+    void stencil_separable_nd(const Sampler_ & sampler, const SrcContainer_ & src, DstContainer_ && dst, const std::array<std::vector<KernelTy_, KernelAllocator_>, Dims_> & kernels)
+    {
+        stencil_separable_nd(parallel_policy{}, sampler, src, std::forward<DstContainer_>(dst), kernels);
+    }
+
+} // namespace yato
+
+#endif // _YATO_STENCIL_ND_H_
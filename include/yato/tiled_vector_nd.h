@@ -0,0 +1,598 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_TILED_VECTOR_ND_H_
+#define _YATO_TILED_VECTOR_ND_H_
+
+#include <array>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "assertion.h"
+#include "array_view.h"
+#include "container_base.h"
+#include "container_nd.h"
+
+namespace yato
+{
+
+    namespace details
+    {
+        YATO_CONSTEXPR_FUNC
+        bool tiled_is_power_of_two_(size_t x)
+        {
+            return (x != 0) && ((x & (x - 1)) == 0);
+        }
+
+        YATO_CONSTEXPR_FUNC
+        size_t tiled_log2_(size_t x)
+        {
+            return (x <= 1) ? 0 : 1 + tiled_log2_(x >> 1);
+        }
+
+        /**
+         * Access to a tiled container with Depth_ indexes fixed.
+         */
+        template <typename Container_, size_t Depth_>
+        class tiled_proxy_;
+
+        /**
+         * Iterates sub-proxies or elements of a tiled proxy.
+         */
+        template <typename Proxy_>
+        class tiled_iterator_
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using reference  = decltype(std::declval<const Proxy_&>()[0]);
+            using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+            using difference_type = std::ptrdiff_t;
+            using pointer    = std::add_pointer_t<std::remove_reference_t<reference>>;
+
+        private:
+            Proxy_ m_owner;
+            size_t m_idx = 0;
+
+        public:
+            tiled_iterator_(const Proxy_ & owner, size_t idx)
+                : m_owner(owner), m_idx(idx)
+            { }
+
+            reference operator*() const
+            {
+                return m_owner[m_idx];
+            }
+
+            tiled_iterator_ & operator++()
+            {
+                ++m_idx;
+                return *this;
+            }
+
+            tiled_iterator_ operator++(int)
+            {
+                tiled_iterator_ tmp(*this);
+                ++m_idx;
+                return tmp;
+            }
+
+            friend
+            bool operator==(const tiled_iterator_ & one, const tiled_iterator_ & another)
+            {
+                return one.m_idx == another.m_idx;
+            }
+
+            friend
+            bool operator!=(const tiled_iterator_ & one, const tiled_iterator_ & another)
+            {
+                return one.m_idx != another.m_idx;
+            }
+        };
+
+        template <typename Container_, size_t Depth_>
+        class tiled_proxy_
+        {
+        private:
+            using container_type = Container_;
+            using this_type = tiled_proxy_<Container_, Depth_>;
+
+        public:
+            static YATO_CONSTEXPR_VAR size_t dimensions_number = std::remove_const_t<Container_>::dimensions_number - Depth_;
+            using value_type = typename std::remove_const_t<Container_>::value_type;
+            using size_type  = size_t;
+            using container_category = yato::container_generic_tag;
+
+            using value_reference = std::conditional_t<std::is_const<Container_>::value, const value_type&, value_type&>;
+            using const_value_reference = const value_type&;
+            using reference = std::conditional_t<(dimensions_number > 1), tiled_proxy_<Container_, Depth_ + 1>, value_reference>;
+            using const_reference = std::conditional_t<(dimensions_number > 1), tiled_proxy_<const Container_, Depth_ + 1>, const_value_reference>;
+            using iterator = tiled_iterator_<this_type>;
+            using const_iterator = iterator;
+
+        private:
+            container_type* m_container;
+            // Storage offset of the fixed indexes
+            size_t m_offset;
+            //-------------------------------------------------------
+
+            reference subscript_(size_t idx, std::true_type /*sub proxy*/) const
+            {
+                return reference(m_container, m_offset + m_container->template dim_offset_<Depth_>(idx));
+            }
+
+            reference subscript_(size_t idx, std::false_type /*element*/) const
+            {
+                return m_container->element_(m_offset + m_container->template dim_offset_<Depth_>(idx));
+            }
+
+        public:
+            tiled_proxy_(container_type* container, size_t offset)
+                : m_container(container), m_offset(offset)
+            { }
+
+            size_type size(size_t idx = 0) const
+            {
+                YATO_REQUIRES(idx < dimensions_number);
+                return m_container->size(Depth_ + idx);
+            }
+
+            reference operator[](size_t idx) const
+            {
+                YATO_REQUIRES(idx < size(0));
+                return subscript_(idx, std::integral_constant<bool, (dimensions_number > 1)>{});
+            }
+
+            iterator begin() const
+            {
+                return iterator(*this, 0);
+            }
+
+            iterator end() const
+            {
+                return iterator(*this, size(0));
+            }
+
+            const_iterator cbegin() const
+            {
+                return begin();
+            }
+
+            const_iterator cend() const
+            {
+                return end();
+            }
+        };
+
+    } // namespace details
+
+
+    /**
+     * Multidimensional vector storing fixed size tiles contiguously.
+     * Neighbours along every dimension are likely to share a cache line and a page, which makes column and neighbourhood access cheap.
+     * Tile extents must be powers of two. Tiles on the border are padded, so the storage size is rounded up to whole tiles.
+     */
+    template <typename Ty_, size_t DimensionsNum_, size_t... TileExtents_>
+    class tiled_vector_nd
+    {
+        static_assert(DimensionsNum_ > 1, "yato::tiled_vector_nd: at least two dimensions are required");
+        static_assert(sizeof...(TileExtents_) == DimensionsNum_, "yato::tiled_vector_nd: tile extents must be given for all dimensions");
+
+    private:
+        using this_type = tiled_vector_nd<Ty_, DimensionsNum_, TileExtents_...>;
+        using indexes_type = std::array<size_t, DimensionsNum_>;
+
+        template <typename, size_t>
+        friend class details::tiled_proxy_;
+
+    public:
+        static YATO_CONSTEXPR_VAR size_t dimensions_number = DimensionsNum_;
+        static YATO_CONSTEXPR_VAR size_t tile_size = (TileExtents_ * ...);
+
+        using value_type = Ty_;
+        using size_type  = size_t;
+        using allocator_type  = std::allocator<Ty_>;
+        using dimensions_type = dimensionality<dimensions_number, size_t>;
+        using container_category = yato::container_generic_tag;
+
+        using value_reference = value_type&;
+        using const_value_reference = const value_type&;
+        using reference       = details::tiled_proxy_<this_type, 1>;
+        using const_reference = details::tiled_proxy_<const this_type, 1>;
+        using iterator        = details::tiled_iterator_<details::tiled_proxy_<this_type, 0>>;
+        using const_iterator  = details::tiled_iterator_<details::tiled_proxy_<const this_type, 0>>;
+
+        using tile_view_type       = array_view_nd<value_type, dimensions_number>;
+        using const_tile_view_type = array_view_nd<const value_type, dimensions_number>;
+
+    private:
+        static YATO_CONSTEXPR_VAR indexes_type s_tile_extents = { TileExtents_... };
+        static YATO_CONSTEXPR_VAR indexes_type s_tile_shifts  = { details::tiled_log2_(TileExtents_)... };
+        static_assert((details::tiled_is_power_of_two_(TileExtents_) && ...), "yato::tiled_vector_nd: tile extents must be powers of two");
+
+        dimensions_type m_extents{};
+        dimensions_type m_tiles{};
+        // Elements between neighbour tiles along each dimension
+        indexes_type m_tile_strides{};
+        std::vector<value_type> m_storage;
+        //-------------------------------------------------------
+
+        static YATO_CONSTEXPR_FUNC_CXX14
+        size_t inner_stride_(size_t dim)
+        {
+            size_t stride = 1;
+            for (size_t d = dim + 1; d < dimensions_number; ++d) {
+                stride *= s_tile_extents[d];
+            }
+            return stride;
+        }
+
+        void init_layout_(const dimensions_type & extents)
+        {
+            m_extents = extents;
+            size_t stride = tile_size;
+            for (size_t d = dimensions_number; d > 0; --d) {
+                m_tiles[d - 1] = (extents[d - 1] + s_tile_extents[d - 1] - 1) >> s_tile_shifts[d - 1];
+                m_tile_strides[d - 1] = stride;
+                stride *= m_tiles[d - 1];
+            }
+        }
+
+        size_t storage_size_() const
+        {
+            return m_tiles.total_size() * tile_size;
+        }
+
+        /**
+         * Contribution of the index along the dimension to the storage offset
+         */
+        template <size_t Dim_>
+        YATO_FORCED_INLINE
+        size_t dim_offset_(size_t idx) const
+        {
+            YATO_REQUIRES(idx < m_extents[Dim_]);
+            YATO_CONSTEXPR_VAR size_t shift = std::get<Dim_>(s_tile_shifts);
+            YATO_CONSTEXPR_VAR size_t mask  = std::get<Dim_>(s_tile_extents) - 1;
+            YATO_CONSTEXPR_VAR size_t inner = inner_stride_(Dim_);
+            return (idx >> shift) * m_tile_strides[Dim_] + (idx & mask) * inner;
+        }
+
+        value_reference element_(size_t offset)
+        {
+            return m_storage[offset];
+        }
+
+        const_value_reference element_(size_t offset) const
+        {
+            return m_storage[offset];
+        }
+
+        template <typename Pointer_, typename View_>
+        View_ tile_view_(Pointer_ ptr, const indexes_type & tile) const
+        {
+            dimensions_type extents;
+            for (size_t d = 0; d < dimensions_number; ++d) {
+                YATO_REQUIRES(tile[d] < m_tiles[d]);
+                extents[d] = std::min(s_tile_extents[d], m_extents[d] - (tile[d] << s_tile_shifts[d]));
+            }
+            size_t offset = 0;
+            for (size_t d = 0; d < dimensions_number; ++d) {
+                offset += tile[d] * m_tile_strides[d];
+            }
+            return View_(ptr + offset, extents, typename View_::element_strides_type(yato::make_range(std::next(s_tile_extents.cbegin()), s_tile_extents.cend())));
+        }
+
+        template <typename Func_, typename Self_>
+        static
+        void for_each_tile_(Self_ & self, Func_ && func)
+        {
+            if (self.m_storage.empty()) {
+                return;
+            }
+            indexes_type tile{};
+            indexes_type origin{};
+            for (;;) {
+                for (size_t d = 0; d < dimensions_number; ++d) {
+                    origin[d] = tile[d] << s_tile_shifts[d];
+                }
+                func(dimensions_type(yato::make_range(origin.cbegin(), origin.cend())), self.tile(tile));
+                size_t d = dimensions_number;
+                while (d > 0) {
+                    --d;
+                    if (++tile[d] < self.m_tiles[d]) {
+                        break;
+                    }
+                    tile[d] = 0;
+                    if (d == 0) {
+                        return;
+                    }
+                }
+            }
+        }
+
+    public:
+        tiled_vector_nd() = default;
+
+        /**
+         * Creates value-initialized vector
+         */
+        explicit
+        tiled_vector_nd(const dimensions_type & extents)
+        {
+            init_layout_(extents);
+            m_storage.resize(storage_size_());
+        }
+
+        tiled_vector_nd(const dimensions_type & extents, const value_type & value)
+        {
+            init_layout_(extents);
+            m_storage.resize(storage_size_(), value);
+        }
+
+        /**
+         * Copies elements from a row-major view
+         */
+        template <typename OtherTy_>
+        explicit
+        tiled_vector_nd(const array_view_nd<OtherTy_, dimensions_number> & src)
+            : tiled_vector_nd(src.dimensions())
+        {
+            assign(src);
+        }
+
+        tiled_vector_nd(const tiled_vector_nd&) = default;
+        tiled_vector_nd(tiled_vector_nd&&) noexcept = default;
+
+        tiled_vector_nd& operator=(const tiled_vector_nd&) = default;
+        tiled_vector_nd& operator=(tiled_vector_nd&&) noexcept = default;
+
+        ~tiled_vector_nd() = default;
+
+        const dimensions_type & dimensions() const
+        {
+            return m_extents;
+        }
+
+        size_type size(size_t idx) const
+        {
+            YATO_REQUIRES(idx < dimensions_number);
+            return m_extents[idx];
+        }
+
+        size_type total_size() const
+        {
+            return m_extents.total_size();
+        }
+
+        bool empty() const
+        {
+            return total_size() == 0;
+        }
+
+        /**
+         * Tile extents
+         */
+        static
+        dimensions_type tile_dimensions()
+        {
+            return dimensions_type(TileExtents_...);
+        }
+
+        /**
+         * Number of tiles along each dimension
+         */
+        const dimensions_type & tiles_dimensions() const
+        {
+            return m_tiles;
+        }
+
+        /**
+         * Raw storage in tile order, including padding of border tiles
+         */
+        value_type* data()
+        {
+            return m_storage.data();
+        }
+
+        const value_type* cdata() const
+        {
+            return m_storage.data();
+        }
+
+        size_type storage_size() const
+        {
+            return m_storage.size();
+        }
+
+        /**
+         *  Element access without bounds check in release
+         */
+        reference operator[](size_t idx)
+        {
+            return details::tiled_proxy_<this_type, 0>(this, 0)[idx];
+        }
+
+        const_reference operator[](size_t idx) const
+        {
+            return details::tiled_proxy_<const this_type, 0>(this, 0)[idx];
+        }
+
+        /**
+         *  Element access with bounds check
+         */
+        template<typename... Indexes_>
+        auto at(Indexes_&&... indexes) const
+            -> std::enable_if_t<(sizeof...(Indexes_) == dimensions_number), const_value_reference>
+        {
+            return yato::at(*this, std::forward<Indexes_>(indexes)...);
+        }
+
+        /**
+         *  Element access with bounds check
+         */
+        template<typename... Indexes_>
+        auto at(Indexes_&&... indexes)
+            -> std::enable_if_t<(sizeof...(Indexes_) == dimensions_number), value_reference>
+        {
+            return yato::at(*this, std::forward<Indexes_>(indexes)...);
+        }
+
+        iterator begin()
+        {
+            return iterator(details::tiled_proxy_<this_type, 0>(this, 0), 0);
+        }
+
+        iterator end()
+        {
+            return iterator(details::tiled_proxy_<this_type, 0>(this, 0), size(0));
+        }
+
+        const_iterator begin() const
+        {
+            return cbegin();
+        }
+
+        const_iterator end() const
+        {
+            return cend();
+        }
+
+        const_iterator cbegin() const
+        {
+            return const_iterator(details::tiled_proxy_<const this_type, 0>(this, 0), 0);
+        }
+
+        const_iterator cend() const
+        {
+            return const_iterator(details::tiled_proxy_<const this_type, 0>(this, 0), size(0));
+        }
+
+        /**
+         * View of the tile elements, which are inside the vector bounds.
+         * @param tile Tile index along each dimension
+         */
+        tile_view_type tile(const indexes_type & tile)
+        {
+            return tile_view_<value_type*, tile_view_type>(m_storage.data(), tile);
+        }
+
+        const_tile_view_type tile(const indexes_type & tile) const
+        {
+            return tile_view_<const value_type*, const_tile_view_type>(m_storage.data(), tile);
+        }
+
+        const_tile_view_type ctile(const indexes_type & tile) const
+        {
+            return this->tile(tile);
+        }
+
+        /**
+         * Calls func(origin, tile_view) for every tile in storage order.
+         * Origin is the index of the first tile element in the vector.
+         */
+        template <typename Func_>
+        void for_each_tile(Func_ && func)
+        {
+            for_each_tile_(*this, std::forward<Func_>(func));
+        }
+
+        template <typename Func_>
+        void for_each_tile(Func_ && func) const
+        {
+            for_each_tile_(*this, std::forward<Func_>(func));
+        }
+
+        /**
+         * Copies elements from a row-major view of the same shape
+         */
+        template <typename OtherTy_>
+        void assign(const array_view_nd<OtherTy_, dimensions_number> & src)
+        {
+            if (src.dimensions() != m_extents) {
+                throw yato::argument_error("yato::tiled_vector_nd[assign]: shape mismatch");
+            }
+            for_each_tile([&src](const dimensions_type & origin, const tile_view_type & dst) {
+                tiled_copy_(dst, src, origin);
+            });
+        }
+
+        /**
+         * Copies elements into a row-major view of the same shape
+         */
+        void copy_to(const array_view_nd<value_type, dimensions_number> & dst) const
+        {
+            if (dst.dimensions() != m_extents) {
+                throw yato::argument_error("yato::tiled_vector_nd[copy_to]: shape mismatch");
+            }
+            for_each_tile([&dst](const dimensions_type & origin, const const_tile_view_type & src) {
+                const auto offset = tiled_offset_view_(dst, origin, src.dimensions());
+                tiled_copy_(offset, src, dimensions_type{});
+            });
+        }
+
+        void swap(tiled_vector_nd & other) noexcept
+        {
+            using std::swap;
+            swap(m_extents, other.m_extents);
+            swap(m_tiles, other.m_tiles);
+            swap(m_tile_strides, other.m_tile_strides);
+            m_storage.swap(other.m_storage);
+        }
+
+    private:
+        /**
+         * Sub-view of the given extents starting at origin
+         */
+        template <typename OtherTy_>
+        static
+        array_view_nd<OtherTy_, dimensions_number> tiled_offset_view_(const array_view_nd<OtherTy_, dimensions_number> & view, const dimensions_type & origin, const dimensions_type & extents)
+        {
+            const auto strides = view.strides();
+            const char* ptr = reinterpret_cast<const char*>(view.cdata());
+            for (size_t d = 0; d + 1 < dimensions_number; ++d) {
+                ptr += origin[d] * strides[d];
+            }
+            ptr += origin[dimensions_number - 1] * sizeof(OtherTy_);
+            return array_view_nd<OtherTy_, dimensions_number>(reinterpret_cast<OtherTy_*>(const_cast<char*>(ptr)), extents, strides);
+        }
+
+        template <typename DstView_, typename OtherTy_>
+        static
+        void tiled_copy_(const DstView_ & dst, const array_view_nd<OtherTy_, dimensions_number> & src, const dimensions_type & origin)
+        {
+            const auto from = tiled_offset_view_(src, origin, dst.dimensions());
+            tiled_copy_rows_(dst, from, std::integral_constant<size_t, dimensions_number>{});
+        }
+
+        template <typename DstProxy_, typename SrcProxy_>
+        static
+        void tiled_copy_rows_(const DstProxy_ & dst, const SrcProxy_ & src, std::integral_constant<size_t, 1>)
+        {
+            std::copy(src.cbegin(), src.cend(), dst.begin());
+        }
+
+        template <typename DstProxy_, typename SrcProxy_, size_t Dims_>
+        static
+        void tiled_copy_rows_(const DstProxy_ & dst, const SrcProxy_ & src, std::integral_constant<size_t, Dims_>)
+        {
+            for (size_t i = 0; i < dst.size(0); ++i) {
+                tiled_copy_rows_(dst[i], src[i], std::integral_constant<size_t, Dims_ - 1>{});
+            }
+        }
+    };
+
+    template <typename Ty_, size_t TileHeight_ = 16, size_t TileWidth_ = 16>
+    using tiled_vector_2d = tiled_vector_nd<Ty_, 2, TileHeight_, TileWidth_>;
+
+    template <typename Ty_, size_t TileDepth_ = 8, size_t TileHeight_ = 8, size_t TileWidth_ = 8>
+    using tiled_vector_3d = tiled_vector_nd<Ty_, 3, TileDepth_, TileHeight_, TileWidth_>;
+
+} // namespace yato
+
+#endif // _YATO_TILED_VECTOR_ND_H_
@@ -11,6 +11,7 @@
 #include <array>
 #include <vector>
 
+#include "aligning_allocator.h"
 #include "array_proxy.h"
 #include "array_view.h"
 #include "assertion.h"
@@ -68,6 +69,33 @@ namespace yato
             }
         };
 
+        /**
+         * Elements are stored densely, rows follow each other without gaps.
+         */
+        struct dense_layout_policy
+        { };
+
+        /**
+         * The innermost dimension is padded, so that every row starts on RowAlignment_ bytes boundary
+         * if the allocator returns storage aligned at least to RowAlignment_.
+         */
+        template <size_t RowAlignment_>
+        struct padded_layout_policy
+        {
+            static_assert((RowAlignment_ != 0) && !(RowAlignment_ & (RowAlignment_ - 1)), "Row alignment should be a power of 2");
+
+            static YATO_CONSTEXPR_VAR size_t row_alignment = RowAlignment_;
+
+            /**
+             * Row pitch in bytes for the row of the given length.
+             */
+            static YATO_CONSTEXPR_FUNC
+            size_t row_pitch(size_t row_bytes)
+            {
+                return (row_bytes + row_alignment - 1) & ~(row_alignment - 1);
+            }
+        };
+
         //-------------------------------------------------------
         //
 
@@ -191,6 +219,21 @@ namespace yato
                 m_allocated_size = allocated_size;
             }
 
+            /**
+             * Allocate without constructing elements. Only for trivial types.
+             * Current state should be empty
+             */
+            void init_uninitialized(size_t plain_size)
+            {
+                static_assert(std::is_trivially_default_constructible<value_type>::value && std::is_trivially_destructible<value_type>::value,
+                    "yato::vector_nd: uninitialized storage requires a trivial value type");
+                YATO_REQUIRES(ptr() == nullptr);
+                if (plain_size != 0) {
+                    ptr() = memory::allocate(allocator(), plain_size);
+                    m_allocated_size = plain_size;
+                }
+            }
+
             /**
              * Allocater and value-initialize.
              * Current state should be empty
@@ -556,9 +599,11 @@ namespace yato
         //-------------------------------------------------------
         // Generic implementation
 
-        template <typename _DataType, size_t _DimensionsNum, typename _Allocator, typename CapacityPolicy_ = details::default_capacity_policy>
+        template <typename _DataType, size_t _DimensionsNum, typename _Allocator, typename CapacityPolicy_ = details::default_capacity_policy, typename LayoutPolicy_ = details::dense_layout_policy>
         class vector_nd_impl
         {
+            static_assert(std::is_same<LayoutPolicy_, details::dense_layout_policy>::value, "yato::vector_nd: unknown layout policy");
+
         public:
             /*
              * Public traits of the multidimensional vector
@@ -929,6 +974,16 @@ namespace yato
                 }
             }
 
+            /**
+             *  Create without constructing elements. Only for trivial types, the content is indeterminate.
+             */
+            vector_nd_impl(const dimensions_type & sizes, yato::uninitialized_t, const allocator_type & alloc = allocator_type())
+                : m_raw_vector(alloc)
+            {
+                init_sizes_(sizes);
+                m_raw_vector.init_uninitialized(total_size());
+            }
+
             /**
              *  Create from a range of elements
              *  Amount of elements in the range [first, last) should exactly match the given sizes 
@@ -1066,6 +1121,34 @@ namespace yato
                 return *this;
             }
 
+            /**
+             *  Evaluate lazy expression. See expression_nd.h
+             */
+            template <typename Expression_, typename = 
+                std::enable_if_t<yato::is_expression_nd<Expression_>::value>>
+            explicit
+            vector_nd_impl(const Expression_ & expression)
+                : vector_nd_impl(expression.dimensions())
+            {
+                expression.evaluate_to(*this);
+            }
+
+            /**
+             *  Evaluate lazy expression. The storage is reused if the shape is unchanged.
+             *  In the case of exception the content is unspecified.
+             */
+            template <typename Expression_, typename = 
+                std::enable_if_t<yato::is_expression_nd<Expression_>::value>>
+            vector_nd_impl & operator= (const Expression_ & expression)
+            {
+                const auto extents = expression.dimensions();
+                if (dimensions() != extents) {
+                    this_type{ extents }.swap(*this);
+                }
+                expression.evaluate_to(*this);
+                return *this;
+            }
+
             /**
              *  Copy from proxy
              */
@@ -1960,7 +2043,7 @@ namespace yato
 
             //------------------------------------------------------------
 
-            template <typename, size_t, typename, typename>
+            template <typename, size_t, typename, typename, typename>
             friend class vector_nd_impl;
         };
 
@@ -1975,7 +2058,7 @@ namespace yato
         // More specific implementation with full std::vector interface
 
         template <typename _DataType, typename _Allocator, typename CapacityPolicy_>
-        class vector_nd_impl<_DataType, 1, _Allocator, CapacityPolicy_>
+        class vector_nd_impl<_DataType, 1, _Allocator, CapacityPolicy_, details::dense_layout_policy>
         {
         public:
             /*
@@ -2125,6 +2208,15 @@ namespace yato
                 m_raw_vector.init_from_value(m_size, value);
             }
 
+            /**
+             *  Create without constructing elements. Only for trivial types, the content is indeterminate.
+             */
+            vector_nd_impl(const dimensions_type & sizes, yato::uninitialized_t, const allocator_type & alloc = allocator_type())
+                : m_raw_vector(alloc), m_size(sizes[0])
+            {
+                m_raw_vector.init_uninitialized(m_size);
+            }
+
             /**
              *  Create from a range of elements
              *  Amount of elements in the range [first, last) should exactly match the given sizes
@@ -2272,6 +2364,34 @@ namespace yato
                 return *this;
             }
 
+            /**
+             *  Evaluate lazy expression. See expression_nd.h
+             */
+            template <typename Expression_, typename = 
+                std::enable_if_t<yato::is_expression_nd<Expression_>::value>>
+            explicit
+            vector_nd_impl(const Expression_ & expression)
+                : vector_nd_impl(expression.dimensions())
+            {
+                expression.evaluate_to(*this);
+            }
+
+            /**
+             *  Evaluate lazy expression. The storage is reused if the shape is unchanged.
+             *  In the case of exception the content is unspecified.
+             */
+            template <typename Expression_, typename = 
+                std::enable_if_t<yato::is_expression_nd<Expression_>::value>>
+            vector_nd_impl & operator= (const Expression_ & expression)
+            {
+                const auto extents = expression.dimensions();
+                if (dimensions() != extents) {
+                    this_type{ extents }.swap(*this);
+                }
+                expression.evaluate_to(*this);
+                return *this;
+            }
+
             /**
              *  Assign from std::vector
              */
@@ -3142,57 +3262,637 @@ namespace yato
 
             //------------------------------------------------------------
 
-            template <typename, size_t, typename, typename>
+            template <typename, size_t, typename, typename, typename>
             friend class vector_nd_impl;
         };
 
-    }
 
-    template <typename DataType_, size_t DimensionsNum_,
-        typename Allocator_ = std::allocator<DataType_>,
-        typename CapacityPolicy_ = details::default_capacity_policy
-    >
-    using vector_nd = details::vector_nd_impl<DataType_, DimensionsNum_, Allocator_, CapacityPolicy_>;
 
-    template <typename DataType_,
-        typename Allocator_ = std::allocator<DataType_>,
-        typename CapacityPolicy_ = details::default_capacity_policy
-    >
-    using vector_1d = vector_nd<DataType_, 1, Allocator_, CapacityPolicy_>;
+        //-------------------------------------------------------
+        // Implementation of the padded layout
+        // Every row of the innermost dimension starts on the aligned boundary, the gap after a row is filled by value-initialized elements.
+        // Only operations preserving the rows layout are provided, i.e. no plain iteration and no push/insert/erase.
 
-    template <typename DataType_,
-        typename Allocator_ = std::allocator<DataType_>,
-        typename CapacityPolicy_ = details::default_capacity_policy
-    >
-    using vector = vector_nd<DataType_, 1, Allocator_, CapacityPolicy_>;
+        template <typename _DataType, size_t _DimensionsNum, typename _Allocator, typename CapacityPolicy_, size_t RowAlignment_>
+        class vector_nd_impl<_DataType, _DimensionsNum, _Allocator, CapacityPolicy_, details::padded_layout_policy<RowAlignment_>>
+        {
+        public:
+            /*
+             * Public traits of the multidimensional vector
+             */
+            using this_type = vector_nd_impl<_DataType, _DimensionsNum, _Allocator, CapacityPolicy_, details::padded_layout_policy<RowAlignment_>>;
+            using layout_policy = details::padded_layout_policy<RowAlignment_>;
+            using dimensions_type = dimensionality<_DimensionsNum, size_t>;
+            using value_type = _DataType;
+            using size_type = std::size_t;
+            using allocator_type = _Allocator;
 
-    template <typename DataType_,
-        typename Allocator_ = std::allocator<DataType_>,
-        typename CapacityPolicy_ = details::default_capacity_policy
-    >
-    using vector_2d = vector_nd<DataType_, 2, Allocator_, CapacityPolicy_>;
+            using dim_descriptor = dimension_descriptor_strided<size_type>;
 
-    template <typename DataType_, 
-        typename Allocator_ = std::allocator<DataType_>,
-        typename CapacityPolicy_ = details::default_capacity_policy
-    >
-    using vector_3d = vector_nd<DataType_, 3, Allocator_, CapacityPolicy_>;
+            static YATO_CONSTEXPR_VAR size_t dimensions_number = _DimensionsNum;
+            static_assert(dimensions_number > 1, "Padded layout is implemented for dimensions number larger than 1");
 
-    template <typename DataType_,
-        typename Allocator_ = std::allocator<DataType_>,
-        typename CapacityPolicy_ = details::default_capacity_policy
-    >
-    using vector_4d = vector_nd<DataType_, 4, Allocator_, CapacityPolicy_>;
+            static YATO_CONSTEXPR_VAR size_t row_alignment = layout_policy::row_alignment;
+            static_assert(row_alignment % sizeof(value_type) == 0, "Row alignment should be a multiple of the element size");
+            //-------------------------------------------------------
+
+        private:
+            using alloc_traits = std::allocator_traits<allocator_type>;
+
+            using sub_proxy       = proxy_nd<value_type,                   dim_descriptor, dimensions_number - 1>;
+            using const_sub_proxy = proxy_nd<std::add_const_t<value_type>, dim_descriptor, dimensions_number - 1>;
+
+        public:
+            using iterator       = iterator_nd<sub_proxy>;
+            using const_iterator = iterator_nd<const_sub_proxy>;
+
+            using reference       = sub_proxy;
+            using const_reference = const_sub_proxy;
+
+            using value_reference       = std::add_lvalue_reference_t<value_type>;
+            using const_value_reference = std::add_lvalue_reference_t<std::add_const_t<value_type>>;
+
+            //-------------------------------------------------------
+
+        private:
+            using descriptors_array = std::array<dim_descriptor::type, dimensions_number>;
+            using plain_iterator_       = std::add_pointer_t<value_type>;
+            using const_plain_iterator_ = std::add_pointer_t<std::add_const_t<value_type>>;
+
+            descriptors_array m_descriptors = {};
+            raw_vector<value_type, allocator_type, CapacityPolicy_> m_raw_vector;
+            //-------------------------------------------------------
+
+            /**
+             * The innermost offset is the row pitch, outer offsets are multiples of it.
+             */
+            static
+            descriptors_array make_descriptors_(const dimensions_type & extents) YATO_NOEXCEPT_KEYWORD
+            {
+                descriptors_array descriptors;
+                const size_t row_pitch = layout_policy::row_pitch(extents[dimensions_number - 1] * sizeof(value_type));
+                descriptors[dimensions_number - 1] = std::make_tuple(extents[dimensions_number - 1], extents[dimensions_number - 1], row_pitch);
+                for (size_t i = dimensions_number - 1; i > 0; --i) {
+                    descriptors[i - 1] = std::make_tuple(
+                        extents[i - 1],
+                        extents[i - 1] * std::get<dim_descriptor::idx_total>(descriptors[i]),
+                        extents[i - 1] * std::get<dim_descriptor::idx_offset>(descriptors[i]));
+                }
+                return descriptors;
+            }
+
+            static
+            size_t storage_size_(const descriptors_array & descriptors) YATO_NOEXCEPT_KEYWORD
+            {
+                return std::get<dim_descriptor::idx_offset>(descriptors[0]) / sizeof(value_type);
+            }
+
+            sub_proxy create_proxy_(size_t offset) YATO_NOEXCEPT_KEYWORD
+            {
+                plain_iterator_ ptr = m_raw_vector.ptr();
+                details::advance_bytes(ptr, offset * std::get<dim_descriptor::idx_offset>(m_descriptors[1]));
+                return sub_proxy(ptr, &m_descriptors[1]);
+            }
+
+            const_sub_proxy create_const_proxy_(size_t offset) const YATO_NOEXCEPT_KEYWORD
+            {
+                const_plain_iterator_ ptr = m_raw_vector.ptr();
+                details::advance_bytes(ptr, offset * std::get<dim_descriptor::idx_offset>(m_descriptors[1]));
+                return const_sub_proxy(ptr, &m_descriptors[1]);
+            }
+
+            template <typename Dst_, typename Src_>
+            static
+            auto copy_rows_(Dst_ && dst, const Src_ & src)
+                -> std::enable_if_t<(yato::remove_cvref_t<Src_>::dimensions_number > 1)>
+            {
+                for (size_t i = 0; i < src.size(0); ++i) {
+                    copy_rows_(dst[i], src[i]);
+                }
+            }
+
+            template <typename Dst_, typename Src_>
+            static
+            auto copy_rows_(Dst_ && dst, const Src_ & src)
+                -> std::enable_if_t<(yato::remove_cvref_t<Src_>::dimensions_number == 1)>
+            {
+                std::copy(src.cbegin(), src.cend(), dst.begin());
+            }
+
+            void destroy_()
+            {
+                const size_t size = storage_size();
+                if(size != 0) {
+                    value_type* ptr = m_raw_vector.ptr();
+                    YATO_ASSERT(ptr != nullptr, "Invalid state");
+                    memory::destroy(m_raw_vector.allocator(), ptr, ptr + size);
+                }
+            }
+
+        public:
+            /**
+             *  Create empty vector
+             */
+            vector_nd_impl() = default;
+
+            /**
+             *  Create empty vector
+             */
+            explicit
+            vector_nd_impl(const allocator_type & alloc)
+                : m_raw_vector(alloc)
+            { }
+
+            /**
+             *  Create with value-initialized elements
+             */
+            explicit
+            vector_nd_impl(const dimensions_type & sizes, const allocator_type & alloc = allocator_type())
+                : m_descriptors(make_descriptors_(sizes))
+                , m_raw_vector(alloc)
+            {
+                const size_t stored_size = storage_size();
+                if(stored_size != 0) {
+                    m_raw_vector.init_from_value(stored_size);
+                }
+            }
+
+            /**
+             *  Create with initialization. Padding is initialized with the same value.
+             */
+            vector_nd_impl(const dimensions_type & sizes, const value_type & value, const allocator_type & alloc = allocator_type())
+                : m_descriptors(make_descriptors_(sizes))
+                , m_raw_vector(alloc)
+            {
+                const size_t stored_size = storage_size();
+                if(stored_size != 0) {
+                    m_raw_vector.init_from_value(stored_size, value);
+                }
+            }
+
+            /**
+             *  Create without constructing elements. Only for trivial types, the content and padding are indeterminate.
+             */
+            vector_nd_impl(const dimensions_type & sizes, yato::uninitialized_t, const allocator_type & alloc = allocator_type())
+                : m_descriptors(make_descriptors_(sizes))
+                , m_raw_vector(alloc)
+            {
+                m_raw_vector.init_uninitialized(storage_size());
+            }
+
+            /**
+             *  Copy from view
+             */
+            template <typename OtherTy_>
+            explicit
+            vector_nd_impl(const yato::array_view_nd<OtherTy_, dimensions_number> & view, const allocator_type & alloc = allocator_type())
+                : vector_nd_impl(view.dimensions(), alloc)
+            {
+                copy_rows_(this->view(), view);
+            }
+
+            /**
+             *  Copy constructor
+             */
+            vector_nd_impl(const vector_nd_impl & other)
+                : m_descriptors(other.m_descriptors)
+                , m_raw_vector(alloc_traits::select_on_container_copy_construction(other.m_raw_vector.allocator()))
+            {
+                const size_t stored_size = storage_size();
+                if(stored_size != 0) {
+                    m_raw_vector.init_from_range(stored_size, other.m_raw_vector.ptr(), other.m_raw_vector.ptr() + stored_size);
+                }
+            }
+
+            /**
+             *  Move-copy constructor
+             */
+            vector_nd_impl(vector_nd_impl && other) YATO_NOEXCEPT_KEYWORD
+                : m_descriptors(std::move(other.m_descriptors))
+                , m_raw_vector(std::move(other.m_raw_vector))
+            {
+                other.m_descriptors = {};
+            }
+
+            /**
+             *  Copy assign
+             */
+            vector_nd_impl& operator = (const vector_nd_impl & other)
+            {
+                if (this != &other) {
+                    this_type{ other }.swap(*this);
+                }
+                return *this;
+            }
+
+            /**
+             *  Move assign
+             */
+            vector_nd_impl& operator = (vector_nd_impl && other) YATO_NOEXCEPT_KEYWORD
+            {
+                if (this != &other) {
+                    destroy_();
+                    m_raw_vector  = std::move(other.m_raw_vector);
+                    m_descriptors = std::move(other.m_descriptors);
+                    other.m_descriptors = {};
+                }
+                return *this;
+            }
+
+            /**
+             *  Assign from view
+             */
+            template <typename OtherTy_>
+            vector_nd_impl& operator = (const yato::array_view_nd<OtherTy_, dimensions_number> & view)
+            {
+                this_type{ view, get_allocator() }.swap(*this);
+                return *this;
+            }
+
+            /**
+             *  Destructor
+             */
+            ~vector_nd_impl()
+            {
+                destroy_();
+            }
+
+            /**
+             *  Returns the allocator associated with the container
+             */
+            allocator_type get_allocator() const
+            {
+                return m_raw_vector.allocator();
+            }
+
+            /**
+             *  Save swap
+             */
+            void swap(this_type & other) noexcept
+            {
+                YATO_REQUIRES(this != &other);
+                using std::swap;
+                swap(m_descriptors, other.m_descriptors);
+                m_raw_vector.swap(other.m_raw_vector);
+            }
+
+            /**
+             *  Element access without bounds check in release
+             */
+            const_reference operator[](size_t idx) const YATO_NOEXCEPT_KEYWORD
+            {
+                YATO_REQUIRES(idx < size(0));
+                return create_const_proxy_(idx);
+            }
+
+            /**
+             *  Element access without bounds check in release
+             */
+            reference operator[](size_t idx) YATO_NOEXCEPT_KEYWORD
+            {
+                YATO_REQUIRES(idx < size(0));
+                return create_proxy_(idx);
+            }
+
+            /**
+             *  Element access with bounds check
+             */
+            template<typename... Indexes_>
+            auto at(Indexes_&&... indexes) const
+                -> typename std::enable_if<(yato::args_length<Indexes_...>::value == dimensions_number), const_value_reference>::type
+            {
+                return yato::at(*this, std::forward<Indexes_>(indexes)...);
+            }
+
+            /**
+             *  Element access with bounds check
+             */
+            template<typename... Indexes_>
+            auto at(Indexes_&&... indexes)
+                -> typename std::enable_if<(yato::args_length<Indexes_...>::value == dimensions_number), value_reference>::type
+            {
+                return yato::at(*this, std::forward<Indexes_>(indexes)...);
+            }
+
+            /**
+             *  Iterator for accessing sub-array elements along the top dimension
+             */
+            const_iterator cbegin() const YATO_NOEXCEPT_KEYWORD
+            {
+                return static_cast<const_iterator>(create_const_proxy_(static_cast<size_t>(0)));
+            }
+
+            /**
+             *  Iterator for accessing sub-array elements along the top dimension
+             */
+            const_iterator begin() const YATO_NOEXCEPT_KEYWORD
+            {
+                return cbegin();
+            }
+
+            /**
+             *  Iterator for accessing sub-array elements along the top dimension
+             */
+            iterator begin() YATO_NOEXCEPT_KEYWORD
+            {
+                return static_cast<iterator>(create_proxy_(static_cast<size_t>(0)));
+            }
+
+            /**
+             *  Iterator for accessing sub-array elements along the top dimension
+             */
+            const_iterator cend() const YATO_NOEXCEPT_KEYWORD
+            {
+                return static_cast<const_iterator>(create_const_proxy_(size(0)));
+            }
+
+            /**
+             *  Iterator for accessing sub-array elements along the top dimension
+             */
+            const_iterator end() const YATO_NOEXCEPT_KEYWORD
+            {
+                return cend();
+            }
+
+            /**
+             *  Iterator for accessing sub-array elements along the top dimension
+             */
+            iterator end() YATO_NOEXCEPT_KEYWORD
+            {
+                return static_cast<iterator>(create_proxy_(size(0)));
+            }
+
+            /**
+             * Get a raw pointer to stored data beginning
+             */
+            std::add_pointer_t<value_type> data() YATO_NOEXCEPT_KEYWORD
+            {
+                return m_raw_vector.ptr();
+            }
+
+            /**
+             * Get a raw pointer to stored data beginning
+             */
+            std::add_pointer_t<std::add_const_t<value_type>> data() const YATO_NOEXCEPT_KEYWORD
+            {
+                return m_raw_vector.ptr();
+            }
+
+            /**
+             * Get a raw pointer to stored data beginning
+             */
+            std::add_pointer_t<std::add_const_t<value_type>> cdata() const YATO_NOEXCEPT_KEYWORD
+            {
+                return m_raw_vector.ptr();
+            }
+
+            /**
+             * Construct view for the full vector
+             */
+            auto cview() const
+            {
+                return yato::array_view_nd<std::add_const_t<value_type>, dimensions_number>(cproxy());
+            }
+
+            /**
+             * Construct view for the full vector
+             */
+            auto view()
+            {
+                return yato::array_view_nd<value_type, dimensions_number>(proxy());
+            }
+
+            /**
+             * Convert to view for the full vector
+             */
+            operator yato::array_view_nd<std::add_const_t<value_type>, dimensions_number>() const
+            {
+                return cview();
+            }
+
+            /**
+             * Convert to view for the full vector
+             */
+            operator yato::array_view_nd<value_type, dimensions_number>()
+            {
+                return view();
+            }
+
+            /**
+             * Get proxy for the full vector
+             */
+            proxy_nd<std::add_const_t<value_type>, dim_descriptor, dimensions_number> cproxy() const
+            {
+                return proxy_nd<std::add_const_t<value_type>, dim_descriptor, dimensions_number>(m_raw_vector.ptr(), &m_descriptors[0]);
+            }
+
+            /**
+             * Get proxy for the full vector
+             */
+            proxy_nd<value_type, dim_descriptor, dimensions_number> proxy()
+            {
+                return proxy_nd<value_type, dim_descriptor, dimensions_number>(m_raw_vector.ptr(), &m_descriptors[0]);
+            }
+
+            /**
+             *  Checks whether the vector is empty
+             */
+            bool empty() const YATO_NOEXCEPT_KEYWORD
+            {
+                return (size(0) == 0);
+            }
+
+            /**
+             *  Data is continuous only if rows don't need padding
+             */
+            bool continuous() const
+            {
+                return total_size() * sizeof(value_type) == std::get<dim_descriptor::idx_offset>(m_descriptors[0]);
+            }
+
+            /**
+             *  Get dimensions
+             */
+            dimensions_type dimensions() const YATO_NOEXCEPT_KEYWORD
+            {
+                return dimensions_type(dimensions_range());
+            }
+
+            /**
+             *  Get strides in bytes, including padding
+             */
+            strides_array<dimensions_number - 1, size_type> strides() const YATO_NOEXCEPT_KEYWORD
+            {
+                return strides_array<dimensions_number - 1, size_type>(strides_range());
+            }
+
+            /**
+             *  Get number of dimensions
+             */
+            YATO_CONSTEXPR_FUNC_CXX14
+            size_t dimensions_num() const YATO_NOEXCEPT_KEYWORD
+            {
+                return dimensions_number;
+            }
+
+            /**
+             *  Get dimensions range
+             */
+            auto dimensions_range() const
+            {
+                return make_range(m_descriptors).map(tuple_cgetter<dim_descriptor::idx_size>());
+            }
+
+            /**
+             *  Get strides range
+             */
+            auto strides_range() const
+            {
+                return make_range(m_descriptors).tail().map([](const dim_descriptor::type& d){ return dim_descriptor::offset_to_bytes<value_type>(std::get<dim_descriptor::idx_offset>(d)); });
+            }
+
+            /**
+             *  Get size of specified dimension
+             */
+            size_type size(size_t idx) const YATO_NOEXCEPT_KEYWORD
+            {
+                YATO_REQUIRES(idx < dimensions_number);
+                return std::get<dim_descriptor::idx_size>(m_descriptors[idx]);
+            }
+
+            /**
+             * Return stride in bytes. The last stride is the row pitch.
+             */
+            size_type stride(size_t idx) const YATO_NOEXCEPT_KEYWORD
+            {
+                YATO_REQUIRES(idx < dimensions_number - 1);
+                return dim_descriptor::offset_to_bytes<value_type>(std::get<dim_descriptor::idx_offset>(m_descriptors[idx + 1]));
+            }
+
+            /**
+             *  Get the total size of the vector (number of all elements excluding padding)
+             */
+            size_t total_size() const YATO_NOEXCEPT_KEYWORD
+            {
+                return std::get<dim_descriptor::idx_total>(m_descriptors[0]);
+            }
+
+            /**
+             *  Get the number of stored elements including padding
+             */
+            size_t storage_size() const YATO_NOEXCEPT_KEYWORD
+            {
+                return storage_size_(m_descriptors);
+            }
+
+            /**
+             * Resize all vector's extents.
+             * All stored data will become invalid.
+             * In the case of exception the vector remains unchanged.
+             * @param extents desired size of the vector
+             */
+            void resize(const dimensions_type & extents)
+            {
+                const descriptors_array descriptors = make_descriptors_(extents);
+                m_raw_vector.resize(storage_size(), storage_size_(descriptors));
+                m_descriptors = descriptors;
+            }
+
+            /**
+             * Resize all vector's extents.
+             * All stored data will become invalid.
+             * In the case of exception the vector remains unchanged.
+             * @param extents desired size of the vector
+             * @param value if the new size is bigger than the current size new elements will be copy initialized from 'value'
+             */
+            void resize(const dimensions_type & extents, const value_type & value)
+            {
+                const descriptors_array descriptors = make_descriptors_(extents);
+                m_raw_vector.resize(storage_size(), storage_size_(descriptors), value);
+                m_descriptors = descriptors;
+            }
+
+            /**
+             *  Clear vector
+             */
+            void clear()
+            {
+                m_raw_vector.resize(storage_size(), 0);
+                m_descriptors = {};
+            }
+
+            //------------------------------------------------------------
+
+            template <typename, size_t, typename, typename, typename>
+            friend class vector_nd_impl;
+        };
+
+    }
+
+    template <typename DataType_, size_t DimensionsNum_,
+        typename Allocator_ = std::allocator<DataType_>,
+        typename CapacityPolicy_ = details::default_capacity_policy,
+        typename LayoutPolicy_ = details::dense_layout_policy
+    >
+    using vector_nd = details::vector_nd_impl<DataType_, DimensionsNum_, Allocator_, CapacityPolicy_, LayoutPolicy_>;
+
+    template <typename DataType_,
+        typename Allocator_ = std::allocator<DataType_>,
+        typename CapacityPolicy_ = details::default_capacity_policy
+    >
+    using vector_1d = vector_nd<DataType_, 1, Allocator_, CapacityPolicy_>;
+
+    template <typename DataType_,
+        typename Allocator_ = std::allocator<DataType_>,
+        typename CapacityPolicy_ = details::default_capacity_policy
+    >
+    using vector = vector_nd<DataType_, 1, Allocator_, CapacityPolicy_>;
+
+    template <typename DataType_,
+        typename Allocator_ = std::allocator<DataType_>,
+        typename CapacityPolicy_ = details::default_capacity_policy
+    >
+    using vector_2d = vector_nd<DataType_, 2, Allocator_, CapacityPolicy_>;
+
+    template <typename DataType_, 
+        typename Allocator_ = std::allocator<DataType_>,
+        typename CapacityPolicy_ = details::default_capacity_policy
+    >
+    using vector_3d = vector_nd<DataType_, 3, Allocator_, CapacityPolicy_>;
+
+    template <typename DataType_,
+        typename Allocator_ = std::allocator<DataType_>,
+        typename CapacityPolicy_ = details::default_capacity_policy
+    >
+    using vector_4d = vector_nd<DataType_, 4, Allocator_, CapacityPolicy_>;
+
+    /**
+     * Vector with every row starting on RowAlignment_ bytes boundary, e.g. a cache line or a SIMD register.
+     */
+    template <typename DataType_, size_t DimensionsNum_, size_t RowAlignment_ = 64,
+        typename Allocator_ = yato::aligning_allocator<DataType_, RowAlignment_>
+    >
+    using padded_vector_nd = vector_nd<DataType_, DimensionsNum_, Allocator_, details::default_capacity_policy, details::padded_layout_policy<RowAlignment_>>;
+
+    template <typename DataType_, size_t RowAlignment_ = 64,
+        typename Allocator_ = yato::aligning_allocator<DataType_, RowAlignment_>
+    >
+    using padded_vector_2d = padded_vector_nd<DataType_, 2, RowAlignment_, Allocator_>;
+
+    template <typename DataType_, size_t RowAlignment_ = 64,
+        typename Allocator_ = yato::aligning_allocator<DataType_, RowAlignment_>
+    >
+    using padded_vector_3d = padded_vector_nd<DataType_, 3, RowAlignment_, Allocator_>;
 
 
-    template <typename DataType_, size_t DimensionsNum_, typename Allocator_, typename CapacityPolicy_>
-    auto view(yato::vector_nd<DataType_, DimensionsNum_, Allocator_, CapacityPolicy_> & v)
+    template <typename DataType_, size_t DimensionsNum_, typename Allocator_, typename CapacityPolicy_, typename LayoutPolicy_>
+    auto view(yato::vector_nd<DataType_, DimensionsNum_, Allocator_, CapacityPolicy_, LayoutPolicy_> & v)
     {
         return v.view();
     }
 
-    template <typename DataType_, size_t DimensionsNum_, typename Allocator_, typename CapacityPolicy_>
-    auto cview(const yato::vector_nd<DataType_, DimensionsNum_, Allocator_, CapacityPolicy_> & v)
+    template <typename DataType_, size_t DimensionsNum_, typename Allocator_, typename CapacityPolicy_, typename LayoutPolicy_>
+    auto cview(const yato::vector_nd<DataType_, DimensionsNum_, Allocator_, CapacityPolicy_, LayoutPolicy_> & v)
     {
         return v.cview();
     }
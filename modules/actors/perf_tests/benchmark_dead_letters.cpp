@@ -0,0 +1,64 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/config/config_builder.h>
+
+namespace
+{
+    struct payload
+    {
+        int64_t value;
+    };
+
+    class TestActor
+        : public yato::actors::actor
+    {
+        void receive(yato::any &&) override
+        { }
+    };
+}
+
+/**
+ * Cost of sending a message to a stopped actor.
+ * Arguments: log level (0 - warning, 1 - verbose), number of captured letters per type.
+ */
+static
+void Actors_DeadLetters(benchmark::State& state)
+{
+    using namespace yato::actors;
+
+    actor_system system("dead_letters", yato::config_builder::object()
+        .put("log_level", state.range(0) ? "verbose" : "warning")
+        .put("dead_letters_capture", static_cast<int32_t>(state.range(1)))
+        .create());
+
+    const auto actor = system.create_actor<TestActor>("stopped");
+    {
+        inbox watcher(system, "watcher");
+        watcher.watch(actor);
+        actor.tell(poison_pill);
+        watcher.receive(std::chrono::seconds(10));
+    }
+
+    int64_t idx = 0;
+    for (auto _ : state) {
+        actor.tell(payload{ idx++ });
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (system.dead_letter_stats().user_messages != static_cast<uint64_t>(idx)) {
+        state.SkipWithError("Lost dead letters");
+    }
+}
+
+BENCHMARK(Actors_DeadLetters)
+    ->Args({ 0, 0 })
+    ->Args({ 0, 8 })
+    ->Args({ 1, 8 });
@@ -0,0 +1,134 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <yato/actors/actor_system.h>
+#include <yato/config/config_builder.h>
+
+namespace
+{
+    class Node
+        : public yato::actors::actor
+    {
+        std::atomic<int64_t> & m_started;
+        int64_t m_children;
+        int64_t m_fanout;
+
+        void pre_start() override
+        {
+            // Distribute the remaining nodes between children
+            int64_t rest = m_children;
+            const int64_t fanout = std::min(m_fanout, rest);
+            for (int64_t i = 0; i < fanout; ++i) {
+                const int64_t subtree = (rest + fanout - i - 1) / (fanout - i);
+                rest -= subtree;
+                create_child<Node>("n" + std::to_string(i), m_started, subtree - 1, m_fanout);
+            }
+            m_started.fetch_add(1, std::memory_order_release);
+        }
+
+        void receive(yato::any &&) override
+        { }
+
+    public:
+        Node(std::atomic<int64_t> & started, int64_t children, int64_t fanout)
+            : m_started(started), m_children(children), m_fanout(fanout)
+        { }
+    };
+
+    void wait_started(const std::atomic<int64_t> & started, int64_t total)
+    {
+        while (started.load(std::memory_order_acquire) < total) {
+            std::this_thread::yield();
+        }
+    }
+
+    yato::conf::config lifecycle_config(bool fast_shutdown)
+    {
+        return yato::config_builder::object()
+            .put("log_level", "warning")
+            .put("fast_shutdown", fast_shutdown)
+            .create();
+    }
+}
+
+/**
+ * Time from the system construction until all actors are started.
+ * Actors form a tree under `fanout` top level actors, every node has up to `fanout` children.
+ * Arguments: number of actors, fanout.
+ */
+static
+void Actors_SystemStartup(benchmark::State& state)
+{
+    using namespace yato::actors;
+
+    const int64_t total  = state.range(0);
+    const int64_t fanout = state.range(1);
+
+    for (auto _ : state) {
+        std::atomic<int64_t> started{ 0 };
+        auto system = std::make_unique<actor_system>("startup", lifecycle_config(true));
+        system->create_actor<Node>("root", started, total - 1, fanout);
+        wait_started(started, total);
+
+        state.PauseTiming();
+        system->shutdown();
+        system.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * total);
+}
+
+BENCHMARK(Actors_SystemStartup)
+    ->Args({ 1000, 1000 })
+    ->Args({ 100000, 100000 })
+    ->Args({ 100000, 10 })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+
+/**
+ * Time of forced shutdown of a system with the tree of actors.
+ * Arguments: number of actors, fanout, fast shutdown.
+ */
+static
+void Actors_SystemShutdown(benchmark::State& state)
+{
+    using namespace yato::actors;
+
+    const int64_t total  = state.range(0);
+    const int64_t fanout = state.range(1);
+    const bool fast = (state.range(2) != 0);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::atomic<int64_t> started{ 0 };
+        auto system = std::make_unique<actor_system>("shutdown", lifecycle_config(fast));
+        system->create_actor<Node>("root", started, total - 1, fanout);
+        wait_started(started, total);
+        state.ResumeTiming();
+
+        system->shutdown();
+        system.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * total);
+}
+
+BENCHMARK(Actors_SystemShutdown)
+    ->Args({ 1000, 1000, 0 })
+    ->Args({ 100000, 100000, 0 })
+    ->Args({ 100000, 10, 0 })
+    ->Args({ 100000, 100000, 1 })
+    ->Args({ 100000, 10, 1 })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,230 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/actors/persistence/persistent_actor.h>
+#include <yato/any_match.h>
+#include <yato/config/config_builder.h>
+
+namespace
+{
+    struct increment
+    {
+        int64_t value;
+    };
+
+    struct incremented
+    {
+        int64_t value;
+    };
+
+    struct total_state
+    {
+        int64_t total;
+    };
+
+    struct counter_reply
+    {
+        int32_t index;
+        int64_t total;
+    };
+
+    struct recovered {};
+
+    class PersistentCounter
+        : public yato::actors::persistence::persistent_actor
+    {
+        std::string m_id;
+        int32_t m_index;
+        int64_t m_total = 0;
+        yato::actors::actor_ref m_observer;
+
+        std::string persistence_id() const override
+        {
+            return m_id;
+        }
+
+        void receive_recover(const yato::any & event) override
+        {
+            m_total += event.get<incremented>().value;
+        }
+
+        void recover_snapshot(const yato::any & state) override
+        {
+            m_total = state.get<total_state>().total;
+        }
+
+        yato::any snapshot() const override
+        {
+            return yato::any(total_state{ m_total });
+        }
+
+        void on_recovery_completed() override
+        {
+            m_observer.tell(recovered{});
+        }
+
+        void receive_command(yato::any && message) override
+        {
+            yato::any_match(
+                [this](const increment & cmd) {
+                    persist(incremented{ cmd.value }, [this](const incremented & e) {
+                        m_total += e.value;
+                        sender().tell(counter_reply{ m_index, m_total });
+                    });
+                }
+            )(message);
+        }
+
+    public:
+        PersistentCounter(const std::shared_ptr<yato::actors::persistence::journal> & events_journal, uint32_t snapshot_interval,
+            std::string id, int32_t index, const yato::actors::actor_ref & observer)
+            : persistent_actor(events_journal, snapshot_interval), m_id(std::move(id)), m_index(index), m_observer(observer)
+        { }
+    };
+
+    yato::conf::config bench_config()
+    {
+        return yato::config_builder::object()
+            .put("log_level", "warning")
+            .create();
+    }
+
+    void register_types(yato::actors::actor_system & system)
+    {
+        system.serialization().register_type<incremented>("bench.incremented");
+        system.serialization().register_type<total_state>("bench.total_state");
+    }
+}
+
+/**
+ * Many actors persist events concurrently. Each actor has one event in flight, so the throughput depends on how many records share one flush.
+ * Arguments: number of actors, sync.
+ */
+static
+void Actors_PersistEvents(benchmark::State& state)
+{
+    using namespace yato::actors;
+
+    const auto actors_number = static_cast<int>(state.range(0));
+    const int events_per_iteration = 100;
+
+    const std::string directory = "yato_bench_journal";
+    persistence::journal::remove(directory);
+    {
+        persistence::journal_options options;
+        options.sync = (state.range(1) != 0);
+        auto events_journal = persistence::journal::open(directory, options);
+
+        actor_system system("persistence", bench_config());
+        register_types(system);
+        inbox output(system, "output");
+
+        std::vector<actor_ref> counters;
+        for (int i = 0; i < actors_number; ++i) {
+            const auto name = "counter_" + std::to_string(i);
+            counters.push_back(system.create_actor<PersistentCounter>(name, events_journal, 0, name, i, output.ref()));
+        }
+        for (int i = 0; i < actors_number; ++i) {
+            output.receive(std::chrono::seconds(10));
+        }
+
+        for (auto _ : state) {
+            for (const auto & counter : counters) {
+                output.send(counter, increment{ 1 });
+            }
+            const int64_t total = static_cast<int64_t>(actors_number) * events_per_iteration;
+            for (int64_t i = 0; i < total; ++i) {
+                const auto reply = output.receive(std::chrono::seconds(10));
+                if (!reply.is_type<counter_reply>()) {
+                    state.SkipWithError("No reply");
+                    break;
+                }
+                // Send the next command
+                const auto & r = reply.get_unsafe<counter_reply>();
+                if (r.total % events_per_iteration != 0) {
+                    output.send(counters[r.index], increment{ 1 });
+                }
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * actors_number * events_per_iteration);
+
+        for (const auto & counter : counters) {
+            counter.tell(poison_pill);
+        }
+    }
+    persistence::journal::remove(directory);
+}
+
+BENCHMARK(Actors_PersistEvents)
+    ->Args({ 1, 0 })
+    ->Args({ 64, 0 })
+    ->Args({ 1, 1 })
+    ->Args({ 64, 1 })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+
+/**
+ * Recovery of an actor with a long history.
+ * Arguments: number of events, snapshot interval.
+ */
+static
+void Actors_PersistRecovery(benchmark::State& state)
+{
+    using namespace yato::actors;
+
+    const auto events = state.range(0);
+    const auto snapshot_interval = static_cast<uint32_t>(state.range(1));
+
+    const std::string directory = "yato_bench_journal_recovery";
+    persistence::journal::remove(directory);
+
+    persistence::journal_options options;
+    options.sync = false;
+    auto events_journal = persistence::journal::open(directory, options);
+    {
+        actor_system system("persistence", bench_config());
+        register_types(system);
+        inbox output(system, "output");
+
+        const auto counter = system.create_actor<PersistentCounter>("counter", events_journal, snapshot_interval, "counter", 0, output.ref());
+        output.receive(std::chrono::seconds(10));
+        for (int64_t i = 0; i < events; ++i) {
+            output.send(counter, increment{ 1 });
+        }
+        for (int64_t i = 0; i < events; ++i) {
+            output.receive(std::chrono::seconds(10));
+        }
+        counter.tell(poison_pill);
+    }
+
+    actor_system system("persistence", bench_config());
+    register_types(system);
+    inbox output(system, "output");
+
+    int64_t idx = 0;
+    for (auto _ : state) {
+        // Every iteration recovers the same entity in a new actor
+        const auto counter = system.create_actor<PersistentCounter>("counter_" + std::to_string(idx++), events_journal, snapshot_interval, "counter", 0, output.ref());
+        if (!output.receive(std::chrono::seconds(60)).is_type<recovered>()) {
+            state.SkipWithError("Recovery is not completed");
+            break;
+        }
+        counter.tell(poison_pill);
+    }
+    state.SetItemsProcessed(state.iterations() * events);
+}
+
+BENCHMARK(Actors_PersistRecovery)
+    ->Args({ 100000, 0 })
+    ->Args({ 100000, 10000 })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,118 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/config/config_builder.h>
+
+namespace
+{
+    struct ping {};
+
+    /**
+     * Replies to the first message and stops.
+     */
+    class OneShot
+        : public yato::actors::actor
+    {
+        void receive(yato::any &&) override
+        {
+            sender().tell(ping{});
+            self().stop();
+        }
+    };
+}
+
+/**
+ * Spawns an actor per request and sends a message to it right after creation.
+ * Reports created actors per second. Every actor has to be attached and started before it replies.
+ * Arguments: number of actors per iteration.
+ */
+static
+void Actors_SpawnPerRequest(benchmark::State& state)
+{
+    using namespace yato::actors;
+
+    const auto actors_number = state.range(0);
+
+    actor_system system("spawn", yato::config_builder::object()
+        .put("log_level", "warning")
+        .create());
+    inbox output(system, "output");
+
+    int64_t idx = 0;
+    for (auto _ : state) {
+        for (int64_t i = 0; i < actors_number; ++i) {
+            const auto actor = system.create_actor<OneShot>("request_" + std::to_string(idx++));
+            output.send(actor, ping{});
+        }
+        for (int64_t i = 0; i < actors_number; ++i) {
+            if (!output.receive(std::chrono::seconds(10)).is_type<ping>()) {
+                state.SkipWithError("No reply");
+                break;
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * actors_number);
+}
+
+BENCHMARK(Actors_SpawnPerRequest)
+    ->Arg(1)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/**
+ * Spawns short living actors on the pinned executor. Threads of stopped actors are reused by the new ones.
+ * Arguments: number of actors per iteration, actors per thread.
+ */
+static
+void Actors_SpawnPinned(benchmark::State& state)
+{
+    using namespace yato::actors;
+
+    const auto actors_number = state.range(0);
+
+    actor_system system("spawn", yato::config_builder::object()
+        .put("log_level", "warning")
+        .put("execution_contexts", yato::config_builder::array()
+            .add(yato::config_builder::object()
+                .put("name", "pinned")
+                .put("type", "pinned")
+                .put("threads_limit", 16)
+                .put("actors_per_thread", static_cast<int32_t>(state.range(1)))
+                .create())
+            .create())
+        .create());
+    inbox output(system, "output");
+
+    properties props;
+    props.execution_name = "pinned";
+
+    int64_t idx = 0;
+    for (auto _ : state) {
+        for (int64_t i = 0; i < actors_number; ++i) {
+            const auto actor = system.create_actor<OneShot>(props, "request_" + std::to_string(idx++));
+            output.send(actor, ping{});
+        }
+        for (int64_t i = 0; i < actors_number; ++i) {
+            if (!output.receive(std::chrono::seconds(10)).is_type<ping>()) {
+                state.SkipWithError("No reply");
+                break;
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * actors_number);
+}
+
+BENCHMARK(Actors_SpawnPinned)
+    ->Args({ 8, 1 })
+    ->Args({ 32, 4 })
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
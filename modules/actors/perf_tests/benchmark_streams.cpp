@@ -0,0 +1,81 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/actors/streams/stream.h>
+#include <yato/config/config_builder.h>
+
+/**
+ * Pipeline source -> map -> filter -> batch -> sink.
+ * Reports the maximal number of elements produced, but not consumed yet. It is bounded by the buffer size and doesn't depend on the stream length.
+ * Arguments: stream length, buffer size.
+ */
+static
+void Actors_StreamPipeline(benchmark::State& state)
+{
+    using namespace yato::actors;
+
+    const int64_t length = state.range(0);
+    const auto buffer = static_cast<uint32_t>(state.range(1));
+
+    actor_system system("streams", yato::config_builder::object()
+        .put("log_level", "warning")
+        .create());
+    inbox output(system, "output");
+
+    int64_t max_in_flight = 0;
+    for (auto _ : state) {
+        std::atomic<int64_t> produced{ 0 };
+        std::atomic<int64_t> consumed{ 0 };
+        std::atomic<int64_t> peak{ 0 };
+
+        streams::stream::generate([&](yato::any & element) {
+                const auto n = produced.load(std::memory_order_relaxed);
+                if (n >= length) {
+                    return false;
+                }
+                produced.store(n + 1, std::memory_order_relaxed);
+                const auto in_flight = n + 1 - consumed.load(std::memory_order_relaxed);
+                if (in_flight > peak.load(std::memory_order_relaxed)) {
+                    peak.store(in_flight, std::memory_order_relaxed);
+                }
+                element = yato::any(n);
+                return true;
+            })
+            .map<int64_t>([](int64_t x) { return x * 3; })
+            .filter<int64_t>([](int64_t x) { return x % 2 == 0; })
+            .batch(64, std::chrono::milliseconds(1))
+            .buffer_size(buffer)
+            .to(streams::for_each<streams::batch_type>([&](const streams::batch_type & batch) {
+                // Filter drops every second element
+                consumed.fetch_add(2 * static_cast<int64_t>(batch.size()), std::memory_order_relaxed);
+            }, [&] {
+                output.ref().tell(streams::on_complete{});
+            }))
+            .run(system, "pipeline");
+
+        if (!output.receive(std::chrono::seconds(60)).is_type<streams::on_complete>()) {
+            state.SkipWithError("Stream is not completed");
+            break;
+        }
+        max_in_flight = std::max(max_in_flight, peak.load());
+    }
+    state.SetItemsProcessed(state.iterations() * length);
+    state.counters["max_in_flight"] = static_cast<double>(max_in_flight);
+}
+
+BENCHMARK(Actors_StreamPipeline)
+    ->Args({ 100000, 64 })
+    ->Args({ 1000000, 64 })
+    ->Args({ 1000000, 1024 })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,91 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/config/config_builder.h>
+
+namespace
+{
+    struct ball
+    {
+        int64_t hits;
+    };
+
+    /**
+     * Bounces the ball to the partner, returns it to the owner after the last hit.
+     */
+    class Player
+        : public yato::actors::actor
+    {
+        yato::actors::actor_ref m_partner;
+        yato::actors::actor_ref m_owner;
+
+        void receive(yato::any && message) override
+        {
+            if (message.is_type<yato::actors::actor_ref>()) {
+                m_partner = message.get<yato::actors::actor_ref>();
+                return;
+            }
+            const auto b = message.get<ball>();
+            if (b.hits == 0) {
+                m_owner.tell(b);
+            } else {
+                m_partner.tell(ball{ b.hits - 1 });
+            }
+        }
+
+    public:
+        explicit
+        Player(const yato::actors::actor_ref & owner)
+            : m_owner(owner)
+        { }
+    };
+}
+
+/**
+ * Overhead of sampled tracing on a chain of messages.
+ * Arguments: number of hits per iteration, sampling (0 - disabled).
+ */
+static
+void Actors_TracedPingPong(benchmark::State& state)
+{
+    using namespace yato::actors;
+
+    const auto hits = state.range(0);
+    actor_system system("tracing", yato::config_builder::object()
+        .put("log_level", "warning")
+        .put("trace_sampling", static_cast<int32_t>(state.range(1)))
+        .create());
+
+    inbox output(system, "output");
+    const auto ping = system.create_actor<Player>("ping", output.ref());
+    const auto pong = system.create_actor<Player>("pong", output.ref());
+    ping.tell(pong);
+    pong.tell(ping);
+
+    for (auto _ : state) {
+        output.send(ping, ball{ hits });
+        if (!output.receive(std::chrono::seconds(10)).is_type<ball>()) {
+            state.SkipWithError("No reply");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * hits);
+
+    ping.tell(poison_pill);
+    pong.tell(poison_pill);
+}
+
+BENCHMARK(Actors_TracedPingPong)
+    ->Args({ 1000, 0 })
+    ->Args({ 1000, 1000 })
+    ->Args({ 1000, 1 })
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
@@ -0,0 +1,123 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/actors/serialization.h>
+#include <yato/actors/remote/remote.h>
+#include <yato/config/config_builder.h>
+
+namespace
+{
+    struct remote_payload
+    {
+        int64_t index;
+        double value;
+    };
+
+    struct remote_done
+    {
+        int64_t count;
+    };
+
+    yato::config remote_benchmark_config(uint32_t port)
+    {
+        return yato::config_builder::object()
+            .put("log_level", "warning")
+            .put("enable_io", true)
+            .put("enable_remote", true)
+            .put("remote", yato::config_builder::object()
+                .put("host", "127.0.0.1")
+                .put("port", port)
+                .create()
+            )
+            .create();
+    }
+
+    /**
+     * Counts messages and replies after the expected number is received.
+     */
+    class RemoteSink
+        : public yato::actors::actor
+    {
+        int64_t m_counter = 0;
+
+        void receive(yato::any && message) override
+        {
+            if (message.is_type<remote_done>()) {
+                m_counter = 0;
+            }
+            else if (message.is_type<remote_payload>()) {
+                ++m_counter;
+                if (m_counter == message.get_unsafe<remote_payload>().index) {
+                    sender().tell(remote_done{ m_counter }, self());
+                }
+            }
+        }
+    };
+
+    class Forwarder
+        : public yato::actors::actor
+    {
+        yato::actors::actor_ref m_output;
+
+        void receive(yato::any && message) override
+        {
+            m_output.tell(std::move(message), sender());
+        }
+
+    public:
+        explicit
+        Forwarder(const yato::actors::actor_ref & output)
+            : m_output(output)
+        { }
+    };
+}
+
+/**
+ * Messages per second between two actor systems in one process, connected over loopback.
+ */
+static
+void Actors_RemoteThroughput(benchmark::State & state)
+{
+    using namespace yato::actors;
+
+    const int64_t messages_num = state.range(0);
+
+    actor_system system_a("A", remote_benchmark_config(9201));
+    actor_system system_b("B", remote_benchmark_config(9202));
+    for (auto* sys : { &system_a, &system_b }) {
+        sys->serialization().register_type<remote_payload>("benchmark.remote_payload");
+        sys->serialization().register_type<remote_done>("benchmark.remote_done");
+    }
+
+    const auto sink = system_b.create_actor<RemoteSink>("sink");
+
+    inbox output(system_a, "output");
+    const auto forwarder = system_a.create_actor<Forwarder>("forwarder", output.ref());
+    const auto remote_sink = remote::resolve(system_a, actor_path("yato://B@127.0.0.1:9202/user/sink"));
+
+    for (auto _ : state) {
+        remote_sink.tell(remote_done{ 0 }, forwarder);
+        for (int64_t i = 1; i <= messages_num; ++i) {
+            remote_sink.tell(remote_payload{ messages_num, static_cast<double>(i) }, forwarder);
+        }
+        const auto reply = output.receive(std::chrono::seconds(30));
+        if (!reply.is_type<remote_done>()) {
+            state.SkipWithError("Remote messages were lost");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * messages_num);
+
+    forwarder.tell(poison_pill);
+    sink.tell(poison_pill);
+}
+
+BENCHMARK(Actors_RemoteThroughput)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond)->UseRealTime();
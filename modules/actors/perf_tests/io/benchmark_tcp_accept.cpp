@@ -0,0 +1,137 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include <asio.hpp>
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/actors/io/tcp.h>
+#include <yato/any_match.h>
+#include <yato/config/config_builder.h>
+
+namespace
+{
+    struct storm_done
+    {
+        int64_t count;
+    };
+
+    /**
+     * Handles all connections of the server and reports after every `storm_size` connected or closed peers.
+     */
+    class StormServer
+        : public yato::actors::actor
+    {
+        yato::actors::actor_ref m_output;
+        int64_t m_storm_size;
+        int64_t m_connected = 0;
+        int64_t m_closed = 0;
+
+        void receive(yato::any && message) override
+        {
+            using namespace yato::actors::io;
+            yato::any_match(
+                [this](const tcp::bound &) {
+                    m_output.tell(storm_done{ 0 });
+                },
+                [this](const tcp::connected &) {
+                    sender().tell(tcp::assign(self()));
+                    if (++m_connected == m_storm_size) {
+                        m_connected = 0;
+                        m_output.tell(storm_done{ m_storm_size });
+                    }
+                },
+                [this](const tcp::peer_closed &) {
+                    if (++m_closed == m_storm_size) {
+                        m_closed = 0;
+                        m_output.tell(storm_done{ m_storm_size });
+                    }
+                }
+            )(message);
+        }
+
+    public:
+        StormServer(const yato::actors::actor_ref & output, int64_t storm_size)
+            : m_output(output), m_storm_size(storm_size)
+        { }
+    };
+}
+
+/**
+ * Many clients connect at once. Measures time until all connections are handled by the server actor.
+ * Arguments: connections per storm, accept batch size, pool size.
+ */
+static
+void Actors_TcpConnectStorm(benchmark::State& state)
+{
+    using namespace yato::actors;
+
+    const int64_t storm_size = state.range(0);
+    const uint16_t port = 9301;
+
+    actor_system system("storm", yato::config_builder::object()
+        .put("log_level", "warning")
+        .put("enable_io", true)
+        .create());
+
+    io::tcp::accept_options accept_options;
+    accept_options.batch_size = static_cast<uint32_t>(state.range(1));
+    accept_options.pool_size  = static_cast<uint32_t>(state.range(2));
+    accept_options.backlog    = static_cast<uint32_t>(storm_size);
+
+    inbox output(system, "output");
+    const auto server = system.create_actor<StormServer>("server", output.ref(), storm_size);
+    io::tcp::get_for(system).tell(io::tcp::bind(server, io::inet_address("127.0.0.1", port), io::socket_options{}, accept_options));
+    if (!output.receive(std::chrono::seconds(5)).is_type<storm_done>()) {
+        state.SkipWithError("Failed to bind");
+        server.tell(poison_pill);
+        return;
+    }
+
+    asio::io_service client_service;
+    const asio::ip::tcp::endpoint endpoint(asio::ip::address::from_string("127.0.0.1"), port);
+
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<asio::ip::tcp::socket>> clients;
+        clients.reserve(static_cast<size_t>(storm_size));
+        for (int64_t i = 0; i < storm_size; ++i) {
+            clients.push_back(std::make_unique<asio::ip::tcp::socket>(client_service));
+            clients.back()->connect(endpoint);
+            // Reset on close, otherwise local ports are exhausted by TIME_WAIT sockets
+            clients.back()->set_option(asio::socket_base::linger(true, 0));
+        }
+        if (!output.receive(std::chrono::seconds(10)).is_type<storm_done>()) {
+            state.SkipWithError("Connections are not accepted");
+            break;
+        }
+
+        state.PauseTiming();
+        for (auto & client : clients) {
+            // Explicit close keeps the linger option, destructor would reset it
+            asio::error_code ignored;
+            client->close(ignored);
+        }
+        clients.clear();
+        output.receive(std::chrono::seconds(10));
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * storm_size);
+
+    server.tell(poison_pill);
+}
+
+BENCHMARK(Actors_TcpConnectStorm)
+    ->Args({ 128, 1, 0 })
+    ->Args({ 128, 16, 0 })
+    ->Args({ 128, 16, 128 })
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,231 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <thread>
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/actors/serialization.h>
+#include <yato/actors/remote/remote.h>
+#include <yato/actors/remote/private/wire_format.h>
+#include <yato/any_match.h>
+
+#include "../test_actors_common.h"
+
+namespace
+{
+    struct ping
+    {
+        int32_t value;
+    };
+
+    yato::config remote_config(uint32_t port)
+    {
+        return yato::config_builder::object()
+            .put("log_level", "debug")
+            .put("enable_io", true)
+            .put("enable_remote", true)
+            .put("remote", yato::config_builder::object()
+                .put("host", "127.0.0.1")
+                .put("port", port)
+                .create()
+            )
+            .create();
+    }
+
+    void register_test_types(yato::actors::actor_system & system)
+    {
+        system.serialization().register_type<ping>("test.ping");
+        system.serialization().register_type<std::string>("std.string");
+    }
+
+    class RemoteEcho
+        : public yato::actors::actor
+    {
+        void receive(yato::any && message) override
+        {
+            yato::any_match(
+                [this](const ping & p) {
+                    sender().tell(ping{ p.value + 1 }, self());
+                },
+                [this](const std::string & str) {
+                    sender().tell(str + "!", self());
+                }
+            )(message);
+        }
+    };
+
+    class Collector
+        : public yato::actors::actor
+    {
+        yato::actors::actor_ref m_output;
+
+        void receive(yato::any && message) override
+        {
+            m_output.tell(std::move(message), sender());
+        }
+
+    public:
+        explicit
+        Collector(const yato::actors::actor_ref & output)
+            : m_output(output)
+        { }
+    };
+}
+
+TEST(Yato_Actors, remote_ping_pong)
+{
+    using namespace yato::actors;
+
+    actor_system system_a("A", remote_config(9101));
+    actor_system system_b("B", remote_config(9102));
+    register_test_types(system_a);
+    register_test_types(system_b);
+    ASSERT_TRUE(remote::wait_listening(system_a, std::chrono::seconds(5)));
+    ASSERT_TRUE(remote::wait_listening(system_b, std::chrono::seconds(5)));
+
+    const auto echo_local = system_b.create_actor<RemoteEcho>("echo");
+
+    inbox output(system_a, "output");
+    const auto collector = system_a.create_actor<Collector>("collector", output.ref());
+
+    actor_ref echo;
+    ASSERT_NO_THROW(echo = remote::resolve(system_a, actor_path("yato://B@127.0.0.1:9102/user/echo")));
+    ASSERT_FALSE(echo.empty());
+
+    echo.tell(ping{ 41 }, collector);
+    auto reply = output.receive(std::chrono::seconds(5));
+    ASSERT_TRUE(reply.is_type<ping>());
+    EXPECT_EQ(42, reply.get_unsafe<ping>().value);
+
+    echo.tell(std::string("hello"), collector);
+    reply = output.receive(std::chrono::seconds(5));
+    ASSERT_TRUE(reply.is_type<std::string>());
+    EXPECT_EQ("hello!", reply.get_unsafe<std::string>());
+
+    // Many messages are batched, but delivered in order
+    for (int32_t i = 0; i < 1000; ++i) {
+        echo.tell(ping{ i }, collector);
+    }
+    for (int32_t i = 0; i < 1000; ++i) {
+        reply = output.receive(std::chrono::seconds(5));
+        ASSERT_TRUE(reply.is_type<ping>());
+        ASSERT_EQ(i + 1, reply.get_unsafe<ping>().value);
+    }
+
+    collector.tell(poison_pill);
+    echo_local.tell(poison_pill);
+}
+
+TEST(Yato_Actors, remote_sender_proxies)
+{
+    using namespace yato::actors;
+
+    actor_system system_a("A", remote_config(9104));
+    actor_system system_b("B", remote_config(9105));
+    register_test_types(system_a);
+    register_test_types(system_b);
+    ASSERT_TRUE(remote::wait_listening(system_b, std::chrono::seconds(5)));
+
+    const auto echo_local = system_b.create_actor<RemoteEcho>("echo");
+
+    actor_ref echo;
+    ASSERT_NO_THROW(echo = remote::resolve(system_a, actor_path("yato://B@127.0.0.1:9105/user/echo")));
+
+    // Proxy of a long living sender is kept
+    inbox output(system_a, "output");
+    const auto collector = system_a.create_actor<Collector>("collector", output.ref());
+    echo.tell(ping{ 0 }, collector);
+    ASSERT_TRUE(output.receive(std::chrono::seconds(5)).is_type<ping>());
+
+    // Every ask has a new temporary sender, its proxy is stopped after the asking actor is terminated
+    const int32_t asks_number = 50;
+    for (int32_t i = 0; i < asks_number; ++i) {
+        const auto reply = echo.ask(ping{ i }, std::chrono::seconds(5)).get();
+        ASSERT_TRUE(reply.is_type<ping>());
+        ASSERT_EQ(i + 1, reply.get_unsafe<ping>().value);
+    }
+
+    const auto wait_proxies = [&system_b](int32_t expected) {
+        int32_t alive = 0;
+        for (int attempt = 0; attempt < 50; ++attempt) {
+            alive = 0;
+            for (int32_t i = 0; i <= asks_number; ++i) {
+                const auto path = actor_path("yato://B/system/remote/inbound_0/proxy_" + std::to_string(i));
+                if (!system_b.find(path, std::chrono::seconds(1)).get().empty()) {
+                    ++alive;
+                }
+            }
+            if (alive == expected) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        return alive;
+    };
+    EXPECT_EQ(1, wait_proxies(1));
+
+    collector.tell(poison_pill);
+    EXPECT_EQ(0, wait_proxies(0));
+
+    echo_local.tell(poison_pill);
+}
+
+TEST(Yato_Actors, remote_resolve_local)
+{
+    using namespace yato::actors;
+
+    actor_system system("A", remote_config(9103));
+    const auto echo = system.create_actor<RemoteEcho>("echo");
+
+    actor_ref local;
+    ASSERT_NO_THROW(local = remote::resolve(system, actor_path("yato://A/user/echo")));
+    EXPECT_EQ(echo, local);
+
+    EXPECT_THROW(remote::resolve(system, actor_path("echo")), yato::argument_error);
+
+    // Bad ports are rejected without waiting for the timeout
+    EXPECT_THROW(remote::resolve(system, actor_path("yato://B@127.0.0.1:70000/user/echo")), yato::runtime_error);
+    EXPECT_THROW(remote::resolve(system, actor_path("yato://B@127.0.0.1:95x/user/echo")), yato::runtime_error);
+
+    echo.tell(poison_pill);
+}
+
+TEST(Yato_Actors, remote_wire_frame_limit)
+{
+    using namespace yato::actors;
+
+    output_buffer out;
+    const size_t offset = remote::wire::begin_frame(out);
+    remote::wire::write_header(out, 1, "user/echo", "");
+    out.write("payload", 7);
+    remote::wire::end_frame(out, offset);
+    const size_t frame_size = out.size() - sizeof(remote::wire::size_type);
+
+    remote::wire::frame f;
+    input_buffer complete(out.data(), out.data() + out.size());
+    ASSERT_EQ(remote::wire::read_result::complete, remote::wire::read_frame(complete, f, frame_size));
+    EXPECT_EQ("user/echo", f.target);
+    EXPECT_EQ(0u, complete.remaining());
+
+    // Oversized frame is rejected as soon as its size is available
+    input_buffer size_only(out.data(), out.data() + sizeof(remote::wire::size_type));
+    EXPECT_EQ(remote::wire::read_result::too_large, remote::wire::read_frame(size_only, f, frame_size - 1));
+    EXPECT_EQ(remote::wire::read_result::incomplete, remote::wire::read_frame(size_only, f, frame_size));
+}
+
+TEST(Yato_Actors, remote_requires_io)
+{
+    using namespace yato::actors;
+
+    const auto conf = yato::config_builder::object()
+        .put("enable_remote", true)
+        .create();
+    EXPECT_THROW(actor_system("A", conf), yato::argument_error);
+}
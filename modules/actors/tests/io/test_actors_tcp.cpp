@@ -11,10 +11,13 @@
 #include <iostream>
 
 #include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
 #include <yato/actors/logger.h>
 #include <yato/any_match.h>
 
 #include <yato/actors/io/tcp.h>
+#include <yato/actors/io/tcp_stream.h>
+#include <yato/actors/streams/stream.h>
 
 #include "../test_actors_common.h"
 
@@ -152,3 +155,373 @@ TEST(Yato_Actors, io_tcp_client)
     client.tell(poison_pill);
 }
 
+
+TEST(Yato_Actors, io_tcp_connect_fail)
+{
+    using namespace yato::actors;
+
+    auto conf_builder = yato::config_builder::object();
+    conf_builder.put("log_level", "verbose");
+    conf_builder.put("enable_io", true);
+
+    actor_system system("default", conf_builder.create());
+
+    actor_ref manager;
+    ASSERT_NO_THROW(manager = io::tcp::get_for(system));
+
+    inbox client(system, "client");
+
+    // Nobody listens the port
+    manager.tell(io::tcp::connect(client.ref(), io::inet_address("localhost", 9002)));
+    auto res = client.receive(std::chrono::seconds(5));
+    EXPECT_EQ(typeid(io::tcp::command_fail), res.type());
+}
+
+TEST(Yato_Actors, io_tcp_connect_timeout)
+{
+    using namespace yato::actors;
+
+    auto conf_builder = yato::config_builder::object();
+    conf_builder.put("log_level", "verbose");
+    conf_builder.put("enable_io", true);
+
+    actor_system system("default", conf_builder.create());
+
+    actor_ref manager;
+    ASSERT_NO_THROW(manager = io::tcp::get_for(system));
+
+    inbox client(system, "client");
+
+    // Non-routable address. Either is expired or fails immediately.
+    manager.tell(io::tcp::connect(client.ref(), io::inet_address("10.255.255.1", 9001), std::chrono::milliseconds(100)));
+
+    // The manager is not blocked by the pending connection
+    inbox server(system, "server");
+    manager.tell(io::tcp::bind(server.ref(), io::inet_address("localhost", 9003)));
+    auto bound = server.receive(std::chrono::seconds(1));
+    EXPECT_EQ(typeid(io::tcp::bound), bound.type());
+
+    auto res = client.receive(std::chrono::seconds(5));
+    EXPECT_EQ(typeid(io::tcp::command_fail), res.type());
+}
+
+namespace
+{
+    class StatsServer
+        : public yato::actors::actor
+    {
+        yato::actors::actor_ref m_output;
+
+        void receive(yato::any && message) override {
+            using namespace yato::actors::io;
+            yato::any_match(
+                [this](const tcp::connected &) {
+                    sender().tell(tcp::assign(self()));
+                },
+                [this](const tcp::received &) {
+                    sender().tell(get_stats{}, self());
+                },
+                [this](const connection_stats & stats) {
+                    m_output.tell(stats);
+                }
+            )(message);
+        }
+
+    public:
+        explicit
+        StatsServer(const yato::actors::actor_ref & output)
+            : m_output(output)
+        { }
+    };
+
+    class HelloClient
+        : public yato::actors::actor
+    {
+        void receive(yato::any && message) override {
+            using namespace yato::actors::io;
+            yato::any_match(
+                [this](const tcp::connected &) {
+                    sender().tell(tcp::assign(self()));
+                    const std::string hello = "hello";
+                    sender().tell(tcp::write(std::vector<char>(hello.cbegin(), hello.cend())));
+                }
+            )(message);
+        }
+    };
+}
+
+TEST(Yato_Actors, io_tcp_socket_options)
+{
+    using namespace yato::actors;
+
+    auto conf_builder = yato::config_builder::object();
+    conf_builder.put("log_level", "verbose");
+    conf_builder.put("enable_io", true);
+
+    actor_system system("default", conf_builder.create());
+
+    actor_ref manager;
+    ASSERT_NO_THROW(manager = io::tcp::get_for(system));
+
+    io::socket_options options;
+    options.no_delay = true;
+    options.reuse_port = true;
+    options.receive_buffer_size = 256 * 1024;
+    options.send_buffer_size = 256 * 1024;
+
+    inbox output(system, "output");
+    const auto server = system.create_actor<StatsServer>("server", output.ref());
+    manager.tell(io::tcp::bind(server, io::inet_address("localhost", 9004), options));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    const auto client = system.create_actor<HelloClient>("client");
+    manager.tell(io::tcp::connect(client, io::inet_address("localhost", 9004), options));
+
+    auto res = output.receive(std::chrono::seconds(5));
+    ASSERT_TRUE(res.is_type<io::connection_stats>());
+    const auto & stats = res.get_unsafe<io::connection_stats>();
+    EXPECT_EQ(5u, stats.bytes_received);
+    EXPECT_EQ(1u, stats.packets_received);
+    EXPECT_EQ(0u, stats.drops);
+
+    client.tell(poison_pill);
+    server.tell(poison_pill);
+}
+
+namespace
+{
+    /**
+     * Assigns itself to every connection and forwards all messages to output
+     */
+    class TcpForwarder
+        : public yato::actors::actor
+    {
+        yato::actors::actor_ref m_output;
+
+        void receive(yato::any && message) override {
+            using namespace yato::actors::io;
+            if (message.is_type<tcp::connected>()) {
+                sender().tell(tcp::assign(self()));
+            }
+            m_output.tell(std::move(message), sender());
+        }
+
+    public:
+        explicit
+        TcpForwarder(const yato::actors::actor_ref & output)
+            : m_output(output)
+        { }
+    };
+}
+
+TEST(Yato_Actors, io_tcp_max_connections)
+{
+    using namespace yato::actors;
+
+    auto conf_builder = yato::config_builder::object();
+    conf_builder.put("log_level", "verbose");
+    conf_builder.put("enable_io", true);
+
+    actor_system system("default", conf_builder.create());
+
+    actor_ref manager;
+    ASSERT_NO_THROW(manager = io::tcp::get_for(system));
+
+    io::tcp::accept_options accept_options;
+    accept_options.max_connections = 1;
+    accept_options.pool_size = 2;
+
+    inbox server_output(system, "server_output");
+    const auto server = system.create_actor<TcpForwarder>("server", server_output.ref());
+    manager.tell(io::tcp::bind(server, io::inet_address("localhost", 9005), io::socket_options{}, accept_options));
+    ASSERT_TRUE(server_output.receive(std::chrono::seconds(5)).is_type<io::tcp::bound>());
+
+    inbox output_1(system, "output_1");
+    const auto client_1 = system.create_actor<TcpForwarder>("client_1", output_1.ref());
+    manager.tell(io::tcp::connect(client_1, io::inet_address("localhost", 9005)));
+    ASSERT_TRUE(output_1.receive(std::chrono::seconds(5)).is_type<io::tcp::connected>());
+    ASSERT_TRUE(server_output.receive(std::chrono::seconds(5)).is_type<io::tcp::connected>());
+
+    // Above the limit. Is closed by the server.
+    inbox output_2(system, "output_2");
+    const auto client_2 = system.create_actor<TcpForwarder>("client_2", output_2.ref());
+    manager.tell(io::tcp::connect(client_2, io::inet_address("localhost", 9005)));
+    ASSERT_TRUE(output_2.receive(std::chrono::seconds(5)).is_type<io::tcp::connected>());
+    EXPECT_TRUE(output_2.receive(std::chrono::seconds(5)).is_type<io::tcp::peer_closed>());
+    EXPECT_TRUE(server_output.receive(std::chrono::milliseconds(200)).empty());
+
+    // Free the slot
+    client_1.tell(poison_pill);
+    EXPECT_TRUE(server_output.receive(std::chrono::seconds(5)).is_type<io::tcp::peer_closed>());
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    inbox output_3(system, "output_3");
+    const auto client_3 = system.create_actor<TcpForwarder>("client_3", output_3.ref());
+    manager.tell(io::tcp::connect(client_3, io::inet_address("localhost", 9005)));
+    ASSERT_TRUE(output_3.receive(std::chrono::seconds(5)).is_type<io::tcp::connected>());
+    EXPECT_TRUE(server_output.receive(std::chrono::seconds(5)).is_type<io::tcp::connected>());
+
+    client_2.tell(poison_pill);
+    client_3.tell(poison_pill);
+    server.tell(poison_pill);
+}
+
+namespace
+{
+    using frames_list = std::vector<std::vector<char>>;
+
+    /**
+     * Runs echo stream for every connection
+     */
+    class FrameEchoServer
+        : public yato::actors::actor
+    {
+        yato::actors::actor_ref m_output;
+        size_t m_max_frame_size;
+        uint32_t m_counter = 0;
+
+        void receive(yato::any && message) override {
+            using namespace yato::actors;
+            yato::any_match(
+                [this](const io::tcp::bound & bound) {
+                    m_output.tell(bound);
+                },
+                [this](const io::tcp::connected &) {
+                    streams::stream::from(io::tcp::frame_source(sender(), m_max_frame_size))
+                        .buffer_size(4)
+                        .to(io::tcp::frame_sink(sender()))
+                        .run(system(), "echo_" + std::to_string(m_counter++));
+                }
+            )(message);
+        }
+
+    public:
+        explicit
+        FrameEchoServer(const yato::actors::actor_ref & output, size_t max_frame_size = 16 * 1024 * 1024)
+            : m_output(output), m_max_frame_size(max_frame_size)
+        { }
+    };
+
+    /**
+     * Sends frames by a stream and forwards raw response bytes to output
+     */
+    class FrameClient
+        : public yato::actors::actor
+    {
+        yato::actors::actor_ref m_output;
+        frames_list m_frames;
+
+        void receive(yato::any && message) override {
+            using namespace yato::actors;
+            yato::any_match(
+                [this](const io::tcp::connected &) {
+                    sender().tell(io::tcp::assign(self()));
+                    streams::stream::from_vector(m_frames)
+                        .to(io::tcp::frame_sink(sender()))
+                        .run(system(), "frames");
+                },
+                [this](const io::tcp::received & received) {
+                    m_output.tell(received.data);
+                },
+                [this](const io::tcp::peer_closed & closed) {
+                    m_output.tell(closed);
+                }
+            )(message);
+        }
+
+    public:
+        FrameClient(const yato::actors::actor_ref & output, const frames_list & frames)
+            : m_output(output), m_frames(frames)
+        { }
+    };
+}
+
+TEST(Yato_Actors, io_tcp_frame_stream)
+{
+    using namespace yato::actors;
+
+    auto conf_builder = yato::config_builder::object();
+    conf_builder.put("log_level", "verbose");
+    conf_builder.put("enable_io", true);
+
+    actor_system system("default", conf_builder.create());
+
+    actor_ref manager;
+    ASSERT_NO_THROW(manager = io::tcp::get_for(system));
+
+    inbox server_output(system, "server_output");
+    const auto server = system.create_actor<FrameEchoServer>("server", server_output.ref());
+    manager.tell(io::tcp::bind(server, io::inet_address("localhost", 9006)));
+    ASSERT_TRUE(server_output.receive(std::chrono::seconds(5)).is_type<io::tcp::bound>());
+
+    frames_list frames;
+    frames.push_back(std::vector<char>{ 'a' });
+    frames.push_back(std::vector<char>{});
+    frames.push_back(std::vector<char>(100000, 'x'));
+    for (int i = 0; i < 50; ++i) {
+        frames.push_back(std::vector<char>(static_cast<size_t>(i), static_cast<char>(i)));
+    }
+
+    std::vector<char> expected;
+    for (const auto & f : frames) {
+        const uint32_t size = static_cast<uint32_t>(f.size());
+        const char* p = reinterpret_cast<const char*>(&size);
+        expected.insert(expected.end(), p, p + sizeof(size));
+        expected.insert(expected.end(), f.cbegin(), f.cend());
+    }
+
+    inbox output(system, "output");
+    const auto client = system.create_actor<FrameClient>("client", output.ref(), frames);
+    manager.tell(io::tcp::connect(client, io::inet_address("localhost", 9006)));
+
+    std::vector<char> response;
+    while (response.size() < expected.size()) {
+        auto msg = output.receive(std::chrono::seconds(5));
+        ASSERT_TRUE(msg.is_type<std::vector<char>>());
+        const auto & data = msg.get_unsafe<std::vector<char>>();
+        response.insert(response.end(), data.cbegin(), data.cend());
+    }
+    EXPECT_EQ(expected, response);
+
+    client.tell(poison_pill);
+    server.tell(poison_pill);
+}
+
+TEST(Yato_Actors, io_tcp_frame_limit)
+{
+    using namespace yato::actors;
+
+    auto conf_builder = yato::config_builder::object();
+    conf_builder.put("log_level", "verbose");
+    conf_builder.put("enable_io", true);
+
+    actor_system system("default", conf_builder.create());
+
+    actor_ref manager;
+    ASSERT_NO_THROW(manager = io::tcp::get_for(system));
+
+    inbox server_output(system, "server_output");
+    const auto server = system.create_actor<FrameEchoServer>("server", server_output.ref(), 1024);
+    manager.tell(io::tcp::bind(server, io::inet_address("localhost", 9007)));
+    ASSERT_TRUE(server_output.receive(std::chrono::seconds(5)).is_type<io::tcp::bound>());
+
+    // Oversized frame fails the server stream as soon as its size is received, so the connection is closed
+    frames_list frames;
+    frames.push_back(std::vector<char>{ 'a' });
+    frames.push_back(std::vector<char>(4096, 'x'));
+
+    inbox output(system, "output");
+    const auto client = system.create_actor<FrameClient>("client", output.ref(), frames);
+    manager.tell(io::tcp::connect(client, io::inet_address("localhost", 9007)));
+
+    bool closed = false;
+    while (!closed) {
+        auto msg = output.receive(std::chrono::seconds(5));
+        ASSERT_FALSE(msg.empty());
+        closed = msg.is_type<io::tcp::peer_closed>();
+    }
+
+    client.tell(poison_pill);
+    server.tell(poison_pill);
+}
@@ -8,8 +8,10 @@
 #include "gtest/gtest.h"
 
 #include <thread>
+#include <vector>
 
 #include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
 #include <yato/actors/logger.h>
 #include <yato/any_match.h>
 #include <yato/stl_utility.h>
@@ -366,3 +368,60 @@ TEST(Yato_Actors, executions)
     system.create_actor<actF0>(props_dyn, "F0");
 }
 
+
+
+namespace
+{
+    class IncrementActor
+        : public yato::actors::actor
+    {
+        void receive(yato::any && message) override
+        {
+            sender().tell(message.get<int>() + 1);
+        }
+    };
+}
+
+TEST(Yato_Actors, pinned_threads_reuse)
+{
+    using namespace yato::actors;
+
+    actor_system system("default", actors_pinned_multiplexed_config(2, 1));
+
+    properties props;
+    props.execution_name = "pinned";
+
+    // More actors than threads, but only one is alive at a time
+    for (int i = 0; i < 10; ++i) {
+        const auto actor = system.create_actor<IncrementActor>(props, "inc_" + std::to_string(i));
+        EXPECT_EQ(i + 1, system.ask(actor, i, std::chrono::seconds(5)).get().get<int>());
+
+        inbox watcher(system, "watcher_" + std::to_string(i));
+        watcher.watch(actor);
+        actor.tell(poison_pill);
+        ASSERT_TRUE(watcher.receive(std::chrono::seconds(5)).is_type<terminated>());
+    }
+}
+
+TEST(Yato_Actors, pinned_multiplexed)
+{
+    using namespace yato::actors;
+
+    actor_system system("default", actors_pinned_multiplexed_config(2, 4));
+
+    properties props;
+    props.execution_name = "pinned";
+
+    std::vector<actor_ref> actors;
+    for (int i = 0; i < 8; ++i) {
+        actors.push_back(system.create_actor<IncrementActor>(props, "inc_" + std::to_string(i)));
+    }
+    for (int k = 0; k < 10; ++k) {
+        for (size_t i = 0; i < actors.size(); ++i) {
+            EXPECT_EQ(k + 1, system.ask(actors[i], k, std::chrono::seconds(5)).get().get<int>());
+        }
+    }
+    for (const auto & actor : actors) {
+        actor.tell(poison_pill);
+    }
+}
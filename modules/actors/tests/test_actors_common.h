@@ -68,4 +68,22 @@ yato::config actors_pinned_config(const std::string & log_level = "debug", uint3
         .create();
 }
 
+inline
+yato::config actors_pinned_multiplexed_config(uint32_t threads_lim, uint32_t actors_per_thread)
+{
+    return yato::config_builder::object()
+        .put("log_level", "debug")
+        .put("execution_contexts", yato::config_builder::array()
+            .add(yato::config_builder::object()
+                .put("name", "pinned")
+                .put("type", "pinned")
+                .put("threads_limit", threads_lim)
+                .put("actors_per_thread", actors_per_thread)
+                .create()
+            )
+            .create()
+        )
+        .create();
+}
+
 #endif // _YATO_TEST_ACTORS_COMMON_H_
@@ -0,0 +1,85 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/actors/logger.h>
+#include <yato/config/config_builder.h>
+
+namespace
+{
+    class TestActor
+        : public yato::actors::actor
+    {
+        void receive(yato::any &&) override
+        { }
+    };
+}
+
+TEST(Yato_Actors, dead_letters)
+{
+    using namespace yato::actors;
+
+    actor_system system("default", yato::config_builder::object()
+        .put("log_level", "verbose")
+        .put("dead_letters_capture", 2)
+        .create());
+
+    inbox subscriber(system, "subscriber");
+    system.subscribe_dead_letters(subscriber.ref());
+
+    for (int i = 0; i < 5; ++i) {
+        system.dead_letters().tell(i);
+    }
+
+    const auto actor = system.create_actor<TestActor>("test");
+    subscriber.watch(actor);
+    actor.tell(poison_pill);
+
+    size_t received = 0;
+    bool stopped = false;
+    while (!stopped || (received < 4)) {
+        const auto msg = subscriber.receive(std::chrono::seconds(5));
+        ASSERT_FALSE(msg.empty());
+        if (msg.is_type<terminated>()) {
+            stopped = true;
+            for (int i = 0; i < 3; ++i) {
+                actor.tell(std::string("ping"));
+            }
+        }
+        else if (msg.is_type<dead_letter>()) {
+            const auto & letter = msg.get<dead_letter>();
+            if (letter.message.is_type<int>()) {
+                EXPECT_EQ(dead_letter_reason::no_recipient, letter.reason);
+            }
+            else {
+                EXPECT_TRUE(letter.message.is_type<std::string>());
+                EXPECT_EQ(dead_letter_reason::recipient_stopped, letter.reason);
+                EXPECT_EQ(actor, letter.recipient);
+            }
+            ++received;
+        }
+    }
+
+    const auto stats = system.dead_letter_stats();
+    EXPECT_GE(stats.user_messages, 8u);
+    EXPECT_EQ(4u, stats.samples.size());
+    for (const auto & counter : stats.by_type) {
+        if (counter.type_name == typeid(int).name()) {
+            EXPECT_EQ(5u, counter.count);
+        }
+        if (counter.type_name == typeid(std::string).name()) {
+            EXPECT_EQ(3u, counter.count);
+        }
+    }
+
+    system.subscribe_dead_letters(actor_ref{});
+}
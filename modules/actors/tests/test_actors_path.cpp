@@ -58,3 +58,26 @@ TEST(Yato_Actors, path4)
     auto p3 = yato::actors::actor_path("yato://someSystem");
     ASSERT_FALSE(p3.parce(elems));
 }
+
+TEST(Yato_Actors, path_interned)
+{
+    using namespace yato::actors;
+
+    const auto parent = actor_path("system", actor_scope::user, "parent");
+    const auto child  = actor_path::join(parent, "child");
+    const auto same   = actor_path(std::string("yato://system/user/parent/child"));
+
+    EXPECT_EQ(child, same);
+    EXPECT_EQ(child.hash(), same.hash());
+    EXPECT_EQ(std::hash<std::string>{}(same.to_string()), same.hash());
+    EXPECT_EQ("child", child.get_name());
+    EXPECT_NE(parent, child);
+
+    ASSERT_EQ(2U, child.elements().names.size());
+    EXPECT_EQ(actor_scope::user, child.elements().scope);
+    EXPECT_EQ("parent", child.elements().names[0]);
+    EXPECT_EQ("child", child.elements().names[1]);
+
+    EXPECT_EQ(actor_path(std::string{}), actor_path(""));
+    EXPECT_EQ(actor_scope::unknown, actor_path("").elements().scope);
+}
@@ -0,0 +1,387 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/actors/persistence/persistent_actor.h>
+#include <yato/any_match.h>
+
+#include "test_actors_common.h"
+
+namespace
+{
+    // Commands
+    struct add
+    {
+        int64_t value;
+    };
+
+    struct get_state {};
+
+    // Event
+    struct added
+    {
+        int64_t value;
+    };
+
+    // Snapshot
+    struct counter_state
+    {
+        int64_t total;
+    };
+
+    struct counter_report
+    {
+        int64_t total;
+        uint64_t sequence;
+        int64_t recovered_events;
+        bool from_snapshot;
+    };
+
+    class Counter
+        : public yato::actors::persistence::persistent_actor
+    {
+        int64_t m_total = 0;
+        int64_t m_recovered_events = 0;
+        bool m_from_snapshot = false;
+
+        void receive_recover(const yato::any & event) override
+        {
+            m_total += event.get<added>().value;
+            ++m_recovered_events;
+        }
+
+        void recover_snapshot(const yato::any & state) override
+        {
+            m_total = state.get<counter_state>().total;
+            m_from_snapshot = true;
+        }
+
+        yato::any snapshot() const override
+        {
+            return yato::any(counter_state{ m_total });
+        }
+
+        void receive_command(yato::any && message) override
+        {
+            yato::any_match(
+                [this](const add & cmd) {
+                    persist(added{ cmd.value }, [this](const added & e) {
+                        m_total += e.value;
+                        sender().tell(m_total);
+                    });
+                },
+                [this](const get_state &) {
+                    sender().tell(counter_report{ m_total, last_sequence(), m_recovered_events, m_from_snapshot });
+                }
+            )(message);
+        }
+
+    public:
+        Counter(const std::shared_ptr<yato::actors::persistence::journal> & events_journal, uint32_t snapshot_interval)
+            : persistent_actor(events_journal, snapshot_interval)
+        { }
+    };
+
+    // Persists a note, which can be too large for the journal, followed by an addition
+    struct add_with_note
+    {
+        int64_t value;
+        size_t note_size;
+    };
+
+    struct ledger_report
+    {
+        int64_t total;
+        uint64_t sequence;
+        int64_t failures;
+    };
+
+    class Ledger
+        : public yato::actors::persistence::persistent_actor
+    {
+        int64_t m_total = 0;
+        int64_t m_failures = 0;
+
+        void receive_recover(const yato::any & event) override
+        {
+            if (event.is_type<added>()) {
+                m_total += event.get_unsafe<added>().value;
+            }
+        }
+
+        void receive_command(yato::any && message) override
+        {
+            yato::any_match(
+                [this](const add & cmd) {
+                    persist(added{ cmd.value }, [this](const added & e) {
+                        m_total += e.value;
+                        sender().tell(m_total);
+                    });
+                },
+                [this](const add_with_note & cmd) {
+                    persist(std::string(cmd.note_size, 'x'), [](const std::string &) {});
+                    persist(added{ cmd.value }, [this](const added & e) {
+                        m_total += e.value;
+                        sender().tell(m_total);
+                    });
+                },
+                [this](const get_state &) {
+                    sender().tell(ledger_report{ m_total, last_sequence(), m_failures });
+                }
+            )(message);
+        }
+
+        void on_persist_failure(const std::string &) override
+        {
+            ++m_failures;
+        }
+
+    public:
+        explicit
+        Ledger(const std::shared_ptr<yato::actors::persistence::journal> & events_journal)
+            : persistent_actor(events_journal)
+        { }
+    };
+
+    void register_counter_types(yato::actors::actor_system & system)
+    {
+        system.serialization().register_type<added>("test.added");
+        system.serialization().register_type<counter_state>("test.counter_state");
+    }
+
+    counter_report run_counter(const std::string & directory, uint32_t snapshot_interval, int64_t adds)
+    {
+        using namespace yato::actors;
+
+        yato::actors::persistence::journal_options options;
+        options.segment_size = 4096;
+        auto events_journal = persistence::journal::open(directory, options);
+
+        actor_system system("default", actors_debug_config());
+        register_counter_types(system);
+        inbox output(system, "output");
+
+        const auto counter = system.create_actor<Counter>("counter", events_journal, snapshot_interval);
+        for (int64_t i = 1; i <= adds; ++i) {
+            output.send(counter, add{ i });
+        }
+        for (int64_t i = 1; i <= adds; ++i) {
+            EXPECT_TRUE(output.receive(std::chrono::seconds(5)).is_type<int64_t>());
+        }
+        output.send(counter, get_state{});
+        auto report = output.receive(std::chrono::seconds(5));
+        counter.tell(poison_pill);
+        EXPECT_TRUE(report.is_type<counter_report>());
+        return report.get<counter_report>();
+    }
+}
+
+TEST(Yato_Actors, persistence_recovery)
+{
+    const std::string directory = "yato_test_journal_recovery";
+    yato::actors::persistence::journal::remove(directory);
+
+    // Commands are stashed while events are written, so totals are consistent
+    const auto first = run_counter(directory, 0, 100);
+    EXPECT_EQ(5050, first.total);
+    EXPECT_EQ(100u, first.sequence);
+    EXPECT_EQ(0, first.recovered_events);
+
+    const auto second = run_counter(directory, 0, 10);
+    EXPECT_EQ(5050 + 55, second.total);
+    EXPECT_EQ(110u, second.sequence);
+    EXPECT_EQ(100, second.recovered_events);
+    EXPECT_FALSE(second.from_snapshot);
+
+    yato::actors::persistence::journal::remove(directory);
+}
+
+TEST(Yato_Actors, persistence_snapshot)
+{
+    const std::string directory = "yato_test_journal_snapshot";
+    yato::actors::persistence::journal::remove(directory);
+
+    run_counter(directory, 10, 95);
+
+    const auto report = run_counter(directory, 10, 0);
+    EXPECT_EQ(95 * 96 / 2, report.total);
+    EXPECT_EQ(95u, report.sequence);
+    EXPECT_TRUE(report.from_snapshot);
+    EXPECT_LT(report.recovered_events, 10);
+
+    yato::actors::persistence::journal::remove(directory);
+}
+
+TEST(Yato_Actors, persistence_journal_segments)
+{
+    using namespace yato::actors;
+
+    const std::string directory = "yato_test_journal_segments";
+    persistence::journal::remove(directory);
+
+    actor_system system("default", actors_debug_config());
+    inbox output(system, "output");
+
+    persistence::journal_options options;
+    options.segment_size = 256;
+    options.sync = false;
+    {
+        auto events_journal = persistence::journal::open(directory, options);
+        for (uint64_t i = 1; i <= 50; ++i) {
+            events_journal->append(i % 2 ? "odd" : "even", i, 7, std::vector<char>(static_cast<size_t>(i), static_cast<char>(i)), output.ref());
+        }
+        events_journal->flush();
+        // Too large for a segment
+        events_journal->append("odd", 51, 7, std::vector<char>(1024), output.ref());
+        events_journal->flush();
+    }
+
+    bool failed = false;
+    for (;;) {
+        auto msg = output.receive(std::chrono::milliseconds(100));
+        if (msg.empty()) {
+            break;
+        }
+        if (msg.is_type<persistence::journal_failure>()) {
+            EXPECT_EQ(51u, msg.get_unsafe<persistence::journal_failure>().sequence);
+            failed = true;
+        }
+    }
+    EXPECT_TRUE(failed);
+
+    auto events_journal = persistence::journal::open(directory, options);
+    std::vector<uint64_t> sequences;
+    events_journal->replay("even", persistence::journal_position{}, 10, [&](uint64_t sequence, serialization_registry::type_id type, input_buffer & payload) {
+        EXPECT_EQ(7u, type);
+        EXPECT_EQ(sequence, payload.remaining());
+        sequences.push_back(sequence);
+    });
+    ASSERT_EQ(20u, sequences.size());
+    EXPECT_EQ(12u, sequences.front());
+    EXPECT_EQ(50u, sequences.back());
+
+    events_journal.reset();
+    persistence::journal::remove(directory);
+}
+
+TEST(Yato_Actors, persistence_failure)
+{
+    using namespace yato::actors;
+
+    const std::string directory = "yato_test_journal_failure";
+    persistence::journal::remove(directory);
+
+    persistence::journal_options options;
+    options.segment_size = 4096;
+    {
+        auto events_journal = persistence::journal::open(directory, options);
+
+        actor_system system("default", actors_debug_config());
+        register_counter_types(system);
+        system.serialization().register_type<std::string>("test.note");
+        inbox output(system, "output");
+
+        const auto ledger = system.create_actor<Ledger>("ledger", events_journal);
+        output.send(ledger, add{ 1 });
+        ASSERT_EQ(1, output.receive(std::chrono::seconds(5)).get<int64_t>());
+
+        // The note is larger than a segment, so the addition persisted after it is dropped too and its sequence number is reused
+        output.send(ledger, add_with_note{ 100, 2 * options.segment_size });
+        output.send(ledger, add{ 2 });
+        ASSERT_EQ(3, output.receive(std::chrono::seconds(5)).get<int64_t>());
+
+        output.send(ledger, add_with_note{ 10, 8 });
+        ASSERT_EQ(13, output.receive(std::chrono::seconds(5)).get<int64_t>());
+
+        output.send(ledger, get_state{});
+        const auto report = output.receive(std::chrono::seconds(5)).get<ledger_report>();
+        EXPECT_EQ(13, report.total);
+        EXPECT_EQ(4u, report.sequence);
+        EXPECT_EQ(1, report.failures);
+        ledger.tell(poison_pill);
+    }
+    {
+        auto events_journal = persistence::journal::open(directory, options);
+
+        actor_system system("default", actors_debug_config());
+        register_counter_types(system);
+        system.serialization().register_type<std::string>("test.note");
+        inbox output(system, "output");
+
+        const auto ledger = system.create_actor<Ledger>("ledger", events_journal);
+        output.send(ledger, get_state{});
+        const auto report = output.receive(std::chrono::seconds(5)).get<ledger_report>();
+        EXPECT_EQ(13, report.total);
+        EXPECT_EQ(4u, report.sequence);
+        EXPECT_EQ(0, report.failures);
+        ledger.tell(poison_pill);
+    }
+
+    persistence::journal::remove(directory);
+}
+
+TEST(Yato_Actors, persistence_torn_tail)
+{
+    using namespace yato::actors;
+
+    const std::string directory = "yato_test_journal_torn_tail";
+    persistence::journal::remove(directory);
+
+    persistence::journal_options options;
+    options.segment_size = 4096;
+    options.sync = false;
+
+    const auto replay_all = [](const persistence::journal & events_journal) {
+        std::vector<uint64_t> sequences;
+        events_journal.replay("entity", persistence::journal_position{}, 0, [&](uint64_t sequence, serialization_registry::type_id, input_buffer & payload) {
+            EXPECT_EQ(sizeof(uint64_t), payload.remaining());
+            sequences.push_back(sequence);
+        });
+        return sequences;
+    };
+
+    {
+        auto events_journal = persistence::journal::open(directory, options);
+        for (uint64_t i = 1; i <= 10; ++i) {
+            events_journal->append("entity", i, 7, std::vector<char>(sizeof(uint64_t), static_cast<char>(i)), actor_ref{});
+        }
+        events_journal->flush();
+    }
+
+    // Record: [u32 size][u32 checksum][u32 id length]["entity"][u64 sequence][u32 type][u64 payload], after the 16 bytes of the segment header
+    const long record_size = 8 + 4 + 6 + 8 + 4 + 8;
+    const long last_payload = 16 + 9 * record_size + record_size - 8;
+    {
+        std::FILE* file = std::fopen((directory + "/segment_00000000.journal").c_str(), "r+b");
+        ASSERT_NE(nullptr, file);
+        std::fseek(file, last_payload, SEEK_SET);
+        std::fputc(0x7F, file);
+        std::fclose(file);
+    }
+
+    {
+        auto events_journal = persistence::journal::open(directory, options);
+        const auto sequences = replay_all(*events_journal);
+        ASSERT_EQ(9u, sequences.size());
+        EXPECT_EQ(9u, sequences.back());
+
+        // The torn record is cleared, so the next record follows the last good one
+        events_journal->append("entity", 10, 7, std::vector<char>(sizeof(uint64_t), 10), actor_ref{});
+        events_journal->flush();
+    }
+    {
+        auto events_journal = persistence::journal::open(directory, options);
+        const auto sequences = replay_all(*events_journal);
+        ASSERT_EQ(10u, sequences.size());
+        EXPECT_EQ(10u, sequences.back());
+    }
+
+    persistence::journal::remove(directory);
+}
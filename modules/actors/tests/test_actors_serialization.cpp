@@ -0,0 +1,184 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <yato/prerequisites.h>
+
+YATO_GCC_WARNING_IGNORE("-Wunused-function")
+YATO_CLANG_WARNING_IGNORE("-Wunused-function")
+
+#include <yato/actors/serialization.h>
+
+namespace
+{
+    struct point
+    {
+        int32_t x;
+        float y;
+    };
+
+    struct padded
+    {
+        int8_t tag;
+        int32_t value;
+    };
+
+    class sample
+    {
+        YATO_REFLECT_CLASS(sample)
+
+    private:
+        std::string YATO_REFLECT_VAR_INLINE(name)
+        std::vector<point> YATO_REFLECT_VAR_INLINE(points)
+
+    public:
+        std::vector<std::string> YATO_REFLECT_VAR_INLINE(tags)
+        int64_t YATO_REFLECT_VAR_INLINE(id)
+
+        sample() = default;
+
+        sample(const std::string & name, const std::vector<point> & points)
+            : name(name), points(points)
+        { }
+
+        const std::string & get_name() const
+        {
+            return name;
+        }
+
+        const std::vector<point> & get_points() const
+        {
+            return points;
+        }
+    };
+
+    template <typename Ty_>
+    Ty_ round_trip(const Ty_ & value)
+    {
+        yato::actors::output_buffer out;
+        yato::actors::serializer<Ty_>::write(out, value);
+
+        Ty_ result{};
+        yato::actors::input_buffer in(out.data(), out.data() + out.size());
+        EXPECT_TRUE(yato::actors::serializer<Ty_>::read(in, result));
+        EXPECT_EQ(0u, in.remaining());
+        return result;
+    }
+}
+
+namespace yato
+{
+namespace actors
+{
+    // Has floating point member, but no padding
+    template <>
+    struct is_bitwise_serializable<point>
+        : std::true_type
+    { };
+}
+}
+
+static_assert(yato::actors::is_bitwise_serializable<int64_t>::value, "Integers are copied");
+static_assert(yato::actors::is_bitwise_serializable<double>::value, "Floating point is copied");
+static_assert(!yato::actors::is_bitwise_serializable<padded>::value, "Padding bytes are not sent");
+static_assert(!yato::actors::is_bitwise_serializable<const char*>::value, "Pointers are not sent");
+static_assert(!yato::actors::is_bitwise_serializable<sample>::value, "Reflected class is serialized by members");
+
+TEST(Yato_Actors, serialization_common)
+{
+    const point p = round_trip(point{ 1, 2.0f });
+    EXPECT_EQ(1, p.x);
+    EXPECT_EQ(2.0f, p.y);
+
+    EXPECT_EQ(std::string("hello"), round_trip(std::string("hello")));
+    EXPECT_EQ(std::string(), round_trip(std::string()));
+
+    const std::vector<int> ints = { 1, 2, 3, 4 };
+    EXPECT_EQ(ints, round_trip(ints));
+
+    const std::vector<std::string> strings = { "a", "", "bcd" };
+    EXPECT_EQ(strings, round_trip(strings));
+
+    const std::vector<bool> bools = { true, false, true };
+    EXPECT_EQ(bools, round_trip(bools));
+
+    const std::vector<std::vector<int>> nested = { { 1 }, {}, { 2, 3 } };
+    EXPECT_EQ(nested, round_trip(nested));
+}
+
+TEST(Yato_Actors, serialization_reflected)
+{
+    sample s("sample", { point{ 1, 1.0f }, point{ 2, 2.0f } });
+    s.tags = { "x", "y" };
+    s.id = 42;
+
+    const sample res = round_trip(s);
+    EXPECT_EQ("sample", res.get_name());
+    ASSERT_EQ(2u, res.get_points().size());
+    EXPECT_EQ(2, res.get_points()[1].x);
+    EXPECT_EQ(s.tags, res.tags);
+    EXPECT_EQ(42, res.id);
+}
+
+TEST(Yato_Actors, serialization_malformed)
+{
+    yato::actors::output_buffer out;
+    yato::actors::serializer<std::vector<std::string>>::write(out, { "abc", "def" });
+
+    std::vector<std::string> res;
+    yato::actors::input_buffer in(out.data(), out.data() + out.size() - 1);
+    EXPECT_FALSE(yato::actors::serializer<std::vector<std::string>>::read(in, res));
+
+    // Huge size
+    yato::actors::output_buffer bad;
+    yato::actors::serializer<uint32_t>::write(bad, 0xFFFFFFFFu);
+    std::vector<int> ints;
+    yato::actors::input_buffer bad_in(bad.data(), bad.data() + bad.size());
+    EXPECT_FALSE(yato::actors::serializer<std::vector<int>>::read(bad_in, ints));
+}
+
+TEST(Yato_Actors, serialization_registry)
+{
+    using namespace yato::actors;
+
+    serialization_registry registry;
+    const auto point_id  = registry.register_type<point>("test.point");
+    const auto string_id = registry.register_type<std::string>("std.string");
+    registry.register_type<sample>("test.sample");
+    EXPECT_NE(point_id, string_id);
+    EXPECT_EQ(point_id, serialization_registry::make_id("test.point"));
+
+    // Duplicates are accepted only for the same codec
+    EXPECT_EQ(point_id, registry.register_type<point>("test.point"));
+    EXPECT_THROW(registry.register_type<sample>("test.point"), yato::argument_error);
+    EXPECT_THROW(registry.register_type<point>("test.point2"), yato::argument_error);
+    EXPECT_EQ(point_id, registry.find(typeid(point))->id);
+
+    output_buffer out(256);
+    const auto entry = registry.encode(yato::any(std::string("message")), out);
+    ASSERT_NE(nullptr, entry);
+    EXPECT_EQ(string_id, entry->id);
+
+    yato::any value;
+    input_buffer in(out.data(), out.data() + out.size());
+    ASSERT_TRUE(registry.decode(string_id, in, value));
+    ASSERT_TRUE(value.is_type<std::string>());
+    EXPECT_EQ("message", value.get_unsafe<std::string>());
+
+    // Buffer is reused
+    const char* storage = out.data();
+    out.clear();
+    registry.encode(yato::any(point{ 3, 4.0f }), out);
+    EXPECT_EQ(storage, out.data());
+
+    EXPECT_EQ(nullptr, registry.encode(yato::any(1.0), out));
+    EXPECT_FALSE(registry.decode(serialization_registry::make_id("unknown"), in, value));
+
+    // Registry is frozen by the first lookup
+    EXPECT_THROW(registry.register_type<double>("double"), yato::runtime_error);
+}
@@ -12,6 +12,7 @@
 
 #include <yato/any_match.h>
 #include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
 #include <yato/actors/logger.h>
 #include <yato/stl_utility.h>
 
@@ -88,3 +89,240 @@ TEST(Yato_Actors, highload_spawn)
 }
 
 
+
+namespace
+{
+    const size_t CHILDREN_NUM = 2000;
+
+    struct children_ready {};
+
+    class IdleActor
+        : public yato::actors::actor
+    {
+        void receive(yato::any &&) override
+        { }
+    };
+
+    class ParentActor
+        : public yato::actors::actor
+    {
+        yato::actors::actor_ref m_output;
+
+        void pre_start() override
+        {
+            for (size_t i = 0; i < CHILDREN_NUM; ++i) {
+                const auto child = create_child<IdleActor>("child_" + yato::stl::to_string(i));
+                // Detach in an arbitrary order
+                if (i % 3 == 0) {
+                    child.tell(yato::actors::poison_pill);
+                }
+            }
+            m_output.tell(children_ready{});
+        }
+
+        void receive(yato::any &&) override
+        { }
+
+    public:
+        explicit
+        ParentActor(const yato::actors::actor_ref & output)
+            : m_output(output)
+        { }
+    };
+}
+
+TEST(Yato_Actors, many_children)
+{
+    using namespace yato::actors;
+
+    actor_system system("default");
+    inbox output(system, "output");
+
+    const auto parent = system.create_actor<ParentActor>("parent", output.ref());
+    ASSERT_TRUE(output.receive(std::chrono::seconds(5)).is_type<children_ready>());
+
+    EXPECT_NO_THROW(system.find("parent/child_1", std::chrono::seconds(5)).get());
+    EXPECT_NO_THROW(system.find("parent/child_1999", std::chrono::seconds(5)).get());
+
+    output.watch(parent);
+    parent.tell(poison_pill);
+    const auto msg = output.receive(std::chrono::seconds(10));
+    ASSERT_TRUE(msg.is_type<terminated>());
+    EXPECT_EQ(parent, msg.get_unsafe<terminated>().ref);
+}
+
+
+
+namespace
+{
+    const size_t SPAWN_THREADS = 4;
+    const size_t SPAWN_PER_THREAD = 500;
+
+    struct pong {};
+
+    class OneShotActor
+        : public yato::actors::actor
+    {
+        void receive(yato::any &&) override
+        {
+            sender().tell(pong{});
+            self().stop();
+        }
+    };
+}
+
+TEST(Yato_Actors, concurrent_spawn)
+{
+    using namespace yato::actors;
+
+    actor_system system("default");
+    inbox output(system, "output");
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < SPAWN_THREADS; ++t) {
+        threads.emplace_back([&system, &output, t] {
+            for (size_t i = 0; i < SPAWN_PER_THREAD; ++i) {
+                const auto actor = system.create_actor<OneShotActor>("spawned_" + yato::stl::to_string(t) + "_" + yato::stl::to_string(i));
+                // Is delivered right after start
+                output.send(actor, run_actor{});
+            }
+        });
+    }
+    for (auto & t : threads) {
+        t.join();
+    }
+
+    for (size_t i = 0; i < SPAWN_THREADS * SPAWN_PER_THREAD; ++i) {
+        ASSERT_TRUE(output.receive(std::chrono::seconds(5)).is_type<pong>());
+    }
+
+    const auto idle = system.create_actor<IdleActor>("idle");
+    EXPECT_EQ(idle, system.find("idle", std::chrono::seconds(5)).get());
+    idle.tell(poison_pill);
+}
+
+
+
+namespace
+{
+    class CountingActor
+        : public yato::actors::actor
+    {
+        std::atomic<int> & m_stopped;
+        std::atomic<int> & m_processed;
+
+        void post_stop() override
+        {
+            ++m_stopped;
+        }
+
+        void receive(yato::any &&) override
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++m_processed;
+        }
+
+    public:
+        CountingActor(std::atomic<int> & stopped, std::atomic<int> & processed)
+            : m_stopped(stopped), m_processed(processed)
+        { }
+    };
+
+    class CountingParent
+        : public yato::actors::actor
+    {
+        std::atomic<int> & m_stopped;
+        std::atomic<int> & m_processed;
+        yato::actors::actor_ref m_output;
+
+        void pre_start() override
+        {
+            for (size_t i = 0; i < CHILDREN_NUM; ++i) {
+                create_child<CountingActor>("child_" + yato::stl::to_string(i), m_stopped, m_processed);
+            }
+            m_output.tell(children_ready{});
+        }
+
+        void post_stop() override
+        {
+            ++m_stopped;
+        }
+
+        void receive(yato::any &&) override
+        { }
+
+    public:
+        CountingParent(std::atomic<int> & stopped, std::atomic<int> & processed, const yato::actors::actor_ref & output)
+            : m_stopped(stopped), m_processed(processed), m_output(output)
+        { }
+    };
+
+    struct gate
+    { };
+
+    /**
+     * Holds the first message until the user guardian has sent stop to all its children.
+     * Counts messages received after the gate.
+     */
+    class GateActor
+        : public yato::actors::actor
+    {
+        std::atomic<int> & m_stopped;
+        std::atomic<int> & m_processed;
+        int m_stopped_before;
+
+        void post_stop() override
+        {
+            ++m_stopped;
+        }
+
+        void receive(yato::any && message) override
+        {
+            if (!message.is_type<gate>()) {
+                ++m_processed;
+                return;
+            }
+            // The sibling subtree is stopped only after the guardian has started handling its stop
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while ((m_stopped.load() < m_stopped_before) && (std::chrono::steady_clock::now() < deadline)) {
+                std::this_thread::yield();
+            }
+            // Selection is handled by the guardian after its stop, which has already put stop into this mailbox
+            system().find("parent", std::chrono::seconds(5)).get();
+        }
+
+    public:
+        GateActor(std::atomic<int> & stopped, std::atomic<int> & processed, int stopped_before)
+            : m_stopped(stopped), m_processed(processed), m_stopped_before(stopped_before)
+        { }
+    };
+}
+
+TEST(Yato_Actors, fast_shutdown)
+{
+    using namespace yato::actors;
+
+    std::atomic<int> stopped{ 0 };
+    std::atomic<int> processed{ 0 };
+    {
+        actor_system system("default", yato::config_builder::object()
+            .put("log_level", "verbose")
+            .put("fast_shutdown", true)
+            .create());
+        {
+            inbox output(system, "output");
+            system.create_actor<CountingParent>("parent", stopped, processed, output.ref());
+            ASSERT_TRUE(output.receive(std::chrono::seconds(5)).is_type<children_ready>());
+        }
+        const auto busy = system.create_actor<GateActor>("busy", stopped, processed, static_cast<int>(CHILDREN_NUM) + 1);
+        busy.tell(gate{});
+        for (int i = 0; i < 1000; ++i) {
+            busy.tell(i);
+        }
+        // Pending messages are dropped
+        system.shutdown();
+    }
+    EXPECT_EQ(static_cast<int>(CHILDREN_NUM) + 2, stopped.load());
+    // Stop overtakes all messages queued behind the gate
+    EXPECT_EQ(0, processed.load());
+}
@@ -0,0 +1,179 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/actors/streams/stream.h>
+
+#include "test_actors_common.h"
+
+TEST(Yato_Actors, stream_fused_ops)
+{
+    using namespace yato::actors;
+
+    actor_system system("default", actors_debug_config());
+    inbox output(system, "output");
+
+    streams::stream::range(0, 1000)
+        .map<int>([](int x) { return 2 * x; })
+        .filter<int>([](int x) { return x % 3 == 0; })
+        .async()
+        .map<int>([](int x) { return static_cast<int64_t>(x) + 1; })
+        .to(streams::to_actor(output.ref()))
+        .run(system, "pipeline");
+
+    int64_t expected = 1;
+    int count = 0;
+    for (;;) {
+        auto msg = output.receive(std::chrono::seconds(5));
+        ASSERT_FALSE(msg.empty());
+        if (msg.is_type<streams::on_complete>()) {
+            break;
+        }
+        ASSERT_TRUE(msg.is_type<int64_t>());
+        ASSERT_EQ(expected, msg.get_unsafe<int64_t>());
+        expected += 6;
+        ++count;
+    }
+    EXPECT_EQ(334, count);
+}
+
+TEST(Yato_Actors, stream_batch)
+{
+    using namespace yato::actors;
+
+    actor_system system("default", actors_debug_config());
+    inbox output(system, "output");
+
+    streams::stream::range(0, 10)
+        .batch(4, std::chrono::seconds(10))
+        .to(streams::to_actor(output.ref()))
+        .run(system, "pipeline");
+
+    std::vector<size_t> sizes;
+    int expected = 0;
+    for (;;) {
+        auto msg = output.receive(std::chrono::seconds(5));
+        ASSERT_FALSE(msg.empty());
+        if (msg.is_type<streams::on_complete>()) {
+            break;
+        }
+        ASSERT_TRUE(msg.is_type<streams::batch_type>());
+        const auto & batch = msg.get_unsafe<streams::batch_type>();
+        for (const auto & element : batch) {
+            ASSERT_EQ(expected++, element.get<int>());
+        }
+        sizes.push_back(batch.size());
+    }
+    EXPECT_EQ(std::vector<size_t>({ 4, 4, 2 }), sizes);
+}
+
+TEST(Yato_Actors, stream_throttle_batch_timeout)
+{
+    using namespace yato::actors;
+
+    actor_system system("default", actors_debug_config());
+    inbox output(system, "output");
+
+    // Throttle passes 3 elements, then the incomplete batch is emitted by timeout
+    const auto start = std::chrono::steady_clock::now();
+    streams::stream::range(0, 5)
+        .throttle(3, std::chrono::milliseconds(500))
+        .batch(10, std::chrono::milliseconds(20))
+        .to(streams::to_actor(output.ref()))
+        .run(system, "pipeline");
+
+    auto first = output.receive(std::chrono::seconds(5));
+    ASSERT_TRUE(first.is_type<streams::batch_type>());
+    EXPECT_EQ(3u, first.get_unsafe<streams::batch_type>().size());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(400));
+
+    auto second = output.receive(std::chrono::seconds(5));
+    ASSERT_TRUE(second.is_type<streams::batch_type>());
+    EXPECT_EQ(2u, second.get_unsafe<streams::batch_type>().size());
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(400));
+
+    EXPECT_TRUE(output.receive(std::chrono::seconds(5)).is_type<streams::on_complete>());
+}
+
+TEST(Yato_Actors, stream_backpressure)
+{
+    using namespace yato::actors;
+
+    actor_system system("default", actors_debug_config());
+    inbox output(system, "output");
+
+    std::atomic<int64_t> produced{ 0 };
+    std::atomic<int64_t> consumed{ 0 };
+    std::atomic<int64_t> max_in_flight{ 0 };
+
+    const uint32_t buffer = 16;
+    streams::stream::generate([&](yato::any & element) {
+            const auto n = produced.fetch_add(1);
+            if (n >= 500) {
+                return false;
+            }
+            const auto in_flight = n + 1 - consumed.load();
+            int64_t prev = max_in_flight.load();
+            while ((in_flight > prev) && !max_in_flight.compare_exchange_weak(prev, in_flight)) { }
+            element = yato::any(n);
+            return true;
+        })
+        .async()
+        .buffer_size(buffer)
+        .to(streams::for_each<int64_t>([&](int64_t) {
+            // Slow consumer
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            consumed.fetch_add(1);
+        }, [&] {
+            output.ref().tell(streams::on_complete{});
+        }))
+        .run(system, "pipeline");
+
+    ASSERT_TRUE(output.receive(std::chrono::seconds(10)).is_type<streams::on_complete>());
+    EXPECT_EQ(500, consumed.load());
+    // Source, async stage and sink buffers
+    EXPECT_LE(max_in_flight.load(), 3 * buffer);
+}
+
+TEST(Yato_Actors, stream_error)
+{
+    using namespace yato::actors;
+
+    actor_system system("default", actors_debug_config());
+    inbox output(system, "output");
+
+    streams::stream::range(0, 100)
+        .async()
+        .map<int>([](int x) {
+            if (x == 10) {
+                throw std::runtime_error("bad element");
+            }
+            return x;
+        })
+        .to(streams::to_actor(output.ref()))
+        .run(system, "pipeline");
+
+    int received = 0;
+    for (;;) {
+        auto msg = output.receive(std::chrono::seconds(5));
+        ASSERT_FALSE(msg.empty());
+        if (msg.is_type<streams::on_error>()) {
+            break;
+        }
+        ASSERT_TRUE(msg.is_type<int>());
+        ++received;
+    }
+    EXPECT_EQ(10, received);
+}
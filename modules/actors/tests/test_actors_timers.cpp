@@ -0,0 +1,105 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <thread>
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/any_match.h>
+
+#include "test_actors_common.h"
+
+namespace
+{
+    struct tick
+    {
+        int32_t id;
+    };
+
+    struct stop_ticks {};
+
+    class Ticker
+        : public yato::actors::actor
+    {
+        yato::actors::actor_ref m_output;
+        yato::actors::timer_handle m_periodic;
+
+        void pre_start() override
+        {
+            schedule_once(std::chrono::milliseconds(10), tick{ 0 });
+            m_periodic = schedule_periodic(std::chrono::milliseconds(10), tick{ 1 });
+            // Cancelled before firing
+            schedule_once(std::chrono::milliseconds(10), tick{ 2 }).cancel();
+        }
+
+        void receive(yato::any && message) override
+        {
+            yato::any_match(
+                [this](const tick & t) {
+                    EXPECT_EQ(self(), sender());
+                    m_output.tell(t);
+                },
+                [this](const stop_ticks &) {
+                    // Ticks are sent to the mailbox meanwhile, cancel() discards them
+                    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+                    m_periodic.cancel();
+                    m_output.tell(stop_ticks{});
+                }
+            )(message);
+        }
+
+    public:
+        explicit
+        Ticker(const yato::actors::actor_ref & output)
+            : m_output(output)
+        { }
+    };
+}
+
+TEST(Yato_Actors, schedule_timers)
+{
+    using namespace yato::actors;
+
+    actor_system system("default", actors_debug_config());
+    inbox output(system, "output");
+
+    const auto ticker = system.create_actor<Ticker>("ticker", output.ref());
+
+    int once = 0;
+    int periodic = 0;
+    while (periodic < 3) {
+        auto msg = output.receive(std::chrono::seconds(5));
+        ASSERT_TRUE(msg.is_type<tick>());
+        const auto id = msg.get_unsafe<tick>().id;
+        ASSERT_NE(2, id);
+        if (id == 0) {
+            ++once;
+        } else {
+            ++periodic;
+        }
+    }
+
+    ticker.tell(stop_ticks{});
+    for (;;) {
+        auto msg = output.receive(std::chrono::seconds(5));
+        ASSERT_FALSE(msg.empty());
+        if (msg.is_type<stop_ticks>()) {
+            break;
+        }
+        if (msg.get_unsafe<tick>().id == 0) {
+            ++once;
+        }
+    }
+    EXPECT_EQ(1, once);
+
+    // No ticks after cancel
+    EXPECT_TRUE(output.receive(std::chrono::milliseconds(50)).empty());
+
+    ticker.tell(poison_pill);
+}
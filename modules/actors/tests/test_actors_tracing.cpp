@@ -0,0 +1,115 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <set>
+#include <string>
+
+#include <yato/actors/actor_system.h>
+#include <yato/actors/inbox.h>
+#include <yato/actors/logger.h>
+#include <yato/config/config_builder.h>
+
+namespace
+{
+    class ForwardActor
+        : public yato::actors::actor
+    {
+        yato::actors::actor_ref m_next;
+
+    public:
+        explicit
+        ForwardActor(const yato::actors::actor_ref & next)
+            : m_next(next)
+        { }
+
+        void receive(yato::any && message) override
+        {
+            forward(std::move(message), m_next);
+        }
+    };
+
+    class ReplyActor
+        : public yato::actors::actor
+    {
+        void receive(yato::any && message) override
+        {
+            sender().tell(message.get<int>() + 1);
+        }
+    };
+}
+
+#ifdef YATO_ACTORS_WITH_TRACING
+
+namespace
+{
+    std::set<std::string> find_all(const std::string & str, const std::string & key)
+    {
+        std::set<std::string> res;
+        for (size_t pos = str.find(key); pos != std::string::npos; pos = str.find(key, pos + 1)) {
+            const size_t start = pos + key.size();
+            res.insert(str.substr(start, str.find('"', start) - start));
+        }
+        return res;
+    }
+}
+
+TEST(Yato_Actors, tracing)
+{
+    using namespace yato::actors;
+
+    actor_system system("default", yato::config_builder::object()
+        .put("log_level", "verbose")
+        .put("trace_sampling", 1)
+        .create());
+
+    const auto last  = system.create_actor<ReplyActor>("last");
+    const auto first = system.create_actor<ForwardActor>("first", last);
+
+    inbox output(system, "output");
+    output.send(first, 1);
+    EXPECT_EQ(2, output.receive(std::chrono::seconds(5)).get<int>());
+
+    const std::string trace = system.export_trace();
+    EXPECT_NE(std::string::npos, trace.find("\"traceEvents\""));
+    EXPECT_NE(std::string::npos, trace.find("user/first"));
+    EXPECT_NE(std::string::npos, trace.find("user/last"));
+
+    // Forwarded message belongs to the same trace
+    EXPECT_EQ(1u, find_all(trace, "\"trace\":\"").size());
+    EXPECT_EQ(2u, find_all(trace, "\"span\":\"").size());
+
+    first.tell(poison_pill);
+    last.tell(poison_pill);
+}
+
+TEST(Yato_Actors, tracing_disabled)
+{
+    using namespace yato::actors;
+
+    actor_system system("default");
+
+    const auto actor = system.create_actor<ReplyActor>("actor");
+    inbox output(system, "output");
+    output.send(actor, 1);
+    EXPECT_EQ(2, output.receive(std::chrono::seconds(5)).get<int>());
+
+    EXPECT_TRUE(find_all(system.export_trace(), "\"span\":\"").empty());
+    actor.tell(poison_pill);
+}
+
+#else
+
+TEST(Yato_Actors, tracing_unavailable)
+{
+    using namespace yato::actors;
+
+    EXPECT_THROW(actor_system("default", yato::config_builder::object().put("trace_sampling", 1).create()), yato::argument_error);
+}
+
+#endif
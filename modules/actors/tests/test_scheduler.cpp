@@ -79,3 +79,47 @@ TEST(Yato_Actors, scheduler_5)
     ASSERT_EQ(42, r.get());
 }
 
+
+TEST(Yato_Actors, scheduler_periodic)
+{
+    std::atomic<int> counter{ 0 };
+    yato::actors::scheduler scheduler;
+
+    const auto handle = scheduler.enqueue_timer(std::chrono::high_resolution_clock::now(), std::chrono::milliseconds(10), [&counter] {
+        ++counter;
+    });
+    ASSERT_TRUE(handle.is_active());
+    std::this_thread::sleep_for(std::chrono::milliseconds(105));
+    EXPECT_TRUE(handle.cancel());
+    EXPECT_FALSE(handle.is_active());
+
+    const int fired = counter.load();
+    EXPECT_GE(fired, 5);
+    EXPECT_LE(fired, 12);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(fired, counter.load());
+}
+
+TEST(Yato_Actors, scheduler_cancel)
+{
+    std::atomic<int> counter{ 0 };
+    yato::actors::scheduler scheduler;
+
+    const auto now = std::chrono::high_resolution_clock::now();
+    std::vector<yato::actors::timer_handle> handles;
+    for (int i = 0; i < 1000; ++i) {
+        handles.push_back(scheduler.enqueue_timer(now + std::chrono::milliseconds(20), std::chrono::milliseconds(0), [&counter] {
+            ++counter;
+        }));
+    }
+    for (size_t i = 0; i < handles.size(); i += 2) {
+        EXPECT_TRUE(handles[i].cancel());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(500, counter.load());
+    for (const auto & h : handles) {
+        EXPECT_FALSE(h.is_active());
+        EXPECT_FALSE(h.cancel());
+    }
+}
@@ -8,14 +8,19 @@
 #ifndef _YATO_ACTOR_H_
 #define _YATO_ACTOR_H_
 
+#include <chrono>
 #include <stack>
+#include <utility>
+#include <vector>
 
 #include <yato/any.h>
 
+#include "actor_common.h"
 #include "actor_ref.h"
 #include "behaviour.h"
 #include "cell_builder.h"
 #include "logger.h"
+#include "timer.h"
 
 namespace yato
 {
@@ -59,6 +64,12 @@ namespace actors
          * Cache for current sender ref
          */
         mutable const actor_ref* m_sender = nullptr;
+
+        /**
+         * Timers to be cancelled on stop
+         */
+        std::vector<timer_handle> m_timers;
+        size_t m_timers_prune_size = 16;
         //-------------------------------------------------------
 
         void stop_impl() noexcept;
@@ -66,6 +77,8 @@ namespace actors
         actor_ref create_child_impl_(const std::string & name, const details::cell_builder & builder);
 
         actor_cell & context_();
+
+        timer_handle schedule_impl_(const timeout_type & delay, const timeout_type & period, yato::any && message);
         //-------------------------------------------------------
 
     protected:
@@ -147,6 +160,33 @@ namespace actors
             return create_child_impl_(name, details::make_cell_builder<ActorType_>(std::forward<Args_>(args)...));
         }
 
+        /**
+         * Send the message to self once after the delay.
+         * The timer is cancelled automatically when the actor stops.
+         */
+        template <typename Ty_, typename Rep_, typename Period_>
+        timer_handle schedule_once(const std::chrono::duration<Rep_, Period_> & delay, Ty_ && message) {
+            return schedule_impl_(std::chrono::duration_cast<timeout_type>(delay), timeout_type::zero(), yato::any(std::forward<Ty_>(message)));
+        }
+
+        /**
+         * Send the message to self every interval, starting after the initial delay.
+         * Firing times don't drift: they stay multiples of the interval. Missed ticks are skipped.
+         * The timer is cancelled automatically when the actor stops.
+         */
+        template <typename Ty_, typename Rep1_, typename Period1_, typename Rep2_, typename Period2_>
+        timer_handle schedule_periodic(const std::chrono::duration<Rep1_, Period1_> & initial_delay, const std::chrono::duration<Rep2_, Period2_> & interval, Ty_ && message) {
+            return schedule_impl_(std::chrono::duration_cast<timeout_type>(initial_delay), std::chrono::duration_cast<timeout_type>(interval), yato::any(std::forward<Ty_>(message)));
+        }
+
+        /**
+         * Send the message to self every interval.
+         */
+        template <typename Ty_, typename Rep_, typename Period_>
+        timer_handle schedule_periodic(const std::chrono::duration<Rep_, Period_> & interval, Ty_ && message) {
+            return schedule_periodic(interval, interval, std::forward<Ty_>(message));
+        }
+
         /**
          * Replace the actor's behavior
          * @param new_behaviour
@@ -160,6 +200,15 @@ namespace actors
          */
         message_consumer* unbecome() noexcept;
 
+        /**
+         * Replace sender of the current message. Is used for delayed processing of messages.
+         * @return Previous sender, can be nullptr
+         */
+        const actor_ref* exchange_sender_(const actor_ref* sender) const noexcept {
+            std::swap(m_sender, sender);
+            return sender;
+        }
+
         //-------------------------------------------------------
 
     public:
@@ -9,6 +9,7 @@
 #define _YATO_ACTOR_PATH_H_
 
 #include <locale>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -42,12 +43,39 @@ namespace actors
     };
 
 
+    namespace details
+    {
+        /**
+         * Interned path. Is shared by all actor_path objects with the same string.
+         */
+        struct path_node
+        {
+            std::string path;
+            std::string name;
+            size_t hash;
+            bool header_valid;
+            path_elements elements;
+        };
+
+        struct path_node_deleter
+        {
+            void operator()(path_node* node) const;
+        };
+    }
+
+
+    /**
+     * Path of an actor.
+     * Paths are interned, so copying and comparison don't touch the string, and the path is parsed only once.
+     */
     class actor_path
     {
     private:
         using path_iterator       = std::string::iterator;
         using path_const_iterator = std::string::const_iterator;
 
+        using node_pointer = std::shared_ptr<details::path_node>;
+
         static const std::locale path_locale;
         static const std::string path_root;
         //----------------------------------------------------
@@ -62,18 +90,29 @@ namespace actors
         //----------------------------------------------------
 
     private:
-        std::string m_path;
+        /**
+         * Null for empty path
+         */
+        node_pointer m_node;
+        //----------------------------------------------------
+
+        /**
+         * Find or create node for the path. If parent is not null, then path is the parent path joined with the name.
+         */
+        static node_pointer intern_(std::string && path, const details::path_node* parent, const std::string & name);
+
+        static const std::string & empty_string_();
         //----------------------------------------------------
 
     public:
         explicit
         actor_path(const std::string & path)
-            : m_path(path)
+            : m_node(intern_(std::string(path), nullptr, std::string{}))
         { }
         
         explicit
         actor_path(const char* path)
-            : m_path(path)
+            : m_node(intern_(std::string(path), nullptr, std::string{}))
         { }
 
         actor_path(const std::string & system_name, const actor_scope & scope, const std::string & actor_name);
@@ -90,12 +129,20 @@ namespace actors
 
         const std::string & to_string() const 
         {
-            return m_path;
+            return (m_node != nullptr) ? m_node->path : empty_string_();
         }
 
         const char* c_str() const
         {
-            return m_path.c_str();
+            return to_string().c_str();
+        }
+
+        /**
+         * Precomputed hash of the path string
+         */
+        size_t hash() const
+        {
+            return (m_node != nullptr) ? m_node->hash : 0;
         }
 
         /**
@@ -103,38 +150,35 @@ namespace actors
          */
         bool parce(path_elements & elems, bool header_only = false) const;
 
+        /**
+         * Parsed path. Scope is unknown if the path is invalid.
+         */
+        const path_elements & elements() const;
+
         /**
          * Get actor name without full path
          */
-        std::string get_name() const 
+        const std::string & get_name() const 
         {
-            //ToDo (a.gruzdev): temporal solution
-            auto pos = m_path.find_last_of('/');
-            if(pos == std::string::npos) {
-                return std::string{};
-            }
-            if(pos < m_path.size()) {
-                ++pos; // skip '/'
-            }
-            return m_path.substr(pos);
+            return (m_node != nullptr) ? m_node->name : empty_string_();
         }
 
         friend
         bool operator == (const actor_path & one, const actor_path & another)
         {
-            return one.m_path == another.m_path;
+            return one.m_node == another.m_node;
         }
 
         friend
         bool operator != (const actor_path & one, const actor_path & another)
         {
-            return one.m_path != another.m_path;
+            return one.m_node != another.m_node;
         }
 
         friend 
         bool operator < (const actor_path & one, const actor_path & another)
         {
-            return one.m_path < another.m_path;
+            return (one.m_node != another.m_node) && (one.to_string() < another.to_string());
         }
 
         static
@@ -150,9 +194,7 @@ namespace actors
         }
 
         static
-        actor_path join(const actor_path & path, const std::string & name) {
-            return actor_path(path.m_path + "/" + name);
-        }
+        actor_path join(const actor_path & path, const std::string & name);
     };
 
 
@@ -160,5 +202,18 @@ namespace actors
 
 }// namespace yato
 
+
+namespace std
+{
+    template <>
+    struct hash<yato::actors::actor_path>
+    {
+        size_t operator()(const yato::actors::actor_path & path) const
+        {
+            return path.hash();
+        }
+    };
+}
+
 #endif //_YATO_ACTOR_PATH_H_
 
@@ -17,6 +17,7 @@
 #include "actor.h"
 #include "actor_common.h"
 #include "config.h"
+#include "dead_letters.h"
 #include "cell_builder.h"
 #include "actor_props.h"
 
@@ -26,7 +27,10 @@ namespace actors
 {
 
     class mailbox;
+    class scheduler;
+    class serialization_registry;
     struct system_context;
+    class tracer;
 
     class actor_system
     {
@@ -39,6 +43,7 @@ namespace actors
 
         void send_user_impl_(const actor_ref & toActor, const actor_ref & fromActor, yato::any && usrMessage) const;
         void send_system_impl_(const actor_ref & addressee, const actor_ref & sender, yato::any && sysMessage) const;
+        void record_dead_letter_(const actor_ref & addressee, const actor_ref & sender, yato::any && message, dead_letter_reason reason, bool system) const;
         void stop_impl_(const std::shared_ptr<mailbox> & mbox) const;
 
         std::future<yato::any> ask_impl_(const actor_ref & addressee, yato::any && message, const timeout_type & timeout) const;
@@ -50,6 +55,18 @@ namespace actors
          */
         void shutdown_impl_(bool forced);
 
+        bool is_stopping_fast_() const;
+
+        /**
+         * Null if tracing is disabled
+         */
+        tracer* tracer_() const;
+
+        /**
+         * Is called by the root after a root_add message is forwarded to a guardian.
+         */
+        void root_add_done_() const;
+
         //-------------------------------------------------------
 
     private: // Extended inferface for internal usage
@@ -58,6 +75,11 @@ namespace actors
          */
         const actor_ref & root() const;
 
+        /**
+         * Get system timer
+         */
+        scheduler & global_scheduler() const;
+
         /**
          * Create actor in specified scope
          */
@@ -163,6 +185,30 @@ namespace actors
 
         const actor_ref & dead_letters() const;
 
+        /**
+         * Counters of undelivered messages and the first captured letters of every type.
+         * The number of captured letters per type is set by "dead_letters_capture" config value, 8 by default.
+         */
+        dead_letters_stats dead_letter_stats() const;
+
+        /**
+         * Captured dead letters are sent to the subscriber as dead_letter messages. Empty ref unsubscribes.
+         */
+        void subscribe_dead_letters(const actor_ref & subscriber) const;
+
+        /**
+         * Sampled message spans in Chrome trace event format.
+         * Sampling is enabled by "trace_sampling" config value: one of every N messages is traced together with all messages sent while receiving it.
+         * The library has to be built with YATO_ACTORS_WITH_TRACING.
+         */
+        std::string export_trace() const;
+
+        /**
+         * Registry of message types, which can be sent to other actor systems.
+         * Types should be registered before the first remote message.
+         */
+        serialization_registry & serialization() const;
+
         /**
          * Send stop signal to actor and terminate it right after the current message
          */
@@ -199,6 +245,7 @@ namespace actors
         /**
          * Terminates the actor system, stopping all actors.
          * Blocks until the system is stopped.
+         * If "fast_shutdown" is enabled in the config, actors don't process their pending messages and stop without logging.
          */
         void shutdown();
 
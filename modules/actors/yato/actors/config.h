@@ -20,6 +20,7 @@
 *           "name" : "fixed",
 *           "type" : "pinned",
 *           "threads_limit": 8
+*           "actors_per_thread": 1
 *       }
 *   ],
 *   "default_executor" : "dynamic",
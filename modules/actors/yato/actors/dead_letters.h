@@ -0,0 +1,77 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_DEAD_LETTERS_H_
+#define _YATO_ACTORS_DEAD_LETTERS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <yato/any.h>
+
+#include "actor_ref.h"
+
+namespace yato
+{
+namespace actors
+{
+
+    enum class dead_letter_reason
+    {
+        no_recipient,       ///< Message was sent to an empty ref or to dead_letters()
+        recipient_stopped,  ///< Recipient is stopped or destroyed
+    };
+
+    /**
+     * Message, which was not delivered.
+     * Captured samples are sent to the dead letters subscriber.
+     */
+    struct dead_letter
+    {
+        actor_ref recipient;
+        actor_ref sender;
+        yato::any message;
+        dead_letter_reason reason;
+        bool system = false;
+    };
+
+    /**
+     * Snapshot of the dead letters accounting.
+     */
+    struct dead_letters_stats
+    {
+        struct type_counter
+        {
+            std::string type_name;
+            uint64_t count;
+        };
+
+        uint64_t user_messages   = 0;
+        uint64_t system_messages = 0;
+
+        /**
+         * Counters per message type, in descending order.
+         */
+        std::vector<type_counter> by_type;
+
+        /**
+         * The first captured dead letters of every type
+         */
+        std::vector<dead_letter> samples;
+
+        uint64_t total() const
+        {
+            return user_messages + system_messages;
+        }
+    };
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_DEAD_LETTERS_H_
@@ -0,0 +1,142 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_IO_SOCKET_TUNING_H_
+#define _YATO_ACTORS_IO_SOCKET_TUNING_H_
+
+#include <atomic>
+
+#include <asio.hpp>
+
+#include "../socket_options.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace io
+{
+
+    /**
+     * Counters, updated from the io thread and the connection actor
+     */
+    struct connection_counters
+    {
+        std::atomic<uint64_t> bytes_received{ 0 };
+        std::atomic<uint64_t> bytes_sent{ 0 };
+        std::atomic<uint64_t> packets_received{ 0 };
+        std::atomic<uint64_t> packets_sent{ 0 };
+        std::atomic<uint64_t> drops{ 0 };
+
+        void on_received(size_t bytes)
+        {
+            bytes_received.fetch_add(bytes, std::memory_order_relaxed);
+            packets_received.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void on_sent(size_t bytes)
+        {
+            bytes_sent.fetch_add(bytes, std::memory_order_relaxed);
+            packets_sent.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void on_drop()
+        {
+            drops.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void reset()
+        {
+            bytes_received.store(0, std::memory_order_relaxed);
+            bytes_sent.store(0, std::memory_order_relaxed);
+            packets_received.store(0, std::memory_order_relaxed);
+            packets_sent.store(0, std::memory_order_relaxed);
+            drops.store(0, std::memory_order_relaxed);
+        }
+
+        template <typename Socket_>
+        connection_stats snapshot(Socket_ & socket) const
+        {
+            connection_stats stats;
+            stats.bytes_received   = bytes_received.load(std::memory_order_relaxed);
+            stats.bytes_sent       = bytes_sent.load(std::memory_order_relaxed);
+            stats.packets_received = packets_received.load(std::memory_order_relaxed);
+            stats.packets_sent     = packets_sent.load(std::memory_order_relaxed);
+            stats.drops            = drops.load(std::memory_order_relaxed);
+            asio::error_code err;
+            const size_t available = socket.available(err);
+            stats.queue_depth = err ? 0 : available;
+            return stats;
+        }
+    };
+
+
+#ifdef SO_REUSEPORT
+    using reuse_port_option = asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
+#ifdef SO_BUSY_POLL
+    using busy_poll_option = asio::detail::socket_option::integer<SOL_SOCKET, SO_BUSY_POLL>;
+#endif
+
+    /**
+     * Options, which have to be set on an opened socket before binding
+     */
+    template <typename Socket_>
+    void apply_bind_options(Socket_ & socket, const socket_options & options, asio::error_code & err)
+    {
+        if (!err && options.reuse_port) {
+            socket.set_option(typename Socket_::reuse_address(true), err);
+#ifdef SO_REUSEPORT
+            if (!err) {
+                socket.set_option(reuse_port_option(true), err);
+            }
+#endif
+        }
+    }
+
+    /**
+     * Options, which can be set on any opened socket
+     */
+    template <typename Socket_>
+    void apply_common_options(Socket_ & socket, const socket_options & options, asio::error_code & err)
+    {
+        if (!err && (options.receive_buffer_size > 0)) {
+            socket.set_option(asio::socket_base::receive_buffer_size(options.receive_buffer_size), err);
+        }
+        if (!err && (options.send_buffer_size > 0)) {
+            socket.set_option(asio::socket_base::send_buffer_size(options.send_buffer_size), err);
+        }
+#ifdef SO_BUSY_POLL
+        if (!err && (options.busy_poll > 0)) {
+            socket.set_option(busy_poll_option(options.busy_poll), err);
+        }
+#endif
+    }
+
+    inline
+    void apply_socket_options(asio::ip::tcp::socket & socket, const socket_options & options, asio::error_code & err)
+    {
+        if (!err && options.no_delay) {
+            socket.set_option(asio::ip::tcp::no_delay(true), err);
+        }
+        apply_common_options(socket, options, err);
+    }
+
+    inline
+    void apply_socket_options(asio::ip::udp::socket & socket, const socket_options & options, asio::error_code & err)
+    {
+        apply_common_options(socket, options, err);
+    }
+
+} // namespace io
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_IO_SOCKET_TUNING_H_
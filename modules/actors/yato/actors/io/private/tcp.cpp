@@ -13,9 +13,11 @@
 #include "../../actor_system.h"
 #include "../../private/actor_system_ex.h"
 #include "../../private/actors/group.h"
+#include "../../private/scheduler.h"
 
 #include "../tcp.h"
 #include "context.h"
+#include "tcp_connector.h"
 #include "tcp_listener.h"
 
 namespace yato
@@ -48,51 +50,61 @@ namespace io
             [this](const tcp::bind & bind) {
                 log().debug("Bind");
 
-                auto address = bind.address;
-
-                asio::error_code err;
-                asio::ip::tcp::resolver resolver(m_context->service());
-                asio::ip::tcp::resolver::query query(asio::ip::tcp::v4(), address.host, std::to_string(address.port));
-                auto endpoint = *resolver.resolve(query, err);
-                if (err) {
+                const auto resolver = std::make_shared<asio::ip::tcp::resolver>(m_context->service());
+                const actor_ref manager = self();
+                resolver->async_resolve(asio::ip::tcp::v4(), bind.address.host, std::to_string(bind.address.port),
+                    [resolver, manager, bind](const asio::error_code & error, const asio::ip::tcp::resolver::results_type & endpoints) {
+                        if (!error && endpoints.empty()) {
+                            manager.tell(tcp_bind_resolved(bind, asio::ip::tcp::endpoint{}, asio::error::host_not_found));
+                        } else {
+                            manager.tell(tcp_bind_resolved(bind, error ? asio::ip::tcp::endpoint{} : (*endpoints.begin()).endpoint(), error));
+                        }
+                    });
+            },
+            [this](const tcp_bind_resolved & resolved) {
+                const auto & bind = resolved.command;
+                if (resolved.error) {
                     bind.handler.tell(tcp::command_fail("Failed to resolve endpoint!"), self());
                     return;
                 }
 
+                const auto & address = bind.address;
                 const auto name = address.host + ":" + std::to_string(address.port);
-                const auto listener = actor_system_ex::create_actor<tcp_listener>(system(), self(), name, bind.handler, m_context, endpoint);
+                const auto listener = actor_system_ex::create_actor<tcp_listener>(system(), self(), name, bind, m_context, resolved.endpoint);
                 system().watch(bind.handler, listener);
-
-                bind.handler.tell(tcp::bound(address), self());
             },
             [this](const tcp::connect & connect) {
                 if(connect.handler.empty() || connect.handler == system().dead_letters()) {
                     log().error("Connection handler is empty.");
                     return;
                 }
-                const auto & remote = connect.address;
-                log().debug("Connect " + remote.to_string());
-
-                asio::error_code err;
-                asio::ip::tcp::resolver resolver(m_context->service());
-                asio::ip::tcp::resolver::query query(asio::ip::tcp::v4(), remote.host, std::to_string(remote.port));
-                auto endpoint = *resolver.resolve(query, err);
-                if (err) {
-                    connect.handler.tell(tcp::command_fail("Failed to resolve endpoint! Address = " + remote.to_string()), self());
+                log().debug("Connect " + connect.address.to_string());
+
+                const std::weak_ptr<tcp_connector> connector = tcp_connector::create(m_context->service(), self(), connect);
+                actor_system_ex::global_scheduler(system()).enqueue(scheduler::clock_type::now() + connect.timeout, [connector] {
+                    const auto ptr = connector.lock();
+                    if (ptr != nullptr) {
+                        ptr->expire();
+                    }
+                });
+            },
+            [this](const tcp_connect_finished & finished) {
+                const auto & connect = finished.command;
+                const auto & remote  = connect.address;
+                if (finished.expired) {
+                    connect.handler.tell(tcp::command_fail("Connection timeout! Address = " + remote.to_string()), self());
                     return;
                 }
-
-                auto connection = std::make_shared<tcp_connection>(connect.handler, m_context->service());
-
-                // ToDo (a.gruzdev): Is async connect necessary?
-                connection->socket().connect(endpoint, err);
-                if(err) {
-                    connect.handler.tell(tcp::command_fail("Failed to connect endpoint! Address = " + remote.to_string()), self());
+                if (finished.error) {
+                    connect.handler.tell(tcp::command_fail("Failed to connect endpoint! Address = " + remote.to_string() + ". " + finished.error.message()), self());
                     return;
                 }
 
-                const std::string remote_name = remote.to_string();
-                actor_system_ex::create_actor<tcp_remote>(system(), self(), remote_name, connection);
+                // Local port makes the name unique, if there are several connections to the same remote
+                asio::error_code err;
+                const auto local = finished.connection->socket().local_endpoint(err);
+                const std::string remote_name = remote.to_string() + "_" + std::to_string(local.port());
+                actor_system_ex::create_actor<tcp_remote>(system(), self(), remote_name, finished.connection);
             }
         )(message);
     }
@@ -10,6 +10,7 @@
 
 #include <asio.hpp>
 #include "../../actor_ref.h"
+#include "socket_tuning.h"
 
 namespace yato
 {
@@ -23,10 +24,12 @@ namespace io
     private:
         actor_ref m_server;
         asio::ip::tcp::socket m_socket;
+        socket_options m_options;
+        connection_counters m_counters;
 
     public:
-        tcp_connection(const actor_ref & server, asio::io_service & io)
-            : m_server(server), m_socket(io)
+        tcp_connection(const actor_ref & server, asio::io_service & io, const socket_options & options)
+            : m_server(server), m_socket(io), m_options(options)
         { }
 
         asio::ip::tcp::socket & socket() {
@@ -40,6 +43,30 @@ namespace io
         const actor_ref & server() const {
             return m_server;
         }
+
+        const socket_options & options() const {
+            return m_options;
+        }
+
+        connection_counters & counters() {
+            return m_counters;
+        }
+
+        /**
+         * Applies options after the socket is connected
+         */
+        void apply_options(asio::error_code & err) {
+            apply_socket_options(m_socket, m_options, err);
+        }
+
+        /**
+         * Closes the socket and clears counters, so the object can be used for a new connection
+         */
+        void reset() {
+            asio::error_code ignored;
+            m_socket.close(ignored);
+            m_counters.reset();
+        }
     };
 
 } // namespace io
@@ -0,0 +1,134 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_IO_TCP_CONNECTION_POOL_H_
+#define _YATO_ACTORS_IO_TCP_CONNECTION_POOL_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <asio.hpp>
+
+#include "tcp_connection.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace io
+{
+
+    /**
+     * Keeps connection objects of a listener.
+     * A connection returns to the pool when the last reference to it is released, so the pool also counts open connections.
+     * Connections can be released from any thread.
+     */
+    class tcp_connection_pool
+        : public std::enable_shared_from_this<tcp_connection_pool>
+    {
+    private:
+        struct recycler
+        {
+            std::weak_ptr<tcp_connection_pool> pool;
+
+            void operator()(tcp_connection* connection) const
+            {
+                auto p = pool.lock();
+                if (p != nullptr) {
+                    p->recycle_(connection);
+                } else {
+                    delete connection;
+                }
+            }
+        };
+
+        asio::io_service & m_service;
+        actor_ref m_server;
+        socket_options m_options;
+        size_t m_capacity;
+
+        std::mutex m_mutex;
+        std::vector<std::unique_ptr<tcp_connection>> m_free;
+        std::atomic<size_t> m_in_use{ 0 };
+
+        void recycle_(tcp_connection* connection)
+        {
+            std::unique_ptr<tcp_connection> holder(connection);
+            holder->reset();
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_free.size() < m_capacity) {
+                    m_free.push_back(std::move(holder));
+                }
+            }
+            m_in_use.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        tcp_connection_pool(asio::io_service & service, const actor_ref & server, const socket_options & options, size_t capacity)
+            : m_service(service), m_server(server), m_options(options), m_capacity(capacity)
+        {
+            m_free.reserve(capacity);
+            for (size_t i = 0; i < capacity; ++i) {
+                m_free.push_back(std::make_unique<tcp_connection>(m_server, m_service, m_options));
+            }
+        }
+
+    public:
+        ~tcp_connection_pool() = default;
+
+        tcp_connection_pool(const tcp_connection_pool&) = delete;
+        tcp_connection_pool(tcp_connection_pool&&) = delete;
+
+        tcp_connection_pool& operator=(const tcp_connection_pool&) = delete;
+        tcp_connection_pool& operator=(tcp_connection_pool&&) = delete;
+
+        /**
+         * Get a closed connection object. Allocates a new one if the pool is empty.
+         */
+        std::shared_ptr<tcp_connection> acquire()
+        {
+            std::unique_ptr<tcp_connection> connection;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (!m_free.empty()) {
+                    connection = std::move(m_free.back());
+                    m_free.pop_back();
+                }
+            }
+            if (connection == nullptr) {
+                connection = std::make_unique<tcp_connection>(m_server, m_service, m_options);
+            }
+            m_in_use.fetch_add(1, std::memory_order_acq_rel);
+            return std::shared_ptr<tcp_connection>(connection.release(), recycler{ shared_from_this() });
+        }
+
+        /**
+         * Number of acquired connections, which are not released yet.
+         */
+        size_t in_use() const
+        {
+            return m_in_use.load(std::memory_order_acquire);
+        }
+
+        static
+        std::shared_ptr<tcp_connection_pool> create(asio::io_service & service, const actor_ref & server, const socket_options & options, size_t capacity)
+        {
+            std::shared_ptr<tcp_connection_pool> p;
+            p.reset(new tcp_connection_pool(service, server, options, capacity));
+            return p;
+        }
+    };
+
+} // namespace io
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_IO_TCP_CONNECTION_POOL_H_
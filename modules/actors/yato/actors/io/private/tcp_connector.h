@@ -0,0 +1,169 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_IO_TCP_CONNECTOR_H_
+#define _YATO_ACTORS_IO_TCP_CONNECTOR_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <asio.hpp>
+
+#include "../tcp.h"
+#include "tcp_connection.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace io
+{
+
+    /**
+     * Result of asynchronous endpoint resolving for tcp::bind
+     */
+    struct tcp_bind_resolved
+    {
+        tcp::bind command;
+        asio::ip::tcp::endpoint endpoint;
+        asio::error_code error;
+
+        tcp_bind_resolved(const tcp::bind & command, const asio::ip::tcp::endpoint & endpoint, const asio::error_code & error)
+            : command(command), endpoint(endpoint), error(error)
+        { }
+    };
+
+    /**
+     * Result of asynchronous connection for tcp::connect
+     */
+    struct tcp_connect_finished
+    {
+        tcp::connect command;
+        std::shared_ptr<tcp_connection> connection;
+        asio::error_code error;
+        bool expired;
+
+        tcp_connect_finished(const tcp::connect & command, const std::shared_ptr<tcp_connection> & connection, const asio::error_code & error, bool expired)
+            : command(command), connection(connection), error(error), expired(expired)
+        { }
+    };
+
+
+    /**
+     * Resolves remote address and connects to it without blocking the manager actor.
+     * Sends `tcp_connect_finished` to the manager after success, failure or expiration.
+     * The object keeps itself alive while there are pending asynchronous operations.
+     */
+    class tcp_connector
+        : public std::enable_shared_from_this<tcp_connector>
+    {
+    private:
+        asio::io_service & m_service;
+        asio::ip::tcp::resolver m_resolver;
+        std::shared_ptr<tcp_connection> m_connection;
+        actor_ref m_manager;
+        tcp::connect m_command;
+
+        /**
+         * Is accessed only from the io thread
+         */
+        bool m_finished = false;
+
+        static
+        void handle_resolve_(const std::shared_ptr<tcp_connector> & self, const asio::error_code & error, const asio::ip::tcp::resolver::results_type & endpoints)
+        {
+            if (self->m_finished) {
+                return;
+            }
+            if (error) {
+                self->finish_(error, false);
+                return;
+            }
+            asio::async_connect(self->m_connection->socket(), endpoints,
+                std::bind(&handle_connect_, self, std::placeholders::_1));
+        }
+
+        static
+        void handle_connect_(const std::shared_ptr<tcp_connector> & self, const asio::error_code & error)
+        {
+            if (error) {
+                self->finish_(error, false);
+                return;
+            }
+            asio::error_code options_error;
+            self->m_connection->apply_options(options_error);
+            self->finish_(options_error, false);
+        }
+
+        static
+        void handle_expire_(const std::shared_ptr<tcp_connector> & self)
+        {
+            if (!self->m_finished) {
+                self->finish_(asio::error::timed_out, true);
+                // Abort pending operations
+                asio::error_code ignored;
+                self->m_resolver.cancel();
+                self->m_connection->socket().close(ignored);
+            }
+        }
+
+        void finish_(const asio::error_code & error, bool expired)
+        {
+            if (!m_finished) {
+                m_finished = true;
+                m_manager.tell(tcp_connect_finished(m_command, error ? nullptr : m_connection, error, expired));
+            }
+        }
+
+        void start_resolve_()
+        {
+            m_resolver.async_resolve(asio::ip::tcp::v4(), m_command.address.host, std::to_string(m_command.address.port),
+                std::bind(&handle_resolve_, shared_from_this(), std::placeholders::_1, std::placeholders::_2));
+        }
+
+        tcp_connector(asio::io_service & service, const actor_ref & manager, const tcp::connect & command)
+            : m_service(service), m_resolver(service), m_manager(manager), m_command(command)
+        {
+            m_connection = std::make_shared<tcp_connection>(command.handler, service, command.options);
+        }
+
+    public:
+        ~tcp_connector() = default;
+
+        tcp_connector(const tcp_connector&) = delete;
+        tcp_connector(tcp_connector&&) = delete;
+
+        tcp_connector& operator=(const tcp_connector&) = delete;
+        tcp_connector& operator=(tcp_connector&&) = delete;
+
+        /**
+         * Abort connection if it is not finished yet.
+         * Can be called from any thread.
+         */
+        void expire()
+        {
+            asio::post(m_service, std::bind(&handle_expire_, shared_from_this()));
+        }
+
+        static
+        std::shared_ptr<tcp_connector> create(asio::io_service & service, const actor_ref & manager, const tcp::connect & command)
+        {
+            std::shared_ptr<tcp_connector> p;
+            p.reset(new tcp_connector(service, manager, command));
+            p->start_resolve_();
+            return p;
+        }
+    };
+
+} // namespace io
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_IO_TCP_CONNECTOR_H_
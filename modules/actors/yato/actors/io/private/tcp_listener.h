@@ -8,14 +8,18 @@
 #ifndef _YATO_ACTORS_IO_TCP_LISTENER_H_
 #define _YATO_ACTORS_IO_TCP_LISTENER_H_
 
+#include <algorithm>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include <asio.hpp>
 
 #include "../../actor.h"
 #include "tcp_remote.h"
 #include "tcp_connection.h"
+#include "tcp_connection_pool.h"
 
 namespace yato
 {
@@ -28,37 +32,77 @@ namespace io
     {
         struct accept
         {
-            std::shared_ptr<tcp_connection> connection;
+            std::vector<std::shared_ptr<tcp_connection>> connections;
             asio::error_code error;
+            size_t rejected;
 
-            accept(const std::shared_ptr<tcp_connection> & connection, const asio::error_code & error)
-                : connection(connection), error(error)
+            accept(std::vector<std::shared_ptr<tcp_connection>> && connections, const asio::error_code & error, size_t rejected)
+                : connections(std::move(connections)), error(error), rejected(rejected)
             { }
         };
         //-----------------------------------------------------------
 
         /**
-         * Listens to socket and sends `accept` message to listener actor
+         * Listens to socket and sends `accept` message to listener actor.
+         * All connections, which are ready, are accepted at once and sent in one message.
+         * Doesn't own the io_context: the last reference to the acceptor can be released by a handler on the io thread, and the context can't be destroyed there.
+         * After an accept error, e.g. out of file descriptors, accepting is resumed with exponential backoff.
          */
         class acceptor
             : public std::enable_shared_from_this<acceptor>
         {
-            std::shared_ptr<io_context> m_context;
             asio::ip::tcp::acceptor m_acceptor;
             asio::ip::tcp::endpoint m_endpoint;
-            actor_ref m_server;
+            tcp::accept_options m_accept_options;
+            std::shared_ptr<tcp_connection_pool> m_pool;
             actor_ref m_listener;
+            asio::steady_timer m_retry_timer;
+            std::chrono::milliseconds m_backoff{ 0 };
 
             static
-            void handle_accept_(const std::weak_ptr<acceptor> weak_self, const std::shared_ptr<tcp_connection> & connection, const asio::error_code & error)
+            void handle_accept_(const std::weak_ptr<acceptor> weak_self, std::shared_ptr<tcp_connection> & connection, const asio::error_code & error)
             {
                 auto self = weak_self.lock();
                 if (self != nullptr) {
-                    self->m_listener.tell(accept(connection, error));
+                    std::vector<std::shared_ptr<tcp_connection>> batch;
+                    size_t rejected = 0;
+                    if (!error) {
+                        self->admit_(std::move(connection), batch, rejected);
+                        self->accept_ready_(batch, rejected);
+                    }
+                    else if (error == asio::error::operation_aborted) {
+                        return;
+                    }
+                    self->m_listener.tell(accept(std::move(batch), error, rejected));
+                    if (!error) {
+                        self->m_backoff = std::chrono::milliseconds{ 0 };
+                        self->start_accept_();
+                    }
+                    else {
+                        // Error persists until resources are released, so retrying at once would spin the io thread
+                        self->retry_accept_();
+                    }
+                }
+            }
+
+            static
+            void handle_retry_(const std::weak_ptr<acceptor> weak_self, const asio::error_code & error)
+            {
+                auto self = weak_self.lock();
+                if ((self != nullptr) && (error != asio::error::operation_aborted)) {
                     self->start_accept_();
                 }
             }
 
+            void retry_accept_()
+            {
+                const std::chrono::milliseconds min_backoff(10);
+                const std::chrono::milliseconds max_backoff(1000);
+                m_backoff = std::min(std::max(m_backoff * 2, min_backoff), max_backoff);
+                m_retry_timer.expires_after(m_backoff);
+                m_retry_timer.async_wait(std::bind(&handle_retry_, weak_from_this_impl_(), std::placeholders::_1));
+            }
+
             std::weak_ptr<acceptor> weak_from_this_impl_()
             {
 #if defined(YATO_CXX17) || (YATO_MSVC >= YATO_MSVC_2017)
@@ -68,16 +112,80 @@ namespace io
 #endif
             }
 
+            /**
+             * Close connections above the limit. Accepted connections are kept in the pool count until released.
+             */
+            void admit_(std::shared_ptr<tcp_connection> && connection, std::vector<std::shared_ptr<tcp_connection>> & batch, size_t & rejected)
+            {
+                if ((m_accept_options.max_connections != 0) && (m_pool->in_use() > m_accept_options.max_connections)) {
+                    ++rejected;
+                    connection.reset();
+                    return;
+                }
+                asio::error_code err;
+                connection->apply_options(err);
+                batch.push_back(std::move(connection));
+            }
+
+            /**
+             * Accept pending connections without waiting, up to the batch size.
+             */
+            void accept_ready_(std::vector<std::shared_ptr<tcp_connection>> & batch, size_t & rejected)
+            {
+                for (size_t i = 1; i < m_accept_options.batch_size; ++i) {
+                    auto connection = m_pool->acquire();
+                    asio::error_code err;
+                    m_acceptor.accept(connection->socket(), err);
+                    if (err) {
+                        break;
+                    }
+                    admit_(std::move(connection), batch, rejected);
+                }
+            }
+
             void start_accept_()
             {
-                auto connection = std::make_shared<tcp_connection>(m_server, m_context->service());
-                m_acceptor.async_accept(connection->socket(),
-                    std::bind(&handle_accept_, weak_from_this_impl_(), connection, std::placeholders::_1));
+                auto connection = m_pool->acquire();
+                auto & socket = connection->socket();
+                m_acceptor.async_accept(socket,
+                    std::bind(&handle_accept_, weak_from_this_impl_(), std::move(connection), std::placeholders::_1));
             }
 
-            acceptor(const std::shared_ptr<io_context> & ctx, const asio::ip::tcp::endpoint & endpoint, const actor_ref & server, const actor_ref & listener)
-                : m_context(ctx), m_acceptor(ctx->service(), endpoint), m_endpoint(endpoint), m_server(server), m_listener(listener) 
-            { }
+            /**
+             * Throws asio::system_error if failed to bind
+             */
+            acceptor(const std::shared_ptr<io_context> & ctx, const asio::ip::tcp::endpoint & endpoint, const socket_options & options, const tcp::accept_options & accept_options, const actor_ref & server, const actor_ref & listener)
+                : m_acceptor(ctx->service()), m_endpoint(endpoint), m_accept_options(accept_options), m_listener(listener), m_retry_timer(ctx->service())
+            {
+                m_pool = tcp_connection_pool::create(ctx->service(), server, options, accept_options.pool_size);
+
+                asio::error_code err;
+                m_acceptor.open(endpoint.protocol(), err);
+                if (!err) {
+                    m_acceptor.set_option(asio::ip::tcp::acceptor::reuse_address(true), err);
+                }
+                if (!err) {
+                    apply_bind_options(m_acceptor, options, err);
+                }
+                if (!err) {
+                    // Buffer sizes are inherited by accepted sockets
+                    apply_common_options(m_acceptor, options, err);
+                }
+                if (!err) {
+                    m_acceptor.bind(endpoint, err);
+                }
+                if (!err) {
+                    const int backlog = (accept_options.backlog != 0) ? static_cast<int>(accept_options.backlog) : static_cast<int>(asio::socket_base::max_listen_connections);
+                    m_acceptor.listen(backlog, err);
+                }
+                if (!err) {
+                    // Synchronous accepts in a batch should not block the io thread
+                    m_acceptor.non_blocking(true, err);
+                }
+                if (err) {
+                    throw asio::system_error(err);
+                }
+            }
 
         public:
             ~acceptor() = default;
@@ -86,10 +194,10 @@ namespace io
              * Has to be stored in shared_ptr object
              */
             static
-            std::shared_ptr<acceptor> create(const std::shared_ptr<io_context> & ctx, const asio::ip::tcp::endpoint & endpoint, const actor_ref & server, const actor_ref & listener) 
+            std::shared_ptr<acceptor> create(const std::shared_ptr<io_context> & ctx, const asio::ip::tcp::endpoint & endpoint, const socket_options & options, const tcp::accept_options & accept_options, const actor_ref & server, const actor_ref & listener)
             {
                 std::shared_ptr<acceptor> p;
-                p.reset(new acceptor(ctx, endpoint, server, listener));
+                p.reset(new acceptor(ctx, endpoint, options, accept_options, server, listener));
                 p->start_accept_();
                 return p;
             }
@@ -98,34 +206,52 @@ namespace io
 
         std::shared_ptr<io_context> m_context;
         asio::ip::tcp::endpoint m_endpoint;
-        actor_ref m_server;
+        tcp::bind m_command;
 
         std::shared_ptr<acceptor> m_acceptor;
         //-----------------------------------------------------------
 
         void pre_start() override
         {
+            try {
+                m_acceptor = acceptor::create(m_context, m_endpoint, m_command.options, m_command.accept, m_command.handler, self());
+            }
+            catch (asio::system_error & err) {
+                m_command.handler.tell(tcp::command_fail("Failed to bind " + m_command.address.to_string() + ". " + err.what()), self());
+                self().tell(poison_pill);
+                return;
+            }
             log().info("Listening %s", m_endpoint.address().to_string().c_str());
-            m_acceptor = acceptor::create(m_context, m_endpoint, m_server, self());
+            // The socket is listening, so clients can connect
+            m_command.handler.tell(tcp::bound(m_command.address), self());
         }
 
         void receive(yato::any && message) override
         {
             yato::any_match(
                 [this](const accept & acc) {
-                    if (!acc.error) {
-                        auto remote = acc.connection->socket().remote_endpoint();
+                    if (acc.error) {
+                        log().error("Error! %s", acc.error.message().c_str());
+                    }
+                    if (acc.rejected != 0) {
+                        log().warning("Connections limit is reached. Rejected %u connections.", static_cast<uint32_t>(acc.rejected));
+                    }
+                    for (const auto & connection : acc.connections) {
+                        asio::error_code err;
+                        const auto remote = connection->socket().remote_endpoint(err);
+                        if (err) {
+                            // Disconnected before the remote actor is created
+                            continue;
+                        }
                         log().debug("New connection from %s", remote.address().to_string().c_str());
 
                         const std::string remote_name = remote.address().to_string() + ":" + std::to_string(remote.port());
-                        actor_system_ex::create_actor<tcp_remote>(system(), self(), remote_name, acc.connection);
-                    } else {
-                        log().error("Error! %s", acc.error.message().c_str());
+                        actor_system_ex::create_actor<tcp_remote>(system(), self(), remote_name, connection);
                     }
                 },
                 [this](const terminated & t) {
                     // Server actor is terminated
-                    if(m_server == t.ref) {
+                    if(m_command.handler == t.ref) {
                         self().tell(poison_pill);
                     }
                 }
@@ -134,13 +260,15 @@ namespace io
 
         void post_stop() override
         {
-            log().info("Stop listening %s", m_endpoint.address().to_string().c_str());
-            m_acceptor.reset();
+            if (m_acceptor != nullptr) {
+                log().info("Stop listening %s", m_endpoint.address().to_string().c_str());
+                m_acceptor.reset();
+            }
         }
 
     public:
-        tcp_listener(const actor_ref & handler, const std::shared_ptr<io_context>& ctx, const asio::ip::tcp::endpoint & endpoint)
-            : m_context(ctx), m_endpoint(endpoint), m_server(handler)
+        tcp_listener(const tcp::bind & command, const std::shared_ptr<io_context>& ctx, const asio::ip::tcp::endpoint & endpoint)
+            : m_context(ctx), m_endpoint(endpoint), m_command(command)
         { }
     };
 
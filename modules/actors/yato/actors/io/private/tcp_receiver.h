@@ -8,8 +8,12 @@
 #ifndef _YATO_ACTORS_IO_TCP_RECEIVER_H_
 #define _YATO_ACTORS_IO_TCP_RECEIVER_H_
 
+#include <atomic>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <asio.hpp>
 
@@ -31,11 +35,21 @@ namespace io
         actor_ref m_remote;
         actor_ref m_handler;
 
+        // Accessed only from the io thread
+        bool m_reading = false;
+        bool m_suspended = false;
+        bool m_writing = false;
+        std::deque<std::pair<std::vector<char>, actor_ref>> m_write_queue;
+
+        // Bytes passed to write() and not written yet
+        std::atomic<size_t> m_queued_bytes{ 0 };
+
         static
         void handle_receive_(const std::weak_ptr<tcp_receiver> & weak_self, const asio::error_code & error, std::size_t /*bytes_transferred*/)
         {
             auto self = weak_self.lock();
             if (self != nullptr) {
+                self->m_reading = false;
                 if ((asio::error::eof == error) || (asio::error::connection_reset == error)) {
                     // Disconnected
                     self->m_remote.tell(tcp::peer_closed());
@@ -53,12 +67,47 @@ namespace io
                         return;
                     }
 
+                    buf.resize(len);
+                    self->m_connection->counters().on_received(len);
                     self->m_handler.tell(tcp::received(std::move(buf)), self->m_remote);
                 }
                 else {
                     self->m_remote.tell(error);
                 }
-                self->start_receive_();
+                if (!self->m_suspended) {
+                    self->start_receive_();
+                }
+            }
+        }
+
+        static
+        void handle_write_(const std::weak_ptr<tcp_receiver> & weak_self, const asio::error_code & error, std::size_t bytes_transferred)
+        {
+            auto self = weak_self.lock();
+            if (self != nullptr) {
+                self->m_writing = false;
+                if (error) {
+                    for (const auto & w : self->m_write_queue) {
+                        self->m_queued_bytes.fetch_sub(w.first.size(), std::memory_order_relaxed);
+                        self->m_connection->counters().on_drop();
+                        if (!w.second.empty()) {
+                            w.second.tell(tcp::command_fail(error.message()), self->m_remote);
+                        }
+                    }
+                    self->m_write_queue.clear();
+                    self->m_remote.tell(error);
+                    return;
+                }
+                const auto & done = self->m_write_queue.front();
+                self->m_queued_bytes.fetch_sub(done.first.size(), std::memory_order_relaxed);
+                self->m_connection->counters().on_sent(bytes_transferred);
+                if (!done.second.empty()) {
+                    done.second.tell(tcp::written{ bytes_transferred }, self->m_remote);
+                }
+                self->m_write_queue.pop_front();
+                if (!self->m_write_queue.empty()) {
+                    self->start_write_();
+                }
             }
         }
 
@@ -74,10 +123,19 @@ namespace io
         // http://www.boost.org/doc/libs/1_55_0/doc/html/boost_asio/overview/core/reactor.html
         void start_receive_()
         {
+            m_reading = true;
             m_connection->socket().async_read_some(asio::null_buffers(), 
                 std::bind(&handle_receive_, weak_from_this_impl_(), std::placeholders::_1, std::placeholders::_2));
         }
 
+        // Only one write is in progress, so buffers are sent in order
+        void start_write_()
+        {
+            m_writing = true;
+            asio::async_write(m_connection->socket(), asio::buffer(m_write_queue.front().first),
+                std::bind(&handle_write_, weak_from_this_impl_(), std::placeholders::_1, std::placeholders::_2));
+        }
+
         tcp_receiver(const std::shared_ptr<tcp_connection> & connection, const actor_ref & remote, const actor_ref & handler)
             : m_connection(connection), m_remote(remote), m_handler(handler) 
         {
@@ -102,12 +160,60 @@ namespace io
         }
 
         /**
-            * Write data to socket
-            */
-        bool write(const std::vector<char> & data) {
-            asio::error_code err;
-            const size_t len = m_connection->socket().send(asio::buffer(data), 0, err);
-            return !err && (len == data.size());
+         * Don't wait for new data. Can be called from any thread.
+         */
+        void suspend()
+        {
+            std::weak_ptr<tcp_receiver> weak_self = weak_from_this_impl_();
+            asio::post(m_connection->socket().get_executor(), [weak_self] {
+                auto self = weak_self.lock();
+                if (self != nullptr) {
+                    self->m_suspended = true;
+                }
+            });
+        }
+
+        /**
+         * Continue reading after suspend(). Can be called from any thread.
+         */
+        void resume()
+        {
+            std::weak_ptr<tcp_receiver> weak_self = weak_from_this_impl_();
+            asio::post(m_connection->socket().get_executor(), [weak_self] {
+                auto self = weak_self.lock();
+                if ((self != nullptr) && self->m_suspended) {
+                    self->m_suspended = false;
+                    if (!self->m_reading) {
+                        self->start_receive_();
+                    }
+                }
+            });
+        }
+
+        /**
+         * Enqueue data for writing to the socket. Doesn't block, the data is written by the io thread. Write errors are sent to the remote actor.
+         * @param ack Receives tcp::written after the data is written, or command_fail on error. Can be empty.
+         * @return false if the data is dropped, because the write queue limit is exceeded
+         */
+        bool write(std::vector<char> && data, const actor_ref & ack) {
+            const size_t limit = m_connection->options().write_queue_limit;
+            const size_t queued = m_queued_bytes.fetch_add(data.size(), std::memory_order_relaxed);
+            if ((limit != 0) && (queued != 0) && (queued + data.size() > limit)) {
+                m_queued_bytes.fetch_sub(data.size(), std::memory_order_relaxed);
+                m_connection->counters().on_drop();
+                return false;
+            }
+            std::weak_ptr<tcp_receiver> weak_self = weak_from_this_impl_();
+            asio::post(m_connection->socket().get_executor(), [weak_self, buffer = std::move(data), ack]() mutable {
+                auto self = weak_self.lock();
+                if (self != nullptr) {
+                    self->m_write_queue.emplace_back(std::move(buffer), ack);
+                    if (!self->m_writing) {
+                        self->start_write_();
+                    }
+                }
+            });
+            return true;
         }
 
         static
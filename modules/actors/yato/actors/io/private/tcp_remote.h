@@ -41,13 +41,21 @@ namespace io
         void receive(yato::any && message) override
         {
             any_match(
-                [this](const tcp::write & msg) {
+                [this](tcp::write & msg) {
+                    const actor_ref ack = msg.ack ? sender() : actor_ref{};
                     if(m_receiver != nullptr) {
-                        if(!m_receiver->write(msg.data)) {
-                            log().error("Unknown error on tcp::write");
+                        if(!m_receiver->write(std::move(msg.data), ack)) {
+                            log().warning("Write queue is full. Message was dropped!");
+                            if (!ack.empty()) {
+                                ack.tell(tcp::command_fail("Write queue is full"), self());
+                            }
                         }
                     } else {
+                        m_connection->counters().on_drop();
                         log().warning("Handler is not assigned yet. Message was dropped!");
+                        if (!ack.empty()) {
+                            ack.tell(tcp::command_fail("Handler is not assigned"), self());
+                        }
                     }
                 },
                 [this](const tcp::assign & assign) {
@@ -56,8 +64,21 @@ namespace io
                         m_receiver = tcp_receiver::create(m_connection, self(), assign.handler);
                     }
                 },
+                [this](const tcp::suspend_reading &) {
+                    if (m_receiver != nullptr) {
+                        m_receiver->suspend();
+                    }
+                },
+                [this](const tcp::resume_reading &) {
+                    if (m_receiver != nullptr) {
+                        m_receiver->resume();
+                    }
+                },
+                [this](const get_stats &) {
+                    sender().tell(m_connection->counters().snapshot(m_connection->socket()), self());
+                },
                 [this](const asio::error_code & error) {
-                    log().error("Receive error! %s", error.message().c_str());
+                    log().error("Socket error! %s", error.message().c_str());
                 },
                 [this](const tcp::peer_closed & closed) {
                     log().info("Disconnected.");
@@ -0,0 +1,230 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <deque>
+#include <string>
+
+#include "../tcp_stream.h"
+
+#include "../../actor_system.h"
+#include "../../serialization.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace io
+{
+
+    namespace
+    {
+        using frame_size_type = uint32_t;
+
+        class frame_source_stage
+            : public streams::stage
+        {
+        private:
+            actor_ref m_connection;
+            size_t m_max_frame_size;
+            std::vector<char> m_input;
+            bool m_suspended = false;
+            //-------------------------------------------------------
+
+            /**
+             * @return false if the stream is failed
+             */
+            bool decode_()
+            {
+                input_buffer in(m_input.data(), m_input.data() + m_input.size());
+                for (;;) {
+                    input_buffer pos = in;
+                    frame_size_type size = 0;
+                    if (!serializer<frame_size_type>::read(pos, size)) {
+                        break;
+                    }
+                    if (size > m_max_frame_size) {
+                        // Partial frame is not buffered, the connection is closed after the handler is stopped
+                        m_input.clear();
+                        m_input.shrink_to_fit();
+                        fail_("frame_source: Frame of " + std::to_string(size) + " bytes exceeds max frame size.");
+                        return false;
+                    }
+                    if (pos.remaining() < size) {
+                        break;
+                    }
+                    emit_(yato::any(std::vector<char>(pos.position(), pos.position() + size)));
+                    in.skip(sizeof(frame_size_type) + size);
+                }
+                m_input.erase(m_input.begin(), m_input.end() - in.remaining());
+                return true;
+            }
+
+            void update_flow_()
+            {
+                const size_t pending = pending_();
+                if (!m_suspended && (pending >= buffer_size())) {
+                    m_suspended = true;
+                    m_connection.tell(tcp::suspend_reading{}, self());
+                } else if (m_suspended && (pending <= buffer_size() / 2)) {
+                    m_suspended = false;
+                    m_connection.tell(tcp::resume_reading{}, self());
+                }
+            }
+
+            void pre_start() override
+            {
+                streams::stage::pre_start();
+                m_connection.tell(tcp::assign(self()), self());
+                watch(m_connection);
+            }
+
+            void on_demand_() override
+            {
+                update_flow_();
+            }
+
+            void on_message_(yato::any & message) override
+            {
+                if (message.is_type<tcp::received>()) {
+                    auto & data = message.get_unsafe<tcp::received>().data;
+                    if (m_input.empty()) {
+                        m_input.swap(data);
+                    } else {
+                        m_input.insert(m_input.end(), data.cbegin(), data.cend());
+                    }
+                    if (decode_()) {
+                        update_flow_();
+                    }
+                } else if (message.is_type<tcp::peer_closed>() || message.is_type<terminated>()) {
+                    if (!m_input.empty()) {
+                        log().warning("frame_source: Connection is closed in the middle of a frame.");
+                    }
+                    complete_();
+                } else {
+                    streams::stage::on_message_(message);
+                }
+            }
+
+        public:
+            frame_source_stage(const streams::stage_settings & settings, const actor_ref & connection, size_t max_frame_size)
+                : streams::stage(settings), m_connection(connection), m_max_frame_size(max_frame_size)
+            { }
+        };
+        //-------------------------------------------------------
+
+        class frame_sink_stage
+            : public streams::stage
+        {
+        private:
+            struct flush {};
+
+            actor_ref m_connection;
+            output_buffer m_output;
+            size_t m_buffered = 0;
+            // Number of frames in every write, which is not acknowledged yet
+            std::deque<size_t> m_writes;
+            size_t m_unacknowledged = 0;
+            bool m_upstream_completed = false;
+            //-------------------------------------------------------
+
+            void flush_()
+            {
+                if (!m_output.empty()) {
+                    m_connection.tell(tcp::write(m_output.release(), true), self());
+                    m_writes.push_back(m_buffered);
+                    m_unacknowledged += m_buffered;
+                    m_buffered = 0;
+                }
+            }
+
+            /**
+             * Elements are requested from upstream, only when frames are written to the socket
+             */
+            size_t pending_() const override
+            {
+                return m_buffered + m_unacknowledged;
+            }
+
+            void on_element_(yato::any && element) override
+            {
+                if (!element.is_type<std::vector<char>>()) {
+                    fail_("frame_sink: Element type is not std::vector<char>.");
+                    return;
+                }
+                const auto & payload = element.get_unsafe<std::vector<char>>();
+                if (m_output.empty()) {
+                    // Written after all frames, which are already in the mailbox
+                    self().tell(flush{});
+                }
+                serializer<frame_size_type>::write(m_output, yato::narrow_cast<frame_size_type>(payload.size()));
+                m_output.write(payload.data(), payload.size());
+                ++m_buffered;
+            }
+
+            void on_upstream_complete_() override
+            {
+                flush_();
+                m_upstream_completed = true;
+                if (m_writes.empty()) {
+                    complete_();
+                }
+            }
+
+            void on_message_(yato::any & message) override
+            {
+                if (message.is_type<flush>()) {
+                    flush_();
+                } else if (message.is_type<tcp::written>()) {
+                    if (!m_writes.empty()) {
+                        m_unacknowledged -= m_writes.front();
+                        m_writes.pop_front();
+                    }
+                    if (m_upstream_completed) {
+                        if (m_writes.empty()) {
+                            complete_();
+                        }
+                    } else {
+                        replenish_();
+                    }
+                } else if (message.is_type<tcp::command_fail>()) {
+                    fail_("frame_sink: Failed to write. " + message.get_unsafe<tcp::command_fail>().reason);
+                } else {
+                    streams::stage::on_message_(message);
+                }
+            }
+
+        public:
+            frame_sink_stage(const streams::stage_settings & settings, const actor_ref & connection)
+                : streams::stage(settings), m_connection(connection)
+            { }
+        };
+        //-------------------------------------------------------
+
+    } // namespace
+
+    namespace tcp
+    {
+        streams::stage_factory frame_source(const actor_ref & connection, size_t max_frame_size)
+        {
+            return [connection, max_frame_size](const streams::stage_settings & settings) {
+                return std::unique_ptr<basic_actor>(new frame_source_stage(settings, connection, max_frame_size));
+            };
+        }
+
+        streams::stage_factory frame_sink(const actor_ref & connection)
+        {
+            return [connection](const streams::stage_settings & settings) {
+                return std::unique_ptr<basic_actor>(new frame_sink_stage(settings, connection));
+            };
+        }
+    }
+
+} // namespace io
+
+} // namespace actors
+
+} // namespace yato
@@ -43,7 +43,14 @@ namespace io
         yato::any_match(
             [this](const udp::bind & bind) {
                 log().debug("Bind");
-                auto connection = std::make_unique<udp_connection>(bind.handler, m_context->service(), bind.address);
+                std::unique_ptr<udp_connection> connection;
+                try {
+                    connection = std::make_unique<udp_connection>(bind.handler, m_context->service(), bind.address, bind.options);
+                }
+                catch (asio::system_error & err) {
+                    bind.handler.tell(udp::command_fail("Failed to bind " + bind.address.to_string() + ". " + err.what()), self());
+                    return;
+                }
 
                 const std::string remote_name = bind.address.to_string();
                 actor_system_ex::create_actor<udp_remote>(system(), self(), remote_name, std::move(connection));
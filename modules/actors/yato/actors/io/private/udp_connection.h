@@ -12,6 +12,7 @@
 
 #include "../../actor_ref.h"
 #include "../inet_address.h"
+#include "socket_tuning.h"
 
 namespace yato
 {
@@ -25,11 +26,27 @@ namespace io
     private:
         actor_ref m_server;
         asio::ip::udp::socket m_socket;
+        connection_counters m_counters;
 
     public:
-        udp_connection(const actor_ref & server, asio::io_service & io, const inet_address & address)
-            : m_server(server), m_socket(io, asio::ip::udp::endpoint(asio::ip::udp::v4(), address.port))
-        { }
+        /**
+         * Throws asio::system_error if failed to bind
+         */
+        udp_connection(const actor_ref & server, asio::io_service & io, const inet_address & address, const socket_options & options)
+            : m_server(server), m_socket(io)
+        {
+            const asio::ip::udp::endpoint endpoint(asio::ip::udp::v4(), address.port);
+            asio::error_code err;
+            m_socket.open(endpoint.protocol(), err);
+            apply_bind_options(m_socket, options, err);
+            apply_socket_options(m_socket, options, err);
+            if (!err) {
+                m_socket.bind(endpoint, err);
+            }
+            if (err) {
+                throw asio::system_error(err);
+            }
+        }
 
         asio::ip::udp::socket & socket() {
             return m_socket;
@@ -42,6 +59,10 @@ namespace io
         const actor_ref & server() const {
             return m_server;
         }
+
+        connection_counters & counters() {
+            return m_counters;
+        }
     };
 
 } // namespace io
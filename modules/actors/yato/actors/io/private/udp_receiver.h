@@ -57,6 +57,7 @@ namespace io
                             std::memcpy(&buf[0], &(*buffer)[0], bytes_transferred);
                         }
 
+                        self->m_connection->counters().on_received(bytes_transferred);
                         inet_address sender(self->m_remote_endpoint.address().to_string(), self->m_remote_endpoint.port());
                         self->m_handler.tell(udp::received(std::move(buf), std::move(sender)), self->m_remote);
                     }
@@ -117,7 +118,12 @@ namespace io
             asio::error_code err;
             const asio::ip::udp::endpoint destination(asio::ip::address::from_string(address.host), address.port);
             const size_t len = m_connection->socket().send_to(asio::buffer(data), destination, 0, err);
-            return !err && (len == data.size());
+            if (err || (len != data.size())) {
+                m_connection->counters().on_drop();
+                return false;
+            }
+            m_connection->counters().on_sent(len);
+            return true;
         }
 
         static
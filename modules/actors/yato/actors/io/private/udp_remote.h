@@ -46,6 +46,9 @@ namespace io
         void receive(yato::any && message) override
         {
             yato::any_match(
+                [this](const get_stats &) {
+                    sender().tell(m_connection->counters().snapshot(m_connection->socket()), self());
+                },
                 [this](const asio::error_code & error) {
                     log().error("Receive error! %s", error.message().c_str());
                 },
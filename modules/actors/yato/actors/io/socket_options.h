@@ -0,0 +1,95 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_IO_SOCKET_OPTIONS_H_
+#define _YATO_ACTORS_IO_SOCKET_OPTIONS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace yato
+{
+namespace actors
+{
+namespace io
+{
+
+    /**
+     * Socket tuning options.
+     * Zero values keep the system defaults.
+     */
+    struct socket_options
+    {
+        /**
+         * TCP_NODELAY. Disables Nagle's algorithm. Ignored for UDP.
+         */
+        bool no_delay = false;
+
+        /**
+         * SO_REUSEPORT. Allows several listeners on the same port. Is set before binding.
+         * Ignored on platforms without the option.
+         */
+        bool reuse_port = false;
+
+        /**
+         * SO_RCVBUF in bytes
+         */
+        int32_t receive_buffer_size = 0;
+
+        /**
+         * SO_SNDBUF in bytes
+         */
+        int32_t send_buffer_size = 0;
+
+        /**
+         * SO_BUSY_POLL in microseconds. Only Linux.
+         */
+        int32_t busy_poll = 0;
+
+        /**
+         * Max bytes waiting to be written to a TCP connection. A write exceeding the limit is dropped and counted in drops.
+         * A write into an empty queue is always accepted. Zero means no limit.
+         */
+        size_t write_queue_limit = 0;
+    };
+
+
+    /**
+     * Requests connection statistics. Can be sent to a connection actor, i.e. the sender of tcp::received or udp::received.
+     * The reply is connection_stats.
+     */
+    struct get_stats
+    { };
+
+    /**
+     * Snapshot of connection counters
+     */
+    struct connection_stats
+    {
+        uint64_t bytes_received = 0;
+        uint64_t bytes_sent = 0;
+        uint64_t packets_received = 0;
+        uint64_t packets_sent = 0;
+
+        /**
+         * Outgoing messages, which were not written completely or were dropped by the write queue limit
+         */
+        uint64_t drops = 0;
+
+        /**
+         * Bytes waiting in the socket receive queue
+         */
+        uint64_t queue_depth = 0;
+    };
+
+} // namespace io
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_IO_SOCKET_OPTIONS_H_
@@ -12,8 +12,10 @@
 #include <vector>
 
 #include "../actor.h"
+#include "../actor_common.h"
 #include "facade.h"
 #include "inet_address.h"
+#include "socket_options.h"
 
 namespace yato
 {
@@ -33,6 +35,33 @@ namespace io
          */
         actor_ref get_for(const actor_system & sys);
 
+        /**
+         * Admission control of a TCP server.
+         */
+        struct accept_options
+        {
+            /**
+             * Maximal number of simultaneously open connections. Zero means no limit.
+             * Connections above the limit are closed right after accepting.
+             */
+            uint32_t max_connections = 0;
+
+            /**
+             * Maximal number of connections accepted per one wake up of the io thread.
+             */
+            uint32_t batch_size = 16;
+
+            /**
+             * Length of the pending connections queue of the listening socket. Zero means the system default.
+             */
+            uint32_t backlog = 0;
+
+            /**
+             * Number of connection objects allocated in advance. Closed connections are recycled up to this number.
+             */
+            uint32_t pool_size = 0;
+        };
+
         /**
          * Create a TCP server and listen for inbound connections.
          */
@@ -40,22 +69,59 @@ namespace io
         {
             actor_ref handler;
             inet_address address;
+            socket_options options;
+            accept_options accept;
 
             bind(const actor_ref & handler, const inet_address & address)
                 : handler(handler), address(address)
             { }
+
+            /**
+             * The options are applied to the listening socket and to all accepted connections.
+             */
+            bind(const actor_ref & handler, const inet_address & address, const socket_options & options)
+                : handler(handler), address(address), options(options)
+            { }
+
+            bind(const actor_ref & handler, const inet_address & address, const socket_options & options, const accept_options & accept)
+                : handler(handler), address(address), options(options), accept(accept)
+            { }
         };
 
+        /**
+         * Connection timeout used if it is not specified explicitly.
+         */
+        YATO_INLINE_VARIABLE constexpr
+        std::chrono::seconds default_connect_timeout{10};
+
         /**
          * Create a TCP client and connect to an endpoint.
+         * Resolving and connecting are asynchronous. If the connection is not established
+         * within the timeout, then command_fail is sent to the handler.
          */
         struct connect
         {
             actor_ref handler;
             inet_address address;
+            timeout_type timeout;
+            socket_options options;
 
             connect(const actor_ref & handler, const inet_address & address)
-                : handler(handler), address(address)
+                : handler(handler), address(address), timeout(default_connect_timeout)
+            { }
+
+            template <typename Rep_, typename Period_>
+            connect(const actor_ref & handler, const inet_address & address, const std::chrono::duration<Rep_, Period_> & timeout)
+                : handler(handler), address(address), timeout(std::chrono::duration_cast<timeout_type>(timeout))
+            { }
+
+            connect(const actor_ref & handler, const inet_address & address, const socket_options & options)
+                : handler(handler), address(address), timeout(default_connect_timeout), options(options)
+            { }
+
+            template <typename Rep_, typename Period_>
+            connect(const actor_ref & handler, const inet_address & address, const std::chrono::duration<Rep_, Period_> & timeout, const socket_options & options)
+                : handler(handler), address(address), timeout(std::chrono::duration_cast<timeout_type>(timeout)), options(options)
             { }
         };
 
@@ -117,23 +183,33 @@ namespace io
         };
 
         /**
-         * Outgoing data wrapper
+         * Outgoing data wrapper.
+         * If ack is set, the sender receives tcp::written when the data is passed to the socket, or command_fail if it is dropped.
          */
         struct write
         {
             std::vector<char> data;
+            bool ack = false;
 
             explicit
-            write(const std::vector<char> & data)
-                : data(data)
+            write(const std::vector<char> & data, bool ack = false)
+                : data(data), ack(ack)
             { }
 
             explicit
-            write(std::vector<char> && data)
-                : data(std::move(data))
+            write(std::vector<char> && data, bool ack = false)
+                : data(std::move(data)), ack(ack)
             { }
         };
 
+        /**
+         * Acknowledgement of tcp::write
+         */
+        struct written
+        {
+            size_t bytes;
+        };
+
         /**
          * Reports error in command execution.
          */
@@ -157,6 +233,19 @@ namespace io
          */
         struct peer_closed
         { };
+
+        /**
+         * Stop reading from the socket until resume_reading is received.
+         * Incoming data stays in the kernel buffer, so the remote side is slowed down by TCP flow control.
+         */
+        struct suspend_reading
+        { };
+
+        /**
+         * Continue reading after suspend_reading.
+         */
+        struct resume_reading
+        { };
     }
 
 
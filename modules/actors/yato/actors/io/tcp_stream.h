@@ -0,0 +1,46 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_IO_TCP_STREAM_H_
+#define _YATO_ACTORS_IO_TCP_STREAM_H_
+
+#include "../streams/stage.h"
+#include "tcp.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace io
+{
+
+    namespace tcp
+    {
+        /**
+         * Stream source producing frames received from a connection.
+         * Frame is encoded as u32 payload size in host byte order followed by the payload. Elements have type std::vector<char>.
+         * The stage is assigned as the connection handler. Reading from the socket is suspended while the stage buffer is full.
+         * The source completes when the connection is closed. The stream fails if a frame is larger than max_frame_size, so a partial frame is never buffered beyond the limit.
+         */
+        streams::stage_factory frame_source(const actor_ref & connection, size_t max_frame_size = 16 * 1024 * 1024);
+
+        /**
+         * Stream sink writing elements of type std::vector<char> to a connection as frames.
+         * Frames received in one burst are coalesced into a single write.
+         * Frames count against the stage buffer until the connection acknowledges the write, so a slow socket slows the stream down.
+         * The sink completes after all frames are written. The stream fails if a write fails.
+         */
+        streams::stage_factory frame_sink(const actor_ref & connection);
+    }
+
+} // namespace io
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_IO_TCP_STREAM_H_
@@ -11,6 +11,7 @@
 #include "../actor.h"
 #include "facade.h"
 #include "inet_address.h"
+#include "socket_options.h"
 
 namespace yato
 {
@@ -29,16 +30,21 @@ namespace io
         actor_ref get_for(const actor_system & sys);
 
         /**
-         * Create a TCP server and listen for inbound connections.
+         * Create a UDP socket bound to an address.
          */
         struct bind
         {
             actor_ref handler;
             inet_address address;
+            socket_options options;
 
             bind(const actor_ref & handler, const inet_address & address)
                 : handler(handler), address(address)
             { }
+
+            bind(const actor_ref & handler, const inet_address & address, const socket_options & options)
+                : handler(handler), address(address), options(options)
+            { }
         };
 
         /**
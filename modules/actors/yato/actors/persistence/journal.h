@@ -0,0 +1,153 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_PERSISTENCE_JOURNAL_H_
+#define _YATO_ACTORS_PERSISTENCE_JOURNAL_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../actor_ref.h"
+#include "../serialization.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace persistence
+{
+
+    /**
+     * Position in the journal
+     */
+    struct journal_position
+    {
+        uint64_t segment = 0;
+        uint64_t offset  = 0;
+    };
+
+    struct journal_options
+    {
+        /**
+         * Size of a journal file. Every file is preallocated and mapped into memory.
+         */
+        uint64_t segment_size = 64 * 1024 * 1024;
+
+        /**
+         * Flush written records to the disk before confirming them.
+         */
+        bool sync = true;
+
+        /**
+         * Maximal number of records committed by one flush.
+         */
+        uint32_t max_batch = 4096;
+    };
+
+    /**
+     * Is sent by the journal to the writer after its records up to the sequence number are committed.
+     */
+    struct journal_written
+    {
+        uint64_t sequence;
+        journal_position end;
+    };
+
+    /**
+     * Is sent by the journal to the writer if a record can't be written.
+     */
+    struct journal_failure
+    {
+        uint64_t sequence;
+        std::string reason;
+    };
+
+    /**
+     * Loaded snapshot
+     */
+    struct snapshot_record
+    {
+        uint64_t sequence = 0;
+        journal_position position;
+        serialization_registry::type_id type = 0;
+        std::vector<char> payload;
+    };
+
+    struct journal_context;
+
+    /**
+     * Append-only event log shared by persistent actors.
+     * The journal is a directory of preallocated segment files mapped into memory.
+     * Records are written by a dedicated thread. All records appended while the previous flush is in progress are committed by the next single flush.
+     */
+    class journal
+    {
+    private:
+        std::unique_ptr<journal_context> m_context;
+        //-------------------------------------------------------
+
+        journal(const std::string & directory, const journal_options & options);
+
+    public:
+        ~journal();
+
+        journal(const journal&) = delete;
+        journal& operator=(const journal&) = delete;
+
+        /**
+         * Open or create a journal in the directory.
+         */
+        static
+        std::shared_ptr<journal> open(const std::string & directory, const journal_options & options = journal_options{});
+
+        /**
+         * Delete all journal files in the directory. The directory is removed if nothing else is left.
+         */
+        static
+        void remove(const std::string & directory);
+
+        /**
+         * Enqueue an event record. The writer is notified by journal_written or journal_failure. Thread safe.
+         * After a failure of a record, the following records of the entity are rejected until a record with the failed sequence number is appended.
+         * Only the first failure is reported to the writer.
+         */
+        void append(const std::string & persistence_id, uint64_t sequence, serialization_registry::type_id type, std::vector<char> && payload, const actor_ref & writer);
+
+        /**
+         * Read committed events of an entity, starting from the position, with the sequence number greater than `after`.
+         * @return Committed end of the journal
+         */
+        journal_position replay(const std::string & persistence_id, const journal_position & from, uint64_t after,
+            const std::function<void(uint64_t sequence, serialization_registry::type_id type, input_buffer & payload)> & callback) const;
+
+        /**
+         * Enqueue a snapshot. It is written after all previously appended records.
+         * @param position Journal position after the event with the sequence number.
+         */
+        void save_snapshot(const std::string & persistence_id, uint64_t sequence, const journal_position & position, serialization_registry::type_id type, std::vector<char> && payload);
+
+        /**
+         * Read the latest snapshot of an entity.
+         * @return false if there is no snapshot
+         */
+        bool load_snapshot(const std::string & persistence_id, snapshot_record & snapshot) const;
+
+        /**
+         * Wait until all records enqueued before the call are committed.
+         */
+        void flush();
+    };
+
+} // namespace persistence
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_PERSISTENCE_JOURNAL_H_
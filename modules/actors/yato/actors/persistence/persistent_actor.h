@@ -0,0 +1,157 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_PERSISTENCE_PERSISTENT_ACTOR_H_
+#define _YATO_ACTORS_PERSISTENCE_PERSISTENT_ACTOR_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include "../actor.h"
+#include "journal.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace persistence
+{
+
+    /**
+     * Event-sourced actor.
+     * State is changed only by events passed to persist(). On start the state is recovered from the latest snapshot and the following events.
+     * Event and snapshot types have to be registered in the actor system serialization registry.
+     * Commands received while events are being written are stashed and processed after the events are confirmed.
+     */
+    class persistent_actor
+        : public basic_actor
+    {
+    private:
+        struct pending_event
+        {
+            uint64_t sequence;
+            yato::any event;
+            std::function<void(const yato::any &)> handler;
+            actor_ref sender;
+        };
+
+        struct stashed_message
+        {
+            yato::any message;
+            actor_ref sender;
+        };
+
+        std::shared_ptr<journal> m_journal;
+        uint32_t m_snapshot_interval;
+        std::string m_persistence_id;
+
+        uint64_t m_sequence = 0;
+        uint64_t m_snapshot_sequence = 0;
+        journal_position m_position;
+
+        std::deque<pending_event> m_pending;
+        std::deque<stashed_message> m_stash;
+        //-------------------------------------------------------
+
+        void persist_impl_(yato::any && event, std::function<void(const yato::any &)> && handler);
+
+        void on_written_(const journal_written & written);
+
+        void on_failed_(const journal_failure & failure);
+
+        void unstash_();
+
+        void save_snapshot_();
+
+        void pre_start() final;
+
+        void post_stop() final;
+
+        void receive(yato::any && message) final;
+
+    protected:
+        /**
+         * Unique and stable identifier of the entity. Path of the actor by default.
+         */
+        virtual std::string persistence_id() const;
+
+        /**
+         * Apply a recovered event to the state.
+         */
+        virtual void receive_recover(const yato::any & event) = 0;
+
+        /**
+         * Process a command.
+         */
+        virtual void receive_command(yato::any && message) = 0;
+
+        /**
+         * Make a snapshot of the current state. Empty result disables snapshots.
+         */
+        virtual yato::any snapshot() const
+        {
+            return yato::any{};
+        }
+
+        /**
+         * Apply a recovered snapshot. Is called before replaying events.
+         */
+        virtual void recover_snapshot(const yato::any & /*state*/)
+        { }
+
+        /**
+         * Is called after recovery, before the first command.
+         */
+        virtual void on_recovery_completed()
+        { }
+
+        /**
+         * Is called if an event can't be written. The failed event and all events persisted after it are dropped, their handlers are not called and their sequence numbers are reused.
+         * Stashed commands are processed after the call. Stops the actor and drops stashed commands by default.
+         */
+        virtual void on_persist_failure(const std::string & reason);
+
+        /**
+         * Write the event to the journal. The handler is called with the event after the write is committed.
+         * Sender of the command is available in the handler.
+         */
+        template <typename Ty_, typename Fn_>
+        void persist(Ty_ && event, Fn_ && handler)
+        {
+            using event_type = typename std::decay<Ty_>::type;
+            persist_impl_(yato::any(std::forward<Ty_>(event)), [h = std::forward<Fn_>(handler)](const yato::any & e) mutable {
+                h(e.get_unsafe<event_type>());
+            });
+        }
+
+        /**
+         * Sequence number of the last persisted or recovered event.
+         */
+        uint64_t last_sequence() const
+        {
+            return m_sequence;
+        }
+
+    public:
+        /**
+         * @param snapshot_interval Save snapshot every N events. Zero disables snapshots.
+         */
+        explicit
+        persistent_actor(const std::shared_ptr<journal> & events_journal, uint32_t snapshot_interval = 0);
+
+        ~persistent_actor() override;
+    };
+
+} // namespace persistence
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_PERSISTENCE_PERSISTENT_ACTOR_H_
@@ -0,0 +1,507 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "../journal.h"
+#include "../../actor_system.h"
+#include "mapped_file.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace persistence
+{
+
+    namespace
+    {
+        /**
+         * Segment layout:
+         *   [u64 magic][u64 reserved][record]...[u32 zero]
+         * Record layout:
+         *   [u32 body size][u32 body checksum][u32 id length][id][u64 sequence][u32 type][payload]
+         * Unused space of a segment is zero, so zero body size marks the end.
+         */
+        const uint64_t segment_magic  = 0x313030304C4E524AULL; // "JRNL0001"
+        const uint64_t snapshot_magic = 0x3130303050414E53ULL; // "SNAP0001"
+
+        const size_t segment_header_size = 2 * sizeof(uint64_t);
+        const size_t record_header_size  = 2 * sizeof(uint32_t);
+
+        uint32_t checksum(const char* data, size_t size)
+        {
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= static_cast<uint8_t>(data[i]);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        template <typename Ty_>
+        void store(char* & dst, const Ty_ & value)
+        {
+            std::memcpy(dst, &value, sizeof(Ty_));
+            dst += sizeof(Ty_);
+        }
+
+        template <typename Ty_>
+        Ty_ load(const char* src)
+        {
+            Ty_ value;
+            std::memcpy(&value, src, sizeof(Ty_));
+            return value;
+        }
+
+        std::string segment_path(const std::string & directory, uint64_t index)
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "segment_%08llu.journal", static_cast<unsigned long long>(index));
+            return directory + "/" + name;
+        }
+
+        std::string snapshot_path(const std::string & directory, const std::string & persistence_id)
+        {
+            std::string name = "snapshot_";
+            for (const char c : persistence_id.substr(0, 64)) {
+                const bool plain = ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) || (c == '-');
+                name.push_back(plain ? c : '_');
+            }
+            char hash[16];
+            std::snprintf(hash, sizeof(hash), "_%08x", static_cast<unsigned>(checksum(persistence_id.data(), persistence_id.size())));
+            return directory + "/" + name + hash + ".snapshot";
+        }
+
+        /**
+         * Finds the end of valid records in a segment.
+         */
+        size_t scan_segment(const mapped_file & file, size_t offset)
+        {
+            const char* data = file.data();
+            while (offset + record_header_size <= file.size()) {
+                const auto size = load<uint32_t>(data + offset);
+                if ((size == 0) || (size > file.size() - offset - record_header_size)) {
+                    break;
+                }
+                if (load<uint32_t>(data + offset + sizeof(uint32_t)) != checksum(data + offset + record_header_size, size)) {
+                    break;
+                }
+                offset += record_header_size + size;
+            }
+            return offset;
+        }
+    }
+    //-------------------------------------------------------
+
+    struct journal_context
+    {
+        struct request
+        {
+            bool is_snapshot;
+            std::string persistence_id;
+            uint64_t sequence;
+            serialization_registry::type_id type;
+            std::vector<char> payload;
+            actor_ref writer;
+            journal_position position;
+            std::string error;
+        };
+
+        std::string directory;
+        journal_options options;
+
+        std::mutex mutex;
+        std::condition_variable request_cv;
+        std::condition_variable flush_cv;
+        std::vector<request> queue;
+        uint64_t enqueued  = 0;
+        uint64_t completed = 0;
+        bool stop = false;
+        journal_position committed;
+
+        // Writer thread state
+        mapped_file segment;
+        uint64_t segment_index = 0;
+        size_t write_offset = 0;
+        size_t sync_offset  = 0;
+        // Sequence number of the first failed record by the entity
+        std::unordered_map<std::string, uint64_t> failed;
+        std::thread writer;
+        //-------------------------------------------------------
+
+        void open_segment_(uint64_t index, bool create)
+        {
+            const auto path = segment_path(directory, index);
+            segment = mapped_file(path, create ? static_cast<size_t>(options.segment_size) : 0, true);
+            if (create && !sync_directory(directory)) {
+                throw yato::runtime_error("journal: Failed to sync directory " + directory);
+            }
+            if (segment.size() < segment_header_size) {
+                throw yato::runtime_error("journal: Segment is too small " + path);
+            }
+            const auto magic = load<uint64_t>(segment.data());
+            if (magic == 0) {
+                char* dst = segment.data();
+                store(dst, segment_magic);
+            } else if (magic != segment_magic) {
+                throw yato::runtime_error("journal: Invalid segment " + path);
+            }
+            segment_index = index;
+            write_offset = scan_segment(segment, segment_header_size);
+            sync_offset  = 0;
+            // Clear a torn record, so it is not confused with data written later
+            if (write_offset + record_header_size <= segment.size()) {
+                const auto torn = load<uint32_t>(segment.data() + write_offset);
+                if (torn != 0) {
+                    const size_t length = std::min<size_t>(segment.size() - write_offset, record_header_size + static_cast<size_t>(torn));
+                    std::memset(segment.data() + write_offset, 0, length);
+                }
+            }
+        }
+
+        bool sync_()
+        {
+            bool success = true;
+            if (options.sync) {
+                success = segment.sync(sync_offset, write_offset - sync_offset);
+            }
+            sync_offset = write_offset;
+            return success;
+        }
+
+        void write_record_(request & r)
+        {
+            const size_t body_size = sizeof(uint32_t) + r.persistence_id.size() + sizeof(uint64_t) + sizeof(uint32_t) + r.payload.size();
+            const size_t record_size = record_header_size + body_size;
+            if (record_size > options.segment_size - segment_header_size) {
+                r.error = "journal: Record is larger than a segment";
+                return;
+            }
+            if (write_offset + record_size > segment.size()) {
+                if (!sync_()) {
+                    r.error = "journal: Failed to flush segment";
+                    return;
+                }
+                open_segment_(segment_index + 1, true);
+            }
+            char* dst = segment.data() + write_offset;
+            char* body = dst + record_header_size;
+            char* pos = body;
+            store(pos, static_cast<uint32_t>(r.persistence_id.size()));
+            std::memcpy(pos, r.persistence_id.data(), r.persistence_id.size());
+            pos += r.persistence_id.size();
+            store(pos, r.sequence);
+            store(pos, r.type);
+            if (!r.payload.empty()) {
+                std::memcpy(pos, r.payload.data(), r.payload.size());
+            }
+            store(dst, static_cast<uint32_t>(body_size));
+            store(dst, checksum(body, body_size));
+
+            write_offset += record_size;
+            r.position.segment = segment_index;
+            r.position.offset  = write_offset;
+        }
+
+        void write_snapshot_(request & r) const
+        {
+            std::vector<char> buffer(4 * sizeof(uint64_t) + 2 * sizeof(uint32_t) + r.payload.size());
+            char* pos = buffer.data();
+            store(pos, snapshot_magic);
+            store(pos, r.sequence);
+            store(pos, r.position.segment);
+            store(pos, r.position.offset);
+            store(pos, r.type);
+            store(pos, checksum(r.payload.data(), r.payload.size()));
+            if (!r.payload.empty()) {
+                std::memcpy(pos, r.payload.data(), r.payload.size());
+            }
+            const auto path = snapshot_path(directory, r.persistence_id);
+            const auto tmp  = path + ".tmp";
+            if (!write_file_sync(tmp, buffer.data(), buffer.size()) || !replace_file(tmp, path)) {
+                r.error = "journal: Failed to write snapshot " + path;
+            }
+        }
+
+        /**
+         * After a failure the writer drops the following events and persists the next event with the failed sequence number.
+         * Records of the entity appended before that are rejected, so the dropped events are never recovered.
+         * @return true if the record is rejected
+         */
+        bool reject_(request & r)
+        {
+            const auto it = failed.find(r.persistence_id);
+            if (it == failed.end()) {
+                return false;
+            }
+            if (r.sequence > it->second) {
+                r.error = "journal: Previous record of the entity is not written";
+                return true;
+            }
+            failed.erase(it);
+            return false;
+        }
+
+        void run_()
+        {
+            std::vector<request> batch;
+            std::unordered_map<actor_path, journal_written> written;
+            for (;;) {
+                batch.clear();
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    request_cv.wait(lock, [this] { return stop || !queue.empty(); });
+                    if (queue.empty()) {
+                        break;
+                    }
+                    if (queue.size() <= options.max_batch) {
+                        batch.swap(queue);
+                    } else {
+                        batch.assign(std::make_move_iterator(queue.begin()), std::make_move_iterator(queue.begin() + options.max_batch));
+                        queue.erase(queue.begin(), queue.begin() + options.max_batch);
+                    }
+                }
+
+                // Group commit: write all records, then flush once
+                for (auto & r : batch) {
+                    if (!r.is_snapshot && !reject_(r)) {
+                        try {
+                            write_record_(r);
+                        }
+                        catch (std::exception & e) {
+                            r.error = e.what();
+                        }
+                        if (!r.error.empty()) {
+                            failed[r.persistence_id] = r.sequence;
+                        }
+                    }
+                }
+                if (!sync_()) {
+                    for (auto & r : batch) {
+                        if (!r.is_snapshot && r.error.empty()) {
+                            r.error = "journal: Failed to flush segment";
+                            const auto it = failed.find(r.persistence_id);
+                            if ((it == failed.end()) || (r.sequence < it->second)) {
+                                failed[r.persistence_id] = r.sequence;
+                            }
+                        }
+                    }
+                }
+                for (auto & r : batch) {
+                    if (r.is_snapshot) {
+                        write_snapshot_(r);
+                    }
+                }
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    committed.segment = segment_index;
+                    committed.offset  = write_offset;
+                }
+
+                // One notification per writer
+                written.clear();
+                for (const auto & r : batch) {
+                    if (r.writer.empty()) {
+                        continue;
+                    }
+                    if (!r.error.empty()) {
+                        // Only the first failure of the entity is reported, the writer drops the following events itself
+                        const auto it = failed.find(r.persistence_id);
+                        if ((it != failed.end()) && (it->second == r.sequence)) {
+                            r.writer.tell(journal_failure{ r.sequence, r.error });
+                        }
+                    } else if (!r.is_snapshot) {
+                        written[r.writer.get_path()] = journal_written{ r.sequence, r.position };
+                    }
+                }
+                for (const auto & r : batch) {
+                    if (!r.writer.empty()) {
+                        const auto it = written.find(r.writer.get_path());
+                        if (it != written.end()) {
+                            r.writer.tell(it->second);
+                            written.erase(it);
+                        }
+                    }
+                }
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    completed += batch.size();
+                }
+                flush_cv.notify_all();
+            }
+        }
+
+        void enqueue_(request && r)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                queue.push_back(std::move(r));
+                ++enqueued;
+            }
+            request_cv.notify_one();
+        }
+    };
+    //-------------------------------------------------------
+
+    journal::journal(const std::string & directory, const journal_options & options)
+        : m_context(new journal_context())
+    {
+        if (options.segment_size <= segment_header_size + record_header_size) {
+            throw yato::argument_error("journal: Segment size is too small.");
+        }
+        if (options.max_batch == 0) {
+            throw yato::argument_error("journal: Batch size must be positive.");
+        }
+        if (!make_directory(directory)) {
+            throw yato::runtime_error("journal: Failed to create directory " + directory);
+        }
+        m_context->directory = directory;
+        m_context->options = options;
+
+        uint64_t count = 0;
+        while (file_exists(segment_path(directory, count))) {
+            ++count;
+        }
+        if (count == 0) {
+            m_context->open_segment_(0, true);
+        } else {
+            m_context->open_segment_(count - 1, false);
+        }
+        m_context->committed.segment = m_context->segment_index;
+        m_context->committed.offset  = m_context->write_offset;
+
+        auto ctx = m_context.get();
+        m_context->writer = std::thread([ctx] { ctx->run_(); });
+    }
+    //-------------------------------------------------------
+
+    journal::~journal()
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_context->mutex);
+            m_context->stop = true;
+        }
+        m_context->request_cv.notify_one();
+        if (m_context->writer.joinable()) {
+            m_context->writer.join();
+        }
+    }
+    //-------------------------------------------------------
+
+    std::shared_ptr<journal> journal::open(const std::string & directory, const journal_options & options)
+    {
+        return std::shared_ptr<journal>(new journal(directory, options));
+    }
+    //-------------------------------------------------------
+
+    void journal::remove(const std::string & directory)
+    {
+        for (const auto & name : list_directory(directory)) {
+            if ((name.compare(0, 8, "segment_") == 0) || (name.compare(0, 9, "snapshot_") == 0)) {
+                std::remove((directory + "/" + name).c_str());
+            }
+        }
+        if (list_directory(directory).empty()) {
+            remove_directory(directory);
+        }
+    }
+    //-------------------------------------------------------
+
+    void journal::append(const std::string & persistence_id, uint64_t sequence, serialization_registry::type_id type, std::vector<char> && payload, const actor_ref & writer)
+    {
+        m_context->enqueue_(journal_context::request{ false, persistence_id, sequence, type, std::move(payload), writer, journal_position{}, std::string{} });
+    }
+    //-------------------------------------------------------
+
+    void journal::save_snapshot(const std::string & persistence_id, uint64_t sequence, const journal_position & position, serialization_registry::type_id type, std::vector<char> && payload)
+    {
+        m_context->enqueue_(journal_context::request{ true, persistence_id, sequence, type, std::move(payload), actor_ref{}, position, std::string{} });
+    }
+    //-------------------------------------------------------
+
+    journal_position journal::replay(const std::string & persistence_id, const journal_position & from, uint64_t after,
+        const std::function<void(uint64_t sequence, serialization_registry::type_id type, input_buffer & payload)> & callback) const
+    {
+        journal_position end;
+        {
+            std::unique_lock<std::mutex> lock(m_context->mutex);
+            end = m_context->committed;
+        }
+        for (uint64_t index = from.segment; index <= end.segment; ++index) {
+            const auto path = segment_path(m_context->directory, index);
+            if (!file_exists(path)) {
+                continue;
+            }
+            const mapped_file file(path, 0, false);
+            const char* data = file.data();
+            size_t offset = std::max<size_t>(segment_header_size, (index == from.segment) ? static_cast<size_t>(from.offset) : 0);
+            const size_t limit = (index == end.segment) ? std::min<size_t>(static_cast<size_t>(end.offset), file.size()) : file.size();
+            while (offset + record_header_size <= limit) {
+                const auto size = load<uint32_t>(data + offset);
+                if ((size == 0) || (size > limit - offset - record_header_size)) {
+                    break;
+                }
+                const char* body = data + offset + record_header_size;
+                const auto id_size = load<uint32_t>(body);
+                const char* id = body + sizeof(uint32_t);
+                if ((id_size == persistence_id.size()) && (std::memcmp(id, persistence_id.data(), id_size) == 0)) {
+                    const auto sequence = load<uint64_t>(id + id_size);
+                    if (sequence > after) {
+                        const auto type = load<uint32_t>(id + id_size + sizeof(uint64_t));
+                        const char* payload = id + id_size + sizeof(uint64_t) + sizeof(uint32_t);
+                        input_buffer in(payload, body + size);
+                        callback(sequence, type, in);
+                    }
+                }
+                offset += record_header_size + size;
+            }
+        }
+        return end;
+    }
+    //-------------------------------------------------------
+
+    bool journal::load_snapshot(const std::string & persistence_id, snapshot_record & snapshot) const
+    {
+        const auto path = snapshot_path(m_context->directory, persistence_id);
+        if (!file_exists(path)) {
+            return false;
+        }
+        const mapped_file file(path, 0, false);
+        const size_t header_size = 4 * sizeof(uint64_t) + 2 * sizeof(uint32_t);
+        if ((file.size() < header_size) || (load<uint64_t>(file.data()) != snapshot_magic)) {
+            return false;
+        }
+        const char* pos = file.data() + sizeof(uint64_t);
+        snapshot.sequence = load<uint64_t>(pos);
+        snapshot.position.segment = load<uint64_t>(pos + sizeof(uint64_t));
+        snapshot.position.offset  = load<uint64_t>(pos + 2 * sizeof(uint64_t));
+        snapshot.type = load<uint32_t>(pos + 3 * sizeof(uint64_t));
+        const auto sum = load<uint32_t>(pos + 3 * sizeof(uint64_t) + sizeof(uint32_t));
+        snapshot.payload.assign(file.data() + header_size, file.data() + file.size());
+        return sum == checksum(snapshot.payload.data(), snapshot.payload.size());
+    }
+    //-------------------------------------------------------
+
+    void journal::flush()
+    {
+        std::unique_lock<std::mutex> lock(m_context->mutex);
+        const auto target = m_context->enqueued;
+        m_context->flush_cv.wait(lock, [this, target] { return m_context->completed >= target; });
+    }
+    //-------------------------------------------------------
+
+} // namespace persistence
+
+} // namespace actors
+
+} // namespace yato
@@ -0,0 +1,396 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_PERSISTENCE_MAPPED_FILE_H_
+#define _YATO_ACTORS_PERSISTENCE_MAPPED_FILE_H_
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+# include <direct.h>
+#else
+# include <dirent.h>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <yato/assertion.h>
+
+namespace yato
+{
+namespace actors
+{
+namespace persistence
+{
+
+    /**
+     * File mapped into memory.
+     */
+    class mapped_file
+    {
+    private:
+        char* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+#else
+        int m_fd = -1;
+#endif
+        //-------------------------------------------------------
+
+        void swap_(mapped_file & other) noexcept
+        {
+            std::swap(m_data, other.m_data);
+            std::swap(m_size, other.m_size);
+#ifdef _WIN32
+            std::swap(m_file, other.m_file);
+            std::swap(m_mapping, other.m_mapping);
+#else
+            std::swap(m_fd, other.m_fd);
+#endif
+        }
+
+#ifndef _WIN32
+        /**
+         * Extends the file with allocated zero blocks. Falls back to a sparse resize if the file system doesn't support allocation.
+         * @return errno
+         */
+        static
+        int allocate_(int fd, size_t size)
+        {
+# ifndef __APPLE__
+            const int err = ::posix_fallocate(fd, 0, static_cast<off_t>(size));
+            if ((err != EINVAL) && (err != EOPNOTSUPP)) {
+                return err;
+            }
+# endif
+            return (::ftruncate(fd, static_cast<off_t>(size)) == 0) ? 0 : errno;
+        }
+#endif
+
+    public:
+        mapped_file() = default;
+
+        /**
+         * Map existing file or create a new one.
+         * @param size Size of the mapping. Writable file is extended with zeros up to the size. Zero means the current file size.
+         */
+        mapped_file(const std::string & path, size_t size, bool writable)
+        {
+#ifdef _WIN32
+            m_file = ::CreateFileA(path.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                nullptr, writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE) {
+                throw yato::runtime_error("mapped_file: Failed to open file " + path);
+            }
+            LARGE_INTEGER file_size;
+            ::GetFileSizeEx(m_file, &file_size);
+            if (size == 0) {
+                size = static_cast<size_t>(file_size.QuadPart);
+            }
+            if (size != 0) {
+                const auto size_high = static_cast<DWORD>(static_cast<uint64_t>(size) >> 32);
+                const auto size_low  = static_cast<DWORD>(static_cast<uint64_t>(size) & 0xFFFFFFFFu);
+                m_mapping = ::CreateFileMappingA(m_file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, size_high, size_low, nullptr);
+                if (m_mapping == nullptr) {
+                    close();
+                    throw yato::runtime_error("mapped_file: Failed to map file " + path);
+                }
+                m_data = static_cast<char*>(::MapViewOfFile(m_mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size));
+                if (m_data == nullptr) {
+                    close();
+                    throw yato::runtime_error("mapped_file: Failed to map file " + path);
+                }
+            }
+#else
+            m_fd = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+            if (m_fd < 0) {
+                throw yato::runtime_error("mapped_file: Failed to open file " + path);
+            }
+            struct stat st{};
+            ::fstat(m_fd, &st);
+            if (size == 0) {
+                size = static_cast<size_t>(st.st_size);
+            }
+            if (writable && (static_cast<size_t>(st.st_size) < size)) {
+                // Blocks are allocated, so a full disk is reported here instead of SIGBUS on a write to the mapping
+                const int err = allocate_(m_fd, size);
+                if (err != 0) {
+                    close();
+                    throw yato::runtime_error("mapped_file: Failed to allocate file " + path + ". " + std::strerror(err));
+                }
+            }
+            if (size != 0) {
+                void* ptr = ::mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, m_fd, 0);
+                if (ptr == MAP_FAILED) {
+                    close();
+                    throw yato::runtime_error("mapped_file: Failed to map file " + path);
+                }
+                m_data = static_cast<char*>(ptr);
+            }
+#endif
+            m_size = size;
+        }
+
+        ~mapped_file()
+        {
+            close();
+        }
+
+        mapped_file(const mapped_file&) = delete;
+
+        mapped_file(mapped_file && other) noexcept
+        {
+            swap_(other);
+        }
+
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        mapped_file& operator=(mapped_file && other) noexcept
+        {
+            if (this != &other) {
+                close();
+                swap_(other);
+            }
+            return *this;
+        }
+
+        char* data() const
+        {
+            return m_data;
+        }
+
+        size_t size() const
+        {
+            return m_size;
+        }
+
+        bool is_open() const
+        {
+            return m_data != nullptr;
+        }
+
+        /**
+         * Write modified pages of the range to the disk.
+         */
+        bool sync(size_t offset, size_t length)
+        {
+            if ((m_data == nullptr) || (length == 0)) {
+                return true;
+            }
+#ifdef _WIN32
+            return ::FlushViewOfFile(m_data + offset, length) && ::FlushFileBuffers(m_file);
+#else
+            const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            const size_t first = offset - offset % page;
+            return ::msync(m_data + first, offset + length - first, MS_SYNC) == 0;
+#endif
+        }
+
+        void close()
+        {
+#ifdef _WIN32
+            if (m_data != nullptr) {
+                ::UnmapViewOfFile(m_data);
+            }
+            if (m_mapping != nullptr) {
+                ::CloseHandle(m_mapping);
+                m_mapping = nullptr;
+            }
+            if (m_file != INVALID_HANDLE_VALUE) {
+                ::CloseHandle(m_file);
+                m_file = INVALID_HANDLE_VALUE;
+            }
+#else
+            if (m_data != nullptr) {
+                ::munmap(m_data, m_size);
+            }
+            if (m_fd >= 0) {
+                ::close(m_fd);
+                m_fd = -1;
+            }
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+    };
+
+    //-------------------------------------------------------
+    // File system helpers
+
+    inline
+    bool file_exists(const std::string & path)
+    {
+#ifdef _WIN32
+        return ::GetFileAttributesA(path.c_str()) != INVALID_FILE_ATTRIBUTES;
+#else
+        struct stat st{};
+        return ::stat(path.c_str(), &st) == 0;
+#endif
+    }
+
+    /**
+     * Creates the directory if it doesn't exist. Parent directory should exist.
+     */
+    inline
+    bool make_directory(const std::string & path)
+    {
+        if (file_exists(path)) {
+            return true;
+        }
+#ifdef _WIN32
+        return ::_mkdir(path.c_str()) == 0;
+#else
+        return ::mkdir(path.c_str(), 0755) == 0;
+#endif
+    }
+
+    /**
+     * Removes an empty directory.
+     */
+    inline
+    bool remove_directory(const std::string & path)
+    {
+#ifdef _WIN32
+        return ::_rmdir(path.c_str()) == 0;
+#else
+        return ::rmdir(path.c_str()) == 0;
+#endif
+    }
+
+    inline
+    std::vector<std::string> list_directory(const std::string & path)
+    {
+        std::vector<std::string> names;
+#ifdef _WIN32
+        WIN32_FIND_DATAA data;
+        const HANDLE h = ::FindFirstFileA((path + "\\*").c_str(), &data);
+        if (h != INVALID_HANDLE_VALUE) {
+            do {
+                if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+                    names.emplace_back(data.cFileName);
+                }
+            } while (::FindNextFileA(h, &data));
+            ::FindClose(h);
+        }
+#else
+        DIR* dir = ::opendir(path.c_str());
+        if (dir != nullptr) {
+            while (const dirent* entry = ::readdir(dir)) {
+                const std::string name = entry->d_name;
+                if ((name != ".") && (name != "..")) {
+                    names.push_back(name);
+                }
+            }
+            ::closedir(dir);
+        }
+#endif
+        return names;
+    }
+
+    /**
+     * Write the whole file and flush it to the disk.
+     */
+    inline
+    bool write_file_sync(const std::string & path, const char* data, size_t size)
+    {
+#ifdef _WIN32
+        const HANDLE h = ::CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (h == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        DWORD written = 0;
+        const bool success = ::WriteFile(h, data, static_cast<DWORD>(size), &written, nullptr) && (written == size) && ::FlushFileBuffers(h);
+        ::CloseHandle(h);
+        return success;
+#else
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        size_t offset = 0;
+        while (offset < size) {
+            const auto res = ::write(fd, data + offset, size - offset);
+            if (res <= 0) {
+                ::close(fd);
+                return false;
+            }
+            offset += static_cast<size_t>(res);
+        }
+        const bool success = (::fsync(fd) == 0);
+        ::close(fd);
+        return success;
+#endif
+    }
+
+    /**
+     * Flush directory entries to the disk, so created or renamed files survive a crash.
+     */
+    inline
+    bool sync_directory(const std::string & path)
+    {
+#ifdef _WIN32
+        // Metadata is written through by MoveFileEx, directories can't be flushed
+        (void)path;
+        return true;
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) {
+            return false;
+        }
+        const bool success = (::fsync(fd) == 0);
+        ::close(fd);
+        return success;
+#endif
+    }
+
+    /**
+     * Directory containing the file
+     */
+    inline
+    std::string parent_directory(const std::string & path)
+    {
+        const auto pos = path.find_last_of("/\\");
+        if (pos == std::string::npos) {
+            return ".";
+        }
+        return (pos == 0) ? path.substr(0, 1) : path.substr(0, pos);
+    }
+
+    /**
+     * Replace file atomically. The rename is flushed to the disk.
+     */
+    inline
+    bool replace_file(const std::string & from, const std::string & to)
+    {
+#ifdef _WIN32
+        return ::MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return (std::rename(from.c_str(), to.c_str()) == 0) && sync_directory(parent_directory(to));
+#endif
+    }
+
+} // namespace persistence
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_PERSISTENCE_MAPPED_FILE_H_
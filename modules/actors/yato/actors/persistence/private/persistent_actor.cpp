@@ -0,0 +1,204 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <algorithm>
+
+#include <yato/assertion.h>
+
+#include "../persistent_actor.h"
+#include "../../actor_system.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace persistence
+{
+
+    persistent_actor::persistent_actor(const std::shared_ptr<journal> & events_journal, uint32_t snapshot_interval)
+        : m_journal(events_journal), m_snapshot_interval(snapshot_interval)
+    {
+        if (m_journal == nullptr) {
+            throw yato::argument_error("persistent_actor: Journal is null.");
+        }
+    }
+    //-------------------------------------------------------
+
+    persistent_actor::~persistent_actor() = default;
+    //-------------------------------------------------------
+
+    std::string persistent_actor::persistence_id() const
+    {
+        return self().get_path().to_string();
+    }
+    //-------------------------------------------------------
+
+    void persistent_actor::pre_start()
+    {
+        m_persistence_id = persistence_id();
+        const auto & registry = system().serialization();
+
+        journal_position from;
+        snapshot_record snapshot;
+        if (m_journal->load_snapshot(m_persistence_id, snapshot)) {
+            yato::any state;
+            input_buffer in(snapshot.payload.data(), snapshot.payload.data() + snapshot.payload.size());
+            if (registry.decode(snapshot.type, in, state)) {
+                recover_snapshot(state);
+                from = snapshot.position;
+                m_sequence = snapshot.sequence;
+                m_snapshot_sequence = snapshot.sequence;
+            } else {
+                log().warning("persistent_actor: Failed to decode snapshot. Recovering from events.");
+            }
+        }
+
+        m_position = m_journal->replay(m_persistence_id, from, m_sequence, [this, &registry](uint64_t sequence, serialization_registry::type_id type, input_buffer & payload) {
+            yato::any event;
+            if (!registry.decode(type, payload, event)) {
+                throw yato::runtime_error("persistent_actor: Failed to decode event " + std::to_string(sequence));
+            }
+            receive_recover(event);
+            m_sequence = sequence;
+        });
+
+        on_recovery_completed();
+    }
+    //-------------------------------------------------------
+
+    void persistent_actor::post_stop()
+    {
+        if (!m_pending.empty()) {
+            // Writer should not be notified after the actor system is destroyed
+            m_journal->flush();
+        }
+    }
+    //-------------------------------------------------------
+
+    void persistent_actor::receive(yato::any && message)
+    {
+        if (message.is_type<journal_written>()) {
+            on_written_(message.get_unsafe<journal_written>());
+            return;
+        }
+        if (message.is_type<journal_failure>()) {
+            on_failed_(message.get_unsafe<journal_failure>());
+            return;
+        }
+        if (!m_pending.empty() || !m_stash.empty()) {
+            m_stash.push_back(stashed_message{ std::move(message), sender() });
+            unstash_();
+            return;
+        }
+        receive_command(std::move(message));
+    }
+    //-------------------------------------------------------
+
+    void persistent_actor::persist_impl_(yato::any && event, std::function<void(const yato::any &)> && handler)
+    {
+        output_buffer out;
+        const auto entry = system().serialization().encode(event, out);
+        if (entry == nullptr) {
+            throw yato::argument_error(std::string("persistent_actor: Event type is not registered: ") + event.type().name());
+        }
+        const actor_ref* current = exchange_sender_(nullptr);
+        exchange_sender_(current);
+
+        ++m_sequence;
+        m_journal->append(m_persistence_id, m_sequence, entry->id, out.release(), self());
+        m_pending.push_back(pending_event{ m_sequence, std::move(event), std::move(handler), (current != nullptr) ? *current : actor_ref{} });
+    }
+    //-------------------------------------------------------
+
+    void persistent_actor::on_written_(const journal_written & written)
+    {
+        m_position = written.end;
+        while (!m_pending.empty() && (m_pending.front().sequence <= written.sequence)) {
+            pending_event p = std::move(m_pending.front());
+            m_pending.pop_front();
+            const actor_ref* prev = exchange_sender_(&p.sender);
+            try {
+                p.handler(p.event);
+            }
+            catch (...) {
+                exchange_sender_(prev);
+                throw;
+            }
+            exchange_sender_(prev);
+        }
+        if ((m_snapshot_interval > 0) && (written.sequence >= m_snapshot_sequence + m_snapshot_interval)) {
+            save_snapshot_();
+        }
+        unstash_();
+    }
+    //-------------------------------------------------------
+
+    void persistent_actor::on_failed_(const journal_failure & failure)
+    {
+        // The journal rejects records following the failed one, until the sequence number is written again
+        const auto it = std::find_if(m_pending.begin(), m_pending.end(), [&failure](const pending_event & p) {
+            return p.sequence == failure.sequence;
+        });
+        if (it == m_pending.end()) {
+            return;
+        }
+        m_pending.erase(it, m_pending.end());
+        m_sequence = failure.sequence - 1;
+        on_persist_failure(failure.reason);
+        unstash_();
+    }
+    //-------------------------------------------------------
+
+    void persistent_actor::unstash_()
+    {
+        while (m_pending.empty() && !m_stash.empty()) {
+            stashed_message m = std::move(m_stash.front());
+            m_stash.pop_front();
+            const actor_ref* prev = exchange_sender_(&m.sender);
+            try {
+                receive_command(std::move(m.message));
+            }
+            catch (...) {
+                exchange_sender_(prev);
+                throw;
+            }
+            exchange_sender_(prev);
+        }
+    }
+    //-------------------------------------------------------
+
+    void persistent_actor::save_snapshot_()
+    {
+        // Events after the confirmed one are not applied yet, so the state corresponds to the confirmed sequence
+        const uint64_t sequence = m_pending.empty() ? m_sequence : m_pending.front().sequence - 1;
+        const yato::any state = snapshot();
+        if (state.empty()) {
+            return;
+        }
+        output_buffer out;
+        if (system().serialization().encode(state, out) == nullptr) {
+            log().error("persistent_actor: Snapshot type is not registered: %s", state.type().name());
+            return;
+        }
+        m_journal->save_snapshot(m_persistence_id, sequence, m_position, system().serialization().find(state.type())->id, out.release());
+        m_snapshot_sequence = sequence;
+    }
+    //-------------------------------------------------------
+
+    void persistent_actor::on_persist_failure(const std::string & reason)
+    {
+        log().error("persistent_actor: Failed to persist event. %s", reason.c_str());
+        m_stash.clear();
+        self().stop();
+    }
+    //-------------------------------------------------------
+
+} // namespace persistence
+
+} // namespace actors
+
+} // namespace yato
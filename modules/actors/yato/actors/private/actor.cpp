@@ -5,6 +5,8 @@
 * Copyright (c) 2016-2020 Alexey Gruzdev
 */
 
+#include <algorithm>
+
 #include <yato/any_match.h>
 
 #include "../actor.h"
@@ -13,7 +15,9 @@
 #include "actor_system_ex.h"
 #include "actor_cell.h"
 #include "message.h"
+#include "scheduler.h"
 #include "system_message.h"
+#include "tracer.h"
 
 #include "actors/selector.h"
 
@@ -82,9 +86,23 @@ namespace actors
             m_context->ref().stop();
             return;
         }
+        if (message.payload.type() == typeid(details::timer_message)) {
+            auto & timer = message.payload.get_unsafe<details::timer_message>();
+            if (timer.state->cancelled.load(std::memory_order_acquire)) {
+                return;
+            }
+            yato::any payload = std::move(timer.payload);
+            message.payload = std::move(payload);
+        }
+#ifdef YATO_ACTORS_WITH_TRACING
+        tracer::receive_scope trace_scope(actor_system_ex::get_tracer(m_context->system()), message.trace, m_context->ref(), message.payload.type().name());
+#endif
         m_sender = &message.sender;
         try {
             YATO_ASSERT(!m_behaviours.empty(), "No behaviours!");
+#ifdef YATO_ACTORS_WITH_TRACING
+            trace_scope.start();
+#endif
             m_behaviours.top()->receive(std::move(message.payload));
         }
         catch(std::exception & e) {
@@ -131,8 +149,36 @@ namespace actors
     }
     //-------------------------------------------------------
 
+    timer_handle basic_actor::schedule_impl_(const timeout_type & delay, const timeout_type & period, yato::any && message)
+    {
+        if (period < timeout_type::zero()) {
+            throw yato::argument_error("actor[schedule]: Period can't be negative.");
+        }
+        const actor_ref target = self();
+        auto state = std::make_shared<details::timer_state>();
+        auto handle = actor_system_ex::global_scheduler(system()).enqueue_timer(scheduler::clock_type::now() + delay, period, state,
+            [target, state, payload = std::move(message)]() {
+                // Cancellation is checked by the receiver, since a tick can be sent concurrently with cancel()
+                target.tell(details::timer_message{ state, payload }, target);
+            });
+
+        // Forget finished timers. Amortized, so many short timers don't cost O(N) each.
+        if (m_timers.size() >= m_timers_prune_size) {
+            m_timers.erase(std::remove_if(m_timers.begin(), m_timers.end(), [](const timer_handle & h) { return !h.is_active(); }), m_timers.end());
+            m_timers_prune_size = std::max<size_t>(16, 2 * m_timers.size());
+        }
+        m_timers.push_back(handle);
+        return handle;
+    }
+    //-------------------------------------------------------
+
     void basic_actor::stop_impl() noexcept
     {
+        for (const auto & timer : m_timers) {
+            timer.cancel();
+        }
+        m_timers.clear();
+
         if(context_().is_started()) {
             try {
                 post_stop();
@@ -145,7 +191,9 @@ namespace actors
             }
         }
         context_().set_started(false);
-        log().verbose("Stopped (%s)", self().get_path().c_str());
+        if (!actor_system_ex::is_stopping_fast(system())) {
+            log().verbose("Stopped (%s)", self().get_path().c_str());
+        }
 
         // Notify watchers
         auto & watchers = m_context->watchers();
@@ -161,6 +209,8 @@ namespace actors
     details::process_result basic_actor::receive_system_message_(message && msg) noexcept
     {
         YATO_REQUIRES(m_context != nullptr);
+        // Children spawned bypassing the mailbox have to be known before any system message, e.g. their detach_child
+        context_().attach_pending_children();
         // (a.gruzdev) static_cast for ReSharper's calmness
         return static_cast<process_result>(any_match(
             [this](const system_message::start &) {
@@ -183,21 +233,19 @@ namespace actors
                 }
                 return process_result::keep_running;
             },
-            [this](const system_message::stop &) {
-                if(context_().children().empty()) {
+            [this](const system_message::stop & stop) {
+                if(context_().seal_children()) {
                     stop_impl();
                     return process_result::request_stop;
                 } else {
                     // Wait and stop after children
                     context_().set_stop(true);
-                    for(auto & child : context_().children()) {
-                        child->ref().tell(poison_pill);
-                    }
+                    context_().stop_children(stop.immediate);
                     return process_result::keep_running;
                 }
             },
             [this](const system_message::stop_after_children &) {
-                if (context_().children().empty()) {
+                if (context_().seal_children()) {
                     stop_impl();
                     return process_result::request_stop;
                 }
@@ -233,8 +281,10 @@ namespace actors
             },
             [this](const system_message::detach_child & detach) {
                 context_().remove_child(detach.ref);
-                context_().log().verbose("Detached child %s", detach.ref.get_path().c_str());
-                if(context_().stopping() && context_().children().empty()) {
+                if (!actor_system_ex::is_stopping_fast(system())) {
+                    context_().log().verbose("Detached child %s", detach.ref.get_path().c_str());
+                }
+                if(context_().stopping() && context_().seal_children()) {
                     stop_impl();
                     return process_result::request_stop;
                 }
@@ -247,16 +297,12 @@ namespace actors
                     select.sender.tell(selection_success(context_().ref()));
                 } else {
                     // Forward to a child
-                    bool found = false;
-                    auto next = std::move(path.back());
+                    const auto next = std::move(path.back());
                     path.pop_back();
-                    for(auto & child : context_().children()) {
-                        if(next == child->ref().name()) {
-                            actor_system_ex::send_system_message(system(), child->ref(), std::move(select));
-                            found = true;
-                        }
-                    }
-                    if(!found) {
+                    const actor_cell* child = context_().find_child(actor_path::join(self().get_path(), next));
+                    if (child != nullptr) {
+                        actor_system_ex::send_system_message(system(), child->ref(), std::move(select));
+                    } else {
                         select.sender.tell(selection_failure("Selection target is not found."));
                     }
                 }
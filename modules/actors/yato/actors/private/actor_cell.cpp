@@ -5,9 +5,12 @@
 * Copyright (c) 2016-2020 Alexey Gruzdev
 */
 
+#include <utility>
+
 #include "../actor.h"
 #include "../actor_ref.h"
 #include "mailbox.h"
+#include "system_message.h"
 
 #include "actor_cell.h"
 #include "../actor_system.h"
@@ -44,7 +47,14 @@ namespace actors
         assert(child->m_parent == nullptr);
 
         child->m_parent = std::make_unique<actor_ref>(m_self);
+        return insert_child_(std::move(child));
+    }
+    //--------------------------------------------
+
+    actor_ref actor_cell::insert_child_(std::unique_ptr<actor_cell> && child)
+    {
         auto child_ref = child->ref();
+        m_children_index[child_ref.get_path()] = m_children.size();
         m_children.push_back(std::move(child));
         return child_ref;
     }
@@ -52,11 +62,132 @@ namespace actors
 
     void actor_cell::remove_child(const actor_ref & ref)
     {
-        auto it = std::find_if(m_children.begin(), m_children.end(), [&ref](const std::unique_ptr<actor_cell> & cell) { return cell->ref() == ref; });
-        assert(it != m_children.end());
-        if(it != m_children.end()) {
-            m_children.erase(it);
+        if (m_stop) {
+            // Skip the index maintenance, since all children are going to be destroyed
+            if (++m_detached == m_children.size()) {
+                m_children_index.clear();
+                m_children.clear();
+                m_detached = 0;
+            }
+            return;
+        }
+        const auto it = m_children_index.find(ref.get_path());
+        assert(it != m_children_index.end());
+        if (it != m_children_index.end()) {
+            const size_t idx = it->second;
+            m_children_index.erase(it);
+            if (idx + 1 != m_children.size()) {
+                // Move the last child into the hole
+                m_children[idx] = std::move(m_children.back());
+                m_children_index[m_children[idx]->ref().get_path()] = idx;
+            }
+            m_children.pop_back();
+        }
+    }
+    //--------------------------------------------
+
+    actor_cell* actor_cell::find_child(const actor_path & path) const
+    {
+        const auto it = m_children_index.find(path);
+        return (it != m_children_index.end()) ? m_children[it->second].get() : nullptr;
+    }
+    //--------------------------------------------
+
+    void actor_cell::insert_pending_(actor_cell* list)
+    {
+        while (list != nullptr) {
+            std::unique_ptr<actor_cell> child(list);
+            list = std::exchange(child->m_next_pending, nullptr);
+            insert_child_(std::move(child));
+        }
+    }
+    //--------------------------------------------
+
+    void actor_cell::attach_pending_children()
+    {
+        if (m_pending_children != nullptr) {
+            insert_pending_(m_pending_children->take(false));
+        }
+    }
+    //--------------------------------------------
+
+    bool actor_cell::seal_children()
+    {
+        if (m_pending_children != nullptr) {
+            insert_pending_(m_pending_children->take(true));
         }
+        return m_children.size() == m_detached;
+    }
+    //--------------------------------------------
+
+    void actor_cell::stop_children(bool immediate)
+    {
+        for (const auto & child : m_children) {
+            mailbox* mbox = child->mail();
+            const bool enqueued = immediate
+                ? mbox->enqueue_system_message(std::make_unique<message>(yato::any(system_message::stop{ true }), m_self))
+                : mbox->enqueue_user_message(std::make_unique<message>(yato::any(poison_pill), m_self));
+            if (enqueued) {
+                mbox->schedule_for_execution();
+            }
+        }
+    }
+    //--------------------------------------------
+
+    child_queue::~child_queue()
+    {
+        actor_cell* next = take(true);
+        while (next != nullptr) {
+            std::unique_ptr<actor_cell> child(next);
+            next = child->m_next_pending;
+        }
+    }
+    //--------------------------------------------
+
+    void child_queue::open(const actor_ref & owner)
+    {
+        YATO_REQUIRES(!m_open.load(std::memory_order_relaxed));
+        m_owner = owner;
+        m_open.store(true, std::memory_order_release);
+    }
+    //--------------------------------------------
+
+    bool child_queue::push(std::unique_ptr<actor_cell> & child)
+    {
+        YATO_REQUIRES(child != nullptr && child->m_parent == nullptr);
+        if (!m_open.load(std::memory_order_acquire)) {
+            return false;
+        }
+        actor_cell* head = m_head.load(std::memory_order_relaxed);
+        if (head == sealed_()) {
+            return false;
+        }
+        // The parent can't be read by the child before it is started, and it is started after the push
+        child->m_parent = std::make_unique<actor_ref>(m_owner);
+        do {
+            if (head == sealed_()) {
+                child->m_parent.reset();
+                return false;
+            }
+            child->m_next_pending = head;
+        } while (!m_head.compare_exchange_weak(head, child.get(), std::memory_order_release, std::memory_order_relaxed));
+        child.release();
+        return true;
+    }
+    //--------------------------------------------
+
+    actor_cell* child_queue::take(bool seal)
+    {
+        actor_cell* head = m_head.load(std::memory_order_relaxed);
+        do {
+            if (head == sealed_()) {
+                return nullptr;
+            }
+            if ((head == nullptr) && !seal) {
+                return nullptr;
+            }
+        } while (!m_head.compare_exchange_weak(head, seal ? sealed_() : nullptr, std::memory_order_acquire, std::memory_order_relaxed));
+        return head;
     }
     //--------------------------------------------
 
@@ -9,10 +9,13 @@
 #define _YATO_ACTORS_ACTOR_CELL_H_
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
+#include "../actor_path.h"
 #include "../logger.h"
 
+#include "child_queue.h"
 #include "execution_context.h"
 #include "properties_internal.h"
 
@@ -26,6 +29,8 @@ namespace actors
 
     class actor_cell
     {
+        friend class child_queue;
+
         /**
          * Parent system
          */
@@ -69,7 +74,28 @@ namespace actors
         std::unique_ptr<actor_ref> m_parent;
         std::vector<std::unique_ptr<actor_cell>> m_children;
 
+        /**
+         * Position of a child in m_children. Paths are interned, so lookup doesn't compare strings.
+         */
+        std::unordered_map<actor_path, size_t> m_children_index;
+
+        /**
+         * Number of stopped children, which are kept until all children of a stopping cell are stopped.
+         */
+        size_t m_detached = 0;
+
+        /**
+         * Children pushed by other threads. Only guardians have the queue.
+         */
+        std::shared_ptr<child_queue> m_pending_children;
+        actor_cell* m_next_pending = nullptr;
+
         //----------------------------------------------
+
+        actor_ref insert_child_(std::unique_ptr<actor_cell> && child);
+
+        void insert_pending_(actor_cell* list);
+
     public:
         actor_cell(actor_system & system, const actor_path & path, const properties_internal & props, std::unique_ptr<basic_actor> && instance);
 
@@ -138,9 +164,43 @@ namespace actors
         /**
          * Destroys child actor.
          * Child has to be stopped.
+         * Order of the remaining children is not preserved.
+         * If the cell is stopping, then all children are destroyed at once after the last one is removed.
          */
         void remove_child(const actor_ref & ref);
 
+        /**
+         * Find child by path.
+         * @return nullptr if there is no such child
+         */
+        actor_cell* find_child(const actor_path & path) const;
+
+        /**
+         * Sends poison_pill to all children.
+         * Messages are put directly into the children mailboxes, since the cell owns them.
+         * @param immediate Send system stop instead, which overtakes user messages
+         */
+        void stop_children(bool immediate = false);
+
+        /**
+         * Set the queue of children created without messaging the cell.
+         */
+        void set_pending_children(std::shared_ptr<child_queue> queue) {
+            m_pending_children = std::move(queue);
+        }
+
+        /**
+         * Move children from the pending queue into the children list.
+         */
+        void attach_pending_children();
+
+        /**
+         * Attach pending children and close the queue, so new children can't bypass the cell's mailbox anymore.
+         * Is called before stopping.
+         * @return true if the cell has no alive children
+         */
+        bool seal_children();
+
         const std::vector<std::unique_ptr<actor_cell>> & children() const {
             return m_children;
         }
@@ -6,6 +6,9 @@
 */
 
 #include <algorithm>
+#include <array>
+#include <mutex>
+#include <unordered_map>
 
 #include "../actor_system.h"
 #include "../actor_path.h"
@@ -51,24 +54,25 @@ YATO_PRAGMA_WARNING_PUSH
     }
     //---------------------------------------------------
 
+    // Paths use "C" locale, so plain ASCII checks are enough and don't touch std::locale
     inline
     bool is_valid_char(const char & c)
     {
-        return std::isalnum(c, actor_path::locale()) || (c == '_');
+        return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) || (c == '_');
     }
     //---------------------------------------------------
 
     inline
     bool is_valid_name(const char & c)
     {
-        return std::isgraph(c, actor_path::locale()) && (c != '/');
+        return (c > ' ') && (c < 127) && (c != '/');
     }
     //---------------------------------------------------
 
     inline
     bool is_valid_path(const char & c)
     {
-        return std::isgraph(c, actor_path::locale());
+        return (c > ' ') && (c < 127);
     }
     //---------------------------------------------------
 
@@ -99,7 +103,7 @@ YATO_PRAGMA_WARNING_PUSH
         if (!is_valid_actor_path(actor_name)) {
             throw yato::argument_error("actor_path[actor_path]: Invalid actor name!");
         }
-        m_path = actor_path::path_root + system_name + "/" + scope_to_str(scope) + "/" + actor_name;
+        m_node = intern_(actor_path::path_root + system_name + "/" + scope_to_str(scope) + "/" + actor_name, nullptr, std::string{});
     }
     //---------------------------------------------------
 
@@ -109,48 +113,223 @@ YATO_PRAGMA_WARNING_PUSH
         if (!is_valid_actor_path(actor_name)) {
             throw yato::argument_error("actor_path[actor_path]: Invalid actor name!");
         }
-        m_path = actor_path::path_root + system.name() + "/" + scope_to_str(scope) + "/" + actor_name;
+        m_node = intern_(actor_path::path_root + system.name() + "/" + scope_to_str(scope) + "/" + actor_name, nullptr, std::string{});
     }
 
     //---------------------------------------------------
 
-    bool actor_path::parce(path_elements & elems, bool header_only) const {
-        // Check root
-        auto begin = m_path.cbegin();
-        if(!std::equal(path_root.cbegin(), path_root.cend(), begin)) {
-            return false;
-        }
-        std::advance(begin, path_root.size());
+    namespace
+    {
+        /**
+         * Returns true if the header (system name and scope) is valid
+         */
+        bool parce_path(const std::string & path, path_elements & elems)
+        {
+            elems.scope = actor_scope::unknown;
 
-        // Decode system
-        auto end = std::find(begin, m_path.cend(), '/');
-        if (end == m_path.cend()) {
-            return false;
-        }
-        elems.system_name = std::string(begin, end);
+            // Check root
+            const std::string & root = actor_path::default_root();
+            if ((path.size() < root.size()) || !std::equal(root.cbegin(), root.cend(), path.cbegin())) {
+                return false;
+            }
+            auto begin = std::next(path.cbegin(), root.size());
 
-        // Decode scope
-        begin = end;
-        if(begin != m_path.cend()) {
-            std::advance(begin, 1);
-        }
-        end   = std::find(begin, m_path.cend(), '/');
-        elems.scope = str_to_scope(std::string(begin, end));
-        if(elems.scope == actor_scope::unknown) {
-            return false;
-        }
+            // Decode system
+            auto end = std::find(begin, path.cend(), '/');
+            if (end == path.cend()) {
+                return false;
+            }
+            elems.system_name = std::string(begin, end);
+
+            // Decode scope
+            begin = std::next(end);
+            end   = std::find(begin, path.cend(), '/');
+            elems.scope = actor_path::str_to_scope(std::string(begin, end));
+            if (elems.scope == actor_scope::unknown) {
+                return false;
+            }
 
-        if(!header_only) {
             // Decode names
-            elems.names.clear();
-            while(end != m_path.cend()) {
+            while (end != path.cend()) {
                 begin = std::next(end); // skip '/'
-                end   = std::find(begin, m_path.cend(), '/');
-                if(begin != end) {
+                end   = std::find(begin, path.cend(), '/');
+                if (begin != end) {
                     elems.names.emplace_back(begin, end);
                 }
             }
-            if(elems.names.empty()) {
+            return true;
+        }
+        //---------------------------------------------------
+
+        std::string last_name(const std::string & path)
+        {
+            auto pos = path.find_last_of('/');
+            if (pos == std::string::npos) {
+                return std::string{};
+            }
+            return path.substr(pos + 1);
+        }
+        //---------------------------------------------------
+
+        /**
+         * Weak table of all alive paths. Nodes remove themselves on destruction.
+         * The table is sharded by path hash, so interning of different paths doesn't contend on one mutex.
+         */
+        class path_table
+        {
+        private:
+            static constexpr size_t shards_number = 64;
+
+            struct entry
+            {
+                details::path_node* node;
+                std::weak_ptr<details::path_node> weak;
+            };
+
+            struct shard
+            {
+                std::mutex mutex;
+                std::unordered_multimap<size_t, entry> entries;
+            };
+
+            std::array<shard, shards_number> m_shards;
+
+            shard & shard_for_(size_t hash)
+            {
+                // High bits select the shard, so hashes inside a shard still differ in low bits used for buckets
+                return m_shards[(hash >> (sizeof(size_t) * 8 - 6)) % shards_number];
+            }
+
+            static
+            std::shared_ptr<details::path_node> find_(const shard & s, const std::string & path, size_t hash)
+            {
+                const auto range = s.entries.equal_range(hash);
+                for (auto it = range.first; it != range.second; ++it) {
+                    if ((*it).second.node->path == path) {
+                        auto node = (*it).second.weak.lock();
+                        if (node != nullptr) {
+                            return node;
+                        }
+                        // Is being destroyed. Leave the entry for its deleter.
+                    }
+                }
+                return nullptr;
+            }
+
+        public:
+            std::shared_ptr<details::path_node> find_or_create(std::string && path, const details::path_node* parent, const std::string & name)
+            {
+                const size_t hash = std::hash<std::string>{}(path);
+                shard & s = shard_for_(hash);
+
+                std::unique_lock<std::mutex> lock(s.mutex);
+                auto existing = find_(s, path, hash);
+                if (existing != nullptr) {
+                    return existing;
+                }
+                lock.unlock();
+
+                std::unique_ptr<details::path_node> node(new details::path_node);
+                node->path = std::move(path);
+                node->hash = hash;
+                if ((parent != nullptr) && parent->header_valid && !name.empty()) {
+                    // Joined path: reuse parsed parent
+                    node->name = name;
+                    node->header_valid = true;
+                    node->elements = parent->elements;
+                    node->elements.names.push_back(name);
+                } else {
+                    node->name = last_name(node->path);
+                    node->header_valid = parce_path(node->path, node->elements);
+                }
+
+                lock.lock();
+                // Could be created by another thread meanwhile
+                existing = find_(s, node->path, hash);
+                if (existing != nullptr) {
+                    return existing;
+                }
+                std::shared_ptr<details::path_node> result(node.release(), details::path_node_deleter{});
+                s.entries.emplace(hash, entry{ result.get(), result });
+                return result;
+            }
+
+            void erase(details::path_node* node)
+            {
+                shard & s = shard_for_(node->hash);
+                std::unique_lock<std::mutex> lock(s.mutex);
+                const auto range = s.entries.equal_range(node->hash);
+                for (auto it = range.first; it != range.second; ++it) {
+                    if ((*it).second.node == node) {
+                        s.entries.erase(it);
+                        break;
+                    }
+                }
+            }
+        };
+        //---------------------------------------------------
+
+        path_table & global_path_table()
+        {
+            // Is never destroyed, since paths can be released by static objects
+            static path_table* table = new path_table;
+            return *table;
+        }
+    }
+    //---------------------------------------------------
+
+    void details::path_node_deleter::operator()(details::path_node* node) const
+    {
+        global_path_table().erase(node);
+        delete node;
+    }
+    //---------------------------------------------------
+
+    actor_path::node_pointer actor_path::intern_(std::string && path, const details::path_node* parent, const std::string & name)
+    {
+        if (path.empty()) {
+            return nullptr;
+        }
+        return global_path_table().find_or_create(std::move(path), parent, name);
+    }
+    //---------------------------------------------------
+
+    const std::string & actor_path::empty_string_()
+    {
+        static const std::string empty;
+        return empty;
+    }
+    //---------------------------------------------------
+
+    actor_path actor_path::join(const actor_path & path, const std::string & name)
+    {
+        actor_path result(path);
+        result.m_node = intern_(path.to_string() + "/" + name, path.m_node.get(), name);
+        return result;
+    }
+    //---------------------------------------------------
+
+    const path_elements & actor_path::elements() const
+    {
+        static const path_elements empty{ std::string{}, actor_scope::unknown, {} };
+        return (m_node != nullptr) ? m_node->elements : empty;
+    }
+    //---------------------------------------------------
+
+    bool actor_path::parce(path_elements & elems, bool header_only) const
+    {
+        if (m_node == nullptr) {
+            return false;
+        }
+        const auto & parsed = m_node->elements;
+        elems.system_name = parsed.system_name;
+        elems.scope = parsed.scope;
+        if (!m_node->header_valid) {
+            return false;
+        }
+        if (!header_only) {
+            elems.names = parsed.names;
+            if (elems.names.empty()) {
                 return false;
             }
         }
@@ -5,6 +5,8 @@
 * Copyright (c) 2016-2020 Alexey Gruzdev
 */
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 
@@ -12,8 +14,11 @@
 
 #include "../actor.h"
 #include "../actor_system.h"
+#include "../serialization.h"
 
 #include "actor_cell.h"
+#include "dead_letters_registry.h"
+#include "tracer.h"
 #include "mailbox.h"
 #include "scheduler.h"
 #include "name_generator.h"
@@ -22,6 +27,7 @@
 
 #ifdef YATO_ACTORS_WITH_IO
 #include "../io/facade.h"
+#include "../remote/facade.h"
 #endif
 
 #include "actors/root.h"
@@ -39,6 +45,11 @@ namespace yato
 namespace actors
 {
 
+    /**
+     * Scopes user, system, temp and remote have guardians
+     */
+    static constexpr size_t guardians_number = static_cast<size_t>(actor_scope::remote) + 1;
+
     struct system_context
     {
         std::string name;
@@ -48,14 +59,38 @@ namespace actors
         std::condition_variable terminate_cv;
         bool root_stopped;
 
+        /**
+         * Forced shutdown stops actors by system messages and without per actor logging
+         */
+        bool fast_shutdown = false;
+        std::atomic<bool> stopping_fast{ false };
+
         name_generator names_gen;
         scheduler global_scheduler;
+        serialization_registry serialization;
 
         std::vector<execution_context> executions;
         std::string default_executor_name;
 
         std::unique_ptr<actor_cell> root;
+
+        /**
+         * Children of the guardians, indexed by actor_scope.
+         */
+        std::array<std::shared_ptr<child_queue>, guardians_number> guardian_children;
+
+        /**
+         * Number of root_add messages, which are not processed by the root yet.
+         * While it is not zero, new actors go through the root too, so they can't be attached before actors created earlier.
+         */
+        std::atomic<size_t> pending_root_adds{ 0 };
+
         actor_ref dead_letters;
+        std::unique_ptr<dead_letters_registry> dead_letters_stats;
+#ifdef YATO_ACTORS_WITH_TRACING
+        std::unique_ptr<tracer> trace;
+#endif
+        actor_path user_guard_path{ std::string{} };
     };
 
     //-------------------------------------------------------------------------
@@ -63,7 +98,7 @@ namespace actors
     inline
     execution_context* find_execution_(system_context& system, const std::string & name)
     {
-        const auto it = std::find_if(system.executions.begin(), system.executions.begin(), 
+        const auto it = std::find_if(system.executions.begin(), system.executions.end(),
             [&name](const execution_context & execution){ return execution.name == name; }
         );
         return (it != system.executions.cend()) ? &(*it) : nullptr;
@@ -75,6 +110,9 @@ namespace actors
     {
         properties_internal res;
         res.execution = find_execution_(system, props.execution_name);
+        if (res.execution == nullptr) {
+            throw yato::argument_error("Unknown execution context \"" + props.execution_name + "\"!");
+        }
         return res;
     }
     //-------------------------------------------------------------------------
@@ -128,11 +166,26 @@ namespace actors
 
         m_context->log = logger_factory::create(std::string("ActorSystem[") + name + "]");
         m_context->log->set_filter(conf.value<log_level>("log_level").get_or(log_level::info));
+        m_context->fast_shutdown = conf.value<bool>("fast_shutdown").get_or(false);
+        m_context->dead_letters_stats = std::make_unique<dead_letters_registry>(conf.value<uint32_t>("dead_letters_capture").get_or(8));
+
+        const auto trace_sampling = conf.value<uint32_t>("trace_sampling").get_or(0);
+        if (trace_sampling != 0) {
+#ifdef YATO_ACTORS_WITH_TRACING
+            m_context->trace = std::make_unique<tracer>(trace_sampling, conf.value<uint32_t>("trace_buffer").get_or(64 * 1024));
+#else
+            throw yato::argument_error("actor_system[actor_system]: Tracing can't be enabled. Build with flag YATO_ACTORS_WITH_TRACING");
+#endif
+        }
 
         init_executors_(conf);
 
         const auto root_builder = details::make_cell_builder<actors::root>();
+        for (auto & queue : m_context->guardian_children) {
+            queue = std::make_shared<child_queue>();
+        }
         m_context->root = root_builder(*this, actor_path("yato://" + name), default_properties_(*m_context));
+        m_context->user_guard_path = actor_path::join(m_context->root->ref().get_path(), actor_path::scope_to_str(actor_scope::user));
         m_context->root_stopped = false;
 
         // System actors
@@ -141,6 +194,16 @@ namespace actors
             io::facade::init(*this);
 #else
             throw yato::argument_error("actor_system[actor_system]: IO can't be enabled. Build with flag YATO_ACTORS_WITH_IO");
+#endif
+        }
+        if(conf.value<bool>("enable_remote").get_or(false)) {
+#ifdef YATO_ACTORS_WITH_IO
+            if(!conf.value<bool>("enable_io").get_or(false)) {
+                throw yato::argument_error("actor_system[actor_system]: Remoting requires IO. Set \"enable_io\" flag");
+            }
+            remote::facade::init(*this, conf.object("remote"));
+#else
+            throw yato::argument_error("actor_system[actor_system]: Remoting can't be enabled. Build with flag YATO_ACTORS_WITH_IO");
 #endif
         }
         YATO_ENSURES(m_context->root != nullptr);
@@ -174,7 +237,11 @@ namespace actors
     {
         YATO_REQUIRES(m_context != nullptr);
 
-        send_message(m_context->root->ref(), root_terminate(forced));
+        const bool fast = forced && m_context->fast_shutdown;
+        if (fast) {
+            m_context->stopping_fast.store(true, std::memory_order_relaxed);
+        }
+        send_message(m_context->root->ref(), root_terminate(forced, fast));
         {
             std::unique_lock<std::mutex> lock(m_context->terminate_mutex);
             m_context->terminate_cv.wait(lock, [this]() { return m_context->root_stopped; });
@@ -184,6 +251,41 @@ namespace actors
     }
     //-------------------------------------------------------
 
+    bool actor_system::is_stopping_fast_() const
+    {
+        return m_context->stopping_fast.load(std::memory_order_relaxed);
+    }
+    //-------------------------------------------------------
+
+    tracer* actor_system::tracer_() const
+    {
+#ifdef YATO_ACTORS_WITH_TRACING
+        return m_context->trace.get();
+#else
+        return nullptr;
+#endif
+    }
+    //-------------------------------------------------------
+
+    void actor_system::root_add_done_() const
+    {
+        YATO_REQUIRES(m_context != nullptr);
+        m_context->pending_root_adds.fetch_sub(1, std::memory_order_acq_rel);
+    }
+    //-------------------------------------------------------
+
+    std::string actor_system::export_trace() const
+    {
+        YATO_REQUIRES(m_context != nullptr);
+#ifdef YATO_ACTORS_WITH_TRACING
+        if (m_context->trace != nullptr) {
+            return m_context->trace->export_json();
+        }
+#endif
+        return "{\"traceEvents\":[]}";
+    }
+    //-------------------------------------------------------
+
     void actor_system::shutdown()
     {
         shutdown_impl_(true);
@@ -197,6 +299,20 @@ namespace actors
     }
     //-------------------------------------------------------
 
+    scheduler & actor_system::global_scheduler() const
+    {
+        YATO_REQUIRES(m_context != nullptr);
+        return m_context->global_scheduler;
+    }
+    //-------------------------------------------------------
+
+    serialization_registry & actor_system::serialization() const
+    {
+        YATO_REQUIRES(m_context != nullptr);
+        return m_context->serialization;
+    }
+    //-------------------------------------------------------
+
     const std::string & actor_system::name() const
     {
         YATO_REQUIRES(m_context != nullptr);
@@ -230,20 +346,30 @@ namespace actors
     {
         YATO_REQUIRES(m_context != nullptr);
 
-        path_elements elems;
-        path.parce(elems);
-
-        if(elems.scope == actor_scope::unknown) {
+        if(path.elements().scope == actor_scope::unknown) {
             throw yato::argument_error("Invalid actor path!");
         }
 
         auto cell = builder(*this, path, props ? resolve_props_(*m_context, props.get()) : default_properties_(*m_context));
         auto ref  = cell->ref();
 
+        const auto scope_idx = static_cast<size_t>(path.elements().scope);
         // Add to the tree
         if(parent.empty()) {
-            send_message(m_context->root->ref(), root_add(std::move(cell)));
+            // Fast path: push directly to the guardian and start. Falls back to the root if the guardian is not created yet or is stopping,
+            // and while earlier actors are still queued in the root, so they are found before the later ones.
+            if((scope_idx < guardians_number) && (m_context->pending_root_adds.load(std::memory_order_acquire) == 0) && m_context->guardian_children[scope_idx]->push(cell)) {
+                send_system_message(ref, system_message::start());
+            } else {
+                m_context->pending_root_adds.fetch_add(1, std::memory_order_acq_rel);
+                send_message(m_context->root->ref(), root_add(std::move(cell)));
+            }
         } else {
+            if((parent == m_context->root->ref()) && (scope_idx < guardians_number)) {
+                // A guardian is created
+                cell->set_pending_children(m_context->guardian_children[scope_idx]);
+                m_context->guardian_children[scope_idx]->open(ref);
+            }
             send_system_message(parent, system_message::attach_child(std::move(cell)));
         }
 
@@ -256,19 +382,31 @@ namespace actors
         YATO_REQUIRES(m_context != nullptr);
 
         if(addressee.empty() || addressee == dead_letters()) {
-            logger()->verbose("A message was delivered to DeadLetters.");
+            record_dead_letter_(addressee, sender, std::move(usrMessage), dead_letter_reason::no_recipient, false);
             return;
         }
 
         const std::shared_ptr<mailbox> mbox = addressee.get_mailbox().lock();
         if(mbox == nullptr) {
-            logger()->verbose("Failed to send a message. Actor %s is not found!", addressee.get_path().c_str());
+            record_dead_letter_(addressee, sender, std::move(usrMessage), dead_letter_reason::recipient_stopped, false);
             return;
         }
 
-        if(mbox->enqueue_user_message(std::make_unique<message>(std::move(usrMessage), sender))) {
+        auto msg = std::make_unique<message>(std::move(usrMessage), sender);
+#ifdef YATO_ACTORS_WITH_TRACING
+        if (m_context->trace != nullptr) {
+            // Internal messages, e.g. to the root or system actors, continue a trace, but don't start new ones
+            const bool may_start = (addressee.get_path().elements().scope == actor_scope::user);
+            m_context->trace->on_send(msg->trace, may_start);
+        }
+#endif
+        if(mbox->enqueue_user_message(std::move(msg))) {
             mbox->schedule_for_execution();
         }
+        else if(msg != nullptr) {
+            // Mailbox is closed
+            record_dead_letter_(addressee, sender, std::move(msg->payload), dead_letter_reason::recipient_stopped, false);
+        }
     }
     //-------------------------------------------------------
 
@@ -277,21 +415,50 @@ namespace actors
         YATO_REQUIRES(m_context != nullptr);
 
         if (addressee.empty() || addressee == dead_letters()) {
-            logger()->verbose("A system message was delivered to DeadLetters.");
+            record_dead_letter_(addressee, sender, std::move(sysMessage), dead_letter_reason::no_recipient, true);
             return;
         }
 
         const std::shared_ptr<mailbox> mbox = addressee.get_mailbox().lock();
         if (mbox == nullptr) {
-            logger()->verbose("Failed to send a message. Actor %s is not found!", addressee.get_path().c_str());
+            record_dead_letter_(addressee, sender, std::move(sysMessage), dead_letter_reason::recipient_stopped, true);
             return;
         }
 
-        if(mbox->enqueue_system_message(std::make_unique<message>(std::move(sysMessage), sender))) {
+        auto msg = std::make_unique<message>(std::move(sysMessage), sender);
+        if(mbox->enqueue_system_message(std::move(msg))) {
             const bool scheduled = mbox->schedule_for_execution();
             YATO_MAYBE_UNUSED(scheduled);
             YATO_ENSURES(scheduled);
         }
+        else if(msg != nullptr) {
+            // Mailbox is closed
+            record_dead_letter_(addressee, sender, std::move(msg->payload), dead_letter_reason::recipient_stopped, true);
+        }
+    }
+    //-------------------------------------------------------
+
+    void actor_system::record_dead_letter_(const actor_ref & addressee, const actor_ref & sender, yato::any && message, dead_letter_reason reason, bool system) const
+    {
+        const char* type_name = message.type().name();
+        if (m_context->dead_letters_stats->record(addressee, sender, std::move(message), reason, system)) {
+            // Only captured letters are logged
+            logger()->verbose("Dead letter of type %s to %s", type_name, addressee.empty() ? "<empty>" : addressee.get_path().c_str());
+        }
+    }
+    //-------------------------------------------------------
+
+    dead_letters_stats actor_system::dead_letter_stats() const
+    {
+        YATO_REQUIRES(m_context != nullptr);
+        return m_context->dead_letters_stats->stats();
+    }
+    //-------------------------------------------------------
+
+    void actor_system::subscribe_dead_letters(const actor_ref & subscriber) const
+    {
+        YATO_REQUIRES(m_context != nullptr);
+        m_context->dead_letters_stats->subscribe(subscriber);
     }
     //-------------------------------------------------------
 
@@ -304,7 +471,7 @@ namespace actors
 
         const auto ask_actor_path = actor_path(*this, actor_scope::temp, m_context->names_gen.next_indexed("ask"));
         const auto ask_actor = const_cast<actor_system*>(this)->create_actor_impl_(
-            details::make_cell_builder<asking_actor>(std::move(response)), yato::make_optional(properties()), ask_actor_path, actor_ref{});
+            details::make_cell_builder<asking_actor>(std::move(response)), yato::nullopt_t{}, ask_actor_path, actor_ref{});
         send_user_impl_(addressee, ask_actor, std::move(message));
 
         m_context->global_scheduler.enqueue(std::chrono::high_resolution_clock::now() + timeout, [ask_actor]{ ask_actor.stop(); });
@@ -346,7 +513,7 @@ namespace actors
 
         const auto selector_path = actor_path(*this, actor_scope::temp, m_context->names_gen.next_indexed("find"));
         const auto select_actor  = const_cast<actor_system*>(this)->create_actor_impl_(
-            details::make_cell_builder<selector>(path, std::move(promise)), yato::make_optional(properties()), selector_path, actor_ref{});
+            details::make_cell_builder<selector>(path, std::move(promise)), yato::nullopt_t{}, selector_path, actor_ref{});
 
         m_context->global_scheduler.enqueue(std::chrono::high_resolution_clock::now() + timeout, [select_actor]{ select_actor.stop(); });
 
@@ -404,11 +571,11 @@ namespace actors
             logger()->verbose("The root is stopped.", ref.get_path().c_str());
         }
         // ToDo (a.gruzdev): Consider better scheduler implementation
-        else if(ref.get_path() == actor_path::join(root().get_path(), actor_path::scope_to_str(actor_scope::user))) {
+        else if(ref.get_path() == m_context->user_guard_path) {
             // Stop after all user actors
             m_context->global_scheduler.stop();
         }
-        else {
+        else if(!is_stopping_fast_()) {
             logger()->verbose("Actor %s is stopped.", ref.get_path().c_str());
         }
     }
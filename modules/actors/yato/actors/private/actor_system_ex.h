@@ -28,6 +28,11 @@ namespace actors
             return sys.root();
         }
 
+        static
+        scheduler & global_scheduler(const actor_system & sys) {
+            return sys.global_scheduler();
+        }
+
         static
         actor_ref create_actor(actor_system & sys, const actor_scope & scope, const std::string & name, const details::cell_builder & builder) {
             return sys.create_actor_(scope, name, builder);
@@ -55,6 +60,27 @@ namespace actors
             sys.notify_on_stop_(ref);
         }
 
+        /**
+         * Forced shutdown with enabled "fast_shutdown" is in progress. Per actor logging is skipped.
+         */
+        static
+        bool is_stopping_fast(const actor_system & sys) {
+            return sys.is_stopping_fast_();
+        }
+
+        /**
+         * Null if tracing is disabled
+         */
+        static
+        tracer* get_tracer(const actor_system & sys) {
+            return sys.tracer_();
+        }
+
+        static
+        void root_add_done(const actor_system & sys) {
+            sys.root_add_done_();
+        }
+
         /**
          * Send system message
          */
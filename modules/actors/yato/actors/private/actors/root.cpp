@@ -44,15 +44,16 @@ namespace actors
         yato::any_match(
             [this] (root_add & add) {
                 YATO_REQUIRES(add.cell != nullptr);
-                path_elements elems;
-                if(!add.cell->ref().get_path().parce(elems, true)) {
+                const actor_scope scope = add.cell->ref().get_path().elements().scope;
+                if(scope == actor_scope::unknown) {
                     log().error("Invalid actor path: %s", add.cell->ref().get_path().c_str());
+                    actor_system_ex::root_add_done(system());
                     return;
                 }
 
                 log().verbose("Adding " + add.cell->ref().get_path().to_string());
 
-                switch(elems.scope) {
+                switch(scope) {
                 case actor_scope::user :
                     actor_system_ex::send_system_message(system(), m_usr_guard, system_message::attach_child(std::move(add.cell)));
                     break;
@@ -69,12 +70,15 @@ namespace actors
                     log().error("root_add: Invalid scope!");
                     break;
                 }
+                // The cell is in the guardian's mailbox now, so new actors may bypass the root again
+                actor_system_ex::root_add_done(system());
             },
             [this] (const root_terminate & t) {
                 log().debug("Terminating root");
+                m_immediate = t.immediate;
                 if(t.stop_user) {
-                    actor_system_ex::send_system_message(system(), m_usr_guard, system_message::stop{});
-                    actor_system_ex::send_system_message(system(), m_rmt_guard, system_message::stop{});
+                    actor_system_ex::send_system_message(system(), m_usr_guard, system_message::stop{ m_immediate });
+                    actor_system_ex::send_system_message(system(), m_rmt_guard, system_message::stop{ m_immediate });
                 } else {
                     actor_system_ex::send_system_message(system(), m_usr_guard, system_message::stop_after_children{});
                     actor_system_ex::send_system_message(system(), m_rmt_guard, system_message::stop_after_children{});
@@ -100,10 +104,10 @@ namespace actors
                 }
                 else if (m_usr_stopped && m_rmt_stopped) {
                     if(!m_sys_stopped) {
-                        actor_system_ex::send_system_message(system(), m_sys_guard, system_message::stop{});
+                        actor_system_ex::send_system_message(system(), m_sys_guard, system_message::stop{ m_immediate });
                     }
                     if(!m_tmp_stopped) {
-                        actor_system_ex::send_system_message(system(), m_tmp_guard, system_message::stop{});
+                        actor_system_ex::send_system_message(system(), m_tmp_guard, system_message::stop{ m_immediate });
                     }
                 }
             },
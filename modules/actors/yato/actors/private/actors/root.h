@@ -36,10 +36,10 @@ namespace actors
     struct root_terminate
     {
         bool stop_user;
+        bool immediate;
 
-        explicit
-        root_terminate(bool stop_user)
-            : stop_user(stop_user)
+        root_terminate(bool stop_user, bool immediate)
+            : stop_user(stop_user), immediate(immediate)
         { }
     };
     //---------------------------------------------------------
@@ -62,6 +62,11 @@ namespace actors
         bool m_tmp_stopped = false;
         bool m_rmt_stopped = false;
 
+        /**
+         * Stop the guards by system_message::stop::immediate
+         */
+        bool m_immediate = false;
+
         //---------------------------------------
 
         void pre_start() override;
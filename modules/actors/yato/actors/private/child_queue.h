@@ -0,0 +1,76 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_PRIVATE_CHILD_QUEUE_H_
+#define _YATO_ACTORS_PRIVATE_CHILD_QUEUE_H_
+
+#include <atomic>
+#include <memory>
+
+#include "../actor_ref.h"
+
+namespace yato
+{
+namespace actors
+{
+
+    class actor_cell;
+
+    /**
+     * Lock-free stack of children created by other threads, which are not attached to the parent cell yet.
+     * It is owned by the actor system, so a creator doesn't need to hold the parent cell alive.
+     * Allows to spawn actors under a guardian without sending messages to the root and the guardian.
+     */
+    class child_queue
+    {
+    private:
+        /**
+         * Cells are linked via actor_cell::m_next_pending. Equals to sealed_() when the queue is closed.
+         */
+        std::atomic<actor_cell*> m_head{ nullptr };
+        std::atomic<bool> m_open{ false };
+        actor_ref m_owner;
+        //-------------------------------------------------------
+
+        actor_cell* sealed_() const
+        {
+            return reinterpret_cast<actor_cell*>(const_cast<child_queue*>(this));
+        }
+
+    public:
+        child_queue() = default;
+
+        ~child_queue();
+
+        child_queue(const child_queue&) = delete;
+        child_queue& operator=(const child_queue&) = delete;
+
+        /**
+         * Start accepting children. Is called once.
+         * @param owner Parent of the pushed children
+         */
+        void open(const actor_ref & owner);
+
+        /**
+         * Sets the parent of the child and pushes it. Thread safe.
+         * @return false if the queue is not open or is sealed. Then the child is not consumed.
+         */
+        bool push(std::unique_ptr<actor_cell> & child);
+
+        /**
+         * Takes all pushed children. Is called by the parent only.
+         * @param seal Reject all following pushes
+         * @return list linked via actor_cell::m_next_pending
+         */
+        actor_cell* take(bool seal);
+    };
+
+} // namespace actors
+
+} // namespace yato
+
+#endif //_YATO_ACTORS_PRIVATE_CHILD_QUEUE_H_
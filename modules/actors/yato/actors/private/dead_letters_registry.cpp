@@ -0,0 +1,133 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <algorithm>
+
+#include "../actor_system.h"
+
+#include "dead_letters_registry.h"
+
+namespace yato
+{
+namespace actors
+{
+
+    size_t dead_letters_registry::shard_index_()
+    {
+        static std::atomic<size_t> next_index{ 0 };
+        thread_local const size_t index = next_index.fetch_add(1, std::memory_order_relaxed) % shards_number;
+        return index;
+    }
+    //-------------------------------------------------------
+
+    dead_letters_registry::type_slot* dead_letters_registry::find_type_slot_(const std::type_info & type)
+    {
+        const size_t hash = std::type_index(type).hash_code();
+        for (size_t probe = 0; probe < type_slots_number; ++probe) {
+            type_slot & slot = m_types[(hash + probe) % type_slots_number];
+            const std::type_info* current = slot.type.load(std::memory_order_acquire);
+            if (current == nullptr) {
+                if (slot.type.compare_exchange_strong(current, &type, std::memory_order_acq_rel)) {
+                    return &slot;
+                }
+                // Occupied by another thread meanwhile, current is updated
+            }
+            if (*current == type) {
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+    //-------------------------------------------------------
+
+    dead_letters_registry::dead_letters_registry(uint32_t capture_per_type)
+        : m_capture_per_type(capture_per_type)
+    { }
+    //-------------------------------------------------------
+
+    dead_letters_registry::~dead_letters_registry() = default;
+    //-------------------------------------------------------
+
+    bool dead_letters_registry::record(const actor_ref & recipient, const actor_ref & sender, yato::any && message, dead_letter_reason reason, bool system)
+    {
+        shard & s = m_shards[shard_index_()];
+        (system ? s.system_messages : s.user_messages).fetch_add(1, std::memory_order_relaxed);
+        if (m_capture_per_type == 0) {
+            return false;
+        }
+
+        type_slot* const slot = find_type_slot_(message.type());
+        if (slot == nullptr) {
+            s.other_types.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        s.by_type[static_cast<size_t>(slot - m_types.data())].fetch_add(1, std::memory_order_relaxed);
+        // Only the first letters of the type are captured. Checked by load first, so the slot is not written after the capture is exhausted.
+        if ((slot->captured.load(std::memory_order_relaxed) >= m_capture_per_type) ||
+            (slot->captured.fetch_add(1, std::memory_order_relaxed) >= m_capture_per_type)) {
+            return false;
+        }
+
+        actor_ref subscriber;
+        {
+            std::unique_lock<std::mutex> lock(m_samples_mutex);
+            subscriber = m_subscriber;
+            if (subscriber.empty()) {
+                m_samples.push_back(dead_letter{ recipient, sender, std::move(message), reason, system });
+            } else {
+                m_samples.push_back(dead_letter{ recipient, sender, message, reason, system });
+            }
+        }
+        if (!subscriber.empty() && (recipient != subscriber)) {
+            subscriber.tell(dead_letter{ recipient, sender, std::move(message), reason, system });
+        }
+        return true;
+    }
+    //-------------------------------------------------------
+
+    void dead_letters_registry::subscribe(const actor_ref & subscriber)
+    {
+        std::unique_lock<std::mutex> lock(m_samples_mutex);
+        m_subscriber = subscriber;
+    }
+    //-------------------------------------------------------
+
+    dead_letters_stats dead_letters_registry::stats() const
+    {
+        dead_letters_stats result;
+        uint64_t other_types = 0;
+        for (const auto & s : m_shards) {
+            result.user_messages   += s.user_messages.load(std::memory_order_relaxed);
+            result.system_messages += s.system_messages.load(std::memory_order_relaxed);
+            other_types += s.other_types.load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < type_slots_number; ++i) {
+            const std::type_info* type = m_types[i].type.load(std::memory_order_acquire);
+            if (type != nullptr) {
+                uint64_t count = 0;
+                for (const auto & s : m_shards) {
+                    count += s.by_type[i].load(std::memory_order_relaxed);
+                }
+                result.by_type.push_back(dead_letters_stats::type_counter{ type->name(), count });
+            }
+        }
+        if (other_types != 0) {
+            result.by_type.push_back(dead_letters_stats::type_counter{ "<other>", other_types });
+        }
+        std::sort(result.by_type.begin(), result.by_type.end(), [](const dead_letters_stats::type_counter & lhs, const dead_letters_stats::type_counter & rhs) {
+            return lhs.count > rhs.count;
+        });
+
+        std::unique_lock<std::mutex> lock(m_samples_mutex);
+        result.samples = m_samples;
+        return result;
+    }
+    //-------------------------------------------------------
+
+} // namespace actors
+
+} // namespace yato
@@ -0,0 +1,111 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_PRIVATE_DEAD_LETTERS_REGISTRY_H_
+#define _YATO_ACTORS_PRIVATE_DEAD_LETTERS_REGISTRY_H_
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
+
+#include "../dead_letters.h"
+
+namespace yato
+{
+namespace actors
+{
+
+    /**
+     * Accounting of undelivered messages.
+     * Counters are sharded by threads, so dropping a message costs an uncontended increment.
+     * Types are assigned to slots of a fixed open addressing table, so accounting a type never takes a lock.
+     * Every shard has a counter per slot, the shared slot is only read after the capture of the type is exhausted.
+     * Only the first letters of every type are captured and forwarded to the subscriber.
+     */
+    class dead_letters_registry
+    {
+    private:
+        static constexpr size_t shards_number = 16;
+        static constexpr size_t type_slots_number = 128;
+
+        /**
+         * Shards are aligned to the cache line, so threads don't share lines.
+         */
+        struct alignas(64) shard
+        {
+            std::atomic<uint64_t> user_messages{ 0 };
+            std::atomic<uint64_t> system_messages{ 0 };
+            /**
+             * Letters of types, which don't fit into the table
+             */
+            std::atomic<uint64_t> other_types{ 0 };
+            /**
+             * Counters indexed by the type slot
+             */
+            std::array<std::atomic<uint64_t>, type_slots_number> by_type{};
+        };
+
+        /**
+         * Slot is owned by the first type, which is stored into it, and is never released.
+         */
+        struct type_slot
+        {
+            std::atomic<const std::type_info*> type{ nullptr };
+            std::atomic<uint32_t> captured{ 0 };
+        };
+
+        std::array<shard, shards_number> m_shards;
+        std::array<type_slot, type_slots_number> m_types;
+        const uint32_t m_capture_per_type;
+
+        mutable std::mutex m_samples_mutex;
+        std::vector<dead_letter> m_samples;
+        actor_ref m_subscriber;
+        //-------------------------------------------------------
+
+        static
+        size_t shard_index_();
+
+        /**
+         * Finds or occupies the slot of the type.
+         * @return nullptr if the table is full
+         */
+        type_slot* find_type_slot_(const std::type_info & type);
+
+    public:
+        /**
+         * @param capture_per_type Number of captured letters of every type. Zero disables per type accounting.
+         */
+        explicit
+        dead_letters_registry(uint32_t capture_per_type);
+
+        ~dead_letters_registry();
+
+        dead_letters_registry(const dead_letters_registry&) = delete;
+        dead_letters_registry& operator=(const dead_letters_registry&) = delete;
+
+        /**
+         * Account a dropped message. Thread safe.
+         * @return true if the letter is captured as a sample
+         */
+        bool record(const actor_ref & recipient, const actor_ref & sender, yato::any && message, dead_letter_reason reason, bool system);
+
+        /**
+         * Set the actor receiving captured letters. Empty ref unsubscribes.
+         */
+        void subscribe(const actor_ref & subscriber);
+
+        dead_letters_stats stats() const;
+    };
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_PRIVATE_DEAD_LETTERS_REGISTRY_H_
@@ -60,7 +60,9 @@ namespace actors
                 }
                 else if(type == "pinned") {
                     const auto threads_limit = conf.value<uint32_t>("threads_limit").get_or(16);
-                    ctx.executor = std::make_unique<pinned_executor>(m_system, threads_limit);
+                    const auto actors_per_thread = conf.value<uint32_t>("actors_per_thread").get_or(1);
+                    const auto throughput  = conf.value<uint32_t>("throughput").get_or(5);
+                    ctx.executor = std::make_unique<pinned_executor>(m_system, threads_limit, actors_per_thread, throughput);
                 }
                 else {
                     throw yato::config_error("Failed to deserialize excution_context: Unknown executor type!");
@@ -13,6 +13,7 @@
 #include <yato/any.h>
 
 #include "../actor_ref.h"
+#include "tracer.h"
 
 namespace yato
 {
@@ -23,6 +24,9 @@ namespace actors
     {
         yato::any payload;
         actor_ref sender;
+#ifdef YATO_ACTORS_WITH_TRACING
+        trace_context trace;
+#endif
         //-----------------------------------------------------------
 
         message(const yato::any & payload, const actor_ref & sender)
@@ -5,7 +5,8 @@
 * Copyright (c) 2016-2020 Alexey Gruzdev
 */
 
-#include <future>
+#include <algorithm>
+#include <limits>
 
 #include "../actor_system.h"
 #include "../logger.h"
@@ -21,68 +22,144 @@ namespace yato
 namespace actors
 {
 
-    void pinned_executor::pinned_thread_function(pinned_executor* executor, const std::shared_ptr<mailbox> & mbox) noexcept
+    void pinned_executor::worker_function(pinned_executor* executor, worker* w) noexcept
     {
-        using details::process_result;
-        const actor_ref ref = mbox->owner_actor()->self();
         try {
             for (;;) {
-                bool is_system_message = false;
-                std::unique_ptr<message> message = mbox->pop_prioritized_message_sync(&is_system_message);
-                YATO_ASSERT(message != nullptr, "Sync pop cant return null!");
-                if(is_system_message) {
-                    if(process_result::request_stop == mbox->owner_actor()->receive_system_message_(std::move(*message))) {
-                        // Terminate loop
+                std::shared_ptr<mailbox> mbox;
+                {
+                    std::unique_lock<std::mutex> lock(w->mutex);
+                    while (w->ready.empty() && !w->stop) {
+                        w->condition.wait(lock);
+                    }
+                    if (w->ready.empty()) {
                         break;
                     }
+                    mbox = std::move(w->ready.front());
+                    w->ready.pop();
                 }
-                else {
-                    mbox->owner_actor()->receive_message_(std::move(*message));
-                }
+                executor->process_mailbox_(w, mbox);
             }
-            mbox->close();
-            actor_system_ex::notify_on_stop(*executor->m_system, ref);
         }
         catch(std::exception & e) {
-            executor->m_logger->error("pinned_executor[pinned_thread_function]: Thread failed with exception: %s", e.what());
+            executor->m_logger->error("pinned_executor[worker_function]: Thread failed with exception: %s", e.what());
         }
         catch (...) {
-            executor->m_logger->error("pinned_executor[pinned_thread_function]: Thread failed with unknown exception!");
+            executor->m_logger->error("pinned_executor[worker_function]: Thread failed with unknown exception!");
         }
     }
     //-------------------------------------------------------
 
-    pinned_executor::pinned_executor(actor_system* system, uint32_t max_threads)
-        : m_system(system), m_threads_limit(max_threads)
+    void pinned_executor::process_mailbox_(worker* w, const std::shared_ptr<mailbox> & mbox)
+    {
+        using details::process_result;
+        const actor_ref ref = mbox->owner_actor()->self();
+        // Dedicated thread drains the mailbox, multiplexed one switches actors after the throughput
+        const uint32_t throughput = (m_actors_per_thread > 1) ? m_throughput : std::numeric_limits<uint32_t>::max();
+        for (uint32_t count = 0;;) {
+            bool is_system_message = false;
+            std::unique_ptr<message> message = mbox->pop_prioritized_message(&is_system_message);
+            if (!message) {
+                break;
+            }
+            if (is_system_message) {
+                if (process_result::request_stop == mbox->owner_actor()->receive_system_message_(std::move(*message))) {
+                    mbox->close();
+                    release_worker_(mbox.get(), w);
+                    actor_system_ex::notify_on_stop(*m_system, ref);
+                    return;
+                }
+            }
+            else {
+                mbox->owner_actor()->receive_message_(std::move(*message));
+                if (++count >= throughput) {
+                    break;
+                }
+            }
+        }
+        // Try reschedule if not empty
+        mbox->schedule_for_execution(true);
+    }
+    //-------------------------------------------------------
+
+    pinned_executor::pinned_executor(actor_system* system, uint32_t max_threads, uint32_t actors_per_thread, uint32_t throughput)
+        : m_system(system), m_threads_limit(max_threads), m_actors_per_thread(std::max(actors_per_thread, 1u)), m_throughput(std::max(throughput, 1u))
     {
         m_logger = logger_factory::create("pinned_executor");
     }
     //-------------------------------------------------------
 
-    pinned_executor::~pinned_executor() {
-        for(auto & t : m_threads) {
-            t.join();
+    pinned_executor::~pinned_executor()
+    {
+        for (auto & w : m_workers) {
+            {
+                std::unique_lock<std::mutex> lock(w->mutex);
+                w->stop = true;
+            }
+            w->condition.notify_one();
+        }
+        for (auto & w : m_workers) {
+            w->thread.join();
+        }
+    }
+    //-------------------------------------------------------
+
+    pinned_executor::worker* pinned_executor::acquire_worker_(const mailbox* mbox)
+    {
+        const auto it = m_assigned.find(mbox);
+        if (it != m_assigned.cend()) {
+            return it->second;
         }
+        // Spread actors over threads first, then multiplex them
+        worker* best = nullptr;
+        for (const auto & w : m_workers) {
+            if ((w->actors < m_actors_per_thread) && ((best == nullptr) || (w->actors < best->actors))) {
+                best = w.get();
+            }
+        }
+        if (((best == nullptr) || (best->actors > 0)) && (m_workers.size() < m_threads_limit)) {
+            m_workers.push_back(std::make_unique<worker>());
+            best = m_workers.back().get();
+            best->thread = std::thread(&worker_function, this, best);
+        }
+        if (best != nullptr) {
+            ++best->actors;
+            m_assigned.emplace(mbox, best);
+        }
+        return best;
+    }
+    //-------------------------------------------------------
+
+    void pinned_executor::release_worker_(const mailbox* mbox, worker* w)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_assigned.erase(mbox);
+        --w->actors;
     }
     //-------------------------------------------------------
 
     bool pinned_executor::execute(const std::shared_ptr<mailbox> & mbox)
     {
-        if(m_threads.size() >= m_threads_limit) {
+        worker* w = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            w = acquire_worker_(mbox.get());
+        }
+        if (w == nullptr) {
             YATO_REQUIRES(mbox->owner_actor() != nullptr);
-            m_logger->error("Failed to start thread for actor \"%s\". Threads limit in the pinned_executor is reached!", 
+            m_logger->error("Failed to start thread for actor \"%s\". Threads limit in the pinned_executor is reached!",
                 mbox->owner_actor()->self().get_path().c_str());
             return false;
         }
-        m_threads.emplace_back(&pinned_thread_function, this, mbox);
+        {
+            std::unique_lock<std::mutex> lock(w->mutex);
+            w->ready.push(mbox);
+        }
+        w->condition.notify_one();
         return true;
     }
     //-------------------------------------------------------
 
-
-
-
-
 } // namespace actors
 
 } // namespace yato
@@ -8,9 +8,13 @@
 #ifndef _YATO_ACTORS_PINNED_EXECUTOR_H_
 #define _YATO_ACTORS_PINNED_EXECUTOR_H_
 
-#include <vector>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
 #include <thread>
-#include <future>
+#include <unordered_map>
+#include <vector>
 
 #include "abstract_executor.h"
 
@@ -23,22 +27,52 @@ namespace actors
     class actor_system;
 
     /**
-     * Simplest thread pool.
-     * Creates a new thread for the each mailbox
+     * Runs every actor on its own thread.
+     * A thread serves up to actors_per_thread actors for their whole life and returns to the idle set after they stop.
+     * Idle threads are reused by new actors, so only the number of simultaneously living actors is limited.
      */
     class pinned_executor
         : public abstract_executor
     {
     private:
+        struct worker
+        {
+            std::thread thread;
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::queue<std::shared_ptr<mailbox>> ready;
+            bool stop = false;
+
+            // Number of assigned actors. Is guarded by the executor mutex
+            uint32_t actors = 0;
+        };
+
         actor_system* m_system;
-        std::vector<std::thread> m_threads;
         logger_ptr m_logger;
         uint32_t m_threads_limit;
+        uint32_t m_actors_per_thread;
+        uint32_t m_throughput;
+
+        std::mutex m_mutex;
+        std::vector<std::unique_ptr<worker>> m_workers;
+        std::unordered_map<const mailbox*, worker*> m_assigned;
+        //-------------------------------------------------------
+
+        static void worker_function(pinned_executor* executor, worker* w) noexcept;
+
+        void process_mailbox_(worker* w, const std::shared_ptr<mailbox> & mbox);
+
+        worker* acquire_worker_(const mailbox* mbox);
 
-        static void pinned_thread_function(pinned_executor* executor, const std::shared_ptr<mailbox> & mbox) noexcept;
+        void release_worker_(const mailbox* mbox, worker* w);
 
     public:
-        pinned_executor(actor_system* system, uint32_t max_threads);
+        /**
+         * @param max_threads Maximal number of threads
+         * @param actors_per_thread Number of actors multiplexed on one thread. One means a dedicated thread for every actor.
+         * @param throughput Number of messages processed by a multiplexed actor before switching to the next one.
+         */
+        pinned_executor(actor_system* system, uint32_t max_threads, uint32_t actors_per_thread = 1, uint32_t throughput = 5);
         ~pinned_executor();
 
         pinned_executor(const pinned_executor&) = delete;
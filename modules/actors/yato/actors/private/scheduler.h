@@ -10,12 +10,17 @@
 
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <future>
 #include <mutex>
+#include <thread>
 #include <vector>
 
+#include <yato/assertion.h>
+
 #include "functor.h"
+#include "../timer.h"
 #include "../logger.h"
 
 #if (defined(_MSVC_LANG) && (_MSVC_LANG >= 201703L)) || (defined(__cplusplus) && (__cplusplus > 201700L))
@@ -29,17 +34,33 @@ namespace yato
 namespace actors
 {
 
+    /**
+     * Timer thread.
+     * Events are kept in a binary heap, so enqueueing and firing cost O(log N) for N pending events.
+     * Cancelled timers are removed lazily, when they reach the top of the heap.
+     */
     class scheduler
     {
     public:
         using clock_type      = std::chrono::high_resolution_clock;
         using time_point_type = std::chrono::high_resolution_clock::time_point;
+        using duration_type   = std::chrono::high_resolution_clock::duration;
 
     private:
         struct event
         {
             time_point_type time;
+            duration_type period;
             std::unique_ptr<void_functor> task;
+            std::shared_ptr<details::timer_state> state;
+        };
+
+        struct event_later
+        {
+            bool operator()(const event & e1, const event & e2) const
+            {
+                return e1.time > e2.time;
+            }
         };
 
         std::vector<event> m_events;
@@ -52,6 +73,45 @@ namespace actors
         bool m_soft_stop  = false;
         bool m_force_stop = false;
 
+        /**
+         * Is called under lock
+         */
+        void push_(event && evt)
+        {
+            m_events.push_back(std::move(evt));
+            std::push_heap(m_events.begin(), m_events.end(), event_later{});
+        }
+
+        /**
+         * Is called under lock
+         */
+        event pop_()
+        {
+            std::pop_heap(m_events.begin(), m_events.end(), event_later{});
+            event evt = std::move(m_events.back());
+            m_events.pop_back();
+            return evt;
+        }
+
+        static
+        bool is_finished_(const event & evt)
+        {
+            return (evt.state != nullptr) && evt.state->finished.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Next firing time of a periodic event. Missed periods are skipped, so the phase doesn't drift.
+         */
+        static
+        time_point_type next_time_(const event & evt, const time_point_type & now)
+        {
+            auto next = evt.time + evt.period;
+            if (next <= now) {
+                next += ((now - next) / evt.period + 1) * evt.period;
+            }
+            return next;
+        }
+
         static
         void thread_function(scheduler* self) noexcept
         {
@@ -59,29 +119,29 @@ namespace actors
                 event evt;
                 {
                     std::unique_lock<std::mutex> lock(self->m_mutex);
-                    if (self->m_force_stop) {
-                        return;
-                    }
-                    while (self->m_events.empty()) {
-                        if(self->m_soft_stop) {
+                    for (;;) {
+                        if (self->m_force_stop) {
                             return;
                         }
-                        self->m_condition.wait(lock);
-                        if(self->m_force_stop) {
-                            return;
+                        if (self->m_events.empty()) {
+                            if (self->m_soft_stop) {
+                                return;
+                            }
+                            self->m_condition.wait(lock);
+                            continue;
                         }
-                    }
-                    event* earliest = &self->m_events.back();
-                    while (earliest->time > std::chrono::high_resolution_clock::now()) {
-                        auto time = earliest->time; // local copy
-                        self->m_condition.wait_until(lock, time);
-                        if (self->m_force_stop) {
-                            return;
+                        if (is_finished_(self->m_events.front())) {
+                            self->pop_();
+                            continue;
+                        }
+                        const auto time = self->m_events.front().time; // local copy
+                        if (time > clock_type::now()) {
+                            self->m_condition.wait_until(lock, time);
+                            continue;
                         }
-                        earliest = &self->m_events.back();
+                        break;
                     }
-                    evt = std::move(*earliest);
-                    self->m_events.pop_back();
+                    evt = self->pop_();
                 }
                 if(evt.task) {
                     try {
@@ -94,6 +154,18 @@ namespace actors
                         self->m_log->error("Unknown exception!");
                     }
                 }
+                if (evt.state != nullptr) {
+                    if (evt.period > duration_type::zero()) {
+                        std::unique_lock<std::mutex> lock(self->m_mutex);
+                        if (!is_finished_(evt) && !self->m_soft_stop && !self->m_force_stop) {
+                            evt.time = next_time_(evt, clock_type::now());
+                            self->push_(std::move(evt));
+                        }
+                    }
+                    else {
+                        evt.state->finished.store(true, std::memory_order_release);
+                    }
+                }
             }
         }
 
@@ -109,6 +181,9 @@ namespace actors
             {
                 std::unique_lock<std::mutex> lock(m_mutex);
                 m_soft_stop = true;
+                // Periodic timers would never finish
+                m_events.erase(std::remove_if(m_events.begin(), m_events.end(), [](const event & evt) { return evt.period > duration_type::zero(); }), m_events.end());
+                std::make_heap(m_events.begin(), m_events.end(), event_later{});
             }
             m_condition.notify_one();
             m_thread.join();
@@ -137,17 +212,51 @@ namespace actors
             auto result = task.get_future();
 
             event evt;
-            evt.time = when;
-            evt.task = make_functor_ptr(std::move(task));
+            evt.time   = when;
+            evt.period = duration_type::zero();
+            evt.task   = make_functor_ptr(std::move(task));
             {
                 std::unique_lock<std::mutex> lock(m_mutex);
-                auto pos = std::upper_bound(m_events.begin(), m_events.end(), evt, [](const event& e1, const event& e2) { return e1.time > e2.time; });
-                m_events.insert(pos, std::move(evt));
+                push_(std::move(evt));
             }
             m_condition.notify_one();
 
             return result;
         }
+
+        /**
+         * Enqueue a cancellable task.
+         * The task is executed at the time point and then repeated with the period, until the timer is cancelled.
+         * Zero period means a single execution.
+         */
+        template <typename Fn_>
+        timer_handle enqueue_timer(const time_point_type & when, const duration_type & period, Fn_ && function)
+        {
+            return enqueue_timer(when, period, std::make_shared<details::timer_state>(), std::forward<Fn_>(function));
+        }
+
+        /**
+         * Enqueue a cancellable task with the given timer state, so the task can refer to its own timer.
+         */
+        template <typename Fn_>
+        timer_handle enqueue_timer(const time_point_type & when, const duration_type & period, const std::shared_ptr<details::timer_state> & state, Fn_ && function)
+        {
+            YATO_REQUIRES(period >= duration_type::zero());
+            YATO_REQUIRES(state != nullptr);
+
+            event evt;
+            evt.time   = when;
+            evt.period = period;
+            evt.task   = make_functor_ptr(std::decay_t<Fn_>(std::forward<Fn_>(function)));
+            evt.state  = state;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                push_(std::move(evt));
+            }
+            m_condition.notify_one();
+
+            return timer_handle(state);
+        }
     };
 
 }// namespace actors
@@ -29,7 +29,14 @@ namespace actors
         /**
          * Terminate actor. Broadcasts stop to all children.
          */
-        struct stop {};
+        struct stop
+        {
+            /**
+             * Stop children by system messages instead of poison_pill, so they don't process pending user messages.
+             * Is propagated to the whole subtree.
+             */
+            bool immediate = false;
+        };
 
         /**
          * Terminate actor after there  are no children left. Don't broadcast stop to the children.
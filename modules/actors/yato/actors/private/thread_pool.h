@@ -35,6 +35,11 @@ namespace actors
 
         bool m_stop = false;
 
+        /**
+         * Number of threads waiting for tasks. Busy threads take new tasks without being notified.
+         */
+        size_t m_idle = 0;
+
         logger_ptr m_log;
 
     public:
@@ -44,7 +49,11 @@ namespace actors
                     std::function<void()> task;
                     {
                         std::unique_lock<std::mutex> lock(m_mutex);
-                        m_cvar.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+                        while (!m_stop && m_tasks.empty()) {
+                            ++m_idle;
+                            m_cvar.wait(lock);
+                            --m_idle;
+                        }
                         if (m_stop && m_tasks.empty()) {
                             break;
                         }
@@ -96,7 +105,11 @@ namespace actors
             } else {
                 m_log->warning("yato::actor::thread_pool[enqueue]: Failed to enqueue a new task. Pool is already stopped.");
             }
-            m_cvar.notify_one();
+            const bool notify = (m_idle > 0);
+            lock.unlock();
+            if (notify) {
+                m_cvar.notify_one();
+            }
         }
     };
 
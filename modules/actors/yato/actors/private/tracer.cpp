@@ -0,0 +1,213 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifdef YATO_ACTORS_WITH_TRACING
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <yato/stl_utility.h>
+
+#include "tracer.h"
+
+namespace yato
+{
+namespace actors
+{
+
+    namespace
+    {
+        /**
+         * Trace of the message being received by the current thread
+         */
+        thread_local trace_context tl_current_trace;
+
+        thread_local uint64_t tl_sample_counter = 0;
+
+        uint32_t thread_index_()
+        {
+            static std::atomic<uint32_t> next_index{ 0 };
+            thread_local const uint32_t index = next_index.fetch_add(1, std::memory_order_relaxed) + 1;
+            return index;
+        }
+
+        /**
+         * Unique without synchronization: thread index in the high bits
+         */
+        uint64_t next_id_()
+        {
+            thread_local uint64_t counter = 0;
+            return (static_cast<uint64_t>(thread_index_()) << 40) | (++counter & ((uint64_t(1) << 40) - 1));
+        }
+
+        uint64_t ceil_power_of_two_(uint64_t x)
+        {
+            uint64_t res = 1;
+            while (res < x) {
+                res <<= 1;
+            }
+            return res;
+        }
+
+        void append_escaped_(std::string & out, const char* str)
+        {
+            for (; *str != '\0'; ++str) {
+                const char c = *str;
+                if ((c == '"') || (c == '\\')) {
+                    out.push_back('\\');
+                    out.push_back(c);
+                }
+                else if (static_cast<unsigned char>(c) >= 0x20) {
+                    out.push_back(c);
+                }
+            }
+        }
+    }
+    //-------------------------------------------------------
+
+    tracer::tracer(uint32_t sample_every, uint32_t capacity)
+        : m_epoch(std::chrono::steady_clock::now()), m_sample_every(std::max(sample_every, 1u)), m_mask(ceil_power_of_two_(std::max(capacity, 1u)) - 1)
+    {
+        m_slots.reset(new slot[m_mask + 1]);
+    }
+    //-------------------------------------------------------
+
+    tracer::~tracer() = default;
+    //-------------------------------------------------------
+
+    void tracer::on_send(trace_context & context, bool may_start)
+    {
+        if (tl_current_trace.trace_id != 0) {
+            context.trace_id    = tl_current_trace.trace_id;
+            context.parent_span = tl_current_trace.span_id;
+        }
+        else if (may_start && (++tl_sample_counter >= m_sample_every)) {
+            tl_sample_counter   = 0;
+            context.trace_id    = next_id_();
+            context.parent_span = 0;
+        }
+        else {
+            return;
+        }
+        context.span_id = next_id_();
+        context.enqueue_time = now();
+    }
+    //-------------------------------------------------------
+
+    void tracer::push_(const span_record & span)
+    {
+        const uint64_t idx = m_head.fetch_add(1, std::memory_order_relaxed);
+        slot & s = m_slots[idx & m_mask];
+        s.sequence.store(2 * idx + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&s.span, &span, sizeof(span_record));
+        s.sequence.store(2 * idx + 2, std::memory_order_release);
+    }
+    //-------------------------------------------------------
+
+    std::string tracer::export_json() const
+    {
+        const uint64_t head = m_head.load(std::memory_order_acquire);
+        const uint64_t capacity = m_mask + 1;
+
+        std::vector<span_record> spans;
+        spans.reserve(static_cast<size_t>(std::min(head, capacity)));
+        for (uint64_t idx = (head > capacity) ? head - capacity : 0; idx < head; ++idx) {
+            const slot & s = m_slots[idx & m_mask];
+            const uint64_t sequence = s.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * idx + 2) {
+                // Is being written or already overwritten
+                continue;
+            }
+            span_record span;
+            std::memcpy(&span, &s.span, sizeof(span_record));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.sequence.load(std::memory_order_relaxed) == sequence) {
+                spans.push_back(span);
+            }
+        }
+
+        std::string json = "{\"traceEvents\":[";
+        char buffer[512];
+        bool first = true;
+        for (const auto & span : spans) {
+            if (!first) {
+                json.push_back(',');
+            }
+            first = false;
+
+            // Time in the mailbox is an async slice, receive is a complete event on the executor thread
+            yato::stl::snprintf(buffer, sizeof(buffer),
+                "{\"name\":\"mailbox\",\"cat\":\"queue\",\"ph\":\"b\",\"id\":\"0x%llx\",\"pid\":1,\"tid\":%u,\"ts\":%.3f},"
+                "{\"name\":\"mailbox\",\"cat\":\"queue\",\"ph\":\"e\",\"id\":\"0x%llx\",\"pid\":1,\"tid\":%u,\"ts\":%.3f},"
+                "{\"cat\":\"receive\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,",
+                static_cast<unsigned long long>(span.span_id), span.thread, span.enqueue_time / 1000.0,
+                static_cast<unsigned long long>(span.span_id), span.thread, span.dequeue_time / 1000.0,
+                span.thread, span.receive_start / 1000.0, (span.receive_end - span.receive_start) / 1000.0);
+            json += buffer;
+
+            json += "\"name\":\"";
+            append_escaped_(json, span.actor);
+            json += "\",\"args\":{\"type\":\"";
+            append_escaped_(json, span.type_name);
+            yato::stl::snprintf(buffer, sizeof(buffer), "\",\"trace\":\"0x%llx\",\"span\":\"0x%llx\",\"parent\":\"0x%llx\"}}",
+                static_cast<unsigned long long>(span.trace_id), static_cast<unsigned long long>(span.span_id), static_cast<unsigned long long>(span.parent_span));
+            json += buffer;
+        }
+        json += "],\"displayTimeUnit\":\"ns\"}";
+        return json;
+    }
+    //-------------------------------------------------------
+
+    tracer::receive_scope::receive_scope(tracer* t, const trace_context & context, const actor_ref & recipient, const char* type_name)
+        : m_tracer(((t != nullptr) && (context.trace_id != 0)) ? t : nullptr)
+    {
+        if (m_tracer != nullptr) {
+            m_span.trace_id     = context.trace_id;
+            m_span.span_id      = context.span_id;
+            m_span.parent_span  = context.parent_span;
+            m_span.enqueue_time = context.enqueue_time;
+            m_span.dequeue_time = m_tracer->now();
+            m_span.thread       = thread_index_();
+            m_span.type_name    = type_name;
+
+            // Keep the tail of the path, it is the most specific part
+            const char* path = recipient.get_path().c_str();
+            const size_t length = std::strlen(path);
+            const size_t offset = (length >= span_record::name_length) ? length - span_record::name_length + 1 : 0;
+            std::memcpy(m_span.actor, path + offset, length - offset + 1);
+
+            m_previous = tl_current_trace;
+            tl_current_trace = context;
+        }
+    }
+    //-------------------------------------------------------
+
+    tracer::receive_scope::~receive_scope()
+    {
+        if (m_tracer != nullptr) {
+            m_span.receive_end = m_tracer->now();
+            tl_current_trace = m_previous;
+            m_tracer->push_(m_span);
+        }
+    }
+    //-------------------------------------------------------
+
+    void tracer::receive_scope::start()
+    {
+        if (m_tracer != nullptr) {
+            m_span.receive_start = m_tracer->now();
+        }
+    }
+    //-------------------------------------------------------
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // YATO_ACTORS_WITH_TRACING
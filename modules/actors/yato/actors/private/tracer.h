@@ -0,0 +1,144 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_PRIVATE_TRACER_H_
+#define _YATO_ACTORS_PRIVATE_TRACER_H_
+
+#ifdef YATO_ACTORS_WITH_TRACING
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "../actor_ref.h"
+
+namespace yato
+{
+namespace actors
+{
+
+    /**
+     * Trace context of a message. Is stored in the envelope.
+     */
+    struct trace_context
+    {
+        uint64_t trace_id = 0;
+        uint64_t span_id = 0;
+        uint64_t parent_span = 0;
+        int64_t enqueue_time = 0;
+    };
+
+    /**
+     * Finished span of a traced message.
+     */
+    struct span_record
+    {
+        static constexpr size_t name_length = 48;
+
+        uint64_t trace_id;
+        uint64_t span_id;
+        uint64_t parent_span;
+        int64_t enqueue_time;
+        int64_t dequeue_time;
+        int64_t receive_start;
+        int64_t receive_end;
+        uint32_t thread;
+        const char* type_name;
+        char actor[name_length];
+    };
+
+    /**
+     * Collects sampled spans into a fixed size lock-free ring. Old spans are overwritten.
+     * A message is traced if it is sampled or if it is sent while a traced message is being received.
+     */
+    class tracer
+    {
+    private:
+        struct slot
+        {
+            // Odd value means the slot is being written
+            std::atomic<uint64_t> sequence{ 0 };
+            span_record span;
+        };
+
+        const std::chrono::steady_clock::time_point m_epoch;
+        const uint32_t m_sample_every;
+        const uint64_t m_mask;
+        std::unique_ptr<slot[]> m_slots;
+        std::atomic<uint64_t> m_head{ 0 };
+        //-------------------------------------------------------
+
+        void push_(const span_record & span);
+
+    public:
+        /**
+         * @param sample_every Trace one of every N messages sent outside of traces
+         * @param capacity Number of stored spans. Is rounded up to a power of two.
+         */
+        tracer(uint32_t sample_every, uint32_t capacity);
+
+        ~tracer();
+
+        tracer(const tracer&) = delete;
+        tracer& operator=(const tracer&) = delete;
+
+        /**
+         * Nanoseconds since the tracer creation
+         */
+        int64_t now() const
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+        }
+
+        /**
+         * Fill context of a message before enqueue.
+         * @param may_start If false, then the message is traced only inside of a current trace and is not counted for sampling.
+         */
+        void on_send(trace_context & context, bool may_start);
+
+        /**
+         * Chrome trace event format.
+         */
+        std::string export_json() const;
+
+        /**
+         * Marks the calling thread as receiving a traced message.
+         * Messages sent inside the scope belong to the same trace.
+         */
+        class receive_scope
+        {
+        private:
+            tracer* m_tracer;
+            span_record m_span;
+            trace_context m_previous;
+
+        public:
+            /**
+             * Does nothing if the tracer is null or the message is not traced.
+             */
+            receive_scope(tracer* t, const trace_context & context, const actor_ref & recipient, const char* type_name);
+            ~receive_scope();
+
+            receive_scope(const receive_scope&) = delete;
+            receive_scope& operator=(const receive_scope&) = delete;
+
+            /**
+             * Dequeued message is passed to the actor
+             */
+            void start();
+        };
+    };
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // YATO_ACTORS_WITH_TRACING
+
+#endif // _YATO_ACTORS_PRIVATE_TRACER_H_
@@ -0,0 +1,44 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_REMOTE_FACADE_H_
+#define _YATO_ACTORS_REMOTE_FACADE_H_
+
+#include <yato/config/config.h>
+
+namespace yato
+{
+namespace actors
+{
+    class actor_system;
+
+namespace remote
+{
+
+    struct facade
+    {
+    private:
+        /**
+         * Initializes remoting module. Requires IO module.
+         */
+        static
+        void init(actor_system & sys, const yato::config & conf);
+
+    public:
+        facade() = delete;
+
+        // Only actor system can use the facade
+        friend class yato::actors::actor_system;
+    };
+
+} // namespace remote
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_REMOTE_FACADE_H_
@@ -0,0 +1,44 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <limits>
+#include <string>
+
+#include "../facade.h"
+#include "../../actor_system.h"
+#include "../../private/actor_system_ex.h"
+#include "remote_manager.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace remote
+{
+
+    void facade::init(actor_system & sys, const yato::config & conf)
+    {
+        const auto host = conf.value<std::string>("host").get_or("127.0.0.1");
+        const auto port = conf.value<uint32_t>("port").get_or(2552);
+        if (port > std::numeric_limits<uint16_t>::max()) {
+            throw yato::config_error("remote[init]: Invalid port " + std::to_string(port));
+        }
+
+        endpoint_settings settings;
+        settings.local_address = sys.name() + "@" + host + ":" + std::to_string(port);
+        settings.batch_size       = conf.value<uint32_t>("batch_size").get_or(64 * 1024);
+        settings.max_frame_size   = conf.value<uint32_t>("max_frame_size").get_or(16 * 1024 * 1024);
+        settings.max_pending_size = conf.value<uint32_t>("max_pending_size").get_or(16 * 1024 * 1024);
+
+        actor_system_ex::create_actor<remote_manager>(sys, actor_scope::system, remote_manager::actor_name(), io::inet_address(host, static_cast<uint16_t>(port)), settings);
+    }
+
+} // namespace remote
+
+} // namespace actors
+
+} // namespace yato
@@ -0,0 +1,398 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <algorithm>
+
+#include <yato/any_match.h>
+
+#include "../../actor_system.h"
+#include "../../private/actor_system_ex.h"
+#include "../../private/system_message.h"
+#include "../../private/actors/selector.h"
+#include "../../io/tcp.h"
+
+#include "remote_endpoint.h"
+#include "remote_proxy.h"
+#include "wire_format.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace remote
+{
+
+    remote_endpoint::remote_endpoint(const endpoint_settings & settings, const io::inet_address & address, const actor_ref & tcp_manager, const actor_ref & connection)
+        : m_settings(settings), m_tcp(tcp_manager), m_address(address), m_outbound(connection.empty()), m_connection(connection)
+    { }
+    //-----------------------------------------------------
+
+    remote_endpoint::~remote_endpoint() = default;
+    //-----------------------------------------------------
+
+    void remote_endpoint::pre_start()
+    {
+        m_local_prefix = actor_path::default_root() + system().name() + "/";
+        m_batch.reserve(m_settings.batch_size);
+        if (!m_outbound) {
+            m_connection.tell(io::tcp::assign(self()), self());
+        }
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::receive(yato::any && message)
+    {
+        yato::any_match(
+            [this](const remote_envelope & envelope) {
+                encode_(envelope);
+            },
+            [this](const remote_flush &) {
+                m_flush_scheduled = false;
+                flush_();
+            },
+            [this](const io::tcp::received & received) {
+                decode_(received.data);
+            },
+            [this](const remote_resolve & resolve) {
+                sender().tell(get_proxy_(resolve.path.to_string(), true));
+            },
+            [this](const selection_success & success) {
+                finish_lookup_(success.result);
+            },
+            [this](const selection_failure &) {
+                finish_lookup_(actor_ref{});
+            },
+            [this](const terminated & t) {
+                const auto & path = t.ref.get_path().to_string();
+                if (path.compare(0, m_local_prefix.size(), m_local_prefix) == 0) {
+                    m_targets.erase(path.substr(m_local_prefix.size()));
+                }
+                const auto sender = m_senders.find(path);
+                if (sender != m_senders.end()) {
+                    encode_terminated_((*sender).second);
+                    m_senders.erase(sender);
+                    if (m_last_sender == path) {
+                        // A new actor with the same path has to be watched again
+                        m_last_sender.clear();
+                    }
+                }
+            },
+            [this](const io::tcp::connected & connected) {
+                log().info("Connected to %s", connected.remote.to_string().c_str());
+                m_connection = sender();
+                m_connecting = false;
+                m_connection.tell(io::tcp::assign(self()), self());
+                report_pending_dropped_();
+                flush_();
+            },
+            [this](const io::tcp::command_fail & fail) {
+                log().error("Failed to connect %s. Reason: %s", m_address.to_string().c_str(), fail.reason.c_str());
+                m_connecting = false;
+                report_pending_dropped_();
+                if (!m_batch.empty()) {
+                    log().warning("%d bytes of messages were dropped.", static_cast<int>(m_batch.size()));
+                    m_batch.clear();
+                }
+            },
+            [this](const io::tcp::peer_closed &) {
+                log().info("Disconnected from %s", m_address.to_string().c_str());
+                m_connection = actor_ref{};
+                m_input.clear();
+                if (!m_outbound) {
+                    self().stop();
+                }
+            },
+            [this](yato::match_default_t) {
+                log().error("Unknown message!");
+            }
+        )(message);
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::post_stop()
+    {
+        if (!m_connection.empty()) {
+            m_connection.stop();
+        }
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::connect_()
+    {
+        YATO_REQUIRES(m_outbound);
+        if (!m_connecting) {
+            m_connecting = true;
+            m_tcp.tell(io::tcp::connect(self(), m_address), self());
+        }
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::report_pending_dropped_()
+    {
+        if (m_pending_dropped != 0) {
+            log().warning("%d messages were dropped while connecting to %s, since pending messages exceed max_pending_size.",
+                static_cast<int>(m_pending_dropped), m_address.to_string().c_str());
+            m_pending_dropped = 0;
+        }
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::encode_(const remote_envelope & envelope)
+    {
+        const auto entry = system().serialization().find(envelope.payload.type());
+        if (entry == nullptr) {
+            log().error("Message type %s is not registered for serialization. Message is dropped.", envelope.payload.type().name());
+            return;
+        }
+
+        // Encode directly into the batch
+        const size_t offset = wire::begin_frame(m_batch);
+        wire::write_header(m_batch, entry->id, *envelope.target, remote_sender_(sender()));
+        entry->encode(envelope.payload, m_batch);
+        const size_t frame_size = m_batch.size() - offset - sizeof(wire::size_type);
+        if (frame_size > m_settings.max_frame_size) {
+            log().error("Message %s of %d bytes exceeds max frame size. Message is dropped.", entry->name.c_str(), static_cast<int>(frame_size));
+            m_batch.truncate(offset);
+            return;
+        }
+        wire::end_frame(m_batch, offset);
+
+        if (m_connection.empty()) {
+            if (m_batch.size() > m_settings.max_pending_size) {
+                m_batch.truncate(offset);
+                ++m_pending_dropped;
+            }
+            if (m_outbound) {
+                connect_();
+            }
+            return;
+        }
+        schedule_flush_();
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::encode_terminated_(const std::string & remote_sender)
+    {
+        // Proxies of the peer are stopped together with the connection
+        if (m_connection.empty()) {
+            return;
+        }
+        const size_t offset = wire::begin_frame(m_batch);
+        wire::write_header(m_batch, wire::sender_terminated_type, std::string{}, remote_sender);
+        wire::end_frame(m_batch, offset);
+        schedule_flush_();
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::schedule_flush_()
+    {
+        if (m_batch.size() >= m_settings.batch_size) {
+            flush_();
+        }
+        else if (!m_flush_scheduled) {
+            // Flush is processed after all messages, which are already in the mailbox
+            m_flush_scheduled = true;
+            self().tell(remote_flush{});
+        }
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::flush_()
+    {
+        if (!m_batch.empty() && !m_connection.empty()) {
+            m_connection.tell(io::tcp::write(m_batch.release()), self());
+            m_batch.reserve(m_settings.batch_size);
+        }
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::decode_(const std::vector<char> & data)
+    {
+        const bool buffered = !m_input.empty();
+        if (buffered) {
+            m_input.insert(m_input.end(), data.cbegin(), data.cend());
+        }
+        input_buffer in = buffered
+            ? input_buffer(m_input.data(), m_input.data() + m_input.size())
+            : input_buffer(data.data(), data.data() + data.size());
+
+        wire::frame f;
+        for (;;) {
+            const auto res = wire::read_frame(in, f, m_settings.max_frame_size);
+            if (res == wire::read_result::incomplete) {
+                break;
+            }
+            if (res == wire::read_result::malformed) {
+                log().error("Malformed frame is received from %s. Connection is closed.", m_address.to_string().c_str());
+                close_input_();
+                return;
+            }
+            if (res == wire::read_result::too_large) {
+                log().error("Frame exceeding max frame size is received from %s. Connection is closed.", m_address.to_string().c_str());
+                close_input_();
+                return;
+            }
+            if (f.type == wire::sender_terminated_type) {
+                stop_proxy_(f.sender);
+                continue;
+            }
+            const auto entry = system().serialization().find(f.type);
+            if (entry == nullptr) {
+                log().error("Received message type %u is not registered for serialization. Message is dropped.", static_cast<unsigned>(f.type));
+                continue;
+            }
+            yato::any payload;
+            input_buffer payload_in(f.payload_begin, f.payload_end);
+            if (!entry->decode(payload_in, payload) || (payload_in.remaining() != 0)) {
+                log().error("Failed to decode message %s. Message is dropped.", entry->name.c_str());
+                continue;
+            }
+            const actor_ref & from = f.sender.empty() ? system().dead_letters() : get_proxy_(f.sender, false);
+            deliver_(std::move(f.target), std::move(payload), from);
+        }
+
+        // Keep incomplete tail
+        if (buffered) {
+            m_input.erase(m_input.begin(), m_input.begin() + (in.position() - m_input.data()));
+        } else {
+            m_input.assign(in.position(), in.position() + in.remaining());
+        }
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::close_input_()
+    {
+        m_input.clear();
+        m_input.shrink_to_fit();
+        if (!m_connection.empty()) {
+            m_connection.tell(io::tcp::peer_closed{});
+        }
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::deliver_(std::string && target, yato::any && payload, const actor_ref & sender)
+    {
+        const auto it = m_targets.find(target);
+        if (it != m_targets.cend()) {
+            (*it).second.tell(std::move(payload), sender);
+            return;
+        }
+        auto lookup = std::find_if(m_lookups.begin(), m_lookups.end(), [&target](const pending_lookup & l) { return l.target == target; });
+        if (lookup == m_lookups.end()) {
+            m_lookups.push_back(pending_lookup{ std::move(target), {} });
+            lookup = std::prev(m_lookups.end());
+        }
+        (*lookup).messages.emplace_back(std::move(payload), sender);
+        if (m_lookups.size() == 1) {
+            start_lookup_();
+        }
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::start_lookup_()
+    {
+        // Lookups are sequential, since selection replies don't identify the request
+        while (!m_lookups.empty()) {
+            path_elements elems;
+            if (actor_path(m_local_prefix + m_lookups.front().target).parce(elems)) {
+                auto search_path = std::move(elems.names);
+                std::reverse(search_path.begin(), search_path.end());
+                search_path.push_back(actor_path::scope_to_str(elems.scope));
+                actor_system_ex::send_system_message(system(), actor_system_ex::root(system()), system_message::selection(self(), elems.scope, std::move(search_path)));
+                return;
+            }
+            log().warning("Invalid target path %s. Messages are dropped.", m_lookups.front().target.c_str());
+            m_lookups.pop_front();
+        }
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::finish_lookup_(const actor_ref & ref)
+    {
+        if (m_lookups.empty()) {
+            return;
+        }
+        auto lookup = std::move(m_lookups.front());
+        m_lookups.pop_front();
+
+        if (!ref.empty()) {
+            m_targets.emplace(lookup.target, ref);
+            watch(ref);
+            for (auto & msg : lookup.messages) {
+                ref.tell(std::move(msg.first), msg.second);
+            }
+        }
+        else {
+            log().warning("Remote message target %s is not found. %d messages are dropped.", lookup.target.c_str(), static_cast<int>(lookup.messages.size()));
+        }
+        start_lookup_();
+    }
+    //-----------------------------------------------------
+
+    const actor_ref & remote_endpoint::get_proxy_(const std::string & remote_path, bool resolved)
+    {
+        auto it = m_proxies.find(remote_path);
+        if (it == m_proxies.end()) {
+            // Target is a path inside the remote system
+            const auto system_end = remote_path.find('/', actor_path::default_root().size());
+            auto target = std::make_shared<const std::string>(
+                (system_end != std::string::npos) ? remote_path.substr(system_end + 1) : std::string{});
+
+            const auto ref = create_child<remote_proxy>("proxy_" + std::to_string(m_proxies_counter++), self(), target);
+            m_proxies_reversed.emplace(ref.get_path().to_string(), remote_path);
+            it = m_proxies.emplace(remote_path, proxy_entry{ ref, std::move(target), false }).first;
+        }
+        (*it).second.resolved = (*it).second.resolved || resolved;
+        return (*it).second.ref;
+    }
+    //-----------------------------------------------------
+
+    void remote_endpoint::stop_proxy_(const std::string & remote_path)
+    {
+        const auto it = m_proxies.find(remote_path);
+        if ((it == m_proxies.end()) || (*it).second.resolved) {
+            return;
+        }
+        const actor_ref ref = (*it).second.ref;
+        m_proxies_reversed.erase(ref.get_path().to_string());
+        m_proxies.erase(it);
+        ref.stop();
+    }
+    //-----------------------------------------------------
+
+    const std::string & remote_endpoint::remote_sender_(const actor_ref & sender)
+    {
+        static const std::string no_sender{};
+
+        if (sender.empty() || sender == system().dead_letters()) {
+            return no_sender;
+        }
+        const auto & path = sender.get_path().to_string();
+        if (path != m_last_sender) {
+            const auto proxy = m_proxies_reversed.find(path);
+            if (proxy != m_proxies_reversed.cend()) {
+                m_last_sender_remote = (*proxy).second;
+            }
+            else if (path.compare(0, m_local_prefix.size(), m_local_prefix) == 0) {
+                m_last_sender_remote = actor_path::default_root() + m_settings.local_address + "/" + path.substr(m_local_prefix.size());
+                if (m_senders.emplace(path, m_last_sender_remote).second) {
+                    watch(sender);
+                }
+            }
+            else {
+                m_last_sender_remote.clear();
+            }
+            m_last_sender = path;
+        }
+        return m_last_sender_remote;
+    }
+
+} // namespace remote
+
+} // namespace actors
+
+} // namespace yato
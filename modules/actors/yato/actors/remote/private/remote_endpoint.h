@@ -0,0 +1,168 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_REMOTE_ENDPOINT_H_
+#define _YATO_ACTORS_REMOTE_ENDPOINT_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../../actor.h"
+#include "../../io/inet_address.h"
+#include "../../serialization.h"
+#include "remote_messages.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace remote
+{
+
+    /**
+     * Settings shared by all endpoints of a system.
+     */
+    struct endpoint_settings
+    {
+        /**
+         * Advertised address of the local system, "system@host:port"
+         */
+        std::string local_address;
+
+        /**
+         * Batch is flushed when it exceeds the size, or when the endpoint mailbox is drained.
+         */
+        size_t batch_size;
+
+        /**
+         * Max size of an encoded message in bytes. Connection sending a larger frame is closed.
+         */
+        size_t max_frame_size;
+
+        /**
+         * Max size of messages in bytes, which are kept while the connection is established. Messages exceeding the limit are dropped.
+         */
+        size_t max_pending_size;
+    };
+
+
+    /**
+     * Single TCP connection to another actor system.
+     * Encodes messages from proxies and accumulates them into a batch, which is sent at once.
+     * Decodes incoming frames and delivers them to local actors.
+     * Outbound endpoint connects lazily and reconnects after the peer is closed.
+     * Inbound endpoint is stopped together with its connection.
+     * Proxy of a remote sender is stopped, when the peer reports that the sender is terminated.
+     */
+    class remote_endpoint
+        : public actor
+    {
+    private:
+        struct proxy_entry
+        {
+            actor_ref ref;
+            std::shared_ptr<const std::string> target;
+            /**
+             * Proxy returned by resolve is never stopped before the endpoint.
+             */
+            bool resolved;
+        };
+
+        struct pending_lookup
+        {
+            std::string target;
+            std::vector<std::pair<yato::any, actor_ref>> messages;
+        };
+
+        endpoint_settings m_settings;
+        std::string m_local_prefix;
+
+        actor_ref m_tcp;
+        io::inet_address m_address;
+        bool m_outbound;
+
+        actor_ref m_connection;
+        bool m_connecting = false;
+
+        output_buffer m_batch;
+        bool m_flush_scheduled = false;
+        size_t m_pending_dropped = 0;
+
+        std::vector<char> m_input;
+
+        std::unordered_map<std::string, proxy_entry> m_proxies;
+        std::unordered_map<std::string, std::string> m_proxies_reversed;
+        size_t m_proxies_counter = 0;
+
+        std::unordered_map<std::string, actor_ref> m_targets;
+
+        /**
+         * Watched local senders of encoded messages, mapped to their remote paths.
+         * Peer is notified when a sender terminates, so it stops the sender's proxy.
+         */
+        std::unordered_map<std::string, std::string> m_senders;
+        std::deque<pending_lookup> m_lookups;
+
+        std::string m_last_sender;
+        std::string m_last_sender_remote;
+        //------------------------------------------------------
+
+        void pre_start() override;
+
+        void receive(yato::any && message) override;
+
+        void post_stop() override;
+
+        void connect_();
+
+        void report_pending_dropped_();
+
+        void encode_(const remote_envelope & envelope);
+
+        void encode_terminated_(const std::string & remote_sender);
+
+        void schedule_flush_();
+
+        void flush_();
+
+        void decode_(const std::vector<char> & data);
+
+        void close_input_();
+
+        void deliver_(std::string && target, yato::any && payload, const actor_ref & sender);
+
+        void start_lookup_();
+
+        void finish_lookup_(const actor_ref & ref);
+
+        const actor_ref & get_proxy_(const std::string & remote_path, bool resolved);
+
+        void stop_proxy_(const std::string & remote_path);
+
+        const std::string & remote_sender_(const actor_ref & sender);
+        //------------------------------------------------------
+
+    public:
+        /**
+         * Creates outbound endpoint if the connection is empty, otherwise inbound endpoint for the accepted connection.
+         */
+        remote_endpoint(const endpoint_settings & settings, const io::inet_address & address, const actor_ref & tcp_manager, const actor_ref & connection);
+
+        ~remote_endpoint();
+    };
+
+} // namespace remote
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_REMOTE_ENDPOINT_H_
@@ -0,0 +1,217 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <algorithm>
+#include <limits>
+
+#include <yato/prerequisites.h>
+#ifdef YATO_CXX17
+# include <charconv>
+#endif
+
+#include <yato/any_match.h>
+
+#include "../../actor_system.h"
+#include "../../private/actor_system_ex.h"
+#include "../../private/system_message.h"
+#include "../../private/actors/selector.h"
+#include "../../io/tcp.h"
+
+#include "../remote.h"
+#include "remote_manager.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace remote
+{
+
+    const char* remote_manager::actor_name()
+    {
+        return "remote";
+    }
+    //-----------------------------------------------------
+
+    remote_manager::remote_manager(const io::inet_address & address, const endpoint_settings & settings)
+        : m_address(address), m_settings(settings)
+    { }
+    //-----------------------------------------------------
+
+    remote_manager::~remote_manager() = default;
+    //-----------------------------------------------------
+
+    void remote_manager::pre_start()
+    {
+        // Search for tcp manager. Resolve requests are postponed until it is found.
+        std::vector<std::string> search_path = { "tcp", actor_path::scope_to_str(actor_scope::system) };
+        actor_system_ex::send_system_message(system(), actor_system_ex::root(system()), system_message::selection(self(), actor_scope::system, std::move(search_path)));
+    }
+    //-----------------------------------------------------
+
+    void remote_manager::receive(yato::any && message)
+    {
+        yato::any_match(
+            [this](const remote_resolve & resolve) {
+                if (m_tcp.empty()) {
+                    m_pending.emplace_back(resolve, sender());
+                } else {
+                    resolve_(resolve, sender());
+                }
+            },
+            [this](const io::tcp::connected & connected) {
+                log().debug("Inbound connection from %s", connected.remote.to_string().c_str());
+                create_child<remote_endpoint>("inbound_" + std::to_string(m_inbound_counter++), m_settings, connected.remote, actor_ref{}, sender());
+            },
+            [this](const selection_success & success) {
+                m_tcp = success.result;
+                m_tcp.tell(io::tcp::bind(self(), m_address), self());
+                for (const auto & pending : m_pending) {
+                    resolve_(pending.first, pending.second);
+                }
+                m_pending.clear();
+            },
+            [this](const selection_failure &) {
+                log().error("TCP manager is not found. Remoting is disabled.");
+                m_pending.clear();
+                set_listening_(listening_state::failed);
+            },
+            [this](const io::tcp::bound & bound) {
+                log().info("Listening on %s as %s", bound.local.to_string().c_str(), m_settings.local_address.c_str());
+                set_listening_(listening_state::listening);
+            },
+            [this](const io::tcp::command_fail & fail) {
+                log().error("Failed to bind %s. Reason: %s", m_address.to_string().c_str(), fail.reason.c_str());
+                set_listening_(listening_state::failed);
+            },
+            [this](const remote_listening_query &) {
+                if (m_listening == listening_state::binding) {
+                    m_listening_waiters.push_back(sender());
+                } else {
+                    sender().tell(m_listening == listening_state::listening);
+                }
+            },
+            [this](yato::match_default_t) {
+                log().error("Unknown message!");
+            }
+        )(message);
+    }
+    //-----------------------------------------------------
+
+    void remote_manager::set_listening_(listening_state state)
+    {
+        m_listening = state;
+        for (const auto & waiter : m_listening_waiters) {
+            waiter.tell(state == listening_state::listening);
+        }
+        m_listening_waiters.clear();
+    }
+    //-----------------------------------------------------
+
+    bool remote_manager::parse_port_(const char* first, const char* last, uint16_t & port)
+    {
+        uint32_t value = 0;
+#ifdef YATO_CXX17
+        const auto res = std::from_chars(first, last, value);
+        if ((res.ec != std::errc{}) || (res.ptr != last) || (value > std::numeric_limits<uint16_t>::max())) {
+            return false;
+        }
+#else
+        if (first == last) {
+            return false;
+        }
+        for (; first != last; ++first) {
+            if ((*first < '0') || (*first > '9')) {
+                return false;
+            }
+            value = value * 10 + static_cast<uint32_t>(*first - '0');
+            if (value > std::numeric_limits<uint16_t>::max()) {
+                return false;
+            }
+        }
+#endif
+        port = static_cast<uint16_t>(value);
+        return true;
+    }
+    //-----------------------------------------------------
+
+    void remote_manager::resolve_(const remote_resolve & resolve, const actor_ref & sender)
+    {
+        path_elements elems;
+        if (!resolve.path.parce(elems, true)) {
+            log().error("Invalid remote path %s", resolve.path.c_str());
+            sender.tell(remote_resolve_failed{ "Invalid remote path" });
+            return;
+        }
+        auto it = m_endpoints.find(elems.system_name);
+        if (it == m_endpoints.end()) {
+            // system@host:port
+            const auto at    = elems.system_name.find('@');
+            const auto colon = elems.system_name.rfind(':');
+            if ((at == std::string::npos) || (colon == std::string::npos) || (colon < at)) {
+                log().error("Invalid remote address %s", elems.system_name.c_str());
+                sender.tell(remote_resolve_failed{ "Invalid remote address " + elems.system_name });
+                return;
+            }
+            const auto host = elems.system_name.substr(at + 1, colon - at - 1);
+            uint16_t port = 0;
+            if (!parse_port_(elems.system_name.data() + colon + 1, elems.system_name.data() + elems.system_name.size(), port)) {
+                log().error("Invalid port in remote address %s", elems.system_name.c_str());
+                sender.tell(remote_resolve_failed{ "Invalid port in remote address " + elems.system_name });
+                return;
+            }
+
+            const auto endpoint = create_child<remote_endpoint>(elems.system_name, m_settings, io::inet_address(host, port), m_tcp, actor_ref{});
+            it = m_endpoints.emplace(elems.system_name, endpoint).first;
+        }
+        (*it).second.tell(resolve, sender);
+    }
+    //-----------------------------------------------------
+
+    actor_ref get_for(const actor_system & sys)
+    {
+        YATO_CONSTEXPR_VAR auto timeout = std::chrono::seconds(5);
+        auto manager = sys.find(actor_path(sys, actor_scope::system, remote_manager::actor_name()), timeout).get();
+        if (manager.empty()) {
+            throw yato::runtime_error("yato::actors::remote[get_for]: Remote manager doesn't exist for actor_system \"" + sys.name() + "\"");
+        }
+        return manager;
+    }
+    //-----------------------------------------------------
+
+    bool wait_listening(const actor_system & sys, const std::chrono::milliseconds & timeout)
+    {
+        const auto result = get_for(sys).ask(remote_listening_query{}, timeout).get();
+        return result.is_type<bool>() && result.get_unsafe<bool>();
+    }
+    //-----------------------------------------------------
+
+    actor_ref resolve(const actor_system & sys, const actor_path & path)
+    {
+        YATO_CONSTEXPR_VAR auto timeout = std::chrono::seconds(5);
+        path_elements elems;
+        if (!path.parce(elems)) {
+            throw yato::argument_error("yato::actors::remote[resolve]: Invalid path " + path.to_string());
+        }
+        if (elems.system_name.find('@') == std::string::npos) {
+            return sys.find(path, timeout).get();
+        }
+        auto result = get_for(sys).ask(remote_resolve(path), timeout).get();
+        if (result.is_type<remote_resolve_failed>()) {
+            throw yato::runtime_error("yato::actors::remote[resolve]: Failed to resolve " + path.to_string() + ". " + result.get_unsafe<remote_resolve_failed>().reason);
+        }
+        if (!result.is_type<actor_ref>()) {
+            throw yato::runtime_error("yato::actors::remote[resolve]: Failed to resolve " + path.to_string());
+        }
+        return result.get_unsafe<actor_ref>();
+    }
+
+} // namespace remote
+
+} // namespace actors
+
+} // namespace yato
@@ -0,0 +1,86 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_REMOTE_MANAGER_H_
+#define _YATO_ACTORS_REMOTE_MANAGER_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../../actor.h"
+#include "../../io/inet_address.h"
+#include "remote_endpoint.h"
+#include "remote_messages.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace remote
+{
+
+    /**
+     * Listens for inbound connections and owns all endpoints.
+     */
+    class remote_manager
+        : public actor
+    {
+    private:
+        io::inet_address m_address;
+        endpoint_settings m_settings;
+
+        actor_ref m_tcp;
+        std::map<std::string, actor_ref> m_endpoints;
+        size_t m_inbound_counter = 0;
+
+        std::vector<std::pair<remote_resolve, actor_ref>> m_pending;
+
+        enum class listening_state
+        {
+            binding,
+            listening,
+            failed
+        };
+
+        listening_state m_listening = listening_state::binding;
+        std::vector<actor_ref> m_listening_waiters;
+        //------------------------------------------------------
+
+        void pre_start() override;
+
+        void receive(yato::any && message) override;
+
+        void resolve_(const remote_resolve & resolve, const actor_ref & sender);
+
+        void set_listening_(listening_state state);
+
+        /**
+         * Parses decimal port in range [0, 65535]. Returns false on invalid input.
+         */
+        static
+        bool parse_port_(const char* first, const char* last, uint16_t & port);
+        //------------------------------------------------------
+
+    public:
+        remote_manager(const io::inet_address & address, const endpoint_settings & settings);
+
+        ~remote_manager();
+
+        static
+        const char* actor_name();
+    };
+
+} // namespace remote
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_REMOTE_MANAGER_H_
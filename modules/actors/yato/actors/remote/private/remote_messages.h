@@ -0,0 +1,79 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_REMOTE_MESSAGES_H_
+#define _YATO_ACTORS_REMOTE_MESSAGES_H_
+
+#include <memory>
+#include <string>
+
+#include <yato/any.h>
+
+#include "../../actor_path.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace remote
+{
+
+    /**
+     * Request for a proxy of a remote actor. Reply is actor_ref.
+     */
+    struct remote_resolve
+    {
+        actor_path path;
+
+        explicit
+        remote_resolve(const actor_path & path)
+            : path(path)
+        { }
+    };
+
+    /**
+     * Query of the listening state. Reply is bool: true when inbound connections are accepted, false if binding failed.
+     * The reply is postponed until the state is known.
+     */
+    struct remote_listening_query
+    { };
+
+    /**
+     * Reply to remote_resolve, if the remote address is invalid.
+     */
+    struct remote_resolve_failed
+    {
+        std::string reason;
+    };
+
+    /**
+     * Message for a remote actor, sent from proxy to endpoint.
+     * Target path is shared with the proxy, so the envelope stays valid after the proxy is stopped.
+     */
+    struct remote_envelope
+    {
+        std::shared_ptr<const std::string> target;
+        yato::any payload;
+
+        remote_envelope(std::shared_ptr<const std::string> target, yato::any && payload)
+            : target(std::move(target)), payload(std::move(payload))
+        { }
+    };
+
+    /**
+     * Sends accumulated batch to the network.
+     */
+    struct remote_flush
+    { };
+
+} // namespace remote
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_REMOTE_MESSAGES_H_
@@ -0,0 +1,53 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_REMOTE_PROXY_H_
+#define _YATO_ACTORS_REMOTE_PROXY_H_
+
+#include <memory>
+#include <string>
+
+#include "../../actor.h"
+#include "remote_messages.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace remote
+{
+
+    /**
+     * Local representative of a remote actor.
+     * Forwards all messages to the parent endpoint, keeping the original sender.
+     * Is a child of the endpoint, so it is never used after the endpoint is stopped.
+     */
+    class remote_proxy
+        : public actor
+    {
+    private:
+        actor_ref m_endpoint;
+        std::shared_ptr<const std::string> m_target;
+
+        void receive(yato::any && message) override
+        {
+            m_endpoint.tell(remote_envelope(m_target, std::move(message)), sender());
+        }
+
+    public:
+        remote_proxy(const actor_ref & endpoint, const std::shared_ptr<const std::string> & target)
+            : m_endpoint(endpoint), m_target(target)
+        { }
+    };
+
+} // namespace remote
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_REMOTE_PROXY_H_
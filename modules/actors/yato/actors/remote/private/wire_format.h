@@ -0,0 +1,121 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_REMOTE_WIRE_FORMAT_H_
+#define _YATO_ACTORS_REMOTE_WIRE_FORMAT_H_
+
+#include <string>
+
+#include "../../serialization.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace remote
+{
+
+    /**
+     * Frame layout:
+     *   [u32 frame size][u32 type id][string target][string sender][payload]
+     * Strings are stored as [u32 length][chars]. Target is a path inside the receiving system, e.g. "user/actor".
+     * Sender is a full remote path or empty. All values use host byte order.
+     * Frame with the type id 0 has empty target and payload, it tells that the sender is terminated.
+     */
+    namespace wire
+    {
+        using size_type = uint32_t;
+
+        const serialization_registry::type_id sender_terminated_type = 0;
+
+        /**
+         * Decoded frame. Points into the input buffer.
+         */
+        struct frame
+        {
+            serialization_registry::type_id type;
+            std::string target;
+            std::string sender;
+            const char* payload_begin;
+            const char* payload_end;
+        };
+
+        enum class read_result
+        {
+            complete,
+            incomplete,
+            malformed,
+            too_large
+        };
+
+        /**
+         * Reserves space for the frame size. Returns the frame offset.
+         */
+        inline
+        size_t begin_frame(output_buffer & out)
+        {
+            const size_t offset = out.size();
+            out.grow(sizeof(size_type));
+            return offset;
+        }
+
+        /**
+         * Writes size of the frame started at the offset.
+         */
+        inline
+        void end_frame(output_buffer & out, size_t offset)
+        {
+            const auto size = yato::narrow_cast<size_type>(out.size() - offset - sizeof(size_type));
+            out.overwrite(offset, &size, sizeof(size_type));
+        }
+
+        inline
+        void write_header(output_buffer & out, serialization_registry::type_id type, const std::string & target, const std::string & sender)
+        {
+            serializer<serialization_registry::type_id>::write(out, type);
+            serializer<std::string>::write(out, target);
+            serializer<std::string>::write(out, sender);
+        }
+
+        /**
+         * Reads one frame from the buffer and advances it, if the frame is complete.
+         * Frame larger than max_size is rejected as soon as its size is read, so a peer can't make the receiver buffer it.
+         */
+        inline
+        read_result read_frame(input_buffer & in, frame & f, size_t max_size)
+        {
+            input_buffer pos = in;
+            size_type size = 0;
+            if (!serializer<size_type>::read(pos, size)) {
+                return read_result::incomplete;
+            }
+            if (size > max_size) {
+                return read_result::too_large;
+            }
+            if (pos.remaining() < size) {
+                return read_result::incomplete;
+            }
+            input_buffer body(pos.position(), pos.position() + size);
+            if (!serializer<serialization_registry::type_id>::read(body, f.type) ||
+                !serializer<std::string>::read(body, f.target) ||
+                !serializer<std::string>::read(body, f.sender)) {
+                return read_result::malformed;
+            }
+            f.payload_begin = body.position();
+            f.payload_end   = body.position() + body.remaining();
+            in.skip(sizeof(size_type) + size);
+            return read_result::complete;
+        }
+    }
+
+} // namespace remote
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_REMOTE_WIRE_FORMAT_H_
@@ -0,0 +1,52 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_REMOTE_H_
+#define _YATO_ACTORS_REMOTE_H_
+
+#include <chrono>
+
+#include "../actor_path.h"
+#include "../actor_ref.h"
+#include "facade.h"
+
+namespace yato
+{
+namespace actors
+{
+    class actor_system;
+
+namespace remote
+{
+
+    /**
+     * Returns remote manager for an actor system.
+     */
+    actor_ref get_for(const actor_system & sys);
+
+    /**
+     * Waits until the actor system accepts inbound remote connections.
+     * @return false if listening failed or the timeout is expired.
+     */
+    bool wait_listening(const actor_system & sys, const std::chrono::milliseconds & timeout);
+
+    /**
+     * Returns a local reference representing an actor of another actor system.
+     * Remote path has format "yato://system@host:port/scope/name".
+     * Messages sent to the reference are serialized using actor_system::serialization(),
+     * so all message types have to be registered in both systems.
+     * Path without network address is resolved locally.
+     */
+    actor_ref resolve(const actor_system & sys, const actor_path & path);
+
+} // namespace remote
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_REMOTE_H_
@@ -0,0 +1,548 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_SERIALIZATION_H_
+#define _YATO_ACTORS_SERIALIZATION_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <yato/any.h>
+#include <yato/meta.h>
+#include <yato/prerequisites.h>
+#include <yato/reflection.h>
+
+namespace yato
+{
+namespace actors
+{
+
+    /**
+     * Growing byte buffer for encoding.
+     * Keeps capacity after clear(), so it can be reused for many messages without allocations.
+     */
+    class output_buffer
+    {
+    private:
+        std::vector<char> m_data;
+
+    public:
+        output_buffer() = default;
+
+        explicit
+        output_buffer(size_t capacity)
+        {
+            m_data.reserve(capacity);
+        }
+
+        ~output_buffer() = default;
+
+        output_buffer(const output_buffer&) = delete;
+        output_buffer(output_buffer&&) = default;
+
+        output_buffer& operator=(const output_buffer&) = delete;
+        output_buffer& operator=(output_buffer&&) = default;
+
+        void write(const void* ptr, size_t size)
+        {
+            const char* first = static_cast<const char*>(ptr);
+            m_data.insert(m_data.end(), first, first + size);
+        }
+
+        /**
+         * Appends uninitialized bytes and returns pointer to them.
+         * The pointer is valid until the next write.
+         */
+        char* grow(size_t size)
+        {
+            const size_t offset = m_data.size();
+            m_data.resize(offset + size);
+            return m_data.data() + offset;
+        }
+
+        /**
+         * Write into already written bytes.
+         */
+        void overwrite(size_t offset, const void* ptr, size_t size)
+        {
+            YATO_REQUIRES(offset + size <= m_data.size());
+            std::memcpy(m_data.data() + offset, ptr, size);
+        }
+
+        void reserve(size_t capacity)
+        {
+            m_data.reserve(capacity);
+        }
+
+        void clear()
+        {
+            m_data.clear();
+        }
+
+        /**
+         * Drops the content after the size.
+         */
+        void truncate(size_t size)
+        {
+            YATO_REQUIRES(size <= m_data.size());
+            m_data.resize(size);
+        }
+
+        bool empty() const
+        {
+            return m_data.empty();
+        }
+
+        size_t size() const
+        {
+            return m_data.size();
+        }
+
+        const char* data() const
+        {
+            return m_data.data();
+        }
+
+        /**
+         * Move out the content. Buffer becomes empty.
+         */
+        std::vector<char> release()
+        {
+            std::vector<char> tmp;
+            tmp.swap(m_data);
+            return tmp;
+        }
+    };
+
+
+    /**
+     * Non-owning view of encoded bytes.
+     */
+    class input_buffer
+    {
+    private:
+        const char* m_first;
+        const char* m_last;
+
+    public:
+        input_buffer(const char* first, const char* last)
+            : m_first(first), m_last(last)
+        { }
+
+        bool read(void* ptr, size_t size)
+        {
+            if (remaining() < size) {
+                return false;
+            }
+            std::memcpy(ptr, m_first, size);
+            m_first += size;
+            return true;
+        }
+
+        bool skip(size_t size)
+        {
+            if (remaining() < size) {
+                return false;
+            }
+            m_first += size;
+            return true;
+        }
+
+        size_t remaining() const
+        {
+            return static_cast<size_t>(m_last - m_first);
+        }
+
+        const char* position() const
+        {
+            return m_first;
+        }
+    };
+
+
+    namespace details
+    {
+        template <typename Ty_>
+        struct has_unique_representation
+            : std::integral_constant<bool,
+#ifdef __cpp_lib_has_unique_object_representations
+                std::has_unique_object_representations<Ty_>::value
+#else
+                __has_unique_object_representations(Ty_)
+#endif
+            >
+        { };
+    }
+
+    /**
+     * Types, which are serialized by copying their bytes.
+     * By default these are trivially copyable types without padding bytes and not pointers, and also float and double.
+     * Padding of a structure with floating point members can't be detected. Such type should be reflected with YATO_REFLECT_CLASS,
+     * or this trait can be specialized as true_type if the type has no padding.
+     */
+    template <typename Ty_>
+    struct is_bitwise_serializable
+        : std::integral_constant<bool,
+            std::is_trivially_copyable<Ty_>::value && !yato::reflection::is_reflected<Ty_>::value &&
+            !std::is_pointer<Ty_>::value && !std::is_member_pointer<Ty_>::value &&
+            (details::has_unique_representation<Ty_>::value || std::is_same<Ty_, float>::value || std::is_same<Ty_, double>::value)>
+    { };
+
+    /**
+     * Binary serializer of a message type.
+     * Implemented for bitwise serializable types, std::string, std::vector and classes reflected with YATO_REFLECT_CLASS.
+     * Can be specialized for other types.
+     */
+    template <typename Ty_, typename = void>
+    struct serializer
+    { };
+
+    template <typename Ty_>
+    struct serializer<Ty_, std::enable_if_t<is_bitwise_serializable<Ty_>::value>>
+    {
+        static
+        void write(output_buffer & out, const Ty_ & value)
+        {
+            out.write(&value, sizeof(Ty_));
+        }
+
+        static
+        bool read(input_buffer & in, Ty_ & value)
+        {
+            return in.read(&value, sizeof(Ty_));
+        }
+    };
+
+    template <>
+    struct serializer<std::string>
+    {
+        static
+        void write(output_buffer & out, const std::string & value)
+        {
+            serializer<uint32_t>::write(out, yato::narrow_cast<uint32_t>(value.size()));
+            out.write(value.data(), value.size());
+        }
+
+        static
+        bool read(input_buffer & in, std::string & value)
+        {
+            uint32_t size = 0;
+            if (!serializer<uint32_t>::read(in, size) || (in.remaining() < size)) {
+                return false;
+            }
+            value.assign(in.position(), size);
+            return in.skip(size);
+        }
+    };
+
+    template <typename Ty_, typename Alloc_>
+    struct serializer<std::vector<Ty_, Alloc_>>
+    {
+    private:
+        static YATO_CONSTEXPR_VAR bool is_bulk = is_bitwise_serializable<Ty_>::value && !std::is_same<Ty_, bool>::value;
+
+        static
+        void write_elements_(output_buffer & out, const std::vector<Ty_, Alloc_> & value, std::true_type /*bulk*/)
+        {
+            out.write(value.data(), value.size() * sizeof(Ty_));
+        }
+
+        static
+        void write_elements_(output_buffer & out, const std::vector<Ty_, Alloc_> & value, std::false_type /*bulk*/)
+        {
+            for (const auto & elem : value) {
+                serializer<Ty_>::write(out, static_cast<const Ty_&>(elem));
+            }
+        }
+
+        static
+        bool read_elements_(input_buffer & in, std::vector<Ty_, Alloc_> & value, uint32_t size, std::true_type /*bulk*/)
+        {
+            if (in.remaining() / sizeof(Ty_) < size) {
+                return false;
+            }
+            value.resize(size);
+            return in.read(value.data(), size * sizeof(Ty_));
+        }
+
+        static
+        bool read_elements_(input_buffer & in, std::vector<Ty_, Alloc_> & value, uint32_t size, std::false_type /*bulk*/)
+        {
+            value.clear();
+            // Don't trust the size before elements are actually read
+            value.reserve(std::min<size_t>(size, in.remaining()));
+            for (uint32_t i = 0; i < size; ++i) {
+                Ty_ elem{};
+                if (!serializer<Ty_>::read(in, elem)) {
+                    return false;
+                }
+                value.push_back(std::move(elem));
+            }
+            return true;
+        }
+
+    public:
+        static
+        void write(output_buffer & out, const std::vector<Ty_, Alloc_> & value)
+        {
+            serializer<uint32_t>::write(out, yato::narrow_cast<uint32_t>(value.size()));
+            write_elements_(out, value, std::integral_constant<bool, is_bulk>{});
+        }
+
+        static
+        bool read(input_buffer & in, std::vector<Ty_, Alloc_> & value)
+        {
+            uint32_t size = 0;
+            if (!serializer<uint32_t>::read(in, size)) {
+                return false;
+            }
+            return read_elements_(in, value, size, std::integral_constant<bool, is_bulk>{});
+        }
+    };
+
+    namespace details
+    {
+        template <typename MembersList_>
+        struct reflected_members_serializer
+        {
+            using member_info = typename MembersList_::head;
+            using next = reflected_members_serializer<typename MembersList_::tail>;
+
+            template <typename Class_>
+            static
+            void write(output_buffer & out, const Class_ & value)
+            {
+                serializer<typename member_info::my_type>::write(out, value.*yato::reflection::data_member_pointer<member_info>());
+                next::write(out, value);
+            }
+
+            template <typename Class_>
+            static
+            bool read(input_buffer & in, Class_ & value)
+            {
+                return serializer<typename member_info::my_type>::read(in, value.*yato::reflection::data_member_pointer<member_info>())
+                    && next::read(in, value);
+            }
+        };
+
+        template <>
+        struct reflected_members_serializer<yato::meta::null_list>
+        {
+            template <typename Class_>
+            static
+            void write(output_buffer &, const Class_ &)
+            { }
+
+            template <typename Class_>
+            static
+            bool read(input_buffer &, Class_ &)
+            {
+                return true;
+            }
+        };
+    }
+
+    /**
+     * Serializes reflected data members one by one in declaration order.
+     */
+    template <typename Ty_>
+    struct serializer<Ty_, std::enable_if_t<yato::reflection::is_reflected<Ty_>::value>>
+    {
+        using members_serializer = details::reflected_members_serializer<yato::reflection::data_members_list<Ty_>>;
+
+        static
+        void write(output_buffer & out, const Ty_ & value)
+        {
+            members_serializer::write(out, value);
+        }
+
+        static
+        bool read(input_buffer & in, Ty_ & value)
+        {
+            return members_serializer::read(in, value);
+        }
+    };
+
+
+    /**
+     * Maps message types to stable identifiers and binary serializers.
+     * All types should be registered before the first message is encoded or decoded.
+     * The first lookup freezes the registry, so lookups from executor threads don't need locking, and later registration throws.
+     */
+    class serialization_registry
+    {
+    public:
+        using type_id = uint32_t;
+
+        using encoder_type = void(*)(const yato::any &, output_buffer &);
+        using decoder_type = bool(*)(input_buffer &, yato::any &);
+
+        struct entry
+        {
+            type_id id;
+            std::string name;
+            encoder_type encode;
+            decoder_type decode;
+        };
+
+    private:
+        std::unordered_map<std::type_index, entry> m_by_type;
+        std::unordered_map<type_id, const entry*> m_by_id;
+
+        mutable std::mutex m_mutex;
+        mutable std::atomic<bool> m_frozen{ false };
+
+        /**
+         * Waits for a registration in progress and disables new ones.
+         */
+        void freeze_() const
+        {
+            if (!m_frozen.load(std::memory_order_acquire)) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_frozen.store(true, std::memory_order_release);
+            }
+        }
+
+        template <typename Ty_>
+        static
+        void encode_impl_(const yato::any & value, output_buffer & out)
+        {
+            serializer<Ty_>::write(out, value.get_unsafe<Ty_>());
+        }
+
+        template <typename Ty_>
+        static
+        bool decode_impl_(input_buffer & in, yato::any & value)
+        {
+            value.emplace<Ty_>();
+            if (!serializer<Ty_>::read(in, value.get_unsafe<Ty_>())) {
+                value.clear();
+                return false;
+            }
+            return true;
+        }
+
+    public:
+        serialization_registry() = default;
+
+        ~serialization_registry() = default;
+
+        serialization_registry(const serialization_registry&) = delete;
+        serialization_registry& operator=(const serialization_registry&) = delete;
+
+        /**
+         * Makes stable type identifier from a name. Uses FNV-1a hash.
+         */
+        static
+        type_id make_id(const std::string & name)
+        {
+            uint32_t hash = 2166136261u;
+            for (const char c : name) {
+                hash ^= static_cast<uint8_t>(c);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        /**
+         * Register message type with a unique name.
+         * The name has to be the same in all communicating processes.
+         * Registering the same type with the same name again does nothing.
+         * Throws argument_error if the name or the type is already registered with a different codec.
+         * Throws runtime_error if the registry is already used for encoding or decoding.
+         */
+        template <typename Ty_>
+        type_id register_type(const std::string & name)
+        {
+            static_assert(std::is_default_constructible<Ty_>::value, "serialization_registry: Message type must be default constructible.");
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_frozen.load(std::memory_order_relaxed)) {
+                throw yato::runtime_error("serialization_registry[register_type]: Type \"" + name + "\" is registered after the first message is serialized");
+            }
+            const type_id id = make_id(name);
+            const auto it = m_by_id.find(id);
+            if (it != m_by_id.cend()) {
+                const entry & existing = *(*it).second;
+                if (existing.name != name) {
+                    throw yato::argument_error("serialization_registry[register_type]: Type id collision for \"" + name + "\"");
+                }
+                if ((existing.encode != &encode_impl_<Ty_>) || (existing.decode != &decode_impl_<Ty_>)) {
+                    throw yato::argument_error("serialization_registry[register_type]: Name \"" + name + "\" is already registered for another type");
+                }
+                return id;
+            }
+            if (m_by_type.find(std::type_index(typeid(Ty_))) != m_by_type.cend()) {
+                throw yato::argument_error("serialization_registry[register_type]: Type is already registered with another name than \"" + name + "\"");
+            }
+            auto & e = m_by_type[std::type_index(typeid(Ty_))];
+            e.id     = id;
+            e.name   = name;
+            e.encode = &encode_impl_<Ty_>;
+            e.decode = &decode_impl_<Ty_>;
+            m_by_id[id] = &e;
+            return id;
+        }
+
+        /**
+         * Find entry for a type.
+         * @return nullptr if type is not registered.
+         */
+        const entry* find(const std::type_info & type) const
+        {
+            freeze_();
+            const auto it = m_by_type.find(std::type_index(type));
+            return (it != m_by_type.cend()) ? &(*it).second : nullptr;
+        }
+
+        /**
+         * Find entry for a type id.
+         * @return nullptr if type is not registered.
+         */
+        const entry* find(type_id id) const
+        {
+            freeze_();
+            const auto it = m_by_id.find(id);
+            return (it != m_by_id.cend()) ? (*it).second : nullptr;
+        }
+
+        /**
+         * Append encoded value to the buffer.
+         * @return Entry of the value type or nullptr if the type is not registered.
+         */
+        const entry* encode(const yato::any & value, output_buffer & out) const
+        {
+            const auto e = find(value.type());
+            if (e != nullptr) {
+                e->encode(value, out);
+            }
+            return e;
+        }
+
+        /**
+         * Decode value of a registered type.
+         * @return false if the type is not registered or the data is malformed.
+         */
+        bool decode(type_id id, input_buffer & in, yato::any & value) const
+        {
+            const auto e = find(id);
+            return (e != nullptr) && e->decode(in, value);
+        }
+    };
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_SERIALIZATION_H_
@@ -0,0 +1,197 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <yato/any_match.h>
+
+#include "../stage.h"
+#include "../../actor_system.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace streams
+{
+
+    stage::stage(const stage_settings & settings)
+        : m_downstream(settings.downstream), m_ops(settings.ops), m_buffer_size(std::max<uint32_t>(settings.buffer_size, 1))
+    { }
+    //-------------------------------------------------------
+
+    stage::~stage() = default;
+    //-------------------------------------------------------
+
+    void stage::pre_start()
+    {
+        if (!m_downstream.empty()) {
+            m_downstream.tell(on_subscribe{}, self());
+        }
+    }
+    //-------------------------------------------------------
+
+    void stage::receive(yato::any && message)
+    {
+        if (m_finished) {
+            return;
+        }
+        if (message.is_type<on_next>()) {
+            // The most frequent message. Element is moved out.
+            if (m_requested > 0) {
+                --m_requested;
+            }
+            on_element_(std::move(message.get_unsafe<on_next>().element));
+            if (!m_finished) {
+                replenish_();
+            }
+            return;
+        }
+        yato::any_match(
+            [this](const request & req) {
+                m_demand += req.count;
+                drain_();
+                if (!m_finished) {
+                    on_demand_();
+                    replenish_();
+                }
+            },
+            [this](const on_subscribe &) {
+                m_upstream = sender();
+                replenish_();
+            },
+            [this](const on_complete &) {
+                m_upstream = actor_ref{};
+                on_upstream_complete_();
+            },
+            [this](const on_error & err) {
+                m_upstream = actor_ref{};
+                on_upstream_error_(err.reason);
+            },
+            [this](const cancel &) {
+                if (!m_upstream.empty()) {
+                    m_upstream.tell(cancel{}, self());
+                }
+                finish_();
+            },
+            [this, &message](yato::match_default_t) {
+                on_message_(message);
+            }
+        )(message);
+    }
+    //-------------------------------------------------------
+
+    void stage::on_element_(yato::any && element)
+    {
+        emit_(std::move(element));
+    }
+    //-------------------------------------------------------
+
+    void stage::on_upstream_complete_()
+    {
+        complete_();
+    }
+    //-------------------------------------------------------
+
+    void stage::on_upstream_error_(const std::string & reason)
+    {
+        if (!m_downstream.empty()) {
+            m_downstream.tell(on_error(reason), self());
+        }
+        finish_();
+    }
+    //-------------------------------------------------------
+
+    void stage::on_message_(yato::any & message)
+    {
+        log().warning("stage: Unknown message %s", message.type().name());
+    }
+    //-------------------------------------------------------
+
+    void stage::emit_(yato::any && element)
+    {
+        try {
+            for (const auto & op : m_ops) {
+                if (!op(element)) {
+                    return;
+                }
+            }
+        }
+        catch (std::exception & e) {
+            fail_(std::string("stage: Operation failed. ") + e.what());
+            return;
+        }
+        m_output.push_back(std::move(element));
+        drain_();
+    }
+    //-------------------------------------------------------
+
+    void stage::complete_()
+    {
+        m_completing = true;
+        drain_();
+    }
+    //-------------------------------------------------------
+
+    void stage::fail_(const std::string & reason)
+    {
+        log().error(reason);
+        if (!m_downstream.empty()) {
+            m_downstream.tell(on_error(reason), self());
+        }
+        if (!m_upstream.empty()) {
+            m_upstream.tell(cancel{}, self());
+        }
+        finish_();
+    }
+    //-------------------------------------------------------
+
+    void stage::replenish_()
+    {
+        if (m_upstream.empty() || m_completing) {
+            return;
+        }
+        const size_t in_flight = m_requested + pending_();
+        if (in_flight <= m_buffer_size / 2) {
+            const auto count = static_cast<uint32_t>(m_buffer_size - in_flight);
+            m_requested += count;
+            m_upstream.tell(request(count), self());
+        }
+    }
+    //-------------------------------------------------------
+
+    void stage::drain_()
+    {
+        if (m_finished) {
+            return;
+        }
+        while ((m_demand > 0) && !m_output.empty()) {
+            m_downstream.tell(on_next(std::move(m_output.front())), self());
+            m_output.pop_front();
+            --m_demand;
+        }
+        if (m_completing && m_output.empty()) {
+            if (!m_downstream.empty()) {
+                m_downstream.tell(on_complete{}, self());
+            }
+            finish_();
+        }
+    }
+    //-------------------------------------------------------
+
+    void stage::finish_()
+    {
+        if (!m_finished) {
+            m_finished = true;
+            self().stop();
+        }
+    }
+    //-------------------------------------------------------
+
+} // namespace streams
+
+} // namespace actors
+
+} // namespace yato
@@ -0,0 +1,531 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <algorithm>
+
+#include <yato/any_match.h>
+#include <yato/assertion.h>
+
+#include "../stream.h"
+#include "../../actor_system.h"
+#include "../../private/actor_system_ex.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace streams
+{
+
+    namespace
+    {
+
+        /**
+         * Calls generator while there is demand.
+         */
+        class generator_source
+            : public stage
+        {
+        private:
+            /**
+             * Elements are produced by chunks, letting other actors of the thread to run.
+             */
+            static constexpr uint32_t chunk_size = 256;
+
+            struct pull {};
+
+            generator m_generator;
+            bool m_pulling = false;
+            //-------------------------------------------------------
+
+            void produce_()
+            {
+                uint32_t produced = 0;
+                while ((demand() > 0) && (produced < chunk_size)) {
+                    yato::any element;
+                    try {
+                        if (!m_generator(element)) {
+                            complete_();
+                            return;
+                        }
+                    }
+                    catch (std::exception & e) {
+                        fail_(std::string("generator_source: Generator failed. ") + e.what());
+                        return;
+                    }
+                    emit_(std::move(element));
+                    ++produced;
+                }
+                if ((demand() > 0) && !m_pulling) {
+                    m_pulling = true;
+                    self().tell(pull{});
+                }
+            }
+
+            void on_demand_() override
+            {
+                if (!m_pulling) {
+                    produce_();
+                }
+            }
+
+            void on_message_(yato::any & message) override
+            {
+                if (message.is_type<pull>()) {
+                    m_pulling = false;
+                    produce_();
+                } else {
+                    stage::on_message_(message);
+                }
+            }
+
+        public:
+            generator_source(const stage_settings & settings, generator && gen)
+                : stage(settings), m_generator(std::move(gen))
+            { }
+        };
+        //-------------------------------------------------------
+
+        class consumer_sink
+            : public stage
+        {
+        private:
+            std::function<void(yato::any &&)> m_consumer;
+            std::function<void()> m_on_complete;
+            //-------------------------------------------------------
+
+            void on_element_(yato::any && element) override
+            {
+                try {
+                    m_consumer(std::move(element));
+                }
+                catch (std::exception & e) {
+                    fail_(std::string("consumer_sink: Consumer failed. ") + e.what());
+                }
+            }
+
+            void on_upstream_complete_() override
+            {
+                if (m_on_complete) {
+                    m_on_complete();
+                }
+                complete_();
+            }
+
+        public:
+            consumer_sink(const stage_settings & settings, std::function<void(yato::any &&)> && consumer, std::function<void()> && on_complete)
+                : stage(settings), m_consumer(std::move(consumer)), m_on_complete(std::move(on_complete))
+            { }
+        };
+        //-------------------------------------------------------
+
+        class actor_sink
+            : public stage
+        {
+        private:
+            actor_ref m_target;
+            //-------------------------------------------------------
+
+            void on_element_(yato::any && element) override
+            {
+                m_target.tell(std::move(element), self());
+            }
+
+            void on_upstream_complete_() override
+            {
+                m_target.tell(on_complete{}, self());
+                complete_();
+            }
+
+            void on_upstream_error_(const std::string & reason) override
+            {
+                m_target.tell(on_error(reason), self());
+                stage::on_upstream_error_(reason);
+            }
+
+        public:
+            actor_sink(const stage_settings & settings, const actor_ref & target)
+                : stage(settings), m_target(target)
+            { }
+        };
+        //-------------------------------------------------------
+
+        class batch_stage
+            : public stage
+        {
+        private:
+            struct flush
+            {
+                uint64_t generation;
+            };
+
+            uint32_t m_size;
+            timeout_type m_timeout;
+            batch_type m_current;
+            uint64_t m_generation = 0;
+            timer_handle m_timer;
+            //-------------------------------------------------------
+
+            void emit_batch_()
+            {
+                m_timer.cancel();
+                batch_type b;
+                b.reserve(m_size);
+                b.swap(m_current);
+                emit_(yato::any(std::move(b)));
+            }
+
+            void on_element_(yato::any && element) override
+            {
+                if (m_current.empty()) {
+                    ++m_generation;
+                    m_timer = schedule_once(m_timeout, flush{ m_generation });
+                }
+                m_current.push_back(std::move(element));
+                if (m_current.size() >= m_size) {
+                    emit_batch_();
+                }
+            }
+
+            void on_upstream_complete_() override
+            {
+                if (!m_current.empty()) {
+                    emit_batch_();
+                }
+                complete_();
+            }
+
+            void on_message_(yato::any & message) override
+            {
+                if (message.is_type<flush>()) {
+                    if ((message.get_unsafe<flush>().generation == m_generation) && !m_current.empty()) {
+                        emit_batch_();
+                        replenish_();
+                    }
+                } else {
+                    stage::on_message_(message);
+                }
+            }
+
+            size_t pending_() const override
+            {
+                return stage::pending_() * m_size + m_current.size();
+            }
+
+        public:
+            batch_stage(const stage_settings & settings, uint32_t size, const timeout_type & timeout)
+                : stage(settings), m_size(size), m_timeout(timeout)
+            {
+                m_current.reserve(m_size);
+            }
+        };
+        //-------------------------------------------------------
+
+        class throttle_stage
+            : public stage
+        {
+        private:
+            struct tick {};
+
+            uint32_t m_elements;
+            timeout_type m_period;
+            uint32_t m_tokens = 0;
+            std::deque<yato::any> m_waiting;
+            bool m_upstream_done = false;
+            //-------------------------------------------------------
+
+            void release_()
+            {
+                while ((m_tokens > 0) && !m_waiting.empty()) {
+                    --m_tokens;
+                    yato::any element = std::move(m_waiting.front());
+                    m_waiting.pop_front();
+                    emit_(std::move(element));
+                }
+                if (m_upstream_done && m_waiting.empty()) {
+                    complete_();
+                }
+            }
+
+            void pre_start() override
+            {
+                stage::pre_start();
+                m_tokens = m_elements;
+                schedule_periodic(m_period, tick{});
+            }
+
+            void on_element_(yato::any && element) override
+            {
+                m_waiting.push_back(std::move(element));
+                release_();
+            }
+
+            void on_upstream_complete_() override
+            {
+                m_upstream_done = true;
+                release_();
+            }
+
+            void on_message_(yato::any & message) override
+            {
+                if (message.is_type<tick>()) {
+                    m_tokens = m_elements;
+                    release_();
+                    replenish_();
+                } else {
+                    stage::on_message_(message);
+                }
+            }
+
+            size_t pending_() const override
+            {
+                return stage::pending_() + m_waiting.size();
+            }
+
+        public:
+            throttle_stage(const stage_settings & settings, uint32_t elements, const timeout_type & period)
+                : stage(settings), m_elements(elements), m_period(period)
+            { }
+        };
+        //-------------------------------------------------------
+
+        /**
+         * Owns stages of a running stream.
+         */
+        class stream_supervisor
+            : public basic_actor
+        {
+        private:
+            struct entry
+            {
+                stage_factory factory;
+                stage_settings settings;
+            };
+
+            std::vector<entry> m_entries;
+            actor_ref m_sink;
+            //-------------------------------------------------------
+
+            void pre_start() override
+            {
+                // Stages are created from the sink, so that every stage knows its downstream
+                actor_ref downstream;
+                for (size_t i = m_entries.size(); i > 0; --i) {
+                    auto & e = m_entries[i - 1];
+                    e.settings.downstream = downstream;
+                    const auto & factory  = e.factory;
+                    const auto & settings = e.settings;
+                    downstream = actor_system_ex::create_actor(system(), self(), "stage_" + std::to_string(i - 1),
+                        actors::details::cell_builder([&factory, &settings] { return factory(settings); }));
+                    if (downstream.empty()) {
+                        log().error("stream_supervisor: Failed to create stage %d", static_cast<int>(i - 1));
+                        self().stop();
+                        return;
+                    }
+                    if (m_sink.empty()) {
+                        m_sink = downstream;
+                        watch(m_sink);
+                    }
+                }
+                m_entries.clear();
+            }
+
+            void receive(yato::any && message) override
+            {
+                yato::any_match(
+                    [this](const terminated & t) {
+                        if (t.ref == m_sink) {
+                            self().stop();
+                        }
+                    },
+                    [this](yato::match_default_t) {
+                        log().warning("stream_supervisor: Unknown message");
+                    }
+                )(message);
+            }
+
+        public:
+            explicit
+            stream_supervisor(std::vector<entry> && entries)
+                : m_entries(std::move(entries))
+            { }
+
+            template <typename Stages_>
+            static
+            std::vector<entry> make_entries(const Stages_ & stages, const stage_factory & sink, uint32_t buffer_size)
+            {
+                std::vector<entry> entries;
+                entries.reserve(stages.size() + 1);
+                for (const auto & s : stages) {
+                    stage_settings settings;
+                    settings.ops = s.ops;
+                    settings.buffer_size = buffer_size;
+                    entries.push_back(entry{ s.factory, std::move(settings) });
+                }
+                stage_settings sink_settings;
+                sink_settings.buffer_size = buffer_size;
+                entries.push_back(entry{ sink, std::move(sink_settings) });
+                return entries;
+            }
+        };
+
+    } // namespace
+
+    //-------------------------------------------------------
+
+    namespace details
+    {
+        stage_factory make_generator_source(generator gen)
+        {
+            return [gen](const stage_settings & settings) {
+                generator g = gen;
+                return std::unique_ptr<basic_actor>(new generator_source(settings, std::move(g)));
+            };
+        }
+
+        stage_factory make_consumer_sink(std::function<void(yato::any &&)> consumer, std::function<void()> on_complete)
+        {
+            return [consumer, on_complete](const stage_settings & settings) {
+                auto c = consumer;
+                auto f = on_complete;
+                return std::unique_ptr<basic_actor>(new consumer_sink(settings, std::move(c), std::move(f)));
+            };
+        }
+    }
+    //-------------------------------------------------------
+
+    stage_factory ignore()
+    {
+        return details::make_consumer_sink([](yato::any &&) {}, nullptr);
+    }
+    //-------------------------------------------------------
+
+    stage_factory to_actor(const actor_ref & target)
+    {
+        return [target](const stage_settings & settings) {
+            return std::unique_ptr<basic_actor>(new actor_sink(settings, target));
+        };
+    }
+    //-------------------------------------------------------
+
+    stream::stream(stage_factory && source)
+    {
+        m_stages.push_back(stage_entry{ std::move(source), {} });
+    }
+    //-------------------------------------------------------
+
+    stream::~stream() = default;
+
+    stream::stream(const stream&) = default;
+    stream::stream(stream&&) noexcept = default;
+
+    stream& stream::operator=(const stream&) = default;
+    stream& stream::operator=(stream&&) noexcept = default;
+    //-------------------------------------------------------
+
+    stream stream::from(stage_factory source)
+    {
+        if (!source) {
+            throw yato::argument_error("stream: Source factory is empty.");
+        }
+        return stream(std::move(source));
+    }
+    //-------------------------------------------------------
+
+    stream stream::generate(generator gen)
+    {
+        if (!gen) {
+            throw yato::argument_error("stream: Generator is empty.");
+        }
+        return stream(details::make_generator_source(std::move(gen)));
+    }
+    //-------------------------------------------------------
+
+    stream & stream::add_op_(element_op && op)
+    {
+        m_stages.back().ops.push_back(std::move(op));
+        return *this;
+    }
+    //-------------------------------------------------------
+
+    stream & stream::via(stage_factory flow)
+    {
+        if (!flow) {
+            throw yato::argument_error("stream: Stage factory is empty.");
+        }
+        m_stages.push_back(stage_entry{ std::move(flow), {} });
+        return *this;
+    }
+    //-------------------------------------------------------
+
+    stream & stream::async()
+    {
+        return via([](const stage_settings & settings) {
+            return std::unique_ptr<basic_actor>(new stage(settings));
+        });
+    }
+    //-------------------------------------------------------
+
+    stream & stream::batch_impl_(uint32_t size, const timeout_type & timeout)
+    {
+        if (size == 0) {
+            throw yato::argument_error("stream: Batch size must be positive.");
+        }
+        return via([size, timeout](const stage_settings & settings) {
+            // Stage should be able to request at least one full batch
+            stage_settings s = settings;
+            s.buffer_size = std::max<uint32_t>(s.buffer_size, 2 * size);
+            return std::unique_ptr<basic_actor>(new batch_stage(s, size, timeout));
+        });
+    }
+    //-------------------------------------------------------
+
+    stream & stream::throttle_impl_(uint32_t elements, const timeout_type & period)
+    {
+        if (elements == 0) {
+            throw yato::argument_error("stream: Throttle rate must be positive.");
+        }
+        return via([elements, period](const stage_settings & settings) {
+            return std::unique_ptr<basic_actor>(new throttle_stage(settings, elements, period));
+        });
+    }
+    //-------------------------------------------------------
+
+    stream & stream::buffer_size(uint32_t size)
+    {
+        if (size == 0) {
+            throw yato::argument_error("stream: Buffer size must be positive.");
+        }
+        m_buffer_size = size;
+        return *this;
+    }
+    //-------------------------------------------------------
+
+    stream & stream::to(stage_factory sink)
+    {
+        if (!sink) {
+            throw yato::argument_error("stream: Sink factory is empty.");
+        }
+        m_sink = std::move(sink);
+        return *this;
+    }
+    //-------------------------------------------------------
+
+    actor_ref stream::run(actor_system & system, const std::string & name) const
+    {
+        if (!m_sink) {
+            throw yato::argument_error("stream: Sink is not set.");
+        }
+        return system.create_actor<stream_supervisor>(name, stream_supervisor::make_entries(m_stages, m_sink, m_buffer_size));
+    }
+    //-------------------------------------------------------
+
+} // namespace streams
+
+} // namespace actors
+
+} // namespace yato
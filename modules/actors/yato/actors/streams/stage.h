@@ -0,0 +1,229 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_STREAMS_STAGE_H_
+#define _YATO_ACTORS_STREAMS_STAGE_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <yato/any.h>
+
+#include "../actor.h"
+
+namespace yato
+{
+namespace actors
+{
+namespace streams
+{
+
+    //-------------------------------------------------------
+    // Protocol between stages
+
+    /**
+     * Is sent by a stage to its downstream before any other message. Sender is the upstream stage.
+     */
+    struct on_subscribe {};
+
+    /**
+     * Downstream is ready to receive `count` more elements.
+     */
+    struct request
+    {
+        uint32_t count;
+
+        explicit
+        request(uint32_t count)
+            : count(count)
+        { }
+    };
+
+    /**
+     * Downstream doesn't need elements anymore.
+     */
+    struct cancel {};
+
+    struct on_next
+    {
+        yato::any element;
+
+        explicit
+        on_next(yato::any && element)
+            : element(std::move(element))
+        { }
+    };
+
+    struct on_complete {};
+
+    struct on_error
+    {
+        std::string reason;
+
+        explicit
+        on_error(const std::string & reason)
+            : reason(reason)
+        { }
+    };
+    //-------------------------------------------------------
+
+    /**
+     * Stateless element operation, fused into a stage.
+     * @return false if the element should be dropped.
+     */
+    using element_op = std::function<bool(yato::any &)>;
+
+    /**
+     * Parameters of a stage, given on materialization.
+     */
+    struct stage_settings
+    {
+        /**
+         * Next stage. Empty for sinks.
+         */
+        actor_ref downstream;
+
+        /**
+         * Operations applied to every element before it is sent downstream.
+         */
+        std::vector<element_op> ops;
+
+        /**
+         * Maximal number of elements requested from upstream and kept in the output buffer.
+         */
+        uint32_t buffer_size = 64;
+    };
+
+    /**
+     * Creates stage actor.
+     */
+    using stage_factory = std::function<std::unique_ptr<basic_actor>(const stage_settings &)>;
+
+
+    /**
+     * Base class of stream stages.
+     * Elements are requested from upstream only while there is space in the stage, and are sent downstream only on demand,
+     * so memory of a stream is bounded by buffer sizes of its stages.
+     * Derived stages implement on_element_() and call emit_() / complete_().
+     */
+    class stage
+        : public basic_actor
+    {
+    private:
+        actor_ref m_downstream;
+        actor_ref m_upstream;
+        std::vector<element_op> m_ops;
+        uint32_t m_buffer_size;
+
+        std::deque<yato::any> m_output;
+        uint64_t m_demand = 0;
+        uint32_t m_requested = 0;
+        bool m_completing = false;
+        bool m_finished = false;
+        //-------------------------------------------------------
+
+        void drain_();
+        void finish_();
+
+    protected:
+        /**
+         * Process an element from upstream.
+         */
+        virtual void on_element_(yato::any && element);
+
+        /**
+         * Upstream is completed.
+         */
+        virtual void on_upstream_complete_();
+
+        /**
+         * Upstream is failed. By default passes the error downstream and stops.
+         */
+        virtual void on_upstream_error_(const std::string & reason);
+
+        /**
+         * Downstream requested more elements.
+         */
+        virtual void on_demand_() { }
+
+        /**
+         * Handle messages, which are not a part of the stream protocol.
+         */
+        virtual void on_message_(yato::any & message);
+
+        /**
+         * Number of elements accepted by the stage, but not sent yet. Used for requesting new elements from upstream.
+         */
+        virtual size_t pending_() const
+        {
+            return m_output.size();
+        }
+
+        /**
+         * Apply fused operations and send element downstream.
+         */
+        void emit_(yato::any && element);
+
+        /**
+         * Complete the stream after all buffered elements are sent.
+         */
+        void complete_();
+
+        /**
+         * Stop the stream with an error.
+         */
+        void fail_(const std::string & reason);
+
+        /**
+         * Request elements from upstream up to the buffer size.
+         */
+        void replenish_();
+
+        const actor_ref & downstream() const
+        {
+            return m_downstream;
+        }
+
+        const actor_ref & upstream() const
+        {
+            return m_upstream;
+        }
+
+        uint32_t buffer_size() const
+        {
+            return m_buffer_size;
+        }
+
+        /**
+         * Number of elements, which can be sent downstream right now.
+         */
+        uint64_t demand() const
+        {
+            return (m_demand > m_output.size()) ? m_demand - m_output.size() : 0;
+        }
+
+        void pre_start() override;
+
+        void receive(yato::any && message) override;
+
+    public:
+        explicit
+        stage(const stage_settings & settings);
+
+        ~stage() override;
+    };
+
+} // namespace streams
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_STREAMS_STAGE_H_
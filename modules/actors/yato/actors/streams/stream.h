@@ -0,0 +1,228 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_STREAMS_STREAM_H_
+#define _YATO_ACTORS_STREAMS_STREAM_H_
+
+#include <chrono>
+#include <type_traits>
+
+#include "stage.h"
+
+namespace yato
+{
+namespace actors
+{
+
+    class actor_system;
+
+namespace streams
+{
+
+    /**
+     * Element type produced by stream::batch()
+     */
+    using batch_type = std::vector<yato::any>;
+
+    /**
+     * Produces the next element. Returns false if there are no more elements.
+     */
+    using generator = std::function<bool(yato::any &)>;
+
+    namespace details
+    {
+        stage_factory make_generator_source(generator gen);
+
+        stage_factory make_consumer_sink(std::function<void(yato::any &&)> consumer, std::function<void()> on_complete);
+    }
+
+
+    /**
+     * Description of a linear stream: source, stages and sink.
+     * Nothing is started until run() is called. Every stage is materialized as a child actor of a stream supervisor.
+     * Stateless operations (map, filter) are fused into the preceding stage and don't add message hops.
+     * Use async() to split a long chain of operations between actors.
+     */
+    class stream
+    {
+    private:
+        struct stage_entry
+        {
+            stage_factory factory;
+            std::vector<element_op> ops;
+        };
+
+        std::vector<stage_entry> m_stages;
+        stage_factory m_sink;
+        uint32_t m_buffer_size = 64;
+        //-------------------------------------------------------
+
+        explicit
+        stream(stage_factory && source);
+
+        stream & add_op_(element_op && op);
+
+    public:
+        ~stream();
+
+        stream(const stream&);
+        stream(stream&&) noexcept;
+
+        stream& operator=(const stream&);
+        stream& operator=(stream&&) noexcept;
+
+        /**
+         * Start from a custom source stage.
+         */
+        static
+        stream from(stage_factory source);
+
+        /**
+         * Start from a generator function. The generator is called only when downstream has demand.
+         */
+        static
+        stream generate(generator gen);
+
+        /**
+         * Produces all elements of the vector.
+         */
+        template <typename Ty_>
+        static
+        stream from_vector(std::vector<Ty_> elements)
+        {
+            auto data = std::make_shared<std::vector<Ty_>>(std::move(elements));
+            size_t idx = 0;
+            return generate([data, idx](yato::any & element) mutable {
+                if (idx >= data->size()) {
+                    return false;
+                }
+                element = yato::any((*data)[idx++]);
+                return true;
+            });
+        }
+
+        /**
+         * Produces integers in the range [first, last)
+         */
+        template <typename Ty_>
+        static
+        stream range(Ty_ first, Ty_ last)
+        {
+            static_assert(std::is_integral<Ty_>::value, "yato::actors::streams: range() expects integer type.");
+            return generate([first, last](yato::any & element) mutable {
+                if (first >= last) {
+                    return false;
+                }
+                element = yato::any(first++);
+                return true;
+            });
+        }
+
+        /**
+         * Transform elements of type Ty_. Is fused into the previous stage.
+         */
+        template <typename Ty_, typename Fn_>
+        stream & map(Fn_ && fn)
+        {
+            return add_op_([fn](yato::any & element) {
+                auto result = fn(element.get<Ty_>());
+                element = yato::any(std::move(result));
+                return true;
+            });
+        }
+
+        /**
+         * Drop elements of type Ty_ not satisfying the predicate. Is fused into the previous stage.
+         */
+        template <typename Ty_, typename Fn_>
+        stream & filter(Fn_ && pred)
+        {
+            return add_op_([pred](yato::any & element) {
+                return static_cast<bool>(pred(static_cast<const Ty_ &>(element.get<Ty_>())));
+            });
+        }
+
+        /**
+         * Add a custom stage.
+         */
+        stream & via(stage_factory flow);
+
+        /**
+         * Asynchronous boundary. Following operations are executed in a new actor.
+         */
+        stream & async();
+
+        /**
+         * Group elements into batch_type of the given size.
+         * An incomplete batch is emitted after the timeout since its first element.
+         */
+        template <typename Rep_, typename Period_>
+        stream & batch(uint32_t size, const std::chrono::duration<Rep_, Period_> & timeout)
+        {
+            return batch_impl_(size, std::chrono::duration_cast<timeout_type>(timeout));
+        }
+
+        /**
+         * Pass at most `elements` per the time period.
+         */
+        template <typename Rep_, typename Period_>
+        stream & throttle(uint32_t elements, const std::chrono::duration<Rep_, Period_> & period)
+        {
+            return throttle_impl_(elements, std::chrono::duration_cast<timeout_type>(period));
+        }
+
+        /**
+         * Buffer size of each stage. Limits the number of elements in flight.
+         */
+        stream & buffer_size(uint32_t size);
+
+        /**
+         * Set the final stage.
+         */
+        stream & to(stage_factory sink);
+
+        /**
+         * Materialize the stream.
+         * @return stream supervisor actor. It stops when the sink stops. Sending poison_pill to it cancels the stream.
+         */
+        actor_ref run(actor_system & system, const std::string & name) const;
+
+    private:
+        stream & batch_impl_(uint32_t size, const timeout_type & timeout);
+        stream & throttle_impl_(uint32_t elements, const timeout_type & period);
+    };
+
+
+    /**
+     * Sink calling the consumer for every element of type Ty_.
+     */
+    template <typename Ty_, typename Fn_>
+    stage_factory for_each(Fn_ && consumer, std::function<void()> on_complete = nullptr)
+    {
+        return details::make_consumer_sink([consumer](yato::any && element) mutable {
+            consumer(element.get<Ty_>());
+        }, std::move(on_complete));
+    }
+
+    /**
+     * Sink dropping all elements.
+     */
+    stage_factory ignore();
+
+    /**
+     * Sink forwarding elements to an actor as plain messages, followed by on_complete or on_error.
+     * The target actor doesn't take part in the demand signalling.
+     */
+    stage_factory to_actor(const actor_ref & target);
+
+} // namespace streams
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_STREAMS_STREAM_H_
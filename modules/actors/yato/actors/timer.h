@@ -0,0 +1,103 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#ifndef _YATO_ACTORS_TIMER_H_
+#define _YATO_ACTORS_TIMER_H_
+
+#include <atomic>
+#include <memory>
+
+#include <yato/any.h>
+
+namespace yato
+{
+namespace actors
+{
+
+    namespace details
+    {
+        struct timer_state
+        {
+            /**
+             * Is set by cancel() or after the last firing
+             */
+            std::atomic<bool> finished{ false };
+
+            /**
+             * Is set by cancel() only. Messages of a cancelled timer are dropped by the receiving actor.
+             */
+            std::atomic<bool> cancelled{ false };
+        };
+
+        /**
+         * Message sent by an actor timer. Is unwrapped by the actor before receive().
+         */
+        struct timer_message
+        {
+            std::shared_ptr<timer_state> state;
+            yato::any payload;
+        };
+    }
+
+    /**
+     * Handle of a scheduled message.
+     * Can be copied and used from any thread.
+     */
+    class timer_handle
+    {
+    private:
+        std::shared_ptr<details::timer_state> m_state;
+
+    public:
+        timer_handle() = default;
+
+        explicit
+        timer_handle(const std::shared_ptr<details::timer_state> & state)
+            : m_state(state)
+        { }
+
+        ~timer_handle() = default;
+
+        timer_handle(const timer_handle&) = default;
+        timer_handle(timer_handle&&) = default;
+
+        timer_handle& operator=(const timer_handle&) = default;
+        timer_handle& operator=(timer_handle&&) = default;
+
+        /**
+         * Stop the timer. Messages of the timer, which are already in the mailbox or are being sent, are discarded,
+         * so the actor doesn't receive them after cancel() returns.
+         * @return true if the timer was active
+         */
+        bool cancel() const
+        {
+            if (m_state == nullptr) {
+                return false;
+            }
+            m_state->cancelled.store(true, std::memory_order_release);
+            return !m_state->finished.exchange(true);
+        }
+
+        /**
+         * Check if the timer can fire again
+         */
+        bool is_active() const
+        {
+            return (m_state != nullptr) && !m_state->finished.load();
+        }
+
+        bool empty() const
+        {
+            return m_state == nullptr;
+        }
+    };
+
+} // namespace actors
+
+} // namespace yato
+
+#endif // _YATO_ACTORS_TIMER_H_
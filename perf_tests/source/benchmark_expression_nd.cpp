@@ -0,0 +1,101 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <yato/expression_nd.h>
+
+
+/**
+ * Reference: one temporary per operation
+ */
+void ExpressionND_Temporaries(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const yato::vector_2d<float> a(yato::dims(size, size), 1.0f);
+    const yato::vector_2d<float> b(yato::dims(size, size), 2.0f);
+    const float k = 3.0f;
+    yato::vector_2d<float> c(yato::dims(size, size));
+
+    for (auto _ : state) {
+        yato::vector_2d<float> tmp(yato::dims(size, size));
+        for (size_t y = 0; y < size; ++y) {
+            for (size_t x = 0; x < size; ++x) {
+                tmp[y][x] = a[y][x] * k;
+            }
+        }
+        for (size_t y = 0; y < size; ++y) {
+            for (size_t x = 0; x < size; ++x) {
+                c[y][x] = tmp[y][x] + b[y][x];
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(c.total_size()));
+}
+BENCHMARK(ExpressionND_Temporaries)->Arg(256)->Arg(2048);
+
+
+/**
+ * Reference: hand-written fused loop
+ */
+void ExpressionND_FusedLoop(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const yato::vector_2d<float> a(yato::dims(size, size), 1.0f);
+    const yato::vector_2d<float> b(yato::dims(size, size), 2.0f);
+    const float k = 3.0f;
+    yato::vector_2d<float> c(yato::dims(size, size));
+
+    for (auto _ : state) {
+        const float* pa = a.cdata();
+        const float* pb = b.cdata();
+        float* pc = c.data();
+        for (size_t i = 0; i < c.total_size(); ++i) {
+            pc[i] = pa[i] * k + pb[i];
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(c.total_size()));
+}
+BENCHMARK(ExpressionND_FusedLoop)->Arg(256)->Arg(2048);
+
+
+void ExpressionND_Expression(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const yato::vector_2d<float> a(yato::dims(size, size), 1.0f);
+    const yato::vector_2d<float> b(yato::dims(size, size), 2.0f);
+    const float k = 3.0f;
+    yato::vector_2d<float> c(yato::dims(size, size));
+
+    for (auto _ : state) {
+        c = a * k + b;
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(c.total_size()));
+}
+BENCHMARK(ExpressionND_Expression)->Arg(256)->Arg(2048);
+
+
+void ExpressionND_ExpressionStrided(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const yato::vector_2d<float> a(yato::dims(size, size), 1.0f);
+    const yato::vector_2d<float> b(yato::dims(size, size), 2.0f);
+    const float k = 3.0f;
+    // Padded rows
+    yato::vector_1d<float> storage(size * (size + 16));
+    yato::array_view_2d<float> c(storage.data(), yato::dims(size, size), yato::dims(size + 16));
+
+    for (auto _ : state) {
+        c = a * k + b;
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(c.total_size()));
+}
+BENCHMARK(ExpressionND_ExpressionStrided)->Arg(256)->Arg(2048);
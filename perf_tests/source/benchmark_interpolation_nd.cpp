@@ -0,0 +1,131 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+
+#include <yato/interpolation_nd.h>
+#include <yato/vector_nd.h>
+
+namespace
+{
+    const size_t image_size = 512;
+
+    yato::vector_2d<float> make_image()
+    {
+        yato::vector_2d<float> img(yato::dims(image_size, image_size));
+        for (size_t y = 0; y < image_size; ++y) {
+            for (size_t x = 0; x < image_size; ++x) {
+                img[y][x] = static_cast<float>((x * 3 + y) % 17);
+            }
+        }
+        return img;
+    }
+
+    /**
+     * Rotated and scaled sampling grid, partially outside of the image
+     */
+    void make_coords(size_t row, std::vector<float> & ys, std::vector<float> & xs)
+    {
+        const float c = 0.94f;
+        const float s = 0.34f;
+        for (size_t x = 0; x < image_size; ++x) {
+            const float u = static_cast<float>(x) - 256.0f;
+            const float v = static_cast<float>(row) - 256.0f;
+            ys[x] = 256.0f + (s * u + c * v) * 1.05f;
+            xs[x] = 256.0f + (c * u - s * v) * 1.05f;
+        }
+    }
+}
+
+
+void Interpolation_Bilinear_Naive(benchmark::State& state)
+{
+    const auto img = make_image();
+    std::vector<float> ys(image_size), xs(image_size), dst(image_size);
+
+    for (auto _ : state) {
+        for (size_t row = 0; row < image_size; ++row) {
+            make_coords(row, ys, xs);
+            for (size_t x = 0; x < image_size; ++x) {
+                const int32_t y0 = static_cast<int32_t>(std::floor(ys[x]));
+                const int32_t x0 = static_cast<int32_t>(std::floor(xs[x]));
+                const float wy = ys[x] - static_cast<float>(y0);
+                const float wx = xs[x] - static_cast<float>(x0);
+                const float v00 = yato::load<yato::sampler_clamp>(img, y0, x0);
+                const float v01 = yato::load<yato::sampler_clamp>(img, y0, x0 + 1);
+                const float v10 = yato::load<yato::sampler_clamp>(img, y0 + 1, x0);
+                const float v11 = yato::load<yato::sampler_clamp>(img, y0 + 1, x0 + 1);
+                dst[x] = (v00 * (1.0f - wx) + v01 * wx) * (1.0f - wy) + (v10 * (1.0f - wx) + v11 * wx) * wy;
+            }
+            benchmark::DoNotOptimize(dst.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(image_size * image_size));
+}
+BENCHMARK(Interpolation_Bilinear_Naive);
+
+
+void Interpolation_Bilinear_Scalar(benchmark::State& state)
+{
+    const auto img = make_image();
+    std::vector<float> ys(image_size), xs(image_size), dst(image_size);
+
+    for (auto _ : state) {
+        for (size_t row = 0; row < image_size; ++row) {
+            make_coords(row, ys, xs);
+            for (size_t x = 0; x < image_size; ++x) {
+                dst[x] = yato::interpolate(img, ys[x], xs[x]);
+            }
+            benchmark::DoNotOptimize(dst.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(image_size * image_size));
+}
+BENCHMARK(Interpolation_Bilinear_Scalar);
+
+
+void Interpolation_Bilinear_Row(benchmark::State& state)
+{
+    const auto img = make_image();
+    std::vector<float> ys(image_size), xs(image_size), dst(image_size);
+
+    for (auto _ : state) {
+        for (size_t row = 0; row < image_size; ++row) {
+            make_coords(row, ys, xs);
+            yato::interpolate_row(img, dst.data(), image_size, ys.data(), xs.data());
+            benchmark::DoNotOptimize(dst.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(image_size * image_size));
+}
+BENCHMARK(Interpolation_Bilinear_Row);
+
+
+void Interpolation_Bilinear_RowFixed(benchmark::State& state)
+{
+    yato::vector_2d<uint8_t> img(yato::dims(image_size, image_size));
+    for (size_t y = 0; y < image_size; ++y) {
+        for (size_t x = 0; x < image_size; ++x) {
+            img[y][x] = static_cast<uint8_t>((x * 3 + y) % 251);
+        }
+    }
+    std::vector<float> ys(image_size), xs(image_size);
+    std::vector<uint8_t> dst(image_size);
+
+    for (auto _ : state) {
+        for (size_t row = 0; row < image_size; ++row) {
+            make_coords(row, ys, xs);
+            yato::interpolate_row<yato::sampler_linear_fixed<>>(img, dst.data(), image_size, ys.data(), xs.data());
+            benchmark::DoNotOptimize(dst.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(image_size * image_size));
+}
+BENCHMARK(Interpolation_Bilinear_RowFixed);
@@ -0,0 +1,134 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include <yato/io_nd.h>
+
+namespace
+{
+    std::string benchmark_file()
+    {
+        return (std::filesystem::temp_directory_path() / "yato_benchmark_io_nd.npy").string();
+    }
+
+    yato::vector_2d<float> make_source(size_t size)
+    {
+        yato::vector_2d<float> res(yato::dims(size, size));
+        float value = 0.0f;
+        for (auto it = res.plain_begin(); it != res.plain_end(); ++it) {
+            *it = (value += 0.5f);
+        }
+        return res;
+    }
+}
+
+/**
+ * Reference: element-wise binary writes
+ */
+void IoND_Iostream_Write(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const auto src = make_source(size);
+    const std::string path = benchmark_file();
+
+    for (auto _ : state) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        for (size_t y = 0; y < size; ++y) {
+            for (size_t x = 0; x < size; ++x) {
+                const float value = src[y][x];
+                file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+            }
+        }
+        file.flush();
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(src.total_size() * sizeof(float)));
+}
+BENCHMARK(IoND_Iostream_Write)->Arg(256)->Arg(4096);
+
+
+void IoND_WriteND(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const auto src = make_source(size);
+    const std::string path = benchmark_file();
+
+    for (auto _ : state) {
+        yato::io::write_nd(path, src);
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(src.total_size() * sizeof(float)));
+}
+BENCHMARK(IoND_WriteND)->Arg(256)->Arg(4096);
+
+
+/**
+ * Rows of a padded view are gathered into chunks
+ */
+void IoND_WriteND_Strided(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const auto storage = make_source(size + 1);
+    const yato::array_view_2d<const float> src(storage.cdata(), yato::dims(size, size), yato::dims(size + 1));
+    const std::string path = benchmark_file();
+
+    for (auto _ : state) {
+        yato::io::write_nd(path, src);
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(src.total_size() * sizeof(float)));
+}
+BENCHMARK(IoND_WriteND_Strided)->Arg(256)->Arg(4096);
+
+
+/**
+ * Reference: element-wise binary reads
+ */
+void IoND_Iostream_Read(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const std::string path = benchmark_file();
+    yato::io::write_nd(path, make_source(size));
+
+    for (auto _ : state) {
+        std::ifstream file(path, std::ios::binary);
+        file.seekg(128);
+        yato::vector_2d<float> dst(yato::dims(size, size));
+        for (size_t y = 0; y < size; ++y) {
+            for (size_t x = 0; x < size; ++x) {
+                float value;
+                file.read(reinterpret_cast<char*>(&value), sizeof(value));
+                dst[y][x] = value;
+            }
+        }
+        benchmark::DoNotOptimize(dst.data());
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size * size * sizeof(float)));
+}
+BENCHMARK(IoND_Iostream_Read)->Arg(256)->Arg(4096);
+
+
+void IoND_ReadND(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const std::string path = benchmark_file();
+    yato::io::write_nd(path, make_source(size));
+
+    for (auto _ : state) {
+        auto dst = yato::io::read_nd<float, 2>(path);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size * size * sizeof(float)));
+}
+BENCHMARK(IoND_ReadND)->Arg(256)->Arg(4096);
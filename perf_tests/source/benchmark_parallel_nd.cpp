@@ -0,0 +1,84 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <functional>
+#include <numeric>
+
+#include <benchmark/benchmark.h>
+
+#include <yato/array_view.h>
+#include <yato/parallel_nd.h>
+#include <yato/vector_nd.h>
+
+namespace
+{
+    yato::parallel_policy make_policy(benchmark::State& state)
+    {
+        yato::parallel_policy policy;
+        policy.threads = yato::narrow_cast<size_t>(state.range(1));
+        return policy;
+    }
+}
+
+/**
+ * Arguments: image size, number of threads.
+ */
+void ParallelND_Transform2D(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const auto policy = make_policy(state);
+
+    yato::vector_2d<float> src(yato::dims(size, size), 1.0f);
+    yato::vector_2d<float> dst(yato::dims(size, size));
+
+    for (auto _ : state) {
+        yato::transform_nd(policy, src, dst, [](float x) { return 2.0f * x + 1.0f; });
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(src.total_size()));
+}
+BENCHMARK(ParallelND_Transform2D)
+    ->ArgsProduct({ { 256, 2048 }, { 1, 2, 4, 8 } })
+    ->UseRealTime();
+
+
+void ParallelND_ForEach3D_Strided(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const auto policy = make_policy(state);
+
+    // Padded rows
+    yato::vector_1d<int32_t> storage(size * size * (size + 3), 0);
+    yato::array_view_3d<int32_t> view(storage.data(), yato::dims(size, size, size), yato::dims(size, size + 3));
+
+    for (auto _ : state) {
+        yato::for_each_nd(policy, view, [](int32_t & x) { ++x; });
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(view.total_size()));
+}
+BENCHMARK(ParallelND_ForEach3D_Strided)
+    ->ArgsProduct({ { 64, 256 }, { 1, 2, 4, 8 } })
+    ->UseRealTime();
+
+
+void ParallelND_Reduce3D(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const auto policy = make_policy(state);
+
+    yato::vector_3d<int64_t> vec(yato::dims(size, size, size));
+    std::iota(vec.plain_begin(), vec.plain_end(), 0);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(yato::reduce_nd(policy, vec, int64_t(0), std::plus<int64_t>{}));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(vec.total_size()));
+}
+BENCHMARK(ParallelND_Reduce3D)
+    ->ArgsProduct({ { 64, 256 }, { 1, 2, 4, 8 } })
+    ->UseRealTime();
@@ -238,3 +238,83 @@ BENCHMARK_TEMPLATE(Fetch3D_Yato, yato::sampler_no_check)->Arg(1)->Arg(1000)->Arg
 BENCHMARK_TEMPLATE(Fetch3D_Yato, yato::sampler_clamp)->Arg(1)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
 BENCHMARK_TEMPLATE(Fetch3D_Yato, yato::sampler_zero)->Arg(1)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
 
+
+
+/**
+ * Strided view over a buffer with padded rows
+ */
+template <typename Sampler_>
+void Fetch2D_Yato_Strided(benchmark::State& state)
+{
+    static const int RND_SEED = 3;
+    std::srand(RND_SEED);
+
+    const auto N = yato::narrow_cast<typename Sampler_::index_type>(state.range(0));
+
+    size_t S0 = yato::narrow_cast<size_t>(10 + rand() % 2);
+    size_t S1 = yato::narrow_cast<size_t>(10 + rand() % 2);
+    benchmark::DoNotOptimize(S0);
+    benchmark::DoNotOptimize(S1);
+    yato::vector_2d<int32_t> storage(yato::dims(S0, S1 + 5));
+    std::generate(storage.plain_begin(), storage.plain_end(), std::rand);
+    const yato::array_view_2d<const int32_t> view(storage.cdata(), yato::dims(S0, S1), yato::dims(S1 + 5));
+
+    auto i0 = yato::narrow_cast<typename Sampler_::index_type>(rand() % (S0 - 3));
+    auto i1 = yato::narrow_cast<typename Sampler_::index_type>(rand() % (S1 - 3));
+    benchmark::DoNotOptimize(i0);
+    benchmark::DoNotOptimize(i1);
+
+    int32_t sum = rand();
+    for (auto _ : state) {
+        for (typename Sampler_::index_type n = 0; n < N; ++n) {
+            sum &= yato::load<Sampler_>(view, i0 + (n & 0x1), i1 + (n & 0x3));
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+BENCHMARK_TEMPLATE(Fetch2D_Yato_Strided, yato::sampler_default)->Arg(1)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(Fetch2D_Yato_Strided, yato::sampler_no_check)->Arg(1)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(Fetch2D_Yato_Strided, yato::sampler_clamp)->Arg(1)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(Fetch2D_Yato_Strided, yato::sampler_zero)->Arg(1)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+
+
+template <typename Sampler_>
+void Fetch3D_Yato_Strided(benchmark::State& state)
+{
+    static const int RND_SEED = 3;
+    std::srand(RND_SEED);
+
+    const auto N = yato::narrow_cast<typename Sampler_::index_type>(state.range(0));
+
+    size_t S0 = yato::narrow_cast<size_t>(10 + rand() % 2);
+    size_t S1 = yato::narrow_cast<size_t>(10 + rand() % 2);
+    size_t S2 = yato::narrow_cast<size_t>(10 + rand() % 2);
+    benchmark::DoNotOptimize(S0);
+    benchmark::DoNotOptimize(S1);
+    benchmark::DoNotOptimize(S2);
+
+    yato::vector_3d<int32_t> storage(yato::dims(S0, S1, S2 + 5));
+    std::generate(storage.plain_begin(), storage.plain_end(), std::rand);
+    const yato::array_view_3d<const int32_t> view(storage.cdata(), yato::dims(S0, S1, S2), yato::dims(S1, S2 + 5));
+
+    auto i0 = yato::narrow_cast<typename Sampler_::index_type>(rand() % (S0 - 3));
+    auto i1 = yato::narrow_cast<typename Sampler_::index_type>(rand() % (S1 - 3));
+    auto i2 = yato::narrow_cast<typename Sampler_::index_type>(rand() % (S2 - 3));
+    benchmark::DoNotOptimize(i0);
+    benchmark::DoNotOptimize(i1);
+    benchmark::DoNotOptimize(i2);
+
+    int32_t sum = rand();
+    for (auto _ : state) {
+        for (typename Sampler_::index_type n = 0; n < N; ++n) {
+            sum &= yato::load<Sampler_>(view, i0 + (n & 0x1), i1 + (n & 0x2), i2 + (n & 0x3));
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+BENCHMARK_TEMPLATE(Fetch3D_Yato_Strided, yato::sampler_default)->Arg(1)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(Fetch3D_Yato_Strided, yato::sampler_no_check)->Arg(1)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(Fetch3D_Yato_Strided, yato::sampler_clamp)->Arg(1)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
+BENCHMARK_TEMPLATE(Fetch3D_Yato_Strided, yato::sampler_zero)->Arg(1)->Arg(1000)->Arg(10000)->Arg(100000)->Arg(1000000);
@@ -0,0 +1,129 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <algorithm>
+
+#include <benchmark/benchmark.h>
+
+#include <yato/simd_nd.h>
+#include <yato/vector_nd.h>
+
+namespace
+{
+    /**
+     * Selects instruction set for the benchmark scope. Skips if not supported.
+     */
+    class isa_scope
+    {
+        yato::simd::isa m_previous;
+
+    public:
+        isa_scope(benchmark::State& state, int64_t set)
+        {
+            const auto requested = static_cast<yato::simd::isa>(set);
+            m_previous = yato::simd::set_active_isa(requested);
+            if (yato::simd::active_isa() != requested) {
+                state.SkipWithError("Instruction set is not supported");
+            }
+            state.SetLabel(yato::simd::isa_name(requested));
+        }
+
+        ~isa_scope()
+        {
+            yato::simd::set_active_isa(m_previous);
+        }
+    };
+
+    const std::vector<int64_t> all_isa = { 0, 1, 2, 3 };
+}
+
+/**
+ * Reference: plain loop over proxies
+ */
+void SimdND_Add_Loop(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    yato::vector_2d<float> a(yato::dims(size, size), 1.0f);
+    yato::vector_2d<float> b(yato::dims(size, size), 2.0f);
+    yato::vector_2d<float> dst(yato::dims(size, size));
+
+    for (auto _ : state) {
+        for (size_t y = 0; y < size; ++y) {
+            for (size_t x = 0; x < size; ++x) {
+                dst[y][x] = a[y][x] + b[y][x];
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(dst.total_size()));
+}
+BENCHMARK(SimdND_Add_Loop)->Arg(256)->Arg(1024);
+
+
+void SimdND_Add(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    yato::vector_2d<float> a(yato::dims(size, size), 1.0f);
+    yato::vector_2d<float> b(yato::dims(size, size), 2.0f);
+    yato::vector_2d<float> dst(yato::dims(size, size));
+
+    isa_scope scope(state, state.range(1));
+    for (auto _ : state) {
+        yato::simd::add(a, b, dst);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(dst.total_size()));
+}
+BENCHMARK(SimdND_Add)->ArgsProduct({ { 256, 1024 }, all_isa });
+
+
+void SimdND_ConvertToU8(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    yato::vector_2d<float> src(yato::dims(size, size), 127.4f);
+    yato::vector_2d<uint8_t> dst(yato::dims(size, size));
+
+    isa_scope scope(state, state.range(1));
+    for (auto _ : state) {
+        yato::simd::convert(src, dst);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(dst.total_size()));
+}
+BENCHMARK(SimdND_ConvertToU8)->ArgsProduct({ { 256, 1024 }, all_isa });
+
+
+/**
+ * Reference: cached stores
+ */
+void SimdND_Fill_STL(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    yato::vector_2d<float> dst(yato::dims(size, size));
+
+    for (auto _ : state) {
+        std::fill(dst.plain_begin(), dst.plain_end(), 1.0f);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(dst.total_size() * sizeof(float)));
+}
+BENCHMARK(SimdND_Fill_STL)->Arg(4096);
+
+
+void SimdND_Fill(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    yato::vector_2d<float> dst(yato::dims(size, size));
+
+    isa_scope scope(state, state.range(1));
+    for (auto _ : state) {
+        yato::simd::fill(dst, 1.0f);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(dst.total_size() * sizeof(float)));
+}
+BENCHMARK(SimdND_Fill)->ArgsProduct({ { 4096 }, all_isa });
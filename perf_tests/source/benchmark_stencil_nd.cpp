@@ -0,0 +1,118 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <yato/stencil_nd.h>
+
+namespace
+{
+    yato::vector_2d<float> make_image(size_t size)
+    {
+        yato::vector_2d<float> res(yato::dims(size, size));
+        for (size_t y = 0; y < size; ++y) {
+            for (size_t x = 0; x < size; ++x) {
+                res[y][x] = static_cast<float>((x * 7 + y * 3) % 31);
+            }
+        }
+        return res;
+    }
+
+    yato::vector_2d<float> make_kernel(size_t size)
+    {
+        return yato::vector_2d<float>(yato::dims(size, size), 1.0f / static_cast<float>(size * size));
+    }
+
+    yato::parallel_policy serial_policy()
+    {
+        yato::parallel_policy policy;
+        policy.threads = 1;
+        return policy;
+    }
+}
+
+/**
+ * Reference: every tap goes through the sampler
+ */
+void StencilND_Naive_Clamp(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const size_t ksize = yato::narrow_cast<size_t>(state.range(1));
+    const auto src = make_image(size);
+    const auto kernel = make_kernel(ksize);
+    yato::vector_2d<float> dst(src.dimensions());
+    const int32_t anchor = static_cast<int32_t>(ksize / 2);
+
+    for (auto _ : state) {
+        for (size_t y = 0; y < size; ++y) {
+            for (size_t x = 0; x < size; ++x) {
+                float acc = 0.0f;
+                for (size_t ky = 0; ky < ksize; ++ky) {
+                    for (size_t kx = 0; kx < ksize; ++kx) {
+                        acc += kernel[ky][kx] * yato::load<yato::sampler_clamp>(src, static_cast<int32_t>(y + ky) - anchor, static_cast<int32_t>(x + kx) - anchor);
+                    }
+                }
+                dst[y][x] = acc;
+            }
+        }
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size * size));
+}
+BENCHMARK(StencilND_Naive_Clamp)->Args({ 1024, 3 })->Args({ 1024, 7 });
+
+
+void StencilND_Dense_Clamp(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const size_t ksize = yato::narrow_cast<size_t>(state.range(1));
+    const auto src = make_image(size);
+    const auto kernel = make_kernel(ksize);
+    yato::vector_2d<float> dst(src.dimensions());
+
+    for (auto _ : state) {
+        yato::stencil_nd(serial_policy(), yato::sampler_clamp{}, src, dst, kernel);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size * size));
+}
+BENCHMARK(StencilND_Dense_Clamp)->Args({ 1024, 3 })->Args({ 1024, 7 });
+
+
+void StencilND_Dense_Clamp_Parallel(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const size_t ksize = yato::narrow_cast<size_t>(state.range(1));
+    const auto src = make_image(size);
+    const auto kernel = make_kernel(ksize);
+    yato::vector_2d<float> dst(src.dimensions());
+
+    for (auto _ : state) {
+        yato::stencil_nd(yato::sampler_clamp{}, src, dst, kernel);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size * size));
+}
+BENCHMARK(StencilND_Dense_Clamp_Parallel)->Args({ 1024, 3 })->Args({ 1024, 7 })->UseRealTime();
+
+
+void StencilND_Separable_Clamp(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    const size_t ksize = yato::narrow_cast<size_t>(state.range(1));
+    const auto src = make_image(size);
+    const std::vector<float> weights(ksize, 1.0f / static_cast<float>(ksize));
+    const std::array<std::vector<float>, 2> kernels = { weights, weights };
+    yato::vector_2d<float> dst(src.dimensions());
+
+    for (auto _ : state) {
+        yato::stencil_separable_nd(serial_policy(), yato::sampler_clamp{}, src, dst, kernels);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size * size));
+}
+BENCHMARK(StencilND_Separable_Clamp)->Args({ 1024, 3 })->Args({ 1024, 7 });
@@ -0,0 +1,139 @@
+/**
+* YATO library
+*
+* Apache License, Version 2.0
+* Copyright (c) 2016-2020 Alexey Gruzdev
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <yato/tiled_vector_nd.h>
+#include <yato/vector_nd.h>
+
+namespace
+{
+    using tiled_type = yato::tiled_vector_2d<float, 16, 16>;
+
+    template <typename Container_>
+    void fill_ramp(Container_ & c, size_t size)
+    {
+        for (size_t y = 0; y < size; ++y) {
+            for (size_t x = 0; x < size; ++x) {
+                c[y][x] = static_cast<float>((x + y) % 17);
+            }
+        }
+    }
+
+    template <typename Container_>
+    float column_sum(const Container_ & c, size_t size)
+    {
+        float sum = 0.0f;
+        for (size_t x = 0; x < size; ++x) {
+            for (size_t y = 0; y < size; ++y) {
+                sum += c[y][x];
+            }
+        }
+        return sum;
+    }
+
+    template <typename Container_>
+    float box3x3(const Container_ & c, size_t size)
+    {
+        float sum = 0.0f;
+        for (size_t y = 1; y + 1 < size; ++y) {
+            for (size_t x = 1; x + 1 < size; ++x) {
+                float acc = 0.0f;
+                for (size_t dy = 0; dy < 3; ++dy) {
+                    for (size_t dx = 0; dx < 3; ++dx) {
+                        acc += c[y + dy - 1][x + dx - 1];
+                    }
+                }
+                sum += acc;
+            }
+        }
+        return sum;
+    }
+}
+
+
+void TiledVectorND_ColumnTraversal_VectorND(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    yato::vector_2d<float> v(yato::dims(size, size));
+    fill_ramp(v, size);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(column_sum(v, size));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size * size));
+}
+BENCHMARK(TiledVectorND_ColumnTraversal_VectorND)->Arg(512)->Arg(4096);
+
+
+void TiledVectorND_ColumnTraversal_Tiled(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    tiled_type v(yato::dims(size, size));
+    fill_ramp(v, size);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(column_sum(v, size));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size * size));
+}
+BENCHMARK(TiledVectorND_ColumnTraversal_Tiled)->Arg(512)->Arg(4096);
+
+
+void TiledVectorND_Stencil3x3_VectorND(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    yato::vector_2d<float> v(yato::dims(size, size));
+    fill_ramp(v, size);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(box3x3(v, size));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size * size));
+}
+BENCHMARK(TiledVectorND_Stencil3x3_VectorND)->Arg(512)->Arg(4096);
+
+
+void TiledVectorND_Stencil3x3_Tiled(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    tiled_type v(yato::dims(size, size));
+    fill_ramp(v, size);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(box3x3(v, size));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size * size));
+}
+BENCHMARK(TiledVectorND_Stencil3x3_Tiled)->Arg(512)->Arg(4096);
+
+
+/**
+ * Cache-blocked column sum: each tile is reduced while it is resident in L1
+ */
+void TiledVectorND_ColumnTraversal_TiledBlocked(benchmark::State& state)
+{
+    const size_t size = yato::narrow_cast<size_t>(state.range(0));
+    tiled_type v(yato::dims(size, size));
+    fill_ramp(v, size);
+    std::vector<float> columns(size);
+
+    for (auto _ : state) {
+        std::fill(columns.begin(), columns.end(), 0.0f);
+        v.for_each_tile([&columns](const yato::dimensionality<2, size_t> & origin, const yato::array_view_2d<const float> & tile) {
+            for (size_t y = 0; y < tile.size(0); ++y) {
+                const float* row = &tile[y][0];
+                for (size_t x = 0; x < tile.size(1); ++x) {
+                    columns[origin[1] + x] += row[x];
+                }
+            }
+        });
+        benchmark::DoNotOptimize(columns.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(size * size));
+}
+BENCHMARK(TiledVectorND_ColumnTraversal_TiledBlocked)->Arg(512)->Arg(4096);
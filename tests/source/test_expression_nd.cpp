@@ -0,0 +1,106 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include <yato/expression_nd.h>
+
+TEST(Yato_ExpressionND, arithmetic)
+{
+    yato::vector_2d<float> a(yato::dims(3, 4));
+    std::iota(a.plain_begin(), a.plain_end(), 0.0f);
+    yato::vector_2d<float> b(yato::dims(3, 4), 10.0f);
+
+    const float k = 2.0f;
+    yato::vector_2d<float> c;
+    c = a * k + b;
+    ASSERT_EQ(a.dimensions(), c.dimensions());
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            EXPECT_EQ(a[i][j] * k + b[i][j], c[i][j]);
+        }
+    }
+
+    const auto d = yato::evaluate((a - b) / 2.0f - (-a));
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            EXPECT_EQ((a[i][j] - b[i][j]) / 2.0f + a[i][j], d[i][j]);
+        }
+    }
+
+    yato::vector_2d<double> e(1.0 + a * b);
+    EXPECT_EQ(1.0 + 11.0 * 10.0, e[2][3]);
+}
+
+TEST(Yato_ExpressionND, reuse_storage)
+{
+    yato::vector_1d<int> a = { 1, 2, 3, 4 };
+    const int* storage = a.data();
+    // Elements are read and written at the same positions, so aliasing is safe
+    a = a * a + 1;
+    EXPECT_EQ(storage, a.data());
+    EXPECT_EQ(2, a[0]);
+    EXPECT_EQ(17, a[3]);
+}
+
+TEST(Yato_ExpressionND, strided)
+{
+    yato::vector_2d<int> a(yato::dims(3, 5));
+    std::iota(a.plain_begin(), a.plain_end(), 0);
+
+    int buffer[3 * 8];
+    std::fill(std::begin(buffer), std::end(buffer), -1);
+    yato::array_view_2d<int> view(buffer, yato::dims(3, 5), yato::dims(8));
+    ASSERT_FALSE(view.continuous());
+
+    view = a + a;
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            EXPECT_EQ(2 * a[i][j], view[i][j]);
+        }
+        EXPECT_EQ(-1, buffer[i * 8 + 5]);
+    }
+
+    // Strided source
+    yato::vector_2d<int> b(view * 3 - a);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            EXPECT_EQ(5 * a[i][j], b[i][j]);
+        }
+    }
+
+    // Sub-proxies
+    yato::vector_1d<int> row(a[1] + view[1]);
+    EXPECT_EQ(3 * a[1][4], row[4]);
+}
+
+TEST(Yato_ExpressionND, custom_functions)
+{
+    yato::vector_2d<float> a(yato::dims(2, 3), -4.0f);
+    const auto abs_a = yato::map_expression([](float x) { return std::abs(x); }, a);
+    yato::vector_2d<float> b(yato::map_expression([](float x, float y) { return std::max(x, y); }, abs_a, 3.0f));
+    EXPECT_EQ(4.0f, b[1][2]);
+
+    const std::vector<float> v = { 1.0f, 2.0f, 3.0f };
+    yato::vector_1d<float> c(yato::make_expression(v) * 2.0f);
+    EXPECT_EQ(6.0f, c[2]);
+}
+
+TEST(Yato_ExpressionND, shape_mismatch)
+{
+    yato::vector_2d<int> a(yato::dims(2, 3), 1);
+    yato::vector_2d<int> b(yato::dims(3, 2), 1);
+    EXPECT_THROW(yato::evaluate(a + b), yato::argument_error);
+
+    int buffer[4];
+    yato::array_view_2d<int> view(buffer, yato::dims(2, 2));
+    EXPECT_THROW(view = a * 2, yato::argument_error);
+}
@@ -0,0 +1,170 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <yato/interpolation_nd.h>
+#include <yato/tiled_vector_nd.h>
+#include <yato/vector_nd.h>
+
+namespace
+{
+    template <typename Sampler_, typename Container_>
+    float reference_bilinear(const Container_ & c, float y, float x)
+    {
+        const int32_t y0 = static_cast<int32_t>(std::floor(y));
+        const int32_t x0 = static_cast<int32_t>(std::floor(x));
+        const float wy = y - static_cast<float>(y0);
+        const float wx = x - static_cast<float>(x0);
+        const float v00 = yato::load<Sampler_>(c, y0, x0);
+        const float v01 = yato::load<Sampler_>(c, y0, x0 + 1);
+        const float v10 = yato::load<Sampler_>(c, y0 + 1, x0);
+        const float v11 = yato::load<Sampler_>(c, y0 + 1, x0 + 1);
+        return (v00 * (1.0f - wx) + v01 * wx) * (1.0f - wy) + (v10 * (1.0f - wx) + v11 * wx) * wy;
+    }
+}
+
+TEST(Yato_Interpolation, bilinear)
+{
+    yato::vector_2d<float> img(yato::dims(4, 5));
+    for (size_t y = 0; y < 4; ++y) {
+        for (size_t x = 0; x < 5; ++x) {
+            img[y][x] = static_cast<float>(y * 10 + x * x);
+        }
+    }
+
+    EXPECT_FLOAT_EQ(img[2][3], yato::interpolate(img, 2.0f, 3.0f));
+    EXPECT_FLOAT_EQ(img[3][4], yato::interpolate(img, 3.0f, 4.0f));
+    EXPECT_FLOAT_EQ(0.5f * (img[1][1] + img[1][2]), yato::interpolate(img, 1.0f, 1.5f));
+
+    const float points[][2] = { { 0.25f, 0.75f }, { 2.5f, 3.9f }, { -0.5f, 1.0f }, { 3.5f, 4.5f }, { -3.0f, 7.25f }, { 1.1f, -0.1f } };
+    for (const auto & p : points) {
+        EXPECT_FLOAT_EQ((reference_bilinear<yato::sampler_clamp>(img, p[0], p[1])), (yato::interpolate<yato::sampler_linear<yato::sampler_clamp>>(img, p[0], p[1])));
+        EXPECT_FLOAT_EQ((reference_bilinear<yato::sampler_zero>(img, p[0], p[1])), (yato::interpolate<yato::sampler_linear<yato::sampler_zero>>(img, p[0], p[1])));
+    }
+
+    // Exact coordinate on the last element doesn't touch the outside neighbour
+    EXPECT_FLOAT_EQ(img[3][4], yato::interpolate<yato::sampler_linear<yato::sampler_default>>(img, 3.0f, 4.0f));
+    EXPECT_THROW(yato::interpolate<yato::sampler_linear<yato::sampler_default>>(img, 3.0f, 4.5f), yato::out_of_range_error);
+
+    // Generic container goes through the border sampler
+    yato::tiled_vector_2d<float, 2, 2> tiled(img.cview());
+    EXPECT_FLOAT_EQ(yato::interpolate(img, 1.3f, 2.6f), yato::interpolate(tiled, 1.3f, 2.6f));
+}
+
+TEST(Yato_Interpolation, trilinear_strided)
+{
+    yato::vector_3d<double> storage(yato::dims(3, 4, 8));
+    for (size_t z = 0; z < 3; ++z) {
+        for (size_t y = 0; y < 4; ++y) {
+            for (size_t x = 0; x < 8; ++x) {
+                storage[z][y][x] = static_cast<double>(z * 100 + y * 10 + x);
+            }
+        }
+    }
+    const yato::array_view_3d<const double> view(storage.cdata(), yato::dims(3, 4, 5), yato::dims(4, 8));
+
+    // Linear function is reproduced exactly
+    EXPECT_NEAR(125.0 + 20.75 + 3.75, yato::interpolate(view, 1.25, 2.075, 3.75), 1e-4);
+    // Padding is never read
+    EXPECT_DOUBLE_EQ(104.0, yato::interpolate(view, 1.0, 0.0, 4.75));
+    EXPECT_DOUBLE_EQ(0.0, yato::interpolate<yato::sampler_linear<yato::sampler_zero>>(view, -1.0, 0.0, 0.0));
+}
+
+TEST(Yato_Interpolation, fixed_point)
+{
+    yato::vector_2d<uint8_t> img(yato::dims(3, 3));
+    img[0][0] = 0;   img[0][1] = 255; img[0][2] = 10;
+    img[1][0] = 100; img[1][1] = 200; img[1][2] = 20;
+    img[2][0] = 7;   img[2][1] = 9;   img[2][2] = 30;
+
+    using fixed = yato::sampler_linear_fixed<yato::sampler_clamp>;
+    EXPECT_EQ(200, yato::interpolate<fixed>(img, 1.0f, 1.0f));
+    EXPECT_EQ(128, yato::interpolate<fixed>(img, 0.0f, 0.5f));
+    EXPECT_EQ(30, yato::interpolate<fixed>(img, 5.0f, 5.0f));
+    for (float y = -0.5f; y < 3.0f; y += 0.3f) {
+        for (float x = -0.5f; x < 3.0f; x += 0.35f) {
+            const float expected = yato::interpolate<yato::sampler_linear<>>(img, y, x);
+            EXPECT_NEAR(expected, static_cast<float>(yato::interpolate<fixed>(img, y, x)), 1.5f);
+        }
+    }
+}
+
+TEST(Yato_Interpolation, row)
+{
+    yato::vector_2d<float> img(yato::dims(7, 9));
+    for (size_t y = 0; y < 7; ++y) {
+        for (size_t x = 0; x < 9; ++x) {
+            img[y][x] = static_cast<float>((y * 13 + x * 7) % 11);
+        }
+    }
+    const size_t count = 600;
+    std::vector<float> ys(count);
+    std::vector<float> xs(count);
+    for (size_t k = 0; k < count; ++k) {
+        ys[k] = -1.5f + 0.0157f * static_cast<float>(k);
+        xs[k] = 10.0f - 0.0211f * static_cast<float>(k);
+    }
+
+    std::vector<float> res(count);
+    yato::interpolate_row<yato::sampler_linear<yato::sampler_zero>>(img, res.data(), count, ys.data(), xs.data());
+    for (size_t k = 0; k < count; ++k) {
+        ASSERT_FLOAT_EQ((yato::interpolate<yato::sampler_linear<yato::sampler_zero>>(img, ys[k], xs[k])), res[k]) << k;
+    }
+
+    yato::vector_2d<uint8_t> img8(yato::dims(7, 9));
+    for (size_t y = 0; y < 7; ++y) {
+        for (size_t x = 0; x < 9; ++x) {
+            img8[y][x] = static_cast<uint8_t>(y * 30 + x);
+        }
+    }
+    using fixed = yato::sampler_linear_fixed<yato::sampler_clamp, 10>;
+    std::vector<uint8_t> res8(count);
+    yato::interpolate_row<fixed>(img8, res8.data(), count, ys.data(), xs.data());
+    for (size_t k = 0; k < count; ++k) {
+        ASSERT_EQ((yato::interpolate<fixed>(img8, ys[k], xs[k])), res8[k]) << k;
+    }
+}
+
+TEST(Yato_Interpolation, invalid_coordinates)
+{
+    yato::vector_2d<float> img(yato::dims(3, 4));
+    for (size_t y = 0; y < 3; ++y) {
+        for (size_t x = 0; x < 4; ++x) {
+            img[y][x] = static_cast<float>(1 + y * 4 + x);
+        }
+    }
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+
+    // NaN and huge coordinates are out of bounds
+    using zero = yato::sampler_linear<yato::sampler_zero>;
+    EXPECT_FLOAT_EQ(0.0f, yato::interpolate<zero>(img, nan, 1.0f));
+    EXPECT_FLOAT_EQ(0.0f, yato::interpolate<zero>(img, 1.0f, 1e20f));
+    EXPECT_FLOAT_EQ(0.0f, yato::interpolate<zero>(img, -inf, 1.0f));
+    EXPECT_FLOAT_EQ(img[2][3], yato::interpolate(img, 5e9f, inf));
+    EXPECT_FLOAT_EQ(img[0][0], yato::interpolate(img, -1e30f, -5e9f));
+
+    using fixed = yato::sampler_linear_fixed<yato::sampler_clamp>;
+    yato::vector_2d<uint8_t> img8(yato::dims(2, 2), 77);
+    EXPECT_EQ(77, yato::interpolate<fixed>(img8, 1e10, nan));
+
+    const std::vector<float> ys = { 1.0f, nan, 1e20f, -inf, 0.5f };
+    const std::vector<float> xs = { nan, 1.0f, 2.0f, 3.0f, 1.5f };
+    std::vector<float> res(ys.size());
+    yato::interpolate_row<zero>(img, res.data(), res.size(), ys.data(), xs.data());
+    for (size_t k = 0; k < res.size(); ++k) {
+        EXPECT_FLOAT_EQ((yato::interpolate<zero>(img, ys[k], xs[k])), res[k]) << k;
+    }
+    EXPECT_FLOAT_EQ(0.0f, res[0]);
+    EXPECT_FLOAT_EQ(0.5f * (img[0][1] + img[1][2]), res[4]);
+}
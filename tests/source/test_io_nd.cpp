@@ -0,0 +1,178 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <sstream>
+#include <string>
+
+#include <yato/io_nd.h>
+
+TEST(Yato_IoND, npy_header)
+{
+    yato::vector_2d<int32_t> a(yato::dims(2, 3));
+    std::iota(a.plain_begin(), a.plain_end(), 0);
+
+    std::ostringstream os;
+    yato::io::write_nd(os, a);
+    const std::string bytes = os.str();
+
+    // Same bytes as numpy.save(np.arange(6, dtype='<i4').reshape(2, 3))
+    std::string expected("\x93NUMPY\x01\x00\x76\x00", 10);
+    expected += "{'descr': '<i4', 'fortran_order': False, 'shape': (2, 3), }";
+    expected.append(128 - 1 - expected.size(), ' ');
+    expected += '\n';
+    ASSERT_EQ(128 + 6 * sizeof(int32_t), bytes.size());
+    EXPECT_EQ(expected, bytes.substr(0, 128));
+    int32_t last = 0;
+    std::memcpy(&last, bytes.data() + bytes.size() - sizeof(int32_t), sizeof(int32_t));
+    EXPECT_EQ(5, last);
+
+    yato::vector_1d<uint8_t> b(yato::dims(7), 1);
+    std::ostringstream os1;
+    yato::io::write_nd(os1, b);
+    EXPECT_NE(std::string::npos, os1.str().find("'descr': '|u1', 'fortran_order': False, 'shape': (7,), }"));
+    EXPECT_EQ(0u, (os1.str().size() - 7) % 64);
+}
+
+TEST(Yato_IoND, roundtrip)
+{
+    yato::vector_3d<float> a(yato::dims(4, 5, 6));
+    std::iota(a.plain_begin(), a.plain_end(), -10.0f);
+
+    std::stringstream ss;
+    yato::io::write_nd(ss, a);
+    const auto b = yato::io::read_nd<float, 3>(ss);
+    ASSERT_EQ(a.dimensions(), b.dimensions());
+    EXPECT_TRUE(std::equal(a.plain_cbegin(), a.plain_cend(), b.plain_cbegin()));
+
+    EXPECT_THROW((yato::io::read_nd<float, 3>(ss)), yato::runtime_error);
+
+    const std::string path = testing::TempDir() + "yato_io_nd.npy";
+    yato::io::write_nd(path, a[1]);
+    const auto c = yato::io::read_nd<float, 2>(path);
+    ASSERT_EQ(yato::dims(5, 6), c.dimensions());
+    EXPECT_EQ(a[1][4][5], c[4][5]);
+    std::remove(path.c_str());
+}
+
+TEST(Yato_IoND, strided)
+{
+    int16_t buffer[3 * 8];
+    std::iota(std::begin(buffer), std::end(buffer), 0);
+    yato::array_view_2d<int16_t> view(buffer, yato::dims(3, 5), yato::dims(8));
+
+    std::stringstream ss;
+    yato::io::write_nd(ss, view);
+    const auto packed = yato::io::read_nd<int16_t, 2>(ss);
+    ASSERT_EQ(yato::dims(3, 5), packed.dimensions());
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            EXPECT_EQ(view[i][j], packed[i][j]);
+        }
+    }
+
+    // Read into strided destination, padding is kept
+    int16_t dst_buffer[3 * 8];
+    std::fill(std::begin(dst_buffer), std::end(dst_buffer), -1);
+    yato::array_view_2d<int16_t> dst(dst_buffer, yato::dims(3, 5), yato::dims(8));
+    ss.clear();
+    ss.seekg(0);
+    yato::io::read_nd(ss, dst);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            EXPECT_EQ(view[i][j], dst[i][j]);
+        }
+        EXPECT_EQ(-1, dst_buffer[i * 8 + 5]);
+    }
+}
+
+TEST(Yato_IoND, strided_chunks)
+{
+    // Rows cross chunk boundaries
+    const size_t height = 700;
+    const size_t width = 1001;
+    yato::vector_2d<float> storage(yato::dims(height, width + 3));
+    std::iota(storage.plain_begin(), storage.plain_end(), 0.0f);
+    yato::array_view_2d<float> view(storage.data(), yato::dims(height, width), yato::dims(width + 3));
+    ASSERT_GT(view.total_size() * sizeof(float), 2 * yato::io::stream_chunk_size);
+
+    std::stringstream ss;
+    yato::io::write_nd(ss, view);
+    yato::vector_2d<float> dst_storage(yato::dims(height, width + 1), -1.0f);
+    yato::array_view_2d<float> dst(dst_storage.data(), yato::dims(height, width), yato::dims(width + 1));
+    yato::io::read_nd(ss, dst);
+    for (size_t i = 0; i < height; ++i) {
+        ASSERT_TRUE(std::equal(&view[i][0], &view[i][0] + width, &dst[i][0]));
+        ASSERT_EQ(-1.0f, dst_storage[i][width]);
+    }
+}
+
+TEST(Yato_IoND, errors)
+{
+    yato::vector_2d<double> a(yato::dims(2, 2), 1.0);
+    std::stringstream ss;
+    yato::io::write_nd(ss, a);
+    const std::string bytes = ss.str();
+
+    std::stringstream s1(bytes);
+    EXPECT_THROW((yato::io::read_nd<float, 2>(s1)), yato::argument_error);
+    std::stringstream s2(bytes);
+    EXPECT_THROW((yato::io::read_nd<double, 3>(s2)), yato::argument_error);
+    std::stringstream s3(bytes);
+    double small[2];
+    EXPECT_THROW(yato::io::read_nd(s3, yato::array_view_2d<double>(small, yato::dims(1, 2))), yato::argument_error);
+    std::stringstream s4(bytes.substr(0, bytes.size() - 1));
+    EXPECT_THROW((yato::io::read_nd<double, 2>(s4)), yato::runtime_error);
+    std::stringstream s5("not npy data");
+    EXPECT_THROW((yato::io::read_nd<double, 2>(s5)), yato::runtime_error);
+}
+
+TEST(Yato_IoND, byte_order)
+{
+    // Big endian uint16 array of shape (2,)
+    std::string bytes("\x93NUMPY\x01\x00\x76\x00", 10);
+    bytes += "{'descr': '>u2', 'fortran_order': False, 'shape': (2,), }";
+    bytes.append(128 - 1 - bytes.size(), ' ');
+    bytes += '\n';
+    bytes += std::string("\x01\x02\xAB\xCD", 4);
+
+    std::stringstream ss(bytes);
+    const auto v = yato::io::read_nd<uint16_t, 1>(ss);
+    ASSERT_EQ(2u, v.size(0));
+    EXPECT_EQ(0x0102, v[0]);
+    EXPECT_EQ(0xABCD, v[1]);
+}
+
+TEST(Yato_IoND, corrupted_shape)
+{
+    const auto make_npy = [](const std::string & shape) {
+        std::string bytes("\x93NUMPY\x01\x00\x76\x00", 10);
+        bytes += "{'descr': '<f8', 'fortran_order': False, 'shape': " + shape + ", }";
+        bytes.append(128 - 1 - bytes.size(), ' ');
+        bytes += '\n';
+        bytes += std::string(4 * sizeof(double), '\0');
+        return bytes;
+    };
+
+    // Huge shape is rejected before the storage is allocated
+    std::stringstream s1(make_npy("(1000000000, 1000000000)"));
+    EXPECT_THROW((yato::io::read_nd<double, 2>(s1)), yato::runtime_error);
+    std::stringstream s2(make_npy("(4294967296, 4294967296)"));
+    EXPECT_THROW((yato::io::read_nd<double, 2>(s2)), yato::runtime_error);
+    std::stringstream s3(make_npy("(99999999999999999999999, 1)"));
+    EXPECT_THROW((yato::io::read_nd<double, 2>(s3)), yato::runtime_error);
+
+    std::stringstream s4(make_npy("(2, 2)"));
+    const auto v = yato::io::read_nd<double, 2>(s4);
+    EXPECT_EQ(2u, v.size(0));
+    EXPECT_EQ(2u, v.size(1));
+}
@@ -0,0 +1,200 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+#include <yato/mapped_array_nd.h>
+
+#ifdef __linux__
+# include <sys/stat.h>
+#endif
+
+namespace
+{
+    std::string temp_file(const char* name)
+    {
+        return testing::TempDir() + name;
+    }
+
+    template <typename Fn_>
+    void patch_header(const std::string & path, Fn_ && fn)
+    {
+        std::FILE* file = std::fopen(path.c_str(), "r+b");
+        ASSERT_NE(nullptr, file);
+        yato::mapped_array_header header{};
+        ASSERT_EQ(1u, std::fread(&header, sizeof(header), 1, file));
+        fn(header);
+        std::fseek(file, 0, SEEK_SET);
+        ASSERT_EQ(1u, std::fwrite(&header, sizeof(header), 1, file));
+        std::fclose(file);
+    }
+}
+
+TEST(Yato_MappedArrayND, create_and_open)
+{
+    const std::string path = temp_file("yato_mapped_array_3d.bin");
+    {
+        auto arr = yato::mapped_array_3d<float>::create(path, yato::dims(3, 4, 5));
+        EXPECT_EQ(yato::dims(3, 4, 5), arr.dimensions());
+        EXPECT_EQ(60u, arr.total_size());
+        auto view = arr.view();
+        EXPECT_TRUE(view.continuous());
+        EXPECT_EQ(0.0f, view[2][3][4]);
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = 0; j < 4; ++j) {
+                for (size_t k = 0; k < 5; ++k) {
+                    view[i][j][k] = static_cast<float>(100 * i + 10 * j + k);
+                }
+            }
+        }
+        arr.flush();
+    }
+    {
+        auto arr = yato::mapped_array_3d<float>::open(path);
+        EXPECT_EQ(yato::mapped_access::read_only, arr.access());
+        EXPECT_EQ(yato::dims(3, 4, 5), arr.dimensions());
+        EXPECT_THROW(arr.view(), yato::bad_state_error);
+        const auto view = arr.cview();
+        EXPECT_EQ(0.0f, view[0][0][0]);
+        EXPECT_EQ(123.0f, view[1][2][3]);
+        EXPECT_EQ(234.0f, view[2][3][4]);
+    }
+    {
+        auto arr = yato::mapped_array_3d<float>::open(path, yato::mapped_access::read_write);
+        arr.view()[1][1][1] = -1.0f;
+    }
+    {
+        auto arr = yato::mapped_array_3d<float>::open(path);
+        EXPECT_EQ(-1.0f, arr.cview()[1][1][1]);
+        arr.close();
+        EXPECT_FALSE(arr.is_open());
+    }
+    std::remove(path.c_str());
+}
+
+TEST(Yato_MappedArrayND, padded_rows)
+{
+    const std::string path = temp_file("yato_mapped_array_padded.bin");
+    yato::mapped_array_options options;
+    options.row_alignment = 64;
+    {
+        auto arr = yato::mapped_array_2d<uint16_t>::create(path, yato::dims(3, 7), options);
+        EXPECT_EQ(64u, arr.strides()[0]);
+        auto view = arr.view();
+        EXPECT_FALSE(view.continuous());
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = 0; j < 7; ++j) {
+                view[i][j] = static_cast<uint16_t>(i * 7 + j);
+            }
+        }
+    }
+    {
+        auto arr = yato::mapped_array_2d<uint16_t>::open(path);
+        EXPECT_EQ(64u, arr.strides()[0]);
+        const auto view = arr.cview();
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(view.cdata()) % 64);
+        EXPECT_EQ(20, view[2][6]);
+        EXPECT_EQ(64, reinterpret_cast<const char*>(&view[1][0]) - reinterpret_cast<const char*>(&view[0][0]));
+    }
+    std::remove(path.c_str());
+}
+
+TEST(Yato_MappedArrayND, type_mismatch)
+{
+    const std::string path = temp_file("yato_mapped_array_mismatch.bin");
+    {
+        auto arr = yato::mapped_array_2d<int32_t>::create(path, yato::dims(2, 2));
+        arr.view()[1][1] = 42;
+    }
+    EXPECT_THROW(yato::mapped_array_2d<float>::open(path), yato::argument_error);
+    EXPECT_THROW(yato::mapped_array_2d<uint32_t>::open(path), yato::argument_error);
+    EXPECT_THROW(yato::mapped_array_3d<int32_t>::open(path), yato::argument_error);
+    EXPECT_EQ(42, yato::mapped_array_2d<int32_t>::open(path).cview()[1][1]);
+    std::remove(path.c_str());
+
+    EXPECT_THROW(yato::mapped_array_1d<int32_t>::open(path), yato::runtime_error);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(nullptr, file);
+    std::fputs("not an array", file);
+    std::fclose(file);
+    EXPECT_THROW(yato::mapped_array_1d<int32_t>::open(path), yato::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(Yato_MappedArrayND, corrupted_header)
+{
+    const std::string path = temp_file("yato_mapped_array_corrupted.bin");
+    {
+        auto arr = yato::mapped_array_2d<int32_t>::create(path, yato::dims(4, 4));
+        arr.view()[3][3] = 7;
+    }
+    ASSERT_EQ(7, yato::mapped_array_2d<int32_t>::open(path).cview()[3][3]);
+
+    // stride * extent wraps to a small size
+    patch_header(path, [](yato::mapped_array_header & header) {
+        header.extents[0] = (static_cast<uint64_t>(1) << 62) + 1;
+        header.strides[0] = 16;
+    });
+    EXPECT_THROW(yato::mapped_array_2d<int32_t>::open(path), yato::runtime_error);
+
+    // data_offset + size wraps
+    patch_header(path, [](yato::mapped_array_header & header) {
+        header.extents[0] = 4;
+        header.data_offset = std::numeric_limits<uint64_t>::max() - 15;
+    });
+    EXPECT_THROW(yato::mapped_array_2d<int32_t>::open(path), yato::runtime_error);
+
+    std::remove(path.c_str());
+}
+
+TEST(Yato_MappedArrayND, hints)
+{
+    const std::string path = temp_file("yato_mapped_array_1d.bin");
+    yato::mapped_array_options options;
+    options.huge_pages = true;
+    {
+        auto arr = yato::mapped_array_1d<double>::create(path, yato::dims(1000), options);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(arr.cview().cdata()) % (2 * 1024 * 1024));
+        arr.advise(yato::mapped_access_hint::sequential);
+        auto view = arr.view();
+        for (size_t i = 0; i < view.size(0); ++i) {
+            view[i] = static_cast<double>(i);
+        }
+    }
+    {
+        auto arr = yato::mapped_array_1d<double>::open(path);
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(arr.cview().cdata()) % (2 * 1024 * 1024));
+        arr.advise(yato::mapped_access_hint::random);
+        EXPECT_EQ(999.0, arr.cview()[999]);
+        arr.advise(yato::mapped_access_hint::will_need);
+        EXPECT_EQ(500.0, arr.cview()[500]);
+    }
+    std::remove(path.c_str());
+}
+
+#ifdef __linux__
+TEST(Yato_MappedArrayND, allocated_storage)
+{
+    // Blocks are allocated on creation, so a full disk is reported by create() instead of SIGBUS on write
+    const std::string path = temp_file("yato_mapped_array_allocated.bin");
+    {
+        auto arr = yato::mapped_array_2d<float>::create(path, yato::dims(512, 1024));
+        struct stat st{};
+        ASSERT_EQ(0, ::stat(path.c_str(), &st));
+        EXPECT_GE(static_cast<uint64_t>(st.st_blocks) * 512u, static_cast<uint64_t>(st.st_size));
+    }
+    std::remove(path.c_str());
+
+    EXPECT_THROW(yato::mapped_array_1d<float>::create(testing::TempDir() + "no_such_dir/array.bin", yato::dims(16)), yato::runtime_error);
+}
+#endif
@@ -0,0 +1,93 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <numeric>
+
+#include <yato/vector_nd.h>
+
+TEST(Yato_PaddedVectorND, layout)
+{
+    yato::padded_vector_2d<float> v(yato::dims(5, 7), 1.0f);
+    EXPECT_EQ(yato::dims(5, 7), v.dimensions());
+    EXPECT_EQ(35u, v.total_size());
+    EXPECT_EQ(5u * 16u, v.storage_size());
+    EXPECT_EQ(64u, v.stride(0));
+    EXPECT_EQ(64u, v.strides()[0]);
+    EXPECT_EQ(64u, *v.strides_range().begin());
+    EXPECT_FALSE(v.continuous());
+
+    for (size_t i = 0; i < v.size(0); ++i) {
+        EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(&v[i][0]) % 64);
+        for (size_t j = 0; j < v.size(1); ++j) {
+            EXPECT_EQ(1.0f, v[i][j]);
+            v[i][j] = static_cast<float>(i * 10 + j);
+        }
+    }
+    EXPECT_EQ(12.0f, v.at(1, 2));
+    EXPECT_THROW(v.at(1, 7), yato::out_of_range_error);
+    EXPECT_EQ(46.0f, yato::load<yato::sampler_clamp>(v, 10, 10));
+
+    const auto view = v.cview();
+    EXPECT_EQ(v.dimensions(), view.dimensions());
+    EXPECT_EQ(64u, view.stride(0));
+    EXPECT_EQ(v.cdata(), &view[0][0]);
+    EXPECT_EQ(34.0f, view[3][4]);
+
+    size_t rows = 0;
+    for (const auto & row : v) {
+        EXPECT_EQ(7, std::distance(row.cbegin(), row.cend()));
+        EXPECT_EQ(static_cast<float>(rows * 10 + 6), row[6]);
+        ++rows;
+    }
+    EXPECT_EQ(5u, rows);
+
+    // Row already fills the alignment
+    yato::padded_vector_2d<double> w(yato::dims(3, 16));
+    EXPECT_EQ(128u, w.stride(0));
+    EXPECT_TRUE(w.continuous());
+}
+
+TEST(Yato_PaddedVectorND, copy)
+{
+    yato::vector_3d<int16_t> src(yato::dims(2, 3, 5));
+    std::iota(src.plain_begin(), src.plain_end(), static_cast<int16_t>(0));
+
+    yato::padded_vector_3d<int16_t, 16> v(src.cview());
+    EXPECT_EQ(16u, v.stride(1));
+    EXPECT_EQ(3u * 16u, v.stride(0));
+    EXPECT_EQ(2u * 3u * 8u, v.storage_size());
+    for (size_t i = 0; i < 2; ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            for (size_t k = 0; k < 5; ++k) {
+                ASSERT_EQ(src[i][j][k], v[i][j][k]);
+            }
+            // padding is value initialized
+            EXPECT_EQ(0, v.cdata()[(i * 3 + j) * 8 + 5]);
+        }
+    }
+
+    auto u = v;
+    EXPECT_EQ(v.dimensions(), u.dimensions());
+    EXPECT_EQ(src[1][2][4], u[1][2][4]);
+
+    auto w = std::move(u);
+    EXPECT_TRUE(u.empty());
+    EXPECT_EQ(src[1][1][1], w[1][1][1]);
+
+    w.resize(yato::dims(4, 2, 9), static_cast<int16_t>(-1));
+    EXPECT_EQ(yato::dims(4, 2, 9), w.dimensions());
+    EXPECT_EQ(32u, w.stride(1));
+    EXPECT_EQ(64u, w.stride(0));
+    EXPECT_EQ(-1, w[3][1][8]);
+
+    w.clear();
+    EXPECT_TRUE(w.empty());
+    EXPECT_EQ(0u, w.total_size());
+}
@@ -0,0 +1,120 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <string>
+
+#include <yato/array_view.h>
+#include <yato/parallel_nd.h>
+#include <yato/vector_nd.h>
+
+namespace
+{
+    yato::parallel_policy small_grain()
+    {
+        yato::parallel_policy policy;
+        policy.threads = 4;
+        policy.grain = 7;
+        return policy;
+    }
+}
+
+TEST(Yato_ParallelND, for_each)
+{
+    yato::vector_3d<int> vec(yato::dims(5, 7, 9), 1);
+    yato::for_each_nd(small_grain(), vec, [](int & x) { x *= 3; });
+    EXPECT_TRUE(std::all_of(vec.plain_cbegin(), vec.plain_cend(), [](int x) { return x == 3; }));
+
+    yato::vector_1d<int> vec1(1000, 2);
+    yato::for_each_nd(small_grain(), vec1, [](int & x) { x += 1; });
+    EXPECT_TRUE(std::all_of(vec1.plain_cbegin(), vec1.plain_cend(), [](int x) { return x == 3; }));
+}
+
+TEST(Yato_ParallelND, for_each_strided)
+{
+    int arr[420] = {};
+    yato::array_view_3d<int> view(arr, yato::dims(2, 3, 4), yato::dims(5, 6));
+    ASSERT_FALSE(view.continuous());
+
+    std::atomic<int> count{ 0 };
+    yato::for_each_nd(small_grain(), view, [&count](int & x) { x = 1; ++count; });
+    EXPECT_EQ(24, count.load());
+    // Padding is not touched
+    EXPECT_EQ(24, std::accumulate(std::begin(arr), std::end(arr), 0));
+}
+
+TEST(Yato_ParallelND, transform)
+{
+    yato::vector_2d<int> src(yato::dims(31, 17));
+    std::iota(src.plain_begin(), src.plain_end(), 0);
+
+    yato::vector_2d<long> dst(yato::dims(31, 17));
+    yato::transform_nd(small_grain(), src, dst, [](int x) { return 2L * x; });
+    for (size_t i = 0; i < src.total_size(); ++i) {
+        EXPECT_EQ(2L * static_cast<long>(i), *(dst.plain_cbegin() + i));
+    }
+
+    int arr[6 * 8] = {};
+    yato::array_view_2d<int> view(arr, yato::dims(6, 5), yato::dims(8));
+    yato::vector_2d<int> src2(yato::dims(6, 5), 4);
+    yato::transform_nd(small_grain(), src2, view, [](int x) { return x + 1; });
+    EXPECT_EQ(30 * 5, std::accumulate(std::begin(arr), std::end(arr), 0));
+
+    yato::vector_2d<int> wrong(yato::dims(6, 4));
+    EXPECT_THROW(yato::transform_nd(src2, wrong, [](int x) { return x; }), yato::argument_error);
+}
+
+TEST(Yato_ParallelND, reduce)
+{
+    yato::vector_3d<int64_t> vec(yato::dims(13, 11, 7));
+    std::iota(vec.plain_begin(), vec.plain_end(), 1);
+    const int64_t n = static_cast<int64_t>(vec.total_size());
+
+    EXPECT_EQ(n * (n + 1) / 2, yato::reduce_nd(small_grain(), vec, int64_t(0), std::plus<int64_t>{}));
+    EXPECT_EQ(n, yato::reduce_nd(vec, int64_t(0), [](int64_t a, int64_t b) { return std::max(a, b); }));
+
+    // Non-commutative operation keeps the order
+    yato::vector_2d<std::string> str(yato::dims(4, 3));
+    size_t idx = 0;
+    for (auto it = str.plain_begin(); it != str.plain_end(); ++it) {
+        *it = std::string(1, static_cast<char>('a' + idx++));
+    }
+    EXPECT_EQ(">abcdefghijkl", yato::reduce_nd(small_grain(), str, std::string(">"), std::plus<std::string>{}));
+
+    int arr[420];
+    std::fill(std::begin(arr), std::end(arr), 1);
+    const yato::array_view_3d<const int> view(arr, yato::dims(2, 3, 4), yato::dims(5, 6));
+    EXPECT_EQ(24, yato::reduce_nd(small_grain(), view, 0, std::plus<int>{}));
+
+    yato::vector_2d<int> empty;
+    EXPECT_EQ(5, yato::reduce_nd(empty, 5, std::plus<int>{}));
+}
+
+TEST(Yato_ParallelND, for_each_index)
+{
+    yato::vector_3d<size_t> vec(yato::dims(6, 5, 4));
+    yato::for_each_index_nd(small_grain(), vec, [](const std::array<size_t, 3> & idx, size_t & x) {
+        x = idx[0] * 100 + idx[1] * 10 + idx[2];
+    });
+    for (size_t i = 0; i < 6; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            for (size_t k = 0; k < 4; ++k) {
+                EXPECT_EQ(i * 100 + j * 10 + k, vec[i][j][k]);
+            }
+        }
+    }
+}
+
+TEST(Yato_ParallelND, exception)
+{
+    yato::vector_2d<int> vec(yato::dims(64, 64), 0);
+    EXPECT_THROW(yato::for_each_nd(small_grain(), vec, [](int &) { throw yato::runtime_error("test"); }), yato::runtime_error);
+}
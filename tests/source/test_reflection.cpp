@@ -164,6 +164,23 @@ TEST(Yato_Reflection, data_members_2)
     dump_class<Foo>::print();
 }
 
+TEST(Yato_Reflection, data_member_pointer)
+{
+    using members = yato::reflection::data_members_list<Foo>;
+    using y_info  = yato::meta::list_at_t<members, 1>;
+
+    Foo f;
+    f.y = 0.0f;
+    f.*yato::reflection::data_member_pointer<y_info>() = 3.0f;
+    EXPECT_EQ(3.0f, f.y);
+
+    // Private member
+    using x_info = members::head;
+    static_assert(std::is_same<int Foo::*, decltype(yato::reflection::data_member_pointer<x_info>())>::value, "data_member_pointer fail");
+    f.*yato::reflection::data_member_pointer<x_info>() = 1;
+    EXPECT_EQ(1, *static_cast<int*>(yato::reflection::reflection_manager<Foo>::instance()->get_by_name("x")->ptr(&f)));
+}
+
 //TEST(Yato_Reflection, data_methods)
 //{
 //    std::cout << typeid(Foo::_yato_reflected_method_f::my_type).name() << std::endl;
@@ -306,3 +306,27 @@ TEST(Yato_Sampler, custom_sampler2)
     static_assert(std::is_same<typename yato::container_traits<decltype(v1[0])>::container_category, yato::container_continuous_tag>::value);
 }
 
+
+TEST(Yato_Sampler, sampler_strided_view)
+{
+    int buffer[3 * 4 * 8];
+    for (size_t i = 0; i < 3 * 4 * 8; ++i) {
+        buffer[i] = static_cast<int>(i);
+    }
+    yato::array_view_3d<int> view(buffer, yato::dims(3, 2, 5), yato::dims(4, 8));
+    static_assert(std::is_same<typename yato::container_traits<decltype(view)>::container_category, yato::container_strided_tag>::value);
+
+    EXPECT_EQ(buffer[(2 * 4 + 1) * 8 + 3], yato::load<yato::sampler_default>(view, 2, 1, 3));
+    EXPECT_EQ(buffer[(2 * 4 + 1) * 8 + 4], yato::load<yato::sampler_clamp>(view, 5, 7, 9));
+    EXPECT_EQ(buffer[0], yato::load<yato::sampler_clamp>(view, -1, -1, -1));
+    EXPECT_EQ(0, yato::load<yato::sampler_zero>(view, 0, 2, 0));
+    EXPECT_EQ(buffer[1 * 8 + 2], yato::load<yato::sampler_zero>(view, 0, 1, 2));
+    EXPECT_THROW(yato::load<yato::sampler_default>(view, 0, 0, 5), yato::out_of_range_error);
+
+    yato::at(view, 1, 1, 1) = -1;
+    EXPECT_EQ(-1, buffer[(1 * 4 + 1) * 8 + 1]);
+
+    // Sub-view keeps strides
+    const auto plane = view[1];
+    EXPECT_EQ(buffer[(1 * 4 + 1) * 8 + 4], yato::load<yato::sampler_clamp>(plane, 3, 10));
+}
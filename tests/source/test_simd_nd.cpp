@@ -0,0 +1,229 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include <yato/array_view.h>
+#include <yato/simd_nd.h>
+#include <yato/vector_nd.h>
+
+namespace
+{
+    /**
+     * Runs the test body for every instruction set supported by CPU
+     */
+    template <typename Func_>
+    void for_each_isa(const Func_ & func)
+    {
+        using yato::simd::isa;
+        const isa previous = yato::simd::active_isa();
+        for (isa set : { isa::scalar, isa::sse2, isa::avx2, isa::avx512 }) {
+            if (set > yato::simd::detected_isa()) {
+                break;
+            }
+            yato::simd::set_active_isa(set);
+            SCOPED_TRACE(yato::simd::isa_name(set));
+            func();
+        }
+        yato::simd::set_active_isa(previous);
+    }
+
+    yato::vector_2d<float> make_ramp(size_t height, size_t width, float start, float step)
+    {
+        yato::vector_2d<float> res(yato::dims(height, width));
+        float value = start;
+        for (auto it = res.plain_begin(); it != res.plain_end(); ++it, value += step) {
+            *it = value;
+        }
+        return res;
+    }
+}
+
+TEST(Yato_SimdND, isa)
+{
+    using yato::simd::isa;
+    const isa previous = yato::simd::set_active_isa(isa::scalar);
+    EXPECT_EQ(yato::simd::detected_isa(), previous);
+    EXPECT_EQ(isa::scalar, yato::simd::active_isa());
+    EXPECT_EQ(isa::scalar, yato::simd::set_active_isa(isa::avx512));
+    EXPECT_EQ(yato::simd::detected_isa(), yato::simd::active_isa());
+}
+
+TEST(Yato_SimdND, arithmetic)
+{
+    // Odd sizes exercise vector tails
+    const auto a = make_ramp(7, 37, -50.0f, 0.5f);
+    const auto b = make_ramp(7, 37, 30.0f, -0.25f);
+    const auto c = make_ramp(7, 37, 1.0f, 0.125f);
+
+    for_each_isa([&] {
+        yato::vector_2d<float> dst(yato::dims(7, 37));
+
+        yato::simd::add(a, b, dst);
+        for (size_t i = 0; i < dst.total_size(); ++i) {
+            EXPECT_EQ(a.plain_cbegin()[i] + b.plain_cbegin()[i], dst.plain_cbegin()[i]);
+        }
+
+        yato::simd::mul(a, b, dst);
+        for (size_t i = 0; i < dst.total_size(); ++i) {
+            EXPECT_EQ(a.plain_cbegin()[i] * b.plain_cbegin()[i], dst.plain_cbegin()[i]);
+        }
+
+        yato::simd::fma(a, b, c, dst);
+        for (size_t i = 0; i < dst.total_size(); ++i) {
+            EXPECT_FLOAT_EQ(a.plain_cbegin()[i] * b.plain_cbegin()[i] + c.plain_cbegin()[i], dst.plain_cbegin()[i]);
+        }
+
+        yato::simd::min(a, b, dst);
+        for (size_t i = 0; i < dst.total_size(); ++i) {
+            EXPECT_EQ(std::min(a.plain_cbegin()[i], b.plain_cbegin()[i]), dst.plain_cbegin()[i]);
+        }
+
+        yato::simd::max(a, b, dst);
+        for (size_t i = 0; i < dst.total_size(); ++i) {
+            EXPECT_EQ(std::max(a.plain_cbegin()[i], b.plain_cbegin()[i]), dst.plain_cbegin()[i]);
+        }
+
+        yato::simd::clamp(a, -10.0f, 10.0f, dst);
+        for (size_t i = 0; i < dst.total_size(); ++i) {
+            EXPECT_EQ(std::min(std::max(a.plain_cbegin()[i], -10.0f), 10.0f), dst.plain_cbegin()[i]);
+        }
+    });
+}
+
+TEST(Yato_SimdND, strided)
+{
+    const auto a = make_ramp(5, 19, 0.0f, 1.0f);
+    for_each_isa([&] {
+        float buffer[5 * 24];
+        std::fill(std::begin(buffer), std::end(buffer), -1.0f);
+        yato::array_view_2d<float> view(buffer, yato::dims(5, 19), yato::dims(24));
+
+        yato::simd::add(a, a, view);
+        for (size_t y = 0; y < 5; ++y) {
+            for (size_t x = 0; x < 19; ++x) {
+                EXPECT_EQ(2.0f * a[y][x], view[y][x]);
+            }
+            // Padding is not touched
+            for (size_t x = 19; x < 24; ++x) {
+                EXPECT_EQ(-1.0f, buffer[y * 24 + x]);
+            }
+        }
+    });
+
+    yato::vector_2d<float> wrong(yato::dims(5, 18));
+    EXPECT_THROW(yato::simd::add(a, a, wrong), yato::argument_error);
+}
+
+TEST(Yato_SimdND, generic_types)
+{
+    yato::vector_2d<int32_t> a(yato::dims(3, 11));
+    std::iota(a.plain_begin(), a.plain_end(), -10);
+    yato::vector_2d<int32_t> dst(yato::dims(3, 11));
+
+    yato::simd::add(a, a, dst);
+    yato::simd::clamp(dst, -5, 5, dst);
+    for (size_t i = 0; i < dst.total_size(); ++i) {
+        EXPECT_EQ(std::min(std::max(2 * a.plain_cbegin()[i], -5), 5), dst.plain_cbegin()[i]);
+    }
+
+    yato::vector_1d<int32_t> wide = { -1, 0, 200, 300, 70000 };
+    yato::vector_1d<uint8_t> narrow(5);
+    yato::simd::convert(wide, narrow);
+    EXPECT_EQ(0, narrow[0]);
+    EXPECT_EQ(0, narrow[1]);
+    EXPECT_EQ(200, narrow[2]);
+    EXPECT_EQ(255, narrow[3]);
+    EXPECT_EQ(255, narrow[4]);
+}
+
+TEST(Yato_SimdND, convert)
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    std::vector<float> values = { -1.0f, 0.0f, 0.5f, 1.5f, 2.5f, 254.6f, 255.0f, 256.0f, 1e10f, -1e10f, nan, 3.49f, -32768.6f, 32767.4f, 40000.0f, 7.0f };
+    // Repeat for vector bodies and tails
+    yato::vector_1d<float> src(values.size() * 3 + 5);
+    for (size_t i = 0; i < src.size(0); ++i) {
+        src[i] = values[i % values.size()];
+    }
+
+    for_each_isa([&] {
+        yato::vector_1d<uint8_t> u8(src.size(0));
+        yato::simd::convert(src, u8);
+        yato::vector_1d<int16_t> i16(src.size(0));
+        yato::simd::convert(src, i16);
+        yato::vector_1d<float> back(src.size(0));
+        yato::simd::convert(u8, back);
+
+        for (size_t i = 0; i < src.size(0); ++i) {
+            const float x = src[i];
+            const float r = std::nearbyint(x);
+            const uint8_t expected_u8 = (x != x || r <= 0.0f) ? 0 : (r >= 255.0f ? 255 : static_cast<uint8_t>(r));
+            const int16_t expected_i16 = (x != x || r <= -32768.0f) ? -32768 : (r >= 32767.0f ? 32767 : static_cast<int16_t>(r));
+            EXPECT_EQ(expected_u8, u8[i]) << x;
+            EXPECT_EQ(expected_i16, i16[i]) << x;
+            EXPECT_EQ(static_cast<float>(u8[i]), back[i]);
+        }
+        // Round half to even
+        EXPECT_EQ(2, u8[4]);
+        EXPECT_EQ(2, u8[3]);
+    });
+}
+
+TEST(Yato_SimdND, fill_copy)
+{
+    // Large enough for non-temporal stores
+    const size_t height = 257;
+    const size_t width = yato::simd::non_temporal_threshold / sizeof(float) / height + 3;
+
+    for_each_isa([&] {
+        yato::vector_2d<float> src(yato::dims(height, width));
+        yato::simd::fill(src, 3.0f);
+        EXPECT_TRUE(std::all_of(src.plain_cbegin(), src.plain_cend(), [](float x) { return x == 3.0f; }));
+
+        // Unaligned destination with padded rows
+        std::vector<float> buffer(height * (width + 1) + 1, -1.0f);
+        yato::array_view_2d<float> view(buffer.data() + 1, yato::dims(height, width), yato::dims(width + 1));
+        yato::simd::copy(src, view);
+        for (size_t y = 0; y < height; ++y) {
+            EXPECT_EQ(-1.0f, buffer[y * (width + 1)]);
+            EXPECT_TRUE(std::all_of(&view[y][0], &view[y][0] + width, [](float x) { return x == 3.0f; }));
+        }
+
+        yato::vector_1d<uint16_t> small(13);
+        yato::simd::fill(small, 7);
+        EXPECT_TRUE(std::all_of(small.cbegin(), small.cend(), [](uint16_t x) { return x == 7; }));
+    });
+}
+
+TEST(Yato_SimdND, fill_misaligned_multi_lane)
+{
+    // Element is 8 bytes, but aligned to 4 bytes, so the vector head is not a multiple of the element size
+    const size_t size = yato::simd::non_temporal_threshold / sizeof(std::complex<float>) + 5;
+    const std::complex<float> value(1.5f, -2.5f);
+
+    for_each_isa([&] {
+        std::vector<float> storage(2 * size + 2, 0.0f);
+        auto* first = reinterpret_cast<std::complex<float>*>(storage.data() + 1);
+        yato::array_view_1d<std::complex<float>> view(first, yato::dims(size));
+        yato::simd::fill(view, value);
+
+        EXPECT_EQ(0.0f, storage.front());
+        EXPECT_EQ(0.0f, storage.back());
+        size_t wrong = 0;
+        for (size_t i = 0; i < size; ++i) {
+            wrong += (view[i] != value) ? 1 : 0;
+        }
+        EXPECT_EQ(0u, wrong);
+    });
+}
@@ -0,0 +1,147 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <numeric>
+
+#include <yato/stencil_nd.h>
+
+namespace
+{
+    template <typename Sampler_, typename Src_, typename Kernel_>
+    float reference_2d(const Src_ & src, const Kernel_ & kernel, size_t y, size_t x)
+    {
+        const int32_t ay = static_cast<int32_t>(kernel.size(0) / 2);
+        const int32_t ax = static_cast<int32_t>(kernel.size(1) / 2);
+        float acc = 0.0f;
+        for (size_t ky = 0; ky < kernel.size(0); ++ky) {
+            for (size_t kx = 0; kx < kernel.size(1); ++kx) {
+                const int32_t sy = static_cast<int32_t>(y + ky) - ay;
+                const int32_t sx = static_cast<int32_t>(x + kx) - ax;
+                acc += kernel[ky][kx] * yato::load<Sampler_>(src, sy, sx);
+            }
+        }
+        return acc;
+    }
+}
+
+TEST(Yato_StencilND, dense_2d)
+{
+    yato::vector_2d<float> src(yato::dims(13, 21));
+    std::iota(src.plain_begin(), src.plain_end(), 0.0f);
+    for (auto it = src.plain_begin(); it != src.plain_end(); ++it) {
+        *it = static_cast<float>(static_cast<int>(*it * 7) % 23);
+    }
+    // Not centered kernel with even width
+    const yato::vector_2d<float> kernel = {
+        { 1.0f, 2.0f, -1.0f, 0.5f },
+        { 0.0f, 3.0f,  1.0f, 1.0f },
+        { 2.0f, 1.0f,  1.0f, -2.0f }
+    };
+
+    yato::vector_2d<float> dst(src.dimensions());
+    yato::stencil_nd(yato::sampler_clamp{}, src, dst, kernel);
+    for (size_t y = 0; y < 13; ++y) {
+        for (size_t x = 0; x < 21; ++x) {
+            ASSERT_FLOAT_EQ((reference_2d<yato::sampler_clamp>(src, kernel, y, x)), dst[y][x]) << y << " " << x;
+        }
+    }
+
+    yato::parallel_policy policy;
+    policy.grain = 1;
+    yato::stencil_nd(policy, yato::sampler_zero{}, src, dst, kernel);
+    for (size_t y = 0; y < 13; ++y) {
+        for (size_t x = 0; x < 21; ++x) {
+            ASSERT_FLOAT_EQ((reference_2d<yato::sampler_zero>(src, kernel, y, x)), dst[y][x]) << y << " " << x;
+        }
+    }
+
+    // Kernel larger than the image: everything is border
+    yato::vector_2d<float> big_kernel(yato::dims(5, 31), 1.0f);
+    yato::stencil_nd(yato::sampler_clamp{}, src, dst, big_kernel);
+    EXPECT_FLOAT_EQ((reference_2d<yato::sampler_clamp>(src, big_kernel, 6, 10)), dst[6][10]);
+}
+
+TEST(Yato_StencilND, strided_3d)
+{
+    yato::vector_3d<uint8_t> storage(yato::dims(6, 7, 16));
+    uint8_t value = 0;
+    for (auto it = storage.plain_begin(); it != storage.plain_end(); ++it) {
+        *it = (value += 37);
+    }
+    const yato::array_view_3d<const uint8_t> src(storage.cdata(), yato::dims(6, 7, 9), yato::dims(7, 16));
+    yato::vector_3d<int> kernel(yato::dims(3, 3, 3));
+    std::iota(kernel.plain_begin(), kernel.plain_end(), -13);
+
+    yato::padded_vector_3d<int> dst(yato::dims(6, 7, 9));
+    yato::stencil_nd(yato::sampler_clamp{}, src, dst, kernel);
+    for (size_t z = 0; z < 6; ++z) {
+        for (size_t y = 0; y < 7; ++y) {
+            for (size_t x = 0; x < 9; ++x) {
+                int acc = 0;
+                for (int dz = 0; dz < 3; ++dz) {
+                    for (int dy = 0; dy < 3; ++dy) {
+                        for (int dx = 0; dx < 3; ++dx) {
+                            acc += kernel[dz][dy][dx] * yato::load<yato::sampler_clamp>(src,
+                                static_cast<int32_t>(z) + dz - 1, static_cast<int32_t>(y) + dy - 1, static_cast<int32_t>(x) + dx - 1);
+                        }
+                    }
+                }
+                ASSERT_EQ(acc, dst[z][y][x]);
+            }
+        }
+    }
+
+    yato::vector_3d<int> wrong(yato::dims(6, 7, 8));
+    EXPECT_THROW(yato::stencil_nd(yato::sampler_clamp{}, src, wrong, kernel), yato::argument_error);
+}
+
+TEST(Yato_StencilND, separable)
+{
+    yato::vector_3d<float> src(yato::dims(5, 8, 11));
+    std::iota(src.plain_begin(), src.plain_end(), 0.0f);
+    for (auto it = src.plain_begin(); it != src.plain_end(); ++it) {
+        *it = static_cast<float>(static_cast<int>(*it * 5) % 19);
+    }
+    const std::array<std::vector<float>, 3> weights = {
+        std::vector<float>{ 1.0f, 2.0f, 1.0f },
+        std::vector<float>{ 0.5f, 1.0f },
+        std::vector<float>{ 1.0f, 4.0f, 6.0f, 4.0f, 1.0f }
+    };
+    yato::vector_3d<float> kernel(yato::dims(3, 2, 5));
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 2; ++j) {
+            for (size_t k = 0; k < 5; ++k) {
+                kernel[i][j][k] = weights[0][i] * weights[1][j] * weights[2][k];
+            }
+        }
+    }
+
+    yato::vector_3d<float> dense(src.dimensions());
+    yato::vector_3d<float> separable(src.dimensions());
+    yato::stencil_nd(yato::sampler_clamp{}, src, dense, kernel);
+    yato::stencil_separable_nd(yato::sampler_clamp{}, src, separable, weights);
+    for (size_t i = 0; i < 5; ++i) {
+        for (size_t j = 0; j < 8; ++j) {
+            for (size_t k = 0; k < 11; ++k) {
+                ASSERT_NEAR(dense[i][j][k], separable[i][j][k], 1e-3f);
+            }
+        }
+    }
+
+    yato::stencil_nd(yato::sampler_zero{}, src, dense, kernel);
+    yato::stencil_separable_nd(yato::sampler_zero{}, src, separable, weights);
+    EXPECT_NEAR(dense[0][0][0], separable[0][0][0], 1e-3f);
+    EXPECT_NEAR(dense[4][7][10], separable[4][7][10], 1e-3f);
+    EXPECT_NEAR(dense[2][3][5], separable[2][3][5], 1e-3f);
+
+    const std::array<std::vector<float>, 2> weights_2d = { std::vector<float>{ 1.0f }, std::vector<float>{} };
+    yato::vector_2d<float> plane(yato::dims(2, 2));
+    EXPECT_THROW(yato::stencil_separable_nd(yato::sampler_zero{}, plane, plane, weights_2d), yato::argument_error);
+}
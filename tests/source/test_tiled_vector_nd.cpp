@@ -0,0 +1,117 @@
+/**
+ * YATO library
+ *
+ * Apache License, Version 2.0
+ * Copyright (c) 2016-2020 Alexey Gruzdev
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include <yato/tiled_vector_nd.h>
+#include <yato/vector_nd.h>
+
+TEST(Yato_TiledVectorND, layout)
+{
+    yato::tiled_vector_nd<int, 2, 4, 8> v(yato::dims(10, 17));
+    EXPECT_EQ(yato::dims(10, 17), v.dimensions());
+    EXPECT_EQ(170u, v.total_size());
+    EXPECT_EQ(yato::dims(3, 3), v.tiles_dimensions());
+    EXPECT_EQ(yato::dims(4, 8), v.tile_dimensions());
+    EXPECT_EQ(9u * 32u, v.storage_size());
+
+    for (size_t i = 0; i < 10; ++i) {
+        for (size_t j = 0; j < 17; ++j) {
+            v[i][j] = static_cast<int>(i * 100 + j);
+        }
+    }
+    // First tile is stored contiguously
+    EXPECT_EQ(0, v.cdata()[0]);
+    EXPECT_EQ(7, v.cdata()[7]);
+    EXPECT_EQ(100, v.cdata()[8]);
+    EXPECT_EQ(307, v.cdata()[31]);
+    // Followed by the next tile along the row
+    EXPECT_EQ(8, v.cdata()[32]);
+
+    for (size_t i = 0; i < 10; ++i) {
+        for (size_t j = 0; j < 17; ++j) {
+            ASSERT_EQ(static_cast<int>(i * 100 + j), v[i][j]);
+        }
+    }
+
+    const auto& cv = v;
+    size_t rows = 0;
+    for (const auto row : cv) {
+        size_t cols = 0;
+        for (int x : row) {
+            EXPECT_EQ(static_cast<int>(rows * 100 + cols), x);
+            ++cols;
+        }
+        EXPECT_EQ(17u, cols);
+        ++rows;
+    }
+    EXPECT_EQ(10u, rows);
+}
+
+TEST(Yato_TiledVectorND, sampler)
+{
+    yato::tiled_vector_3d<float, 2, 4, 4> v(yato::dims(3, 5, 6), 1.0f);
+    v[2][4][5] = 7.0f;
+    EXPECT_EQ(7.0f, v.at(2, 4, 5));
+    EXPECT_THROW(v.at(3, 0, 0), yato::out_of_range_error);
+    EXPECT_EQ(7.0f, yato::load<yato::sampler_clamp>(v, 10, 10, 10));
+    EXPECT_EQ(0.0f, yato::load<yato::sampler_zero>(v, -1, 0, 0));
+    EXPECT_EQ(1.0f, yato::load<yato::sampler_zero>(v, 0, 0, 0));
+
+    using ops = yato::container_ops<decltype(v)>;
+    EXPECT_EQ(5u, ops::size(v, 1));
+    EXPECT_EQ(90u, ops::total_size(v));
+    EXPECT_EQ(v.dimensions(), ops::dimensions(v));
+}
+
+TEST(Yato_TiledVectorND, tiles)
+{
+    yato::vector_2d<int> src(yato::dims(9, 13));
+    std::iota(src.plain_begin(), src.plain_end(), 0);
+
+    yato::tiled_vector_2d<int, 4, 4> v(yato::array_view_2d<const int>(src.cdata(), src.dimensions()));
+    for (size_t i = 0; i < 9; ++i) {
+        for (size_t j = 0; j < 13; ++j) {
+            ASSERT_EQ(src[i][j], v[i][j]);
+        }
+    }
+
+    size_t visited = 0;
+    size_t elements = 0;
+    v.for_each_tile([&](const yato::dimensionality<2, size_t> & origin, const yato::array_view_2d<int> & tile) {
+        EXPECT_EQ(0u, origin[0] % 4);
+        EXPECT_EQ(0u, origin[1] % 4);
+        EXPECT_EQ(std::min<size_t>(4, 9 - origin[0]), tile.size(0));
+        EXPECT_EQ(std::min<size_t>(4, 13 - origin[1]), tile.size(1));
+        for (size_t i = 0; i < tile.size(0); ++i) {
+            for (size_t j = 0; j < tile.size(1); ++j) {
+                EXPECT_EQ(src[origin[0] + i][origin[1] + j], tile[i][j]);
+                tile[i][j] *= 2;
+                ++elements;
+            }
+        }
+        ++visited;
+    });
+    EXPECT_EQ(12u, visited);
+    EXPECT_EQ(9u * 13u, elements);
+
+    yato::vector_2d<int> dst(yato::dims(9, 13));
+    v.copy_to(yato::array_view_2d<int>(dst.data(), dst.dimensions()));
+    for (size_t i = 0; i < 9; ++i) {
+        for (size_t j = 0; j < 13; ++j) {
+            ASSERT_EQ(2 * src[i][j], dst[i][j]);
+        }
+    }
+
+    EXPECT_EQ(2 * src[5][9], v.ctile({ 1, 2 })[1][1]);
+
+    yato::vector_2d<int> wrong(yato::dims(9, 12));
+    EXPECT_THROW(v.copy_to(yato::array_view_2d<int>(wrong.data(), wrong.dimensions())), yato::argument_error);
+}